@@ -9,6 +9,16 @@
   *  Version    Date            Author          Modification
   *  V1.0.0     Dec-26-2018     RM              1. done
   *  V1.1.0     Nov-11-2019     RM              1. support hal lib
+  *  V1.2.0     Oct-16-2026     RM              1. seqlock feedback snapshot with
+  *                                                receive timestamp and sequence
+  *  V1.3.0     Oct-16-2026     RM              1. table driven rx on both CAN buses and fifos
+  *  V1.4.0     Oct-16-2026     RM              1. tx scheduler, commands are posted and sent
+  *                                                by TIM7 at fixed phase of 1ms cycle
+  *  V1.5.0     Oct-16-2026     RM              1. bus load, error counter and per ID rate statistics
+  *  V1.6.0     Oct-16-2026     RM              1. motor state estimated at frame rate
+  *  V1.7.0     Oct-16-2026     RM              1. Damiao motor in MIT mode
+  *  V1.8.0     Oct-16-2026     RM              1. record rx and tx frames in can_recorder
+  *  V1.10.0    Oct-16-2026     RM              1. unused 0x2FF id removed, no tx group sends it
   *
   @verbatim
   ==============================================================================
@@ -22,6 +32,8 @@
 #define CAN_RECEIVE_H
 
 #include "struct_typedef.h"
+#include "motor_state.h"
+#include "dm_motor.h"
 
 #define CHASSIS_CAN hcan1
 #define GIMBAL_CAN hcan2
@@ -39,9 +51,27 @@ typedef enum
     CAN_PIT_MOTOR_ID = 0x206,
     CAN_TRIGGER_MOTOR_ID = 0x207,
     CAN_GIMBAL_ALL_ID = 0x1FF,
+    CAN_CHASSIS_RESET_ID = 0x700,
 
 } can_msg_id_e;
 
+//bus index of can_motor_table, CAN_BUS_1:hcan1, CAN_BUS_2:hcan2
+//CAN, CAN_BUS_1:hcan1, CAN_BUS_2:hcan2
+#define CAN_BUS_1 0
+#define CAN_BUS_2 1
+#define CAN_BUS_NUM 2
+
+//bit rate of both buses, see MX_CAN1_Init/MX_CAN2_Init
+//·CANĲ
+#define CAN_BIT_RATE 1000000
+
+//motor feedback ID range of the lookup table, 0x201~0x220.
+//0x201~0x20B are DJI motors (3508/2006 ID 1~8, 6020 ID 1~7), set Damiao master ID in 0x20C~0x220
+//ұǵĵIDΧ, 0x201~0x220.
+//0x201~0x20BΪ󽮵, master ID0x20C~0x220
+#define CAN_RX_ID_BASE 0x201
+#define CAN_RX_ID_RANGE 32
+
 //rm motor data
 typedef struct
 {
@@ -52,6 +82,214 @@ typedef struct
     int16_t last_ecd;
 } motor_measure_t;
 
+/*
+motor table, every row is X(index, bus, rx id, rx fifo, detect toe).
+the motor index enum, the receive lookup table and the filter banks in bsp_can.c
+are all generated from this table, add a row to receive a new motor.
+, ÿһΪ X(, , ID, FIFO, ߼).
+, ղұԼbsp_can.cеĹɸñ, ӵֻһ.
+*/
+#define CAN_MOTOR_TABLE(X)                                                              \
+    X(CAN_CHASSIS_M1_INDEX,    CAN_BUS_1, CAN_3508_M1_ID,       CAN_RX_FIFO0, CHASSIS_MOTOR1_TOE) \
+    X(CAN_CHASSIS_M2_INDEX,    CAN_BUS_1, CAN_3508_M2_ID,       CAN_RX_FIFO0, CHASSIS_MOTOR2_TOE) \
+    X(CAN_CHASSIS_M3_INDEX,    CAN_BUS_1, CAN_3508_M3_ID,       CAN_RX_FIFO0, CHASSIS_MOTOR3_TOE) \
+    X(CAN_CHASSIS_M4_INDEX,    CAN_BUS_1, CAN_3508_M4_ID,       CAN_RX_FIFO0, CHASSIS_MOTOR4_TOE) \
+    X(CAN_YAW_MOTOR_INDEX,     CAN_BUS_2, CAN_YAW_MOTOR_ID,     CAN_RX_FIFO1, YAW_GIMBAL_MOTOR_TOE) \
+    X(CAN_PIT_MOTOR_INDEX,     CAN_BUS_2, CAN_PIT_MOTOR_ID,     CAN_RX_FIFO1, PITCH_GIMBAL_MOTOR_TOE) \
+    X(CAN_TRIGGER_MOTOR_INDEX, CAN_BUS_2, CAN_TRIGGER_MOTOR_ID, CAN_RX_FIFO0, TRIGGER_MOTOR_TOE)
+
+/*
+Damiao motor table in MIT mode, every row is
+X(index, bus, CAN ID, master ID, rx fifo, detect toe, PMAX, VMAX, TMAX).
+the motor is commanded on CAN ID and feeds back on master ID, every motor needs its own master ID.
+PMAX, VMAX, TMAX must be the same as set in the motor. e.g. a DM4310 yaw motor:
+(MITģʽ), ÿһΪ
+X(, , CAN ID, master ID, FIFO, ߼, PMAX, VMAX, TMAX).
+CAN IDϽտ, master IDϷ, ÿҪͬmaster ID.
+PMAX, VMAX, TMAXеһ. DM4310 yaw:
+    X(CAN_DM_YAW_MOTOR_INDEX, CAN_BUS_2, 0x01, 0x211, CAN_RX_FIFO1, YAW_GIMBAL_MOTOR_TOE, 12.5f, 30.0f, 10.0f)
+*/
+#define CAN_DM_MOTOR_TABLE(X)
+
+//motor feedback index, the order of motor data in CAN_receive.c, Damiao motors follow DJI motors
+//, ڴ󽮵֮
+#define CAN_MOTOR_INDEX_ENUM(index, bus, id, fifo, toe) index,
+#define CAN_DM_MOTOR_INDEX_ENUM(index, bus, can_id, master_id, fifo, toe, p_max, v_max, t_max) index,
+typedef enum
+{
+    CAN_MOTOR_TABLE(CAN_MOTOR_INDEX_ENUM)
+    CAN_DM_MOTOR_TABLE(CAN_DM_MOTOR_INDEX_ENUM)
+    CAN_MOTOR_NUM,
+} can_motor_index_e;
+#undef CAN_MOTOR_INDEX_ENUM
+#undef CAN_DM_MOTOR_INDEX_ENUM
+
+#define CAN_DM_MOTOR_COUNT(...) + 1
+#define CAN_DM_MOTOR_NUM (0 CAN_DM_MOTOR_TABLE(CAN_DM_MOTOR_COUNT))
+#define CAN_DM_MOTOR_INDEX_BASE (CAN_MOTOR_NUM - CAN_DM_MOTOR_NUM)
+
+//one consistent feedback frame of a motor, with its receive time
+//һ֡ķ,Լʱ
+typedef struct
+{
+    motor_measure_t measure;
+    motor_state_t state;    //multi-turn position, velocity and acceleration of DJI motor.󽮵Ȧλ, ٶȺͼٶ
+    dm_motor_measure_t dm;  //feedback of Damiao motor.
+    uint32_t rx_cycle;  //DWT cycle count when the frame was received.ʱDWTڼ
+    uint32_t seq;       //frame count of this motor, 0 means no frame yet.֡,0ʾûյ
+} motor_feedback_t;
+
+//tx phases of 1ms cycle, TIM7 runs at 4kHz
+//ÿ1msڵλ, TIM7Ƶ4kHz
+#define CAN_TX_PHASE_NUM 4
+
+//tx group, every group id is sent at a fixed phase
+//, ÿڹ̶λ
+typedef enum
+{
+    CAN_TX_GIMBAL_GROUP = 0,
+    CAN_TX_CHASSIS_GROUP,
+    CAN_TX_CHASSIS_RESET_ID_GROUP,
+    CAN_TX_DM_GROUP_BASE,   //one group per Damiao motor, in CAN_DM_MOTOR_TABLE order.ÿһ
+    CAN_TX_GROUP_NUM = CAN_TX_DM_GROUP_BASE + CAN_DM_MOTOR_NUM,
+} can_tx_group_e;
+
+//tx counters of a group
+//
+typedef struct
+{
+    uint32_t sent;       //frames put into mailbox.֡
+    uint32_t coalesced;  //posts that replaced data not sent yet.δݵĴ
+    uint32_t late;       //frames sent after their phase.λ֡
+    uint32_t dropped;    //frames aborted in mailbox.бֹ֡
+    //marked source data to mailbox, see CAN_tx_mark.ӱǵԴӳ
+    uint32_t latency_us;
+    uint32_t latency_max_us;
+    uint32_t latency_sum_us;
+    uint32_t latency_num;
+} can_tx_stat_t;
+
+//statistics of a CAN bus, rates and load are of the last second
+//CANͳ, ʺ͸Ϊһֵ
+typedef struct
+{
+    uint32_t rx_rate;               //rx frames per second.ÿ֡
+    uint32_t tx_rate;               //tx frames per second.ÿ뷢֡
+    uint16_t load;                  //estimated bus load, unit 0.1%.߸, λ0.1%
+    uint8_t tec;                    //transmit error counter.ʹ
+    uint8_t rec;                    //receive error counter.մ
+    uint8_t error_passive;          //1: error passive.1: ״̬
+    uint8_t bus_off;                //1: bus off now.1: ǰ
+    uint8_t mailbox_high_water;     //most tx mailboxes in use, 0~3.ռ
+    uint32_t bus_off_count;         //bus off events.ߴ
+    uint32_t fifo_overrun[2];       //rx fifo0/fifo1 overruns.FIFO
+} can_bus_stat_t;
+
+//statistics of one CAN ID
+//CAN IDͳ
+typedef struct
+{
+    uint8_t bus;
+    uint16_t std_id;
+    uint32_t frame;                 //total frames.֡
+    uint32_t rate;                  //frames per second.ÿ֡
+} can_id_stat_t;
+
+/**
+  * @brief          start the tx scheduler timer
+  * @param[in]      none
+  * @retval         none
+  */
+/**
+  * @brief          ͵ȶʱ
+  * @param[in]      none
+  * @retval         none
+  */
+extern void can_tx_init(void);
+
+/**
+  * @brief          mark the next post of a group with the DWT cycle of the data it comes from,
+  *                 the latency from that cycle to mailbox is counted in can_tx_stat_t
+  * @param[in]      group: tx group, CAN_TX_GIMBAL_GROUP etc.
+  * @param[in]      src_cycle: DWT cycle of the source data, such as an INS sample
+  * @retval         none
+  */
+/**
+  * @brief          һһύԴDWT, Ӹüӳټcan_tx_stat_t
+  * @param[in]      group: , CAN_TX_GIMBAL_GROUP
+  * @param[in]      src_cycle: ԴDWT, INS
+  * @retval         none
+  */
+extern void CAN_tx_mark(uint8_t group, uint32_t src_cycle);
+
+/**
+  * @brief          send the pending data of a group now instead of at its phase,
+  *                 if no mailbox is free it is left to the scheduler
+  * @param[in]      group: tx group, CAN_TX_GIMBAL_GROUP etc.
+  * @retval         none
+  */
+/**
+  * @brief          һ, ǵȵλ, ûпʱɵȷ
+  * @param[in]      group: , CAN_TX_GIMBAL_GROUP
+  * @retval         none
+  */
+extern void CAN_tx_now(uint8_t group);
+
+/**
+  * @brief          get the tx counters of a group
+  * @param[in]      group: tx group, CAN_TX_GIMBAL_GROUP etc.
+  * @param[out]     stat: counters copy
+  * @retval         1: ok, 0: group out of range
+  */
+/**
+  * @brief          ȡļ
+  * @param[in]      group: , CAN_TX_GIMBAL_GROUP
+  * @param[out]     stat: 
+  * @retval         1: ɹ, 0: 鳬Χ
+  */
+extern bool_t get_can_tx_stat(uint8_t group, can_tx_stat_t *stat);
+
+/**
+  * @brief          get the statistics of a CAN bus
+  * @param[in]      bus: CAN_BUS_1 or CAN_BUS_2
+  * @param[out]     stat: statistics copy
+  * @retval         1: ok, 0: bus out of range
+  */
+/**
+  * @brief          ȡCANͳ
+  * @param[in]      bus: CAN_BUS_1  CAN_BUS_2
+  * @param[out]     stat: ͳƿ
+  * @retval         1: ɹ, 0: ߳Χ
+  */
+extern bool_t get_can_bus_stat(uint8_t bus, can_bus_stat_t *stat);
+
+/**
+  * @brief          get the rx statistics of a motor feedback ID
+  * @param[in]      motor_index: CAN_CHASSIS_M1_INDEX etc.
+  * @param[out]     stat: statistics copy
+  * @retval         1: ok, 0: index out of range
+  */
+/**
+  * @brief          ȡIDĽͳ
+  * @param[in]      motor_index: CAN_CHASSIS_M1_INDEX
+  * @param[out]     stat: ͳƿ
+  * @retval         1: ɹ, 0: ųΧ
+  */
+extern bool_t get_can_rx_id_stat(uint8_t motor_index, can_id_stat_t *stat);
+
+/**
+  * @brief          get the tx statistics of a tx group ID
+  * @param[in]      group: CAN_TX_GIMBAL_GROUP etc.
+  * @param[out]     stat: statistics copy
+  * @retval         1: ok, 0: group out of range
+  */
+/**
+  * @brief          ȡIDķͳ
+  * @param[in]      group: CAN_TX_GIMBAL_GROUP
+  * @param[out]     stat: ͳƿ
+  * @retval         1: ɹ, 0: 鳬Χ
+  */
+extern bool_t get_can_tx_id_stat(uint8_t group, can_id_stat_t *stat);
 
 /**
   * @brief          send control current of motor (0x205, 0x206, 0x207, 0x208)
@@ -101,6 +339,42 @@ extern void CAN_cmd_chassis_reset_ID(void);
   */
 extern void CAN_cmd_chassis(int16_t motor1, int16_t motor2, int16_t motor3, int16_t motor4);
 
+/**
+  * @brief          send a special command to a Damiao motor, enable, disable, save zero or clear error
+  * @param[in]      motor_index: index in CAN_DM_MOTOR_TABLE
+  * @param[in]      cmd: DM_MOTOR_CMD_ENABLE etc.
+  * @retval         none
+  */
+/**
+  * @brief          , ʹ, ʧ, 
+  * @param[in]      motor_index: CAN_DM_MOTOR_TABLEе
+  * @param[in]      cmd: DM_MOTOR_CMD_ENABLE
+  * @retval         none
+  */
+extern void CAN_cmd_dm_motor(uint8_t motor_index, uint8_t cmd);
+
+/**
+  * @brief          send MIT command to a Damiao motor
+  * @param[in]      motor_index: index in CAN_DM_MOTOR_TABLE
+  * @param[in]      position: target position, rad
+  * @param[in]      velocity: target velocity, rad/s
+  * @param[in]      kp: position gain, [0, 500]
+  * @param[in]      kd: velocity gain, [0, 5]
+  * @param[in]      torque: feedforward torque, N.m
+  * @retval         none
+  */
+/**
+  * @brief          MIT֡
+  * @param[in]      motor_index: CAN_DM_MOTOR_TABLEе
+  * @param[in]      position: Ŀλ, rad
+  * @param[in]      velocity: Ŀٶ, rad/s
+  * @param[in]      kp: λ, [0, 500]
+  * @param[in]      kd: ٶ, [0, 5]
+  * @param[in]      torque: ǰ, N.m
+  * @retval         none
+  */
+extern void CAN_cmd_dm_mit(uint8_t motor_index, fp32 position, fp32 velocity, fp32 kp, fp32 kd, fp32 torque);
+
 /**
   * @brief          return the yaw 6020 motor data point
   * @param[in]      none
@@ -149,5 +423,35 @@ extern const motor_measure_t *get_trigger_motor_measure_point(void);
   */
 extern const motor_measure_t *get_chassis_motor_measure_point(uint8_t i);
 
+/**
+  * @brief          copy the latest feedback frame of a motor, never torn by the CAN interrupt.
+  *                 the data pointed by get_xxx_measure_point may change while it is read,
+  *                 control loop should use this function once per cycle.
+  * @param[in]      motor_index: motor index, see can_motor_index_e
+  * @param[out]     feedback: the copy of feedback frame
+  * @retval         1: at least one frame has been received, 0: no frame or invalid index
+  */
+/**
+  * @brief          Ƶµһ֡,ᱻCANжд.
+  *                 get_xxx_measure_pointصݿڶȡбд,
+  *                 ѭӦÿڵһα
+  * @param[in]      motor_index: ,can_motor_index_e
+  * @param[out]     feedback: ݸ
+  * @retval         1:Ѿյ, 0:δյݻŴ
+  */
+extern bool_t get_motor_feedback(uint8_t motor_index, motor_feedback_t *feedback);
+
+/**
+  * @brief          return the age of a feedback frame, unit us
+  * @param[in]      feedback: the copy from get_motor_feedback
+  * @retval         time since the frame was received, unit us
+  */
+/**
+  * @brief          طݵʱ, λ us
+  * @param[in]      feedback: get_motor_feedbackõ
+  * @retval         ո֡ʱ, λ us
+  */
+extern uint32_t get_motor_feedback_age_us(const motor_feedback_t *feedback);
+
 
 #endif
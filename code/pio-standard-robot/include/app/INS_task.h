@@ -12,6 +12,16 @@
   *  Version    Date            Author          Modification
   *  V1.0.0     Dec-26-2018     RM              1. done
   *  V2.0.0     Nov-11-2019     RM              1. support bmi088, but don't support mpu6500
+  *  V2.1.0     Oct-16-2026     RM              1. quaternion EKF with gyro bias, selected by INS_FILTER
+  *  V2.2.0     Oct-16-2026     RM              1. integrate with dt measured at gyro data ready, dt histogram
+  *  V2.3.0     Oct-16-2026     RM              1. read gyro FIFO bursts when BMI088_GYRO_FIFO_ENABLE
+  *  V2.4.0     Oct-16-2026     RM              1. triple buffered INS snapshot, wait for next sample
+  *  V2.5.0     Oct-16-2026     RM              1. read ist8310 by I2C DMA at its data ready, latency statistics
+  *  V2.6.0     Oct-16-2026     RM              1. heater warm up by thermal model, learned model saved in flash, time to ready
+  *  V2.7.0     Oct-16-2026     RM              1. gyro zero drift vs temperature table learned while still
+  *  V2.8.0     Oct-16-2026     RM              1. temperature pid with real dt
+  *  V2.9.0     Oct-16-2026     RM              1. gyro temperature still window by window mean and deviation, no command
+  *  V2.10.0    Oct-16-2026     RM              1. INS_FILTER_EKF described as a gyro bias update at rest (ZARU)
   *
   @verbatim
   ==============================================================================
@@ -24,9 +34,14 @@
 #ifndef INS_Task_H
 #define INS_Task_H
 #include "struct_typedef.h"
+#include "BMI088driver.h"
 
 
+#if defined(BMI088_GYRO_FIFO_ENABLE)
+#define SPI_DMA_GYRO_LENGHT       (1 + BMI088_GYRO_FIFO_DEPTH * BMI088_GYRO_FIFO_FRAME_SIZE)
+#else
 #define SPI_DMA_GYRO_LENGHT       8
+#endif
 #define SPI_DMA_ACCEL_LENGHT      9
 #define SPI_DMA_ACCEL_TEMP_LENGHT 4
 
@@ -44,9 +59,14 @@
 #define IST8310_RX_BUF_DATA_OFFSET 16
 
 
+//KI and KD are per TEMPERATURE_PID_DT, turned to per second in the pid config
+//KIKDTEMPERATURE_PID_DT, pidлΪ
 #define TEMPERATURE_PID_KP 1600.0f //¶ȿPIDkp
 #define TEMPERATURE_PID_KI 0.2f    //¶ȿPIDki
 #define TEMPERATURE_PID_KD 0.0f    //¶ȿPIDkd
+//temperature is read at every accel data ready, 800Hz
+//ÿμٶȼݾʱȡ¶, 800Hz
+#define TEMPERATURE_PID_DT 0.00125f
 
 #define TEMPERATURE_PID_MAX_OUT   4500.0f //¶ȿPIDmax_out
 #define TEMPERATURE_PID_MAX_IOUT 4400.0f  //¶ȿPIDmax_iout
@@ -56,6 +76,164 @@
 
 #define INS_TASK_INIT_TIME 7 //ʼ delay һʱ
 
+//heater thermal model: dT/dt = gain * pwm / MPU6500_TEMP_PWM_MAX - (T - T_ambient) / tau
+//warm up at full power, brake early by the rise in the lag time, then PID with the integrator
+//preloaded by the hold power of the model
+//ģ: dT/dt = gain * pwm / MPU6500_TEMP_PWM_MAX - (T - T_ambient) / tau
+//ȫʼ, ǰһͺʱֹͣȫ, ֮PID, ԤΪģ͵άֹ
+#define HEATER_DEFAULT_GAIN     0.5f    //heating rate at full power, unit /s.ȫ λ /s
+#define HEATER_DEFAULT_TAU      60.0f   //heat loss time constant, unit s.ɢʱ䳣 λ s
+#define HEATER_GAIN_MIN         0.05f
+#define HEATER_GAIN_MAX         5.0f
+#define HEATER_TAU_MIN          10.0f
+#define HEATER_TAU_MAX          1000.0f
+#define HEATER_LAG_TIME         1.0f    //heater to sensor lag, unit s.ȵͺ λ s
+//ready when the temperature stays in the band for the time
+//¶ȱڸ÷Χһʱ伴Ϊ
+#define HEATER_READY_BAND       0.5f    //unit 
+#define HEATER_READY_TIME       1000    //unit ms
+//the model is learned only at a cold boot, this much below the target
+//ֻʱѧϰģ, ʱĿ¶ȸֵ
+#define HEATER_LEARN_MIN_RISE   8.0f
+//gain is learned from the slope in this window of warm up, tau from the mean hold power in the window after ready
+//ڸʱ䴰ڵбѧϰgain, ʱ䴰ڵƽάֹѧϰtau
+#define HEATER_GAIN_LEARN_START 2000    //unit ms
+#define HEATER_GAIN_LEARN_END   7000    //unit ms
+#define HEATER_TAU_LEARN_DELAY  10000   //unit ms
+#define HEATER_TAU_LEARN_TIME   20000   //unit ms
+//learned model is saved when it differs from the one in use by this ratio
+//ѧϰģ뵱ǰģñʱ
+#define HEATER_MODEL_SAVE_DIFF  0.1f
+
+#define HEATER_MODE_INIT        0
+#define HEATER_MODE_WARM_UP     1
+#define HEATER_MODE_HOLD        2
+
+//gyro zero drift vs temperature, learned while the board is still and used by imu_cali_slove,
+//the single calibrated offset is used out of the learned range
+//Ư¶ȱ仯ı, ھֹʱѧϰimu_cali_slove, ѧϰΧʹõһУ׼Ư
+#define GYRO_TEMP_BIN_NUM       16
+#define GYRO_TEMP_MIN           20.0f   //temperature of bin 0, unit .0¶ λ 
+#define GYRO_TEMP_STEP          2.0f    //unit 
+//still: no chassis or gimbal command and the accel in the limit at every sample of the window, the gyro
+//mean and standard deviation of the window in the limits. the mean only leaves the residual of the offset
+//in use, about 0.3 deg/s over the table range (BMI088 0.015 deg/s/K), the deviation is about twice the
+//gyro noise at the 116~230Hz bandwidth
+//ֹ: ÿβûеָ̨̺ҼٶڷΧ, ǵľֵͱ׼ڷΧ. ֵֻ
+//ǰƯĲв, ¶ȱΧԼ0.3 deg/s(BMI088 0.015 deg/s/K), ׼ԼΪ116~230Hz
+#define GYRO_TEMP_STILL_GYRO        0.005f  //window mean, unit rad/s.ھֵ λ rad/s
+#define GYRO_TEMP_STILL_GYRO_STD    0.008f  //window standard deviation, unit rad/s.ڱ׼ λ rad/s
+#define GYRO_TEMP_STILL_ACCEL       0.3f    //from gravity, unit m/s2.ٶ֮ λ m/s2
+#define GYRO_TEMP_STILL_RC          10      //rocker deadband, no mouse or key.ҡ, Ͱ
+#define GYRO_TEMP_STILL_TIME    1000    //window, unit sample.ڳ λ 
+//a bin is the running mean of its windows
+//ÿΪڵĻƽ
+#define GYRO_TEMP_AVG_MAX       16
+#define GYRO_TEMP_VALID_COUNT   3       //windows before a bin is used.ʹǰҪĴ
+//saved when a bin becomes valid or moves this much, at most once in the time
+//µЧĳ仯ֵʱ, Сڸʱ
+#define GYRO_TEMP_SAVE_DIFF     0.0005f //unit rad/s
+#define GYRO_TEMP_SAVE_TIME     60000   //unit ms
+//not used while the gyro is calibrated by remote control
+//ңУ׼ʱʹøñ
+#define GYRO_TEMP_CALI_HOLD     100     //unit ms
+
+//attitude filter: Mahony AHRS or quaternion EKF, the EKF learns the gyro bias only at rest (ZARU), see quaternion_ekf.h
+//̬˲: Mahony AHRS ԪEKF, EKFֻھֹʱƯ(ZARU), quaternion_ekf.h
+#define INS_FILTER_AHRS 0
+#define INS_FILTER_EKF  1
+#ifndef INS_FILTER
+#define INS_FILTER INS_FILTER_AHRS
+#endif
+//fuse ist8310 in the AHRS filter, the mag is not calibrated, so it is off by default
+//AHRSǷںϴ, δУ׼, Ĭϲں
+#ifndef INS_MAG_FUSION
+#define INS_MAG_FUSION 0
+#endif
+
+//INS_DT_NOMINAL_US is the period of the INS samples, INS_DT_FRAME_US is the period of the gyro frames
+//integrated one by one, a FIFO burst is one INS sample of several frames
+//INS_DT_NOMINAL_USΪINSݵ, INS_DT_FRAME_USΪֵ֡֡, һFIFOȡΪһκ֡INS
+#if defined(BMI088_GYRO_FIFO_ENABLE)
+#define INS_DT_NOMINAL_US   (BMI088_GYRO_FIFO_FRAME_NUM * BMI088_GYRO_FIFO_FRAME_US)
+#define INS_DT_FRAME_US     BMI088_GYRO_FIFO_FRAME_US
+#else
+#define INS_DT_NOMINAL_US   1000
+#define INS_DT_FRAME_US     1000
+#endif
+//dt histogram of the frames, bin i counts dt in [INS_DT_FRAME_US + (i - INS_DT_HIST_NUM / 2) * INS_DT_HIST_STEP_US, + INS_DT_HIST_STEP_US),
+//the first and last bins are open ended
+//֡dtֱͼ, iͳڶӦdt, β߽
+#define INS_DT_HIST_NUM     16
+#define INS_DT_HIST_STEP_US 25
+//dt above this is a lost gyro sample or a stall, the nominal dt is used instead
+//dtֵΪʧݻ򿨶, ʹñdt
+#define INS_DT_MAX_US       10000
+
+//snapshots published by INS_task, the writer never overwrites the latest one
+//INS_taskĿ, дʱḲµһ
+#define INS_SNAPSHOT_NUM 3
+//tasks that can wait for the next sample at the same time
+//ͬʱȴһβ
+#define INS_WAIT_TASK_NUM 4
+
+//one consistent INS sample, all fields come from the same gyro sample
+//һINS, ͬһǲ
+typedef struct
+{
+    fp32 quat[4];
+    fp32 angle[3];          //euler angle, 0:yaw, 1:pitch, 2:roll, unit rad.ŷ λ rad
+    fp32 gyro[3];           //unit rad/s.ٶ λ rad/s
+    fp32 accel[3];          //unit m/s2.ٶ λ m/s2
+    uint32_t sample_cycle;  //DWT cycle at the gyro data ready.ݾʱDWT
+    uint32_t seq;           //sample sequence, 0: no sample yet., 0Ϊ
+} INS_snapshot_t;
+
+typedef struct
+{
+    uint32_t count[INS_DT_HIST_NUM];
+    uint32_t dt_min_us;
+    uint32_t dt_max_us;
+} INS_dt_hist_t;
+
+//ist8310 read statistics, data ready -> I2C DMA -> INS_task
+//ƶȡͳ, ݾ -> I2C DMA -> INS_task
+typedef struct
+{
+    uint32_t sample;            //samples handled by INS_task.INS_task
+    uint32_t drop;              //data ready while the last read not done.ϴζȡδʱݾ
+    uint32_t error;             //I2C error.I2C
+    uint32_t latency_us;        //data ready to handled, last sample.ݾӳ
+    uint32_t latency_max_us;
+    uint32_t isr_cycle_max;     //max cycle in data ready and read over interrupt.жеʱ λ cycle
+} INS_mag_stat_t;
+
+//gyro FIFO read statistics, zero without BMI088_GYRO_FIFO_ENABLE
+//FIFOȡͳ, δBMI088_GYRO_FIFO_ENABLEʱΪ0
+typedef struct
+{
+    uint32_t burst;             //bursts handled.ѶȡĴ
+    uint32_t frame;             //frames read.Ѷȡ֡
+    uint32_t frame_max;         //most frames in a burst, above BMI088_GYRO_FIFO_FRAME_NUM the watermark was late.֡, ˮλ˵ͺ
+    uint32_t empty;             //watermark with no frame.ݵˮλж
+    uint32_t overrun;           //FIFO cleared after an overrun.FIFOĴ
+} INS_gyro_fifo_stat_t;
+
+typedef struct
+{
+    uint32_t ready_time_ms;     //power on to temperature ready, 0: not ready.ϵ絽¶Ⱦʱ, 0Ϊδ
+    fp32 start_temp;            //imu temperature at boot, unit .ʱimu¶
+    fp32 gain;                  //model in use.ǰʹõģ
+    fp32 tau;
+    uint8_t mode;
+} INS_heater_stat_t;
+
+typedef struct
+{
+    fp32 offset[GYRO_TEMP_BIN_NUM][3];  //zero drift as gyro_offset, unit rad/s.gyro_offsetͬƯ λ rad/s
+    uint16_t count[GYRO_TEMP_BIN_NUM];  //windows averaged.ƽĴ
+} INS_gyro_temp_table_t;
+
 #define INS_YAW_ADDRESS_OFFSET    0
 #define INS_PITCH_ADDRESS_OFFSET  1
 #define INS_ROLL_ADDRESS_OFFSET   2
@@ -139,6 +317,40 @@ extern const fp32 *get_INS_quat_point(void);
   */
 extern const fp32 *get_INS_angle_point(void);
 
+/**
+  * @brief          copy the latest INS sample, wait-free for the reader, never torn by INS_task.
+  *                 the arrays returned by get_xxx_point may change while they are read,
+  *                 control loop should use this function once per cycle.
+  * @param[out]     snapshot: copy of the latest sample
+  * @retval         1: a sample has been published, 0: no sample yet
+  */
+/**
+  * @brief          µINS, ȡȴ, ᱻINS_taskд.
+  *                 get_xxx_pointصڶȡбд,
+  *                 ѭӦÿڵһα
+  * @param[out]     snapshot: ݵĸ
+  * @retval         1:, 0:
+  */
+extern bool_t get_INS_snapshot(INS_snapshot_t *snapshot);
+
+/**
+  * @brief          block until a sample newer than last_seq is published, then copy it.
+  *                 at most INS_WAIT_TASK_NUM tasks can call it.
+  * @param[out]     snapshot: copy of the new sample
+  * @param[in]      last_seq: seq of the sample already used, 0 to wait for the first one
+  * @param[in]      timeout: max wait time, unit ms
+  * @retval         1: new sample, 0: timeout or too many waiting tasks, snapshot is the latest one
+  */
+/**
+  * @brief          ֱlast_seqµ, Ƹ.
+  *                 INS_WAIT_TASK_NUMԵ
+  * @param[out]     snapshot: ݵĸ
+  * @param[in]      last_seq: ʹݵ, 0Ϊȴһ
+  * @param[in]      timeout: ȴʱ λ ms
+  * @retval         1:õ, 0:ʱȴ, snapshotΪ
+  */
+extern bool_t INS_wait_snapshot(INS_snapshot_t *snapshot, uint32_t last_seq, uint32_t timeout);
+
 
 /**
   * @brief          get the rotation speed, 0:x-axis, 1:y-axis, 2:roll-axis,unit rad/s
@@ -177,4 +389,104 @@ extern const fp32 *get_accel_data_point(void);
   */
 extern const fp32 *get_mag_data_point(void);
 
+/**
+  * @brief          get the histogram of the measured integration dt
+  * @param[in]      none
+  * @retval         the point of the dt histogram
+  */
+/**
+  * @brief          ȡʵʱֱͼ
+  * @param[in]      none
+  * @retval         dtֱͼָ
+  */
+extern const INS_dt_hist_t *get_INS_dt_hist_point(void);
+
+/**
+  * @brief          get the ist8310 read statistics
+  * @param[in]      none
+  * @retval         the point of the statistics
+  */
+/**
+  * @brief          ȡƶȡͳ
+  * @param[in]      none
+  * @retval         ͳݵָ
+  */
+extern const INS_mag_stat_t *get_INS_mag_stat_point(void);
+
+/**
+  * @brief          get the gyro FIFO read statistics
+  * @param[in]      none
+  * @retval         the point of the statistics
+  */
+/**
+  * @brief          ȡFIFOȡͳ
+  * @param[in]      none
+  * @retval         ͳݵָ
+  */
+extern const INS_gyro_fifo_stat_t *get_INS_gyro_fifo_stat_point(void);
+
+/**
+  * @brief          set the heater thermal model, called by calibrate with the model in flash
+  * @param[in]      gain: heating rate at full power, unit /s
+  * @param[in]      tau: heat loss time constant, unit s
+  * @retval         none
+  */
+/**
+  * @brief          üģ, У׼flashеģ͵
+  * @param[in]      gain: ȫ λ /s
+  * @param[in]      tau: ɢʱ䳣 λ s
+  * @retval         none
+  */
+extern void INS_set_heater_model(fp32 gain, fp32 tau);
+
+/**
+  * @brief          get the heater thermal model learned at this boot, once
+  * @param[out]     gain: heating rate at full power, unit /s
+  * @param[out]     tau: heat loss time constant, unit s
+  * @retval         1: a new model to save, 0: none
+  */
+/**
+  * @brief          ȡѧϰļģ, ֻһ
+  * @param[out]     gain: ȫ λ /s
+  * @param[out]     tau: ɢʱ䳣 λ s
+  * @retval         1: Ҫģ, 0: 
+  */
+extern bool_t INS_get_heater_model(fp32 *gain, fp32 *tau);
+
+/**
+  * @brief          set the gyro zero drift vs temperature table, called by calibrate with the table in flash
+  * @param[in]      table: the table
+  * @retval         none
+  */
+/**
+  * @brief          Ư¶ȱ, У׼flashеı
+  * @param[in]      table: Ư¶ȱ
+  * @retval         none
+  */
+extern void INS_set_gyro_temp_table(const INS_gyro_temp_table_t *table);
+
+/**
+  * @brief          get the learned gyro zero drift vs temperature table when it should be saved
+  * @param[out]     table: the table
+  * @retval         1: a table to save, 0: none
+  */
+/**
+  * @brief          ҪʱȡѧϰƯ¶ȱ
+  * @param[out]     table: Ư¶ȱ
+  * @retval         1: Ҫı, 0: 
+  */
+extern bool_t INS_get_gyro_temp_table(INS_gyro_temp_table_t *table);
+
+/**
+  * @brief          get the heater statistics, include time to ready
+  * @param[in]      none
+  * @retval         the point of the statistics
+  */
+/**
+  * @brief          ȡͳ, ʱ
+  * @param[in]      none
+  * @retval         ͳݵָ
+  */
+extern const INS_heater_stat_t *get_INS_heater_stat_point(void);
+
 #endif
@@ -16,6 +16,9 @@
   *  Version    Date            Author          Modification
   *  V1.0.0     Oct-25-2018     RM              1. done
   *  V1.1.0     Nov-11-2019     RM              1. add chassis clabration
+  *  V1.2.0     Oct-16-2026     RM              1. save the imu heater model learned by INS task
+  *  V1.3.0     Oct-16-2026     RM              1. save the gyro zero drift vs temperature table learned by INS task
+  *  V1.4.0     Oct-16-2026     RM              1. relay feedback pid auto-tune of gimbal speed loops and trigger
   *
   @verbatim
   ==============================================================================
@@ -25,6 +28,9 @@
   *             third:hold for 2 seconds, two rockers set to ./\., begin the gyro calibration
   *                     or set to '\/', begin the gimbal calibration
   *                     or set to /''\, begin the chassis calibration
+  *                     or set to '\'\, begin the pid auto-tune of yaw speed loop
+  *                     or set to /'/', begin the pid auto-tune of pitch speed loop
+  *                     or set to ././, begin the pid auto-tune of trigger speed loop
   *
   *             data in flash, include cali data and name[3] and cali_flag
   *             for example, head_cali has 8 bytes, and it need 12 bytes in flash. if it starts in 0x080A0000
@@ -60,6 +66,9 @@
   *             :ҡ˴./\. ʼУ׼
   *                    ҡ˴'\/' ʼ̨У׼
   *                    ҡ˴/''\ ʼУ׼
+  *                    ҡ˴'\'\ ʼyawٶȻpid
+  *                    ҡ˴/'/' ʼpitchٶȻpid
+  *                    ҡ˴././ ʼٶȻpid
   *
   *             flashУУ׼ݺ name[3]  У׼־λ cali_flag
   *             head_caliа˸ֽ,Ҫ12ֽflash,0x080A0000ʼ
@@ -126,6 +135,14 @@
 #define gyro_cali_fun(cali_scale, cali_offset, time_count)  INS_cali_gyro((cali_scale), (cali_offset), (time_count))
 //set the zero drift to the INS task, INS taskڵƯ
 #define gyro_set_cali(cali_scale, cali_offset)              INS_set_cali_gyro((cali_scale), (cali_offset))
+//set the heater model to the INS task, INS taskļģ
+#define heater_set_cali(gain, tau)                          INS_set_heater_model((gain), (tau))
+//get the heater model learned by the INS task, ȡINS taskѧϰļģ
+#define heater_get_learned(gain, tau)                       INS_get_heater_model((gain), (tau))
+//set the gyro zero drift vs temperature table to the INS task, INS taskƯ¶ȱ
+#define gyro_temp_set_cali(table)                           INS_set_gyro_temp_table((table))
+//get the table learned by the INS task, ȡINS taskѧϰƯ¶ȱ
+#define gyro_temp_get_learned(table)                        INS_get_gyro_temp_table((table))
 
 
 
@@ -161,6 +178,8 @@
 
 
 #define GYRO_CALIBRATE_TIME         20000   //gyro calibrate time,У׼ʱ
+//learned data are written after the robot is safe for this time, see cali_learned_safe.˰ȫʱдѧϰ
+#define CALI_LEARNED_SAFE_TIME      1000
 
 //cali device name
 typedef enum
@@ -170,6 +189,9 @@ typedef enum
     CALI_GYRO = 2,
     CALI_ACC = 3,
     CALI_MAG = 4,
+    CALI_HEATER = 5,
+    CALI_GYRO_TEMP = 6,
+    CALI_PID_TUNE = 7,
     //add more...
     CALI_LIST_LENGHT,
 } cali_id_e;
@@ -212,6 +234,22 @@ typedef struct
     fp32 scale[3];  //x,y,z
 } imu_cali_t;
 
+//imu heater model, learned by INS task at a cold boot
+//imuģ, INS taskʱѧϰ
+typedef struct
+{
+    fp32 gain;  //heating rate at full power, unit /s
+    fp32 tau;   //heat loss time constant, unit s
+} heater_cali_t;
+
+//gains of the relay feedback pid auto-tune, order: yaw speed, pitch speed, trigger, kp 0 means not tuned
+//̵練pidĲ, ˳: yawٶȻ, pitchٶȻ, , kpΪ0û
+typedef struct
+{
+    fp32 kp[3];
+    fp32 ki[3]; //unit 1/s
+} pid_tune_cali_t;
+
 
 /**
   * @brief          use remote control to begin a calibrate,such as gyro, gimbal, chassis
@@ -0,0 +1,101 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       can_recorder.c/h
+  * @brief      CAN flight recorder, a RAM ring of every rx and tx CAN frame with
+  *             us timestamp. it is frozen and drained by usb_task.
+  *             CAN¼, RAMλм¼ÿһ֡շCANݼusʱ,
+  *             usb_task.
+  * @note       
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *
+  @verbatim
+  ==============================================================================
+  the newest CAN_RECORDER_SIZE frames are kept, older ones are overwritten.
+  µCAN_RECORDER_SIZE֡, ֡.
+  ==============================================================================
+  @endverbatim
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+
+#ifndef CAN_RECORDER_H
+#define CAN_RECORDER_H
+
+#include "struct_typedef.h"
+
+//records in the ring, must be power of 2, 16 bytes each
+//λ¼, Ϊ2, ÿ16ֽ
+#define CAN_RECORDER_SIZE 1024
+
+#define CAN_RECORD_RX 0
+#define CAN_RECORD_TX 1
+
+typedef struct
+{
+    uint32_t time_us;   //dwt_get_us when recorded.¼ʱusʱ
+    uint16_t std_id;
+    uint8_t bus;        //CAN_BUS_1 or CAN_BUS_2
+    uint8_t dir_dlc;    //bit7: CAN_RECORD_TX, bit0~3: dlc.bit7: , bit0~3: ݳ
+    uint8_t data[8];
+} can_record_t;
+
+/**
+  * @brief          record a CAN frame, called in CAN rx interrupt and tx stage
+  * @param[in]      bus: CAN_BUS_1 or CAN_BUS_2
+  * @param[in]      dir: CAN_RECORD_RX or CAN_RECORD_TX
+  * @param[in]      std_id: standard ID
+  * @param[in]      dlc: data length, [0,8]
+  * @param[in]      data: frame data
+  * @retval         none
+  */
+/**
+  * @brief          ¼һ֡CAN, CANжϺͷ͵е
+  * @param[in]      bus: CAN_BUS_1  CAN_BUS_2
+  * @param[in]      dir: CAN_RECORD_RX  CAN_RECORD_TX
+  * @param[in]      std_id: ׼ID
+  * @param[in]      dlc: ݳ, [0,8]
+  * @param[in]      data: ֡
+  * @retval         none
+  */
+extern void can_recorder_write(uint8_t bus, uint8_t dir, uint32_t std_id, uint8_t dlc, const uint8_t *data);
+
+/**
+  * @brief          freeze or resume recording, records can be read only when frozen
+  * @param[in]      freeze: 1: freeze, 0: resume
+  * @retval         none
+  */
+/**
+  * @brief          ָ¼, ʱܶȡ¼
+  * @param[in]      freeze: 1: , 0: ָ
+  * @retval         none
+  */
+extern void can_recorder_freeze(bool_t freeze);
+
+/**
+  * @brief          number of records in the ring
+  * @param[in]      none
+  * @retval         record number, [0, CAN_RECORDER_SIZE]
+  */
+/**
+  * @brief          λеļ¼
+  * @param[in]      none
+  * @retval         ¼, [0, CAN_RECORDER_SIZE]
+  */
+extern uint16_t can_recorder_count(void);
+
+/**
+  * @brief          read a record, 0 is the oldest
+  * @param[in]      n: record order, [0, can_recorder_count())
+  * @param[out]     record: record copy
+  * @retval         1: ok, 0: out of range
+  */
+/**
+  * @brief          ȡһ¼, 0Ϊһ
+  * @param[in]      n: ¼, [0, can_recorder_count())
+  * @param[out]     record: ¼
+  * @retval         1: ɹ, 0: Χ
+  */
+extern bool_t can_recorder_read(uint16_t n, can_record_t *record);
+
+#endif
@@ -0,0 +1,160 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       dm_motor.c/h
+  * @brief      Damiao motor protocol in MIT mode, command packing and feedback decode.
+  *             the frames are sent and received by CAN_receive.c.
+  *             MITģʽЭ, ֡뷴, շCAN_receive.c.
+  * @note       position, velocity and torque ranges must be the same as PMAX, VMAX, TMAX
+  *             set in the motor by the Damiao debug tool.
+  *             λ, ٶ, طΧԹõPMAX, VMAX, TMAXһ.
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *
+  @verbatim
+  ==============================================================================
+  MIT command, 8 bytes, big endian bit fields:
+  position 16 bit | velocity 12 bit | kp 12 bit | kd 12 bit | torque 12 bit
+  feedback, 8 bytes:
+  id 4 bit, state 4 bit | position 16 bit | velocity 12 bit | torque 12 bit | T_mos | T_rotor
+  MIT֡뷴֡λ, .
+  ==============================================================================
+  @endverbatim
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+
+#ifndef DM_MOTOR_H
+#define DM_MOTOR_H
+
+#include "struct_typedef.h"
+
+//kp and kd ranges of MIT command, fixed by the protocol
+//MIT֡kp, kdΧ, Э̶
+#define DM_MIT_KP_MIN 0.0f
+#define DM_MIT_KP_MAX 500.0f
+#define DM_MIT_KD_MIN 0.0f
+#define DM_MIT_KD_MAX 5.0f
+
+//special commands, sent as FF FF FF FF FF FF FF cmd
+//,  FF FF FF FF FF FF FF cmd
+typedef enum
+{
+    DM_MOTOR_CMD_CLEAR_ERROR = 0xFB,
+    DM_MOTOR_CMD_ENABLE = 0xFC,
+    DM_MOTOR_CMD_DISABLE = 0xFD,
+    DM_MOTOR_CMD_SAVE_ZERO = 0xFE,
+} dm_motor_cmd_e;
+
+//position, velocity and torque range, [-max, max]
+//λ, ٶ, طΧ, [-max, max]
+typedef struct
+{
+    fp32 p_max;     //rad
+    fp32 v_max;     //rad/s
+    fp32 t_max;     //N.m
+} dm_motor_range_t;
+
+//Damiao motor feedback
+//
+typedef struct
+{
+    uint8_t id;         //motor CAN ID.CAN ID
+    uint8_t state;      //0:disable, 1:enable, 8~14:error code.0:ʧ, 1:ʹ, 8~14:
+    fp32 position;      //rad
+    fp32 velocity;      //rad/s
+    fp32 torque;        //N.m
+    uint8_t t_mos;      //driver MOS temperature.MOS¶
+    uint8_t t_rotor;    //rotor temperature.Ȧ¶
+} dm_motor_measure_t;
+
+/**
+  * @brief          map a float in [x_min, x_max] to an unsigned int of bits
+  * @param[in]      x: value, limited to [x_min, x_max]
+  * @param[in]      x_min: minimum
+  * @param[in]      x_max: maximum
+  * @param[in]      bits: bits of result
+  * @retval         unsigned int value
+  */
+/**
+  * @brief          [x_min, x_max]ڵĸӳΪbitsλ޷
+  * @param[in]      x: ֵ, [x_min, x_max]
+  * @param[in]      x_min: Сֵ
+  * @param[in]      x_max: ֵ
+  * @param[in]      bits: λ
+  * @retval         ޷
+  */
+extern uint16_t dm_float_to_uint(fp32 x, fp32 x_min, fp32 x_max, uint8_t bits);
+
+/**
+  * @brief          map an unsigned int of bits to a float in [x_min, x_max]
+  * @param[in]      x_int: unsigned int value
+  * @param[in]      x_min: minimum
+  * @param[in]      x_max: maximum
+  * @param[in]      bits: bits of x_int
+  * @retval         float value
+  */
+/**
+  * @brief          bitsλ޷ӳΪ[x_min, x_max]ڵĸ
+  * @param[in]      x_int: ޷
+  * @param[in]      x_min: Сֵ
+  * @param[in]      x_max: ֵ
+  * @param[in]      bits: x_intλ
+  * @retval         
+  */
+extern fp32 dm_uint_to_float(uint16_t x_int, fp32 x_min, fp32 x_max, uint8_t bits);
+
+/**
+  * @brief          pack a MIT command, torque = kp * (position - p) + kd * (velocity - v) + torque
+  * @param[out]     data: 8 bytes of frame data
+  * @param[in]      range: ranges set in the motor
+  * @param[in]      position: target position, rad
+  * @param[in]      velocity: target velocity, rad/s
+  * @param[in]      kp: position gain, [0, 500]
+  * @param[in]      kd: velocity gain, [0, 5]
+  * @param[in]      torque: feedforward torque, N.m
+  * @retval         none
+  */
+/**
+  * @brief          MIT֡,  = kp * (λ - p) + kd * (ٶ - v) + ǰ
+  * @param[out]     data: 8ֽ֡
+  * @param[in]      range: õķΧ
+  * @param[in]      position: Ŀλ, rad
+  * @param[in]      velocity: Ŀٶ, rad/s
+  * @param[in]      kp: λ, [0, 500]
+  * @param[in]      kd: ٶ, [0, 5]
+  * @param[in]      torque: ǰ, N.m
+  * @retval         none
+  */
+extern void dm_motor_pack_mit(uint8_t data[8], const dm_motor_range_t *range, fp32 position, fp32 velocity, fp32 kp, fp32 kd, fp32 torque);
+
+/**
+  * @brief          pack a special command, enable, disable, save zero or clear error
+  * @param[out]     data: 8 bytes of frame data
+  * @param[in]      cmd: DM_MOTOR_CMD_ENABLE etc.
+  * @retval         none
+  */
+/**
+  * @brief          , ʹ, ʧ, 
+  * @param[out]     data: 8ֽ֡
+  * @param[in]      cmd: DM_MOTOR_CMD_ENABLE
+  * @retval         none
+  */
+extern void dm_motor_pack_cmd(uint8_t data[8], uint8_t cmd);
+
+/**
+  * @brief          decode a feedback frame
+  * @param[out]     measure: motor feedback
+  * @param[in]      range: ranges set in the motor
+  * @param[in]      data: 8 bytes of frame data
+  * @retval         none
+  */
+/**
+  * @brief          뷴֡
+  * @param[out]     measure: 
+  * @param[in]      range: õķΧ
+  * @param[in]      data: 8ֽ֡
+  * @retval         none
+  */
+extern void dm_motor_decode(dm_motor_measure_t *measure, const dm_motor_range_t *range, const uint8_t data[8]);
+
+#endif
@@ -16,6 +16,7 @@
   *  Version    Date            Author          Modification
   *  V1.0.0     Dec-26-2018     RM              1. done
   *  V1.1.0     Nov-11-2019     RM              1. add some annotation
+  *  V1.2.0     Oct-16-2026     RM              1. GIMBAL_TUNE, relay feedback pid auto-tune
   *
   @verbatim
   ==============================================================================
@@ -91,6 +92,7 @@ typedef enum
   GIMBAL_ABSOLUTE_ANGLE, 
   GIMBAL_RELATIVE_ANGLE, 
   GIMBAL_MOTIONLESS,     
+  GIMBAL_TUNE,           
 } gimbal_behaviour_e;
 
 /**
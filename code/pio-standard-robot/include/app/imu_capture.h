@@ -0,0 +1,139 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       imu_capture.c/h
+  * @brief      raw imu capture, a RAM ring of the bmi088 SPI DMA buffers with
+  *             DWT timestamp. it is drained over usb by usb_task, for replay of
+  *             the INS calculation on a host.
+  *             IMUԭʼݲɼ, RAMλм¼bmi088SPI DMAԭʼݼDWT
+  *             ʱ, usb_taskͨusb, λط̬.
+  * @note
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *
+  @verbatim
+  ==============================================================================
+  every record is a imu_capture_t of 24 bytes, little endian:
+  sync(0xA5) type len seq cycle[4] data[16]
+  type IMU_CAPTURE_GYRO: gyro_dma_rx_buf, cycle at gyro data ready. with
+  BMI088_GYRO_FIFO_ENABLE one record per FIFO frame, the frame at data[1],
+  cycle at the sample time of the frame
+  type IMU_CAPTURE_ACCEL: accel_dma_rx_buf, cycle at read over
+  type IMU_CAPTURE_TEMP: accel_temp_dma_rx_buf, cycle at read over
+  type IMU_CAPTURE_GYRO_OFFSET/ACCEL_OFFSET: fp32[3] offsets of imu_cali_slove,
+  sent once at start
+  seq is the low byte of the record count, a gap means records were dropped.
+  ÿ¼Ϊ24ֽڵimu_capture_t, С. seq˵м¼ʧ.
+  ==============================================================================
+  @endverbatim
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+
+#ifndef IMU_CAPTURE_H
+#define IMU_CAPTURE_H
+
+#include "struct_typedef.h"
+
+//records in the ring, must be power of 2, 24 bytes each
+//λ¼, Ϊ2, ÿ24ֽ
+#define IMU_CAPTURE_SIZE 512
+//longer SPI buffers are cut, a gyro FIFO burst is recorded frame by frame
+//SPIᱻض, FIFOȡֱ֡¼
+#define IMU_CAPTURE_DATA_LEN 16
+#define IMU_CAPTURE_SYNC 0xA5
+
+#define IMU_CAPTURE_GYRO            0
+#define IMU_CAPTURE_ACCEL           1
+#define IMU_CAPTURE_TEMP            2
+#define IMU_CAPTURE_GYRO_OFFSET     3
+#define IMU_CAPTURE_ACCEL_OFFSET    4
+
+typedef struct
+{
+    uint8_t sync;       //IMU_CAPTURE_SYNC when the record is complete.¼дʱΪIMU_CAPTURE_SYNC
+    uint8_t type;
+    uint8_t len;        //valid bytes in data.dataеЧֽ
+    uint8_t seq;
+    uint32_t cycle;     //DWT cycle.DWT
+    uint8_t data[IMU_CAPTURE_DATA_LEN];
+} imu_capture_t;
+
+/**
+  * @brief          start capture, the ring is cleared and the offsets are recorded first
+  * @param[in]      none
+  * @retval         none
+  */
+/**
+  * @brief          ʼɼ, ջȼ¼Ư
+  * @param[in]      none
+  * @retval         none
+  */
+extern void imu_capture_start(void);
+
+/**
+  * @brief          stop capture
+  * @param[in]      none
+  * @retval         none
+  */
+/**
+  * @brief          ֹͣɼ
+  * @param[in]      none
+  * @retval         none
+  */
+extern void imu_capture_stop(void);
+
+/**
+  * @brief          whether capture is on
+  * @param[in]      none
+  * @retval         1: on, 0: off
+  */
+/**
+  * @brief          Ƿڲɼ
+  * @param[in]      none
+  * @retval         1: ڲɼ, 0: δɼ
+  */
+extern bool_t imu_capture_is_on(void);
+
+/**
+  * @brief          record a raw buffer, called in SPI DMA interrupt
+  * @param[in]      type: IMU_CAPTURE_GYRO, IMU_CAPTURE_ACCEL ...
+  * @param[in]      cycle: DWT cycle of the data
+  * @param[in]      data: raw buffer
+  * @param[in]      len: buffer length, cut to IMU_CAPTURE_DATA_LEN
+  * @retval         none
+  */
+/**
+  * @brief          ¼һԭʼ, SPI DMAже
+  * @param[in]      type: IMU_CAPTURE_GYRO, IMU_CAPTURE_ACCEL ...
+  * @param[in]      cycle: ݵDWT
+  * @param[in]      data: ԭʼ
+  * @param[in]      len: ݳ, IMU_CAPTURE_DATA_LENֽض
+  * @retval         none
+  */
+extern void imu_capture_write(uint8_t type, uint32_t cycle, const uint8_t *data, uint8_t len);
+
+/**
+  * @brief          take the oldest record
+  * @param[out]     record: record copy
+  * @retval         1: ok, 0: no complete record
+  */
+/**
+  * @brief          ȡһ¼
+  * @param[out]     record: ¼
+  * @retval         1: ɹ, 0: ûļ¼
+  */
+extern bool_t imu_capture_read(imu_capture_t *record);
+
+/**
+  * @brief          records dropped because the ring was full
+  * @param[in]      none
+  * @retval         drop number since start
+  */
+/**
+  * @brief          ļ¼
+  * @param[in]      none
+  * @retval         ʼɼĶ
+  */
+extern uint32_t imu_capture_drop(void);
+
+#endif
@@ -23,4 +23,18 @@
 
 extern void usb_task(void const * argument);
 
+/**
+  * @brief          usb receive call back, called in usb interrupt
+  * @param[in]      buf: received data
+  * @param[in]      len: data length
+  * @retval         none
+  */
+/**
+  * @brief          usbջص, usbже
+  * @param[in]      buf: 
+  * @param[in]      len: ݳ
+  * @retval         none
+  */
+extern void usb_receive(uint8_t *buf, uint32_t len);
+
 #endif
@@ -3,6 +3,16 @@
 #include "struct_typedef.h"
 
 
+typedef struct
+{
+    uint8_t tec;            //transmit error counter
+    uint8_t rec;            //receive error counter
+    uint8_t error_passive;
+    uint8_t bus_off;
+    uint8_t mailbox_used;   //tx mailboxes holding a frame, 0~3
+} can_bus_reg_t;
+
 extern void can_filter_init(void);
+extern void can_bus_reg_read(uint8_t bus, can_bus_reg_t *reg);
 
 #endif
@@ -57,13 +57,19 @@ void SysTick_Handler(void);
 void EXTI0_IRQHandler(void);
 void EXTI3_IRQHandler(void);
 void EXTI4_IRQHandler(void);
+void DMA1_Stream2_IRQHandler(void);
 void CAN1_RX0_IRQHandler(void);
+void CAN1_RX1_IRQHandler(void);
 void EXTI9_5_IRQHandler(void);
+void TIM7_IRQHandler(void);
 void DMA2_Stream1_IRQHandler(void);
 void CAN2_RX0_IRQHandler(void);
+void CAN2_RX1_IRQHandler(void);
 void OTG_FS_IRQHandler(void);
 void DMA2_Stream6_IRQHandler(void);
 void DMA2_Stream7_IRQHandler(void);
+void I2C3_EV_IRQHandler(void);
+void I2C3_ER_IRQHandler(void);
 /* USER CODE BEGIN EFP */
 
 /* USER CODE END EFP */
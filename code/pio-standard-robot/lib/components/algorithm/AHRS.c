@@ -0,0 +1,310 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       AHRS.c/h
+  * @brief      ̬, Mahony˲, ԤAHRS.lib
+  * @note
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. 
+  *
+  @verbatim
+  ==============================================================================
+  ٶȼ()ԪƵ(ش)ĲΪ, PI
+  ǽٶȺԪ. ȫΪ0ʱֻüٶȼ, ƫǻ.
+  Ԫ˳ (w, x, y, z), ŷ˳ Z-Y-X (yaw, pitch, roll).
+  ==============================================================================
+  @endverbatim
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+
+#include "AHRS.h"
+#include "arm_math.h"
+
+//2, ԽԽμٶȼƺʹ
+#define AHRS_TWO_KP 1.0f
+//2, Ư, 0Ϊʹ
+#define AHRS_TWO_KI 0.0f
+
+//ٶ λ m/s2
+#define AHRS_GRAVITY_EQUATOR 9.780327f
+
+static fp32 AHRS_integral[3] = {0.0f, 0.0f, 0.0f};
+static fp32 AHRS_gravity = AHRS_GRAVITY_EQUATOR;
+
+/**
+ * @brief          ƽ͵ĵƽ, ʹarm_sqrt_f32
+ * @author         RM
+ * @param[in]      ƽ, 0
+ * @retval         1/sqrt, 벻0ʱ0
+ */
+static fp32 AHRS_norm_inv(fp32 sum)
+{
+    fp32 root;
+
+    if (!(sum > 0.0f) || arm_sqrt_f32(sum, &root) != ARM_MATH_SUCCESS || root == 0.0f)
+    {
+        return 0.0f;
+    }
+    return 1.0f / root;
+}
+
+/**
+  * @brief          ݼٶȵݣƵݽԪʼ
+  * @param[in]      ҪʼԪ
+  * @param[in]      ڳʼļٶȼ,(x,y,z)Ϊ λ m/s2
+  * @param[in]      ڳʼĴƼ,(x,y,z)Ϊ λ uT
+  * @retval         ؿ
+  */
+void AHRS_init(fp32 quat[4], const fp32 accel[3], const fp32 mag[3])
+{
+    fp32 roll = 0.0f, pitch = 0.0f, yaw = 0.0f;
+    fp32 sin_roll, cos_roll, sin_pitch, cos_pitch, sin_yaw, cos_yaw;
+    fp32 mag_x, mag_y;
+    fp32 latitude, height, sin_lat, sin_2lat;
+
+    if (quat == NULL)
+    {
+        return;
+    }
+
+    AHRS_integral[0] = AHRS_integral[1] = AHRS_integral[2] = 0.0f;
+
+    //γȺ͸߶ȼ㵱ٶ
+    AHRS_get_latitude(&latitude);
+    AHRS_get_height(&height);
+    sin_lat = AHRS_sinf(latitude * ANGLE_TO_RAD);
+    sin_2lat = AHRS_sinf(2.0f * latitude * ANGLE_TO_RAD);
+    AHRS_gravity = AHRS_GRAVITY_EQUATOR * (1.0f + 0.0053024f * sin_lat * sin_lat - 0.0000058f * sin_2lat * sin_2lat) - 3.086e-6f * height;
+
+    //ٶȼƸ͸
+    if (accel != NULL && (accel[0] != 0.0f || accel[1] != 0.0f || accel[2] != 0.0f))
+    {
+        roll = AHRS_atan2f(accel[1], accel[2]);
+        pitch = AHRS_atan2f(-accel[0], 1.0f / AHRS_norm_inv(accel[1] * accel[1] + accel[2] * accel[2] + 1e-12f));
+    }
+
+    sin_roll = AHRS_sinf(roll);
+    cos_roll = AHRS_cosf(roll);
+    sin_pitch = AHRS_sinf(pitch);
+    cos_pitch = AHRS_cosf(pitch);
+
+    //ǲĴƸƫ
+    if (mag != NULL && (mag[0] != 0.0f || mag[1] != 0.0f || mag[2] != 0.0f))
+    {
+        mag_x = mag[0] * cos_pitch + mag[1] * sin_roll * sin_pitch + mag[2] * cos_roll * sin_pitch;
+        mag_y = mag[1] * cos_roll - mag[2] * sin_roll;
+        yaw = AHRS_atan2f(-mag_y, mag_x);
+    }
+
+    sin_roll = AHRS_sinf(roll * 0.5f);
+    cos_roll = AHRS_cosf(roll * 0.5f);
+    sin_pitch = AHRS_sinf(pitch * 0.5f);
+    cos_pitch = AHRS_cosf(pitch * 0.5f);
+    sin_yaw = AHRS_sinf(yaw * 0.5f);
+    cos_yaw = AHRS_cosf(yaw * 0.5f);
+
+    quat[0] = cos_roll * cos_pitch * cos_yaw + sin_roll * sin_pitch * sin_yaw;
+    quat[1] = sin_roll * cos_pitch * cos_yaw - cos_roll * sin_pitch * sin_yaw;
+    quat[2] = cos_roll * sin_pitch * cos_yaw + sin_roll * cos_pitch * sin_yaw;
+    quat[3] = cos_roll * cos_pitch * sin_yaw - sin_roll * sin_pitch * cos_yaw;
+}
+
+/**
+  * @brief          ǵݣٶȵݣƵݽԪ
+  * @param[in]      ҪµԪ
+  * @param[in]      ¶ʱʱ䣬̶ʱã1000HzΪ0.001f,
+  * @param[in]      ڸµ,˳(x,y,z) λ rad
+  * @param[in]      ڳʼļٶ,˳(x,y,z) λ m/s2
+  * @param[in]      ڳʼĴ,˳(x,y,z) λ uT
+  * @retval         1:³ɹ, 0:ʧ
+  */
+bool_t AHRS_update(fp32 quat[4], const fp32 timing_time, const fp32 gyro[3], const fp32 accel[3], const fp32 mag[3])
+{
+    fp32 q0, q1, q2, q3;
+    fp32 q0q0, q0q1, q0q2, q0q3, q1q1, q1q2, q1q3, q2q2, q2q3, q3q3;
+    fp32 gx, gy, gz;
+    fp32 ax, ay, az;
+    fp32 mx, my, mz;
+    fp32 hx, hy, bx, bz;
+    fp32 vx, vy, vz, wx, wy, wz;
+    fp32 ex, ey, ez;
+    fp32 norm;
+
+    if (quat == NULL || gyro == NULL || !(timing_time > 0.0f))
+    {
+        return 0;
+    }
+
+    q0 = quat[0];
+    q1 = quat[1];
+    q2 = quat[2];
+    q3 = quat[3];
+    gx = gyro[0];
+    gy = gyro[1];
+    gz = gyro[2];
+
+    norm = (accel != NULL) ? AHRS_norm_inv(accel[0] * accel[0] + accel[1] * accel[1] + accel[2] * accel[2]) : 0.0f;
+    if (norm != 0.0f)
+    {
+        ax = accel[0] * norm;
+        ay = accel[1] * norm;
+        az = accel[2] * norm;
+
+        q0q0 = q0 * q0;
+        q0q1 = q0 * q1;
+        q0q2 = q0 * q2;
+        q0q3 = q0 * q3;
+        q1q1 = q1 * q1;
+        q1q2 = q1 * q2;
+        q1q3 = q1 * q3;
+        q2q2 = q2 * q2;
+        q2q3 = q2 * q3;
+        q3q3 = q3 * q3;
+
+        //Ƶ
+        vx = q1q3 - q0q2;
+        vy = q0q1 + q2q3;
+        vz = q0q0 - 0.5f + q3q3;
+
+        ex = ay * vz - az * vy;
+        ey = az * vx - ax * vz;
+        ez = ax * vy - ay * vx;
+
+        norm = (mag != NULL) ? AHRS_norm_inv(mag[0] * mag[0] + mag[1] * mag[1] + mag[2] * mag[2]) : 0.0f;
+        if (norm != 0.0f)
+        {
+            mx = mag[0] * norm;
+            my = mag[1] * norm;
+            mz = mag[2] * norm;
+
+            //شڵϵķ, ˮƽ鵽x
+            hx = 2.0f * (mx * (0.5f - q2q2 - q3q3) + my * (q1q2 - q0q3) + mz * (q1q3 + q0q2));
+            hy = 2.0f * (mx * (q1q2 + q0q3) + my * (0.5f - q1q1 - q3q3) + mz * (q2q3 - q0q1));
+            bx = 1.0f / AHRS_norm_inv(hx * hx + hy * hy + 1e-12f);
+            bz = 2.0f * (mx * (q1q3 - q0q2) + my * (q2q3 + q0q1) + mz * (0.5f - q1q1 - q2q2));
+
+            //Ƶĵشŷ
+            wx = bx * (0.5f - q2q2 - q3q3) + bz * (q1q3 - q0q2);
+            wy = bx * (q1q2 - q0q3) + bz * (q0q1 + q2q3);
+            wz = bx * (q0q2 + q1q3) + bz * (0.5f - q1q1 - q2q2);
+
+            ex += my * wz - mz * wy;
+            ey += mz * wx - mx * wz;
+            ez += mx * wy - my * wx;
+        }
+
+        if (AHRS_TWO_KI > 0.0f)
+        {
+            AHRS_integral[0] += AHRS_TWO_KI * ex * timing_time;
+            AHRS_integral[1] += AHRS_TWO_KI * ey * timing_time;
+            AHRS_integral[2] += AHRS_TWO_KI * ez * timing_time;
+            gx += AHRS_integral[0];
+            gy += AHRS_integral[1];
+            gz += AHRS_integral[2];
+        }
+
+        gx += AHRS_TWO_KP * ex;
+        gy += AHRS_TWO_KP * ey;
+        gz += AHRS_TWO_KP * ez;
+    }
+
+    //Ԫ
+    gx *= 0.5f * timing_time;
+    gy *= 0.5f * timing_time;
+    gz *= 0.5f * timing_time;
+    quat[0] = q0 - q1 * gx - q2 * gy - q3 * gz;
+    quat[1] = q1 + q0 * gx + q2 * gz - q3 * gy;
+    quat[2] = q2 + q0 * gy - q1 * gz + q3 * gx;
+    quat[3] = q3 + q0 * gz + q1 * gy - q2 * gx;
+
+    norm = AHRS_norm_inv(quat[0] * quat[0] + quat[1] * quat[1] + quat[2] * quat[2] + quat[3] * quat[3]);
+    if (norm == 0.0f)
+    {
+        quat[0] = 1.0f;
+        quat[1] = quat[2] = quat[3] = 0.0f;
+        return 0;
+    }
+    quat[0] *= norm;
+    quat[1] *= norm;
+    quat[2] *= norm;
+    quat[3] *= norm;
+
+    return 1;
+}
+
+/**
+  * @brief          ԪСӦŷƫyaw
+  * @param[in]      Ԫ飬ΪNULL
+  * @retval         صƫyaw λ rad
+  */
+fp32 get_yaw(const fp32 quat[4])
+{
+    return AHRS_atan2f(2.0f * (quat[0] * quat[3] + quat[1] * quat[2]), 2.0f * (quat[0] * quat[0] + quat[1] * quat[1]) - 1.0f);
+}
+
+/**
+  * @brief          ԪСӦŷǸ pitch
+  * @param[in]      Ԫ飬ΪNULL
+  * @retval         صĸ pitch λ rad
+  */
+fp32 get_pitch(const fp32 quat[4])
+{
+    fp32 sin_pitch = -2.0f * (quat[1] * quat[3] - quat[0] * quat[2]);
+
+    if (sin_pitch > 1.0f)
+    {
+        sin_pitch = 1.0f;
+    }
+    else if (sin_pitch < -1.0f)
+    {
+        sin_pitch = -1.0f;
+    }
+    return AHRS_asinf(sin_pitch);
+}
+
+/**
+  * @brief          ԪСӦŷǺ roll
+  * @param[in]      Ԫ飬ΪNULL
+  * @retval         صĺ roll λ rad
+  */
+fp32 get_roll(const fp32 quat[4])
+{
+    return AHRS_atan2f(2.0f * (quat[0] * quat[1] + quat[2] * quat[3]), 2.0f * (quat[0] * quat[0] + quat[3] * quat[3]) - 1.0f);
+}
+
+/**
+  * @brief          ԪСӦŷyawpitchroll
+  * @param[in]      Ԫ飬ΪNULL
+  * @param[in]      صƫyaw λ rad
+  * @param[in]      صĸpitch  λ rad
+  * @param[in]      صĺroll λ rad
+  */
+void get_angle(const fp32 quat[4], fp32 *yaw, fp32 *pitch, fp32 *roll)
+{
+    if (quat == NULL)
+    {
+        return;
+    }
+    if (yaw != NULL)
+    {
+        *yaw = get_yaw(quat);
+    }
+    if (pitch != NULL)
+    {
+        *pitch = get_pitch(quat);
+    }
+    if (roll != NULL)
+    {
+        *roll = get_roll(quat);
+    }
+}
+
+/**
+  * @brief          صǰٶ
+  * @param[in]      
+  * @retval         ٶ λ m/s2
+  */
+fp32 get_carrier_gravity(void)
+{
+    return AHRS_gravity;
+}
@@ -0,0 +1,371 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       quaternion_ekf.c/h
+  * @brief      Ԫչ˲, ֹʱٶȹ۲(ZARU)Ư
+  * @note
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. 
+  *  V1.1.0     Oct-16-2026     RM              1. ٶȼֻ, Ưֻɾֹ۲
+  *  V1.2.0     Oct-16-2026     RM              1. ˵ΪֹƯ(ZARU), ˶вƯ
+  *
+  @verbatim
+  ==============================================================================
+  ״̬ x = [q0 q1 q2 q3 bx by bz], ԪƯ λ rad/s.
+  Ԥ: ǼȥƯԪ.
+  : һļٶȼΪ۲,  |a| ƫĳ̶,
+        ƫʱ; ֹһʱٶȹ۲, ʹyawƯɹ.
+  ٶȼƹ۲ֻ: ƯΪ0, ƯЭ(Schmidt), Ԫȥ
+  (yaw)ķ. ˶еˮƽ߼ٶ޷ |a| , ᾭЭĽ
+  ƶyawƯ, tools/host/bench_ahrs ̨yawƯΪƯ2.
+  Ưֻٶȹ۲, ˶б־ֹʱĹֵ.
+  һֹƯ(ZARU)ѡ, ˶еƯ: ˶yawƯ
+  MahonyС. tools/host/bench_ahrs ̨yawƯ qekf 13.8 deg/min,
+  ahrs 10.6 deg/min, ʱԼΪAHRS_update20. ֻڻ˾ֹʱʹ.
+  ==============================================================================
+  @endverbatim
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+
+#include "quaternion_ekf.h"
+#include "AHRS.h"
+#include "arm_math.h"
+
+//, ÿķ
+#define QEKF_Q_QUAT 1e-6f           //Ԫ, ԼΪBMI088(0.014dps/sqrt(Hz))70, 񶯺ͻ
+#define QEKF_Q_BIAS 1e-8f           //Ư
+//ʼЭ
+#define QEKF_P_QUAT 1e-2f
+#define QEKF_P_BIAS 1e-6f           //INS_taskѼȥУ׼Ư, ʣԼ1mrad/s
+//ٶȼƹ۲, λΪһƽ
+#define QEKF_R_ACCEL 1e-2f
+//|a| ƫı d, ۲Ϊ QEKF_R_ACCEL * (1 + QEKF_ACCEL_ADAPT * d^2)
+#define QEKF_ACCEL_ADAPT 1e4f
+//d ֵüٶȼƸ
+#define QEKF_ACCEL_REJECT 0.3f
+//ֹж, ģ rad/s  d Сֵҳ QEKF_STILL_COUNT 
+#define QEKF_STILL_GYRO 0.05f
+#define QEKF_STILL_ACCEL 0.02f
+#define QEKF_STILL_COUNT 200
+//ٶȹ۲ (rad/s)^2
+#define QEKF_R_STILL 1e-4f
+//Ư޷ rad/s
+#define QEKF_BIAS_MAX 0.1f
+
+/**
+  * @brief          3ά۲״̬, x += K * residual, P -= K * H * P
+  * @param[out]     ekf: ˲
+  * @param[in]      H: ۲
+  * @param[in]      residual: ۲ֵȥԤ۲ֵ
+  * @param[in]      r: ۲, ͬ
+  * @param[in]      tilt_only: 1: ֻ, ƯΪ0, ȥԪyawķ
+  * @retval         ؿ
+  */
+static void quaternion_ekf_correct(quaternion_ekf_t *ekf, fp32 H[3][QEKF_STATE_NUM], const fp32 residual[3], fp32 r, bool_t tilt_only)
+{
+    fp32 PHt[QEKF_STATE_NUM][3];
+    fp32 S[3][3];
+    fp32 S_inv[3][3];
+    fp32 K[QEKF_STATE_NUM][3];
+    fp32 HP[3][QEKF_STATE_NUM];
+    fp32 yaw_dir[4];
+    fp32 dq[4];
+    fp32 det, dx, norm;
+    uint8_t i, j, k;
+
+    //PHt = P * H^T, HP = (PHt)^T
+    for (i = 0; i < QEKF_STATE_NUM; i++)
+    {
+        for (j = 0; j < 3; j++)
+        {
+            PHt[i][j] = 0.0f;
+            for (k = 0; k < QEKF_STATE_NUM; k++)
+            {
+                PHt[i][j] += ekf->P[i][k] * H[j][k];
+            }
+            HP[j][i] = PHt[i][j];
+        }
+    }
+
+    //S = H * P * H^T + R
+    for (i = 0; i < 3; i++)
+    {
+        for (j = 0; j < 3; j++)
+        {
+            S[i][j] = (i == j) ? r : 0.0f;
+            for (k = 0; k < QEKF_STATE_NUM; k++)
+            {
+                S[i][j] += H[i][k] * PHt[k][j];
+            }
+        }
+    }
+
+    S_inv[0][0] = S[1][1] * S[2][2] - S[1][2] * S[2][1];
+    S_inv[0][1] = S[0][2] * S[2][1] - S[0][1] * S[2][2];
+    S_inv[0][2] = S[0][1] * S[1][2] - S[0][2] * S[1][1];
+    S_inv[1][0] = S[1][2] * S[2][0] - S[1][0] * S[2][2];
+    S_inv[1][1] = S[0][0] * S[2][2] - S[0][2] * S[2][0];
+    S_inv[1][2] = S[0][2] * S[1][0] - S[0][0] * S[1][2];
+    S_inv[2][0] = S[1][0] * S[2][1] - S[1][1] * S[2][0];
+    S_inv[2][1] = S[0][1] * S[2][0] - S[0][0] * S[2][1];
+    S_inv[2][2] = S[0][0] * S[1][1] - S[0][1] * S[1][0];
+    det = S[0][0] * S_inv[0][0] + S[0][1] * S_inv[1][0] + S[0][2] * S_inv[2][0];
+    if (det == 0.0f)
+    {
+        return;
+    }
+    det = 1.0f / det;
+
+    //K = P * H^T * S^-1
+    for (i = 0; i < QEKF_STATE_NUM; i++)
+    {
+        for (j = 0; j < 3; j++)
+        {
+            K[i][j] = (i >= 4 && tilt_only) ? 0.0f : (PHt[i][0] * S_inv[0][j] + PHt[i][1] * S_inv[1][j] + PHt[i][2] * S_inv[2][j]) * det;
+        }
+    }
+
+    //x += K * residual
+    for (i = 0; i < 4; i++)
+    {
+        dq[i] = K[i][0] * residual[0] + K[i][1] * residual[1] + K[i][2] * residual[2];
+    }
+    //ȥԪתķ, Ϊ (0, 0, 0, 1) * q
+    if (tilt_only)
+    {
+        yaw_dir[0] = -ekf->q[3];
+        yaw_dir[1] = -ekf->q[2];
+        yaw_dir[2] = ekf->q[1];
+        yaw_dir[3] = ekf->q[0];
+        dx = dq[0] * yaw_dir[0] + dq[1] * yaw_dir[1] + dq[2] * yaw_dir[2] + dq[3] * yaw_dir[3];
+        for (i = 0; i < 4; i++)
+        {
+            dq[i] -= dx * yaw_dir[i];
+        }
+    }
+    for (i = 0; i < QEKF_STATE_NUM; i++)
+    {
+        if (i < 4)
+        {
+            ekf->q[i] += dq[i];
+        }
+        else
+        {
+            ekf->gyro_bias[i - 4] += K[i][0] * residual[0] + K[i][1] * residual[1] + K[i][2] * residual[2];
+        }
+    }
+
+    //P -= K * H * P, ֶԳ
+    for (i = 0; i < QEKF_STATE_NUM; i++)
+    {
+        for (j = i; j < QEKF_STATE_NUM; j++)
+        {
+            ekf->P[i][j] -= K[i][0] * HP[0][j] + K[i][1] * HP[1][j] + K[i][2] * HP[2][j];
+            ekf->P[j][i] = ekf->P[i][j];
+        }
+    }
+
+    arm_sqrt_f32(ekf->q[0] * ekf->q[0] + ekf->q[1] * ekf->q[1] + ekf->q[2] * ekf->q[2] + ekf->q[3] * ekf->q[3], &norm);
+    if (norm > 0.0f)
+    {
+        norm = 1.0f / norm;
+        for (i = 0; i < 4; i++)
+        {
+            ekf->q[i] *= norm;
+        }
+    }
+    for (i = 0; i < 3; i++)
+    {
+        if (ekf->gyro_bias[i] > QEKF_BIAS_MAX)
+        {
+            ekf->gyro_bias[i] = QEKF_BIAS_MAX;
+        }
+        else if (ekf->gyro_bias[i] < -QEKF_BIAS_MAX)
+        {
+            ekf->gyro_bias[i] = -QEKF_BIAS_MAX;
+        }
+    }
+}
+
+/**
+  * @brief          ԪEKFʼ, ɼٶȼƸʼ̬
+  * @param[out]     ekf: ˲
+  * @param[in]      accel: ٶȼ,(x,y,z) λ m/s2
+  * @retval         ؿ
+  */
+void quaternion_ekf_init(quaternion_ekf_t *ekf, const fp32 accel[3])
+{
+    uint8_t i, j;
+
+    if (ekf == NULL)
+    {
+        return;
+    }
+
+    AHRS_init(ekf->q, accel, NULL);
+    for (i = 0; i < 3; i++)
+    {
+        ekf->gyro_bias[i] = 0.0f;
+    }
+    for (i = 0; i < QEKF_STATE_NUM; i++)
+    {
+        for (j = 0; j < QEKF_STATE_NUM; j++)
+        {
+            ekf->P[i][j] = 0.0f;
+        }
+        ekf->P[i][i] = (i < 4) ? QEKF_P_QUAT : QEKF_P_BIAS;
+    }
+    ekf->accel_r = 0.0f;
+    ekf->still_count = 0;
+}
+
+/**
+  * @brief          ԪEKF
+  * @param[out]     ekf: ˲
+  * @param[in]      dt: ϴθµʱ λ s
+  * @param[in]      gyro: ,(x,y,z) λ rad/s
+  * @param[in]      accel: ٶȼ,(x,y,z) λ m/s2
+  * @retval         ؿ
+  */
+void quaternion_ekf_update(quaternion_ekf_t *ekf, fp32 dt, const fp32 gyro[3], const fp32 accel[3])
+{
+    fp32 F[QEKF_STATE_NUM][QEKF_STATE_NUM];
+    fp32 FP[QEKF_STATE_NUM][QEKF_STATE_NUM];
+    fp32 H[3][QEKF_STATE_NUM];
+    fp32 residual[3];
+    fp32 q0, q1, q2, q3;
+    fp32 wx, wy, wz;
+    fp32 a_norm, a_dev, gyro_norm, norm, sum;
+    uint8_t i, j, k;
+
+    if (ekf == NULL || gyro == NULL || accel == NULL || !(dt > 0.0f))
+    {
+        return;
+    }
+
+    q0 = ekf->q[0];
+    q1 = ekf->q[1];
+    q2 = ekf->q[2];
+    q3 = ekf->q[3];
+    wx = (gyro[0] - ekf->gyro_bias[0]) * 0.5f * dt;
+    wy = (gyro[1] - ekf->gyro_bias[1]) * 0.5f * dt;
+    wz = (gyro[2] - ekf->gyro_bias[2]) * 0.5f * dt;
+
+    //Ԥ q = q + 0.5 * dt * q * (0, w)
+    ekf->q[0] = q0 - q1 * wx - q2 * wy - q3 * wz;
+    ekf->q[1] = q1 + q0 * wx + q2 * wz - q3 * wy;
+    ekf->q[2] = q2 + q0 * wy - q1 * wz + q3 * wx;
+    ekf->q[3] = q3 + q0 * wz + q1 * wy - q2 * wx;
+
+    //F = d(q, b)/d(q, b)
+    for (i = 0; i < QEKF_STATE_NUM; i++)
+    {
+        for (j = 0; j < QEKF_STATE_NUM; j++)
+        {
+            F[i][j] = (i == j) ? 1.0f : 0.0f;
+        }
+    }
+    F[0][1] = -wx; F[0][2] = -wy; F[0][3] = -wz;
+    F[1][0] = wx;  F[1][2] = wz;  F[1][3] = -wy;
+    F[2][0] = wy;  F[2][1] = -wz; F[2][3] = wx;
+    F[3][0] = wz;  F[3][1] = wy;  F[3][2] = -wx;
+    norm = 0.5f * dt;
+    F[0][4] = q1 * norm;  F[0][5] = q2 * norm;  F[0][6] = q3 * norm;
+    F[1][4] = -q0 * norm; F[1][5] = q3 * norm;  F[1][6] = -q2 * norm;
+    F[2][4] = -q3 * norm; F[2][5] = -q0 * norm; F[2][6] = q1 * norm;
+    F[3][4] = q2 * norm;  F[3][5] = -q1 * norm; F[3][6] = -q0 * norm;
+
+    //P = F * P * F^T + Q
+    for (i = 0; i < QEKF_STATE_NUM; i++)
+    {
+        for (j = 0; j < QEKF_STATE_NUM; j++)
+        {
+            sum = 0.0f;
+            for (k = 0; k < QEKF_STATE_NUM; k++)
+            {
+                sum += F[i][k] * ekf->P[k][j];
+            }
+            FP[i][j] = sum;
+        }
+    }
+    for (i = 0; i < QEKF_STATE_NUM; i++)
+    {
+        for (j = i; j < QEKF_STATE_NUM; j++)
+        {
+            sum = 0.0f;
+            for (k = 0; k < QEKF_STATE_NUM; k++)
+            {
+                sum += FP[i][k] * F[j][k];
+            }
+            if (i == j)
+            {
+                sum += ((i < 4) ? QEKF_Q_QUAT : QEKF_Q_BIAS) * dt;
+            }
+            ekf->P[i][j] = sum;
+            ekf->P[j][i] = sum;
+        }
+    }
+
+    arm_sqrt_f32(accel[0] * accel[0] + accel[1] * accel[1] + accel[2] * accel[2], &a_norm);
+    a_dev = a_norm / get_carrier_gravity() - 1.0f;
+    if (a_dev < 0.0f)
+    {
+        a_dev = -a_dev;
+    }
+
+    ekf->accel_r = 0.0f;
+    if (a_norm > 0.0f && a_dev < QEKF_ACCEL_REJECT)
+    {
+        q0 = ekf->q[0];
+        q1 = ekf->q[1];
+        q2 = ekf->q[2];
+        q3 = ekf->q[3];
+        norm = 1.0f / a_norm;
+
+        //۲ ڻϵķ
+        residual[0] = accel[0] * norm - 2.0f * (q1 * q3 - q0 * q2);
+        residual[1] = accel[1] * norm - 2.0f * (q0 * q1 + q2 * q3);
+        residual[2] = accel[2] * norm - (q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3);
+
+        for (i = 0; i < 3; i++)
+        {
+            for (j = 4; j < QEKF_STATE_NUM; j++)
+            {
+                H[i][j] = 0.0f;
+            }
+        }
+        H[0][0] = -2.0f * q2; H[0][1] = 2.0f * q3;  H[0][2] = -2.0f * q0; H[0][3] = 2.0f * q1;
+        H[1][0] = 2.0f * q1;  H[1][1] = 2.0f * q0;  H[1][2] = 2.0f * q3;  H[1][3] = 2.0f * q2;
+        H[2][0] = 2.0f * q0;  H[2][1] = -2.0f * q1; H[2][2] = -2.0f * q2; H[2][3] = 2.0f * q3;
+
+        ekf->accel_r = QEKF_R_ACCEL * (1.0f + QEKF_ACCEL_ADAPT * a_dev * a_dev);
+        quaternion_ekf_correct(ekf, H, residual, ekf->accel_r, 1);
+    }
+
+    //ֹʱٶȹ۲ gyro - b = 0
+    arm_sqrt_f32(gyro[0] * gyro[0] + gyro[1] * gyro[1] + gyro[2] * gyro[2], &gyro_norm);
+    if (gyro_norm < QEKF_STILL_GYRO && a_dev < QEKF_STILL_ACCEL)
+    {
+        if (ekf->still_count < QEKF_STILL_COUNT)
+        {
+            ekf->still_count++;
+        }
+    }
+    else
+    {
+        ekf->still_count = 0;
+    }
+
+    if (ekf->still_count >= QEKF_STILL_COUNT)
+    {
+        for (i = 0; i < 3; i++)
+        {
+            for (j = 0; j < QEKF_STATE_NUM; j++)
+            {
+                H[i][j] = (j == i + 4) ? 1.0f : 0.0f;
+            }
+            residual[i] = gyro[i] - ekf->gyro_bias[i];
+        }
+        quaternion_ekf_correct(ekf, H, residual, QEKF_R_STILL, 0);
+    }
+}
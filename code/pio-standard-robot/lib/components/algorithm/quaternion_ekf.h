@@ -0,0 +1,59 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       quaternion_ekf.c/h
+  * @brief      Ԫչ˲, ֹʱٶȹ۲(ZARU)Ư
+  * @note
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. 
+  *  V1.1.0     Oct-16-2026     RM              1. ٶȼֻ, Ưֻɾֹ۲
+  *  V1.2.0     Oct-16-2026     RM              1. ˵ΪֹƯ(ZARU), ˶вƯ
+  *
+  @verbatim
+  ==============================================================================
+  ״̬ x = [q0 q1 q2 q3 bx by bz], ԪƯ λ rad/s.
+  Ԥ: ǼȥƯԪ.
+  : һļٶȼΪ۲,  |a| ƫĳ̶,
+        ƫʱ; ֹһʱٶȹ۲, ʹyawƯɹ.
+  ٶȼƹ۲ֻ, Ưֻٶȹ۲, ˶б־ֹʱĹֵ.
+  һֹƯ(ZARU)ѡ, ˶еƯ: ˶yawƯ
+  MahonyС. tools/host/bench_ahrs ̨yawƯ qekf 13.8 deg/min,
+  ahrs 10.6 deg/min, ʱԼΪAHRS_update20. ֻڻ˾ֹʱʹ.
+  ==============================================================================
+  @endverbatim
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+#ifndef QUATERNION_EKF_H
+#define QUATERNION_EKF_H
+#include "struct_typedef.h"
+
+#define QEKF_STATE_NUM 7
+
+typedef struct
+{
+    fp32 q[4];                                  //Ԫ (w, x, y, z)
+    fp32 gyro_bias[3];                          //Ư λ rad/s
+    fp32 P[QEKF_STATE_NUM][QEKF_STATE_NUM];     //Э
+    fp32 accel_r;                               //μٶȼƹ۲, 0Ϊδ
+    uint16_t still_count;                       //ֹ
+} quaternion_ekf_t;
+
+/**
+  * @brief          ԪEKFʼ, ɼٶȼƸʼ̬
+  * @param[out]     ekf: ˲
+  * @param[in]      accel: ٶȼ,(x,y,z) λ m/s2
+  * @retval         ؿ
+  */
+extern void quaternion_ekf_init(quaternion_ekf_t *ekf, const fp32 accel[3]);
+
+/**
+  * @brief          ԪEKF
+  * @param[out]     ekf: ˲
+  * @param[in]      dt: ϴθµʱ λ s
+  * @param[in]      gyro: ,(x,y,z) λ rad/s
+  * @param[in]      accel: ٶȼ,(x,y,z) λ m/s2
+  * @retval         ؿ
+  */
+extern void quaternion_ekf_update(quaternion_ekf_t *ekf, fp32 dt, const fp32 gyro[3], const fp32 accel[3]);
+
+#endif
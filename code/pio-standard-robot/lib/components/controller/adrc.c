@@ -0,0 +1,72 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       adrc.c/h
+  * @brief      linear active disturbance rejection control of an angle, the
+  *             extended state observer runs on the measured rate and the
+  *             motor rate of the encoder.
+  *             ǶȵԿſ, ״̬۲ʹòĽٶȺͱĵת.
+  * @note
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *  V1.1.0     Oct-16-2026     RM              1. damping on the motor rate of the encoder taken into the model
+  *
+  @verbatim
+  ==============================================================================
+
+  ==============================================================================
+  @endverbatim
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+
+#include "adrc.h"
+#include "main.h"
+
+/**
+  * @brief          adrc struct data init, gains are set from the bandwidths of the config
+  * @param[out]     adrc: adrc struct data point
+  * @param[in]      config: adrc config
+  * @retval         none
+  */
+/**
+  * @brief          adrcṹʼ, configĴò
+  * @param[out]     adrc: adrcṹָ
+  * @param[in]      config: adrc
+  * @retval         none
+  */
+void ADRC_init(adrc_type_def *adrc, const adrc_config_t *config)
+{
+    if (adrc == NULL || config == NULL)
+    {
+        return;
+    }
+    adrc->b0 = config->b0;
+    adrc->kp = config->wc * config->wc;
+    adrc->kd = 2.0f * config->wc;
+    adrc->beta1 = 2.0f * config->wo;
+    adrc->beta2 = config->wo * config->wo;
+    adrc->c = config->c;
+    adrc->max_out = config->max_out;
+    ADRC_clear(adrc);
+}
+
+/**
+  * @brief          adrc out and observer clear, the gains are kept
+  * @param[out]     adrc: adrc struct data point
+  * @retval         none
+  */
+/**
+  * @brief          adrc͹۲, 
+  * @param[out]     adrc: adrcṹָ
+  * @retval         none
+  */
+void ADRC_clear(adrc_type_def *adrc)
+{
+    if (adrc == NULL)
+    {
+        return;
+    }
+    adrc->z1 = adrc->z2 = 0.0f;
+    adrc->err = adrc->out = 0.0f;
+    adrc->z_ready = 0;
+}
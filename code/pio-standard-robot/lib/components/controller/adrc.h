@@ -0,0 +1,158 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       adrc.c/h
+  * @brief      linear active disturbance rejection control of an angle, the
+  *             extended state observer runs on the measured rate and the
+  *             motor rate of the encoder.
+  *             ǶȵԿſ, ״̬۲ʹòĽٶȺͱĵת.
+  * @note
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *  V1.1.0     Oct-16-2026     RM              1. damping on the motor rate of the encoder taken into the model
+  *
+  @verbatim
+  ==============================================================================
+  model rate' = b0 * u - c * motor_rate + f. rate is of the world, from the
+  gyro, motor_rate is of the motor against its mount, from the encoder. the
+  back emf and the damping of the motor act on motor_rate, so a rotation of the
+  mount, the chassis for yaw, is known from the encoder in the same cycle and
+  is not left to the observer. f is the rest of the disturbance: load,
+  friction and what b0 and c miss. c = 0 leaves all to f.
+  the observer estimates z1 = rate and z2 = f from the measured rate, poles at
+  -wo, beta1 = 2 * wo, beta2 = wo^2:
+  z1 += (z2 + b0 * u - c * motor_rate - beta1 * (z1 - rate)) * dt
+  z2 += -beta2 * (z1 - rate) * dt
+  the control cancels f and the damping and places the loop at -wc,
+  kp = wc^2, kd = 2 * wc:
+  u = (kp * e + kd * (rate_set - z1) - z2 + c * motor_rate) / b0,
+  e = angle_set - angle wrapped to (-pi, pi). u is limited to max_out, the
+  observer takes the limited u.
+  wo is 3 ~ 10 times wc, less with a long delay or a noisy rate.
+
+  ģ rate' = b0 * u - c * motor_rate + f. rateΪǵϵٶ,
+  motor_rateΪõĵ԰װת. 綯ƺ
+  motor_rate, ˰װ(yawΪ)תͬһɱ֪, ۲.
+  fΪŶ: , ĦԼb0c. c = 0 ʱȫfе.
+  ۲ɲĽٶȹ z1 = rate  z2 = f, Ϊ -wo, beta1 = 2 * wo,
+  beta2 = wo^2:
+  z1 += (z2 + b0 * u - c * motor_rate - beta1 * (z1 - rate)) * dt
+  z2 += -beta2 * (z1 - rate) * dt
+  ɵfᲢջ -wc, kp = wc^2, kd = 2 * wc:
+  u = (kp * e + kd * (rate_set - z1) - z2 + c * motor_rate) / b0,
+  e = angle_set - angle (-pi, pi). u޷Ϊmax_out, ۲ʹ޷u.
+  woȡwc3 ~ 10, ʱٶʱȡС.
+  ==============================================================================
+  @endverbatim
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+#ifndef ADRC_H
+#define ADRC_H
+#include "struct_typedef.h"
+#include "user_lib.h"
+
+#define ADRC_ANGLE_PI       3.14159265358979f
+
+typedef struct
+{
+    fp32 b0;        //rate' per out, unit rad/s2.ÿλĽǼٶ λ rad/s2
+    fp32 wc;        //controller bandwidth, unit rad/s. λ rad/s
+    fp32 wo;        //observer bandwidth, unit rad/s.۲ λ rad/s
+    fp32 c;         //rate' per motor rate, unit 1/s.ÿλתٵĽǼٶ λ 1/s
+    fp32 max_out;   //
+} adrc_config_t;
+
+typedef struct
+{
+    //gains, may be changed at run
+    //, ʱ޸
+    fp32 b0;
+    fp32 kp;
+    fp32 kd;
+    fp32 beta1;
+    fp32 beta2;
+    fp32 c;
+    fp32 max_out;
+
+    fp32 z1;        //rate estimated.ƵĽٶ
+    fp32 z2;        //total disturbance estimated, unit rad/s2.ƵŶ λ rad/s2
+    fp32 err;
+    fp32 out;
+
+    uint8_t z_ready;    //z1 and z2 are valid.z1z2Ч
+} adrc_type_def;
+
+/**
+  * @brief          adrc struct data init, gains are set from the bandwidths of the config
+  * @param[out]     adrc: adrc struct data point
+  * @param[in]      config: adrc config
+  * @retval         none
+  */
+/**
+  * @brief          adrcṹʼ, configĴò
+  * @param[out]     adrc: adrcṹָ
+  * @param[in]      config: adrc
+  * @retval         none
+  */
+extern void ADRC_init(adrc_type_def *adrc, const adrc_config_t *config);
+
+/**
+  * @brief          adrc out and observer clear, the gains are kept
+  * @param[out]     adrc: adrc struct data point
+  * @retval         none
+  */
+/**
+  * @brief          adrc͹۲, 
+  * @param[out]     adrc: adrcṹָ
+  * @retval         none
+  */
+extern void ADRC_clear(adrc_type_def *adrc);
+
+/**
+  * @brief          adrc calculate, the observer takes the out of last calculation
+  * @param[out]     adrc: adrc struct data point
+  * @param[in]      angle: feedback angle, unit rad
+  * @param[in]      rate: feedback rate, unit rad/s
+  * @param[in]      motor_rate: rate of the motor against its mount from the encoder, unit rad/s
+  * @param[in]      angle_set: set angle, unit rad
+  * @param[in]      rate_set: set rate, unit rad/s
+  * @param[in]      dt: time since last calculation, unit s
+  * @retval         adrc out
+  */
+/**
+  * @brief          adrc, ۲ʹϴμ
+  * @param[out]     adrc: adrcṹָ
+  * @param[in]      angle: Ƕ λ rad
+  * @param[in]      rate: ٶ λ rad/s
+  * @param[in]      motor_rate: õĵ԰װת λ rad/s
+  * @param[in]      angle_set: 趨Ƕ λ rad
+  * @param[in]      rate_set: 趨ٶ λ rad/s
+  * @param[in]      dt: ϴμʱ λ s
+  * @retval         adrc
+  */
+static __inline fp32 ADRC_calc(adrc_type_def *adrc, fp32 angle, fp32 rate, fp32 motor_rate, fp32 angle_set, fp32 rate_set, fp32 dt)
+{
+    fp32 obs_err;
+    fp32 damping = adrc->c * motor_rate;
+
+    if (!adrc->z_ready)
+    {
+        adrc->z1 = rate;
+        adrc->z2 = 0.0f;
+        adrc->out = 0.0f;
+        adrc->z_ready = 1;
+    }
+
+    //extended state observer
+    //״̬۲
+    obs_err = adrc->z1 - rate;
+    adrc->z1 += (adrc->z2 + adrc->b0 * adrc->out - damping - adrc->beta1 * obs_err) * dt;
+    adrc->z2 -= adrc->beta2 * obs_err * dt;
+
+    adrc->err = loop_fp32_constrain(angle_set - angle, -ADRC_ANGLE_PI, ADRC_ANGLE_PI);
+    adrc->out = (adrc->kp * adrc->err + adrc->kd * (rate_set - adrc->z1) - adrc->z2 + damping) / adrc->b0;
+    abs_limit(&adrc->out, adrc->max_out);
+    return adrc->out;
+}
+
+#endif
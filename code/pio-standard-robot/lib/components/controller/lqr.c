@@ -0,0 +1,68 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       lqr.c/h
+  * @brief      state feedback on angle and rate with an integral state, the
+  *             gains are from an LQR design done offline.
+  *             ǶȺͽٶȵ״̬, ״̬, ߵLQRƵõ.
+  * @note
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *
+  @verbatim
+  ==============================================================================
+
+  ==============================================================================
+  @endverbatim
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+
+#include "lqr.h"
+#include "main.h"
+
+/**
+  * @brief          lqr struct data init, gains and limits are copied from the config
+  * @param[out]     lqr: lqr struct data point
+  * @param[in]      config: lqr config
+  * @retval         none
+  */
+/**
+  * @brief          lqrṹʼ, configƲ޷
+  * @param[out]     lqr: lqrṹָ
+  * @param[in]      config: lqr
+  * @retval         none
+  */
+void LQR_init(lqr_type_def *lqr, const lqr_config_t *config)
+{
+    if (lqr == NULL || config == NULL)
+    {
+        return;
+    }
+    lqr->K_angle = config->K_angle;
+    lqr->K_rate = config->K_rate;
+    lqr->K_i = config->K_i;
+    lqr->max_out = config->max_out;
+    lqr->max_iout = config->max_iout;
+    lqr->i_band = config->i_band;
+    LQR_clear(lqr);
+}
+
+/**
+  * @brief          lqr out clear, the gains are kept
+  * @param[out]     lqr: lqr struct data point
+  * @retval         none
+  */
+/**
+  * @brief          lqr, 
+  * @param[out]     lqr: lqrṹָ
+  * @retval         none
+  */
+void LQR_clear(lqr_type_def *lqr)
+{
+    if (lqr == NULL)
+    {
+        return;
+    }
+    lqr->err = 0.0f;
+    lqr->Iout = lqr->Fout = lqr->out = 0.0f;
+}
@@ -0,0 +1,141 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       lqr.c/h
+  * @brief      state feedback on angle and rate with an integral state, the
+  *             gains are from an LQR design done offline.
+  *             ǶȺͽٶȵ״̬, ״̬, ߵLQRƵõ.
+  * @note
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *
+  @verbatim
+  ==============================================================================
+  e = angle_set - angle, wrapped to (-pi, pi)
+  out = K_angle * e + K_rate * (rate_set - rate) + I + ff
+  I += K_i * e * dt only while |e| < i_band, and |I| <= max_iout, I stops while
+  out is over max_out and e drives it further. out of the band a step would
+  wind I up and overshoot.
+  the gains are u = -K x of a discrete LQR on x = [-e, rate, -integral of e]
+  of the model rate' = a * u - c * rate at the control period, ff takes the
+  known load such as gravity off the model. the integral only takes what ff
+  misses.
+
+  e = angle_set - angle, (-pi, pi)
+  out = K_angle * e + K_rate * (rate_set - rate) + I + ff
+   |e| < i_band ʱ I += K_i * e * dt,  |I| <= max_iout, outmax_outeʹ
+  ʱֹͣ. ڷΧֻڽԾʱͲ.
+  Ϊģ rate' = a * u - c * rate ڿ,  x = [-e, rate, -eĻ]
+  ɢLQR u = -K x. ffе֪, ֻеff֮Ĳ.
+  ==============================================================================
+  @endverbatim
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+#ifndef LQR_H
+#define LQR_H
+#include "struct_typedef.h"
+#include "user_lib.h"
+
+#define LQR_ANGLE_PI        3.14159265358979f
+
+typedef struct
+{
+    fp32 K_angle;   //unit out/rad
+    fp32 K_rate;    //unit out/(rad/s)
+    fp32 K_i;       //unit out/(rad*s)
+
+    fp32 max_out;   //
+    fp32 max_iout;  //
+    fp32 i_band;    //I only while |e| < i_band, 0 always. unit rad
+} lqr_config_t;
+
+typedef struct
+{
+    //gains, may be changed at run
+    //, ʱ޸
+    fp32 K_angle;
+    fp32 K_rate;
+    fp32 K_i;
+
+    fp32 max_out;
+    fp32 max_iout;
+    fp32 i_band;
+
+    fp32 err;
+    fp32 Iout;
+    fp32 Fout;
+    fp32 out;
+} lqr_type_def;
+
+/**
+  * @brief          lqr struct data init, gains and limits are copied from the config
+  * @param[out]     lqr: lqr struct data point
+  * @param[in]      config: lqr config
+  * @retval         none
+  */
+/**
+  * @brief          lqrṹʼ, configƲ޷
+  * @param[out]     lqr: lqrṹָ
+  * @param[in]      config: lqr
+  * @retval         none
+  */
+extern void LQR_init(lqr_type_def *lqr, const lqr_config_t *config);
+
+/**
+  * @brief          lqr out clear, the gains are kept
+  * @param[out]     lqr: lqr struct data point
+  * @retval         none
+  */
+/**
+  * @brief          lqr, 
+  * @param[out]     lqr: lqrṹָ
+  * @retval         none
+  */
+extern void LQR_clear(lqr_type_def *lqr);
+
+/**
+  * @brief          lqr calculate
+  * @param[out]     lqr: lqr struct data point
+  * @param[in]      angle: feedback angle, unit rad
+  * @param[in]      rate: feedback rate, unit rad/s
+  * @param[in]      angle_set: set angle, unit rad
+  * @param[in]      rate_set: set rate, unit rad/s
+  * @param[in]      ff: feedforward, unit of out
+  * @param[in]      dt: time since last calculation, unit s
+  * @retval         lqr out
+  */
+/**
+  * @brief          lqr
+  * @param[out]     lqr: lqrṹָ
+  * @param[in]      angle: Ƕ λ rad
+  * @param[in]      rate: ٶ λ rad/s
+  * @param[in]      angle_set: 趨Ƕ λ rad
+  * @param[in]      rate_set: 趨ٶ λ rad/s
+  * @param[in]      ff: ǰ, λͬ
+  * @param[in]      dt: ϴμʱ λ s
+  * @retval         lqr
+  */
+static __inline fp32 LQR_calc(lqr_type_def *lqr, fp32 angle, fp32 rate, fp32 angle_set, fp32 rate_set, fp32 ff, fp32 dt)
+{
+    fp32 err = loop_fp32_constrain(angle_set - angle, -LQR_ANGLE_PI, LQR_ANGLE_PI);
+    fp32 out;
+
+    lqr->err = err;
+    lqr->Fout = ff;
+    out = lqr->K_angle * err + lqr->K_rate * (rate_set - rate) + lqr->Iout + ff;
+
+    //conditional integration, I only within i_band, and not while out is over the limit and e drives it further
+    //, i_bandڻ, ޷ʹʱ
+    if ((lqr->i_band <= 0.0f || (err < lqr->i_band && err > -lqr->i_band)) &&
+        !((out > lqr->max_out && err > 0.0f) || (out < -lqr->max_out && err < 0.0f)))
+    {
+        lqr->Iout += lqr->K_i * err * dt;
+        abs_limit(&lqr->Iout, lqr->max_iout);
+    }
+
+    lqr->out = lqr->K_angle * err + lqr->K_rate * (rate_set - rate) + lqr->Iout + ff;
+    abs_limit(&lqr->out, lqr->max_out);
+    return lqr->out;
+}
+
+#endif
@@ -6,6 +6,9 @@
   * @history
   *  Version    Date            Author          Modification
   *  V1.0.0     Dec-26-2018     RM              1. 
+  *  V2.0.0     Oct-16-2026     RM              1. one pid for all tasks, real dt, D on measurement,
+  *                                                D filter, back calculation, feedforward
+  *  V2.1.0     Oct-16-2026     RM              1. pid bank, PID_BANK_NUM identical loops in arrays
   *
   @verbatim
   ==============================================================================
@@ -18,125 +21,107 @@
 #include "pid.h"
 #include "main.h"
 
-#define LimitMax(input, max)   \
-    {                          \
-        if (input > max)       \
-        {                      \
-            input = max;       \
-        }                      \
-        else if (input < -max) \
-        {                      \
-            input = -max;      \
-        }                      \
-    }
-
 /**
-  * @brief          pid struct data init
+  * @brief          pid struct data init, gains and limits are copied from the config
   * @param[out]     pid: PID struct data point
-  * @param[in]      mode: PID_POSITION: normal pid
-  *                 PID_DELTA: delta pid
-  * @param[in]      PID: 0: kp, 1: ki, 2:kd
-  * @param[in]      max_out: pid max out
-  * @param[in]      max_iout: pid max iout
+  * @param[in]      config: pid config
   * @retval         none
   */
 /**
-  * @brief          pid struct data init
+  * @brief          pid struct data init, configƲ޷
   * @param[out]     pid: PIDṹָ
-  * @param[in]      mode: PID_POSITION:ͨPID
-  *                 PID_DELTA: PID
-  * @param[in]      PID: 0: kp, 1: ki, 2:kd
-  * @param[in]      max_out: pid
-  * @param[in]      max_iout: pid
+  * @param[in]      config: pid
   * @retval         none
   */
-void PID_init(pid_type_def *pid, uint8_t mode, const fp32 PID[3], fp32 max_out, fp32 max_iout)
+void PID_init(pid_type_def *pid, const pid_config_t *config)
 {
-    if (pid == NULL || PID == NULL)
+    if (pid == NULL || config == NULL)
     {
         return;
     }
-    pid->mode = mode;
-    pid->Kp = PID[0];
-    pid->Ki = PID[1];
-    pid->Kd = PID[2];
-    pid->max_out = max_out;
-    pid->max_iout = max_iout;
-    pid->Dbuf[0] = pid->Dbuf[1] = pid->Dbuf[2] = 0.0f;
-    pid->error[0] = pid->error[1] = pid->error[2] = pid->Pout = pid->Iout = pid->Dout = pid->out = 0.0f;
+    pid->Kp = config->Kp;
+    pid->Ki = config->Ki;
+    pid->Kd = config->Kd;
+    pid->max_out = config->max_out;
+    pid->max_iout = config->max_iout;
+    pid->Kaw = config->Kaw;
+    pid->d_tau = config->d_tau;
+    PID_clear(pid);
 }
 
 /**
-  * @brief          pid calculate 
+  * @brief          pid out clear, the gains are kept
   * @param[out]     pid: PID struct data point
-  * @param[in]      ref: feedback data 
-  * @param[in]      set: set point
-  * @retval         pid out
+  * @retval         none
   */
 /**
-  * @brief          pid
+  * @brief          pid , 
   * @param[out]     pid: PIDṹָ
-  * @param[in]      ref: 
-  * @param[in]      set: 趨ֵ
-  * @retval         pid
+  * @retval         none
   */
-fp32 PID_calc(pid_type_def *pid, fp32 ref, fp32 set)
+void PID_clear(pid_type_def *pid)
 {
     if (pid == NULL)
     {
-        return 0.0f;
+        return;
     }
 
-    pid->error[2] = pid->error[1];
-    pid->error[1] = pid->error[0];
-    pid->set = set;
-    pid->fdb = ref;
-    pid->error[0] = set - ref;
-    if (pid->mode == PID_POSITION)
-    {
-        pid->Pout = pid->Kp * pid->error[0];
-        pid->Iout += pid->Ki * pid->error[0];
-        pid->Dbuf[2] = pid->Dbuf[1];
-        pid->Dbuf[1] = pid->Dbuf[0];
-        pid->Dbuf[0] = (pid->error[0] - pid->error[1]);
-        pid->Dout = pid->Kd * pid->Dbuf[0];
-        LimitMax(pid->Iout, pid->max_iout);
-        pid->out = pid->Pout + pid->Iout + pid->Dout;
-        LimitMax(pid->out, pid->max_out);
-    }
-    else if (pid->mode == PID_DELTA)
+    pid->err = pid->last = 0.0f;
+    pid->out = pid->Pout = pid->Iout = pid->Dout = pid->Fout = 0.0f;
+    pid->fdb = pid->set = 0.0f;
+    pid->d_ready = 0;
+}
+
+/**
+  * @brief          pid bank init, gains and limits are copied from the config
+  * @param[out]     bank: pid bank point
+  * @param[in]      config: pid config
+  * @retval         none
+  */
+/**
+  * @brief          pidʼ, configƲ޷
+  * @param[out]     bank: pidָ
+  * @param[in]      config: pid
+  * @retval         none
+  */
+void PID_bank_init(pid_bank_t *bank, const pid_config_t *config)
+{
+    if (bank == NULL || config == NULL)
     {
-        pid->Pout = pid->Kp * (pid->error[0] - pid->error[1]);
-        pid->Iout = pid->Ki * pid->error[0];
-        pid->Dbuf[2] = pid->Dbuf[1];
-        pid->Dbuf[1] = pid->Dbuf[0];
-        pid->Dbuf[0] = (pid->error[0] - 2.0f * pid->error[1] + pid->error[2]);
-        pid->Dout = pid->Kd * pid->Dbuf[0];
-        pid->out += pid->Pout + pid->Iout + pid->Dout;
-        LimitMax(pid->out, pid->max_out);
+        return;
     }
-    return pid->out;
+    bank->Kp = config->Kp;
+    bank->Ki = config->Ki;
+    bank->Kd = config->Kd;
+    bank->max_out = config->max_out;
+    bank->max_iout = config->max_iout;
+    bank->Kaw = config->Kaw;
+    bank->d_tau = config->d_tau;
+    PID_bank_clear(bank);
 }
 
 /**
-  * @brief          pid out clear
-  * @param[out]     pid: PID struct data point
+  * @brief          pid bank out clear, the gains are kept
+  * @param[out]     bank: pid bank point
   * @retval         none
   */
 /**
-  * @brief          pid 
-  * @param[out]     pid: PIDṹָ
+  * @brief          pid, 
+  * @param[out]     bank: pidָ
   * @retval         none
   */
-void PID_clear(pid_type_def *pid)
+void PID_bank_clear(pid_bank_t *bank)
 {
-    if (pid == NULL)
+    uint8_t i;
+
+    if (bank == NULL)
     {
         return;
     }
-
-    pid->error[0] = pid->error[1] = pid->error[2] = 0.0f;
-    pid->Dbuf[0] = pid->Dbuf[1] = pid->Dbuf[2] = 0.0f;
-    pid->out = pid->Pout = pid->Iout = pid->Dout = 0.0f;
-    pid->fdb = pid->set = 0.0f;
+    for (i = 0; i < PID_BANK_NUM; i++)
+    {
+        bank->set[i] = bank->fdb[i] = bank->ff[i] = bank->last[i] = 0.0f;
+        bank->Iout[i] = bank->Dout[i] = bank->out[i] = 0.0f;
+    }
+    bank->d_ready = 0;
 }
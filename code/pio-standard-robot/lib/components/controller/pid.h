@@ -2,14 +2,48 @@
   ****************************(C) COPYRIGHT 2016 DJI****************************
   * @file       pid.c/h
   * @brief      pidʵֺʼPID㺯
-  * @note       
+  * @note
   * @history
   *  Version    Date            Author          Modification
   *  V1.0.0     Dec-26-2018     RM              1. 
+  *  V2.0.0     Oct-16-2026     RM              1. one pid for all tasks, real dt, D on measurement,
+  *                                                D filter, back calculation, feedforward
+  *  V2.1.0     Oct-16-2026     RM              1. pid bank, PID_BANK_NUM identical loops in arrays
+  *  V2.2.0     Oct-16-2026     RM              1. the flag is only given to the calculation, not in pid_config_t
+  *  V2.3.0     Oct-16-2026     RM              1. limits of PID_calc inline, no call of abs_limit
+  *  V2.3.1     Oct-16-2026     RM              1. unroll pragma only on gcc 8 and later
   *
   @verbatim
   ==============================================================================
+  out = Kp * e + I + D + ff, e = set - fdb
+  I += (Ki * e + Kaw * (out_limited - out)) * dt, and |I| <= max_iout
+  D = Kd * de/dt, or -Kd * dfdb/dt with PID_D_ON_MEASURE, or -Kd * rate with
+  PID_EXT_RATE, then low pass with d_tau when PID_D_FILTER.
+  the flag given to PID_calc says which terms are there, P is always. PID_calc
+  is inline, a constant flag leaves the terms not in it out of the code, so a
+  user keeps the flag of a loop in one macro for all its calls.
+  Ki and Kd are per second. gains tuned per control cycle at period T are
+  Ki = ki / T and Kd = kd * T.
+  pid_type_def keeps a copy of the gains and limits, they may be changed at run.
+  pid_bank_t is PID_BANK_NUM loops of the same gains, e.g. chassis wheels. set,
+  fdb and state are arrays, PID_bank_calc updates all in one pass without
+  branches and takes the gains and dt terms once. it is for one place of the
+  gains, not for speed: on a host it is no faster than PID_BANK_NUM PID_calc
+  (tools/host/bench_pid), no M4 timing is taken. it has the terms of
+  pid_type_def except PID_EXT_RATE and PID_ANGLE, and keeps no Pout.
 
+  out = Kp * e + I + D + ff, e = set - fdb
+  I += (Ki * e + Kaw * (޷out - out)) * dt,  |I| <= max_iout
+  D = Kd * de/dt, PID_D_ON_MEASUREʱΪ -Kd * dfdb/dt, PID_EXT_RATEʱΪ -Kd * rate,
+  PID_D_FILTERʱd_tauͨ˲.
+  PID_calcflagָ, Pǰ. PID_calcΪ, flagΪʱ
+  ᱻ, ÿ·flagһڸεʹ.
+  KiKdΪλ. TĲΪ Ki = ki / T, Kd = kd * T.
+  pid_type_def޷ĸ, ʱ޸.
+  pid_bank_tΪPID_BANK_NUM·ͬpid, . 趨ֵ, ״̬Ϊ,
+  PID_bank_calcһ޷֧ظȫ, dtֻһ. ڲһ,
+  : λϲPID_BANK_NUMPID_calc(tools/host/bench_pid), δ
+  M4ʱ. pid_type_defPID_EXT_RATEPID_ANGLE, Pout.
   ==============================================================================
   @endverbatim
   ****************************(C) COPYRIGHT 2016 DJI****************************
@@ -17,16 +51,41 @@
 #ifndef PID_H
 #define PID_H
 #include "struct_typedef.h"
-enum PID_MODE
+#include "user_lib.h"
+
+//terms of a pid, the flag of PID_calc
+//pid, PID_calcflag
+#define PID_I               0x01    //I term.
+#define PID_D               0x02    //D term.΢
+#define PID_D_ON_MEASURE    0x04    //D of the feedback, no kick at a set step.Է΢, 趨ֵԾʱ޳
+#define PID_EXT_RATE        0x08    //D of the feedback rate given, e.g. gyro.ʹôķ仯΢, 
+#define PID_D_FILTER        0x10    //first order low pass on D.Dһ׵ͨ˲
+#define PID_ANTI_WINDUP     0x20    //back calculation of I, or I is only limited.ַ㿹, ֻ޷
+#define PID_FEEDFORWARD     0x40    //ff added to the output.ǰ
+#define PID_ANGLE           0x80    //error wrapped to (-pi, pi).(-pi, pi)
+
+#define PID_ANGLE_PI        3.14159265358979f
+
+//loops of a pid bank
+//pidĻ·
+#define PID_BANK_NUM        4
+
+typedef struct
 {
-    PID_POSITION = 0,
-    PID_DELTA
-};
+    fp32 Kp;
+    fp32 Ki;        //unit 1/s
+    fp32 Kd;        //unit s
+
+    fp32 max_out;   //
+    fp32 max_iout;  //
+
+    fp32 Kaw;       //back calculation gain, unit 1/s. λ 1/s
+    fp32 d_tau;     //D filter time constant, unit s.D˲ʱ䳣 λ s
+} pid_config_t;
 
 typedef struct
 {
-    uint8_t mode;
-    //PID 
+    //PID , ʱ޸
     fp32 Kp;
     fp32 Ki;
     fp32 Kd;
@@ -34,65 +93,314 @@ typedef struct
     fp32 max_out;  //
     fp32 max_iout; //
 
+    fp32 Kaw;
+    fp32 d_tau;
+
     fp32 set;
     fp32 fdb;
+    fp32 err;
+    fp32 last;     //error or feedback of last calculation.ϴμ
 
     fp32 out;
     fp32 Pout;
     fp32 Iout;
     fp32 Dout;
-    fp32 Dbuf[3];  //΢ 0 1һ 2ϴ
-    fp32 error[3]; // 0 1һ 2ϴ
+    fp32 Fout;
 
+    uint8_t d_ready;   //last is valid.lastЧ
 } pid_type_def;
+
+typedef struct
+{
+    //the same for all loops, may be changed at run
+    //·ͬ, ʱ޸
+    fp32 Kp;
+    fp32 Ki;
+    fp32 Kd;
+
+    fp32 max_out;
+    fp32 max_iout;
+
+    fp32 Kaw;
+    fp32 d_tau;
+
+    fp32 set[PID_BANK_NUM];
+    fp32 fdb[PID_BANK_NUM];
+    fp32 ff[PID_BANK_NUM];
+    fp32 last[PID_BANK_NUM];
+
+    fp32 Iout[PID_BANK_NUM];
+    fp32 Dout[PID_BANK_NUM];
+    fp32 out[PID_BANK_NUM];
+
+    uint8_t d_ready;
+} pid_bank_t;
+
+/**
+  * @brief          pid struct data init, gains and limits are copied from the config
+  * @param[out]     pid: PID struct data point
+  * @param[in]      config: pid config
+  * @retval         none
+  */
+/**
+  * @brief          pid struct data init, configƲ޷
+  * @param[out]     pid: PIDṹָ
+  * @param[in]      config: pid
+  * @retval         none
+  */
+extern void PID_init(pid_type_def *pid, const pid_config_t *config);
+
 /**
-  * @brief          pid struct data init
+  * @brief          pid out clear, the gains are kept
   * @param[out]     pid: PID struct data point
-  * @param[in]      mode: PID_POSITION: normal pid
-  *                 PID_DELTA: delta pid
-  * @param[in]      PID: 0: kp, 1: ki, 2:kd
-  * @param[in]      max_out: pid max out
-  * @param[in]      max_iout: pid max iout
   * @retval         none
   */
 /**
-  * @brief          pid struct data init
+  * @brief          pid , 
   * @param[out]     pid: PIDṹָ
-  * @param[in]      mode: PID_POSITION:ͨPID
-  *                 PID_DELTA: PID
-  * @param[in]      PID: 0: kp, 1: ki, 2:kd
-  * @param[in]      max_out: pid
-  * @param[in]      max_iout: pid
   * @retval         none
   */
-extern void PID_init(pid_type_def *pid, uint8_t mode, const fp32 PID[3], fp32 max_out, fp32 max_iout);
+extern void PID_clear(pid_type_def *pid);
+
+/**
+  * @brief          pid bank init, gains and limits are copied from the config
+  * @param[out]     bank: pid bank point
+  * @param[in]      config: pid config
+  * @retval         none
+  */
+/**
+  * @brief          pidʼ, configƲ޷
+  * @param[out]     bank: pidָ
+  * @param[in]      config: pid
+  * @retval         none
+  */
+extern void PID_bank_init(pid_bank_t *bank, const pid_config_t *config);
+
+/**
+  * @brief          pid bank out clear, the gains are kept
+  * @param[out]     bank: pid bank point
+  * @retval         none
+  */
+/**
+  * @brief          pid, 
+  * @param[out]     bank: pidָ
+  * @retval         none
+  */
+extern void PID_bank_clear(pid_bank_t *bank);
 
 /**
-  * @brief          pid calculate 
+  * @brief          pid calculate with feedback rate and feedforward
   * @param[out]     pid: PID struct data point
-  * @param[in]      ref: feedback data 
+  * @param[in]      flag: terms of the pid, a constant
+  * @param[in]      fdb: feedback data
+  * @param[in]      fdb_rate: feedback rate, used with PID_EXT_RATE
   * @param[in]      set: set point
+  * @param[in]      ff: feedforward, used with PID_FEEDFORWARD
+  * @param[in]      dt: time since last calculation, unit s
+  * @retval         pid out
+  */
+/**
+  * @brief          pid, 仯ʺǰ
+  * @param[out]     pid: PIDṹָ
+  * @param[in]      flag: pid, ӦΪ
+  * @param[in]      fdb: 
+  * @param[in]      fdb_rate: 仯, PID_EXT_RATEʱʹ
+  * @param[in]      set: 趨ֵ
+  * @param[in]      ff: ǰ, PID_FEEDFORWARDʱʹ
+  * @param[in]      dt: ϴμʱ λ s
+  * @retval         pid
+  */
+static __inline fp32 PID_calc_full(pid_type_def *pid, uint8_t flag, fp32 fdb, fp32 fdb_rate, fp32 set, fp32 ff, fp32 dt)
+{
+    fp32 err = set - fdb;
+    fp32 d_raw;
+    fp32 out;
+
+    if (flag & PID_ANGLE)
+    {
+        err = loop_fp32_constrain(err, -PID_ANGLE_PI, PID_ANGLE_PI);
+    }
+    pid->set = set;
+    pid->fdb = fdb;
+    pid->err = err;
+
+    pid->Pout = pid->Kp * err;
+
+    if (flag & PID_D)
+    {
+        if (flag & PID_EXT_RATE)
+        {
+            d_raw = -fdb_rate;
+        }
+        else if (flag & PID_D_ON_MEASURE)
+        {
+            d_raw = pid->d_ready ? -(fdb - pid->last) / dt : 0.0f;
+            pid->last = fdb;
+        }
+        else
+        {
+            d_raw = pid->d_ready ? (err - pid->last) / dt : 0.0f;
+            pid->last = err;
+        }
+        pid->d_ready = 1;
+        if (flag & PID_D_FILTER)
+        {
+            pid->Dout += dt / (pid->d_tau + dt) * (pid->Kd * d_raw - pid->Dout);
+        }
+        else
+        {
+            pid->Dout = pid->Kd * d_raw;
+        }
+    }
+
+    if (flag & PID_FEEDFORWARD)
+    {
+        pid->Fout = ff;
+    }
+
+    if (flag & PID_I)
+    {
+        pid->Iout += pid->Ki * err * dt;
+        if (flag & PID_ANTI_WINDUP)
+        {
+            //bleed I back at Kaw by the part of out over the limit
+            //Kaw޷Ĳַ
+            out = pid->Pout + pid->Iout + pid->Dout + pid->Fout;
+            if (out > pid->max_out)
+            {
+                pid->Iout -= pid->Kaw * (out - pid->max_out) * dt;
+            }
+            else if (out < -pid->max_out)
+            {
+                pid->Iout -= pid->Kaw * (out + pid->max_out) * dt;
+            }
+        }
+        //limited in place, abs_limit of user_lib.c is a call. a branch as the old LimitMax is cheaper than a select
+        //on a host, it is speculated past, and no dearer on the M4
+        //͵޷, user_lib.cabs_limitΪ. ԭLimitMaxͬķ֧λϱƲִ, ѡ,
+        //M4Ҳ
+        if (pid->Iout > pid->max_iout)
+        {
+            pid->Iout = pid->max_iout;
+        }
+        else if (pid->Iout < -pid->max_iout)
+        {
+            pid->Iout = -pid->max_iout;
+        }
+    }
+
+    out = pid->Pout + pid->Iout + pid->Dout + pid->Fout;
+    if (out > pid->max_out)
+    {
+        out = pid->max_out;
+    }
+    else if (out < -pid->max_out)
+    {
+        out = -pid->max_out;
+    }
+    pid->out = out;
+    return out;
+}
+
+/**
+  * @brief          pid calculate
+  * @param[out]     pid: PID struct data point
+  * @param[in]      flag: terms of the pid, a constant
+  * @param[in]      ref: feedback data
+  * @param[in]      set: set point
+  * @param[in]      dt: time since last calculation, unit s
   * @retval         pid out
   */
 /**
   * @brief          pid
   * @param[out]     pid: PIDṹָ
+  * @param[in]      flag: pid, ӦΪ
   * @param[in]      ref: 
   * @param[in]      set: 趨ֵ
+  * @param[in]      dt: ϴμʱ λ s
   * @retval         pid
   */
-extern fp32 PID_calc(pid_type_def *pid, fp32 ref, fp32 set);
+static __inline fp32 PID_calc(pid_type_def *pid, uint8_t flag, fp32 ref, fp32 set, fp32 dt)
+{
+    return PID_calc_full(pid, flag, ref, 0.0f, set, 0.0f, dt);
+}
+
+//select, not branch, a minss/maxss on a host and vcmp with IT on the M4
+//ѡǷ֧, λΪminss/maxss, M4ΪvcmpIT
+static __inline fp32 PID_bank_limit(fp32 x, fp32 limit)
+{
+    x = (x > limit) ? limit : x;
+    return (x < -limit) ? -limit : x;
+}
 
 /**
-  * @brief          pid out clear
-  * @param[out]     pid: PID struct data point
+  * @brief          pid bank calculate, set and fdb (and ff) are filled first, the
+  *                 out is in bank->out
+  * @param[out]     bank: pid bank point
+  * @param[in]      flag: terms of the pid, a constant, PID_EXT_RATE and PID_ANGLE are not used
+  * @param[in]      dt: time since last calculation, unit s
   * @retval         none
   */
 /**
-  * @brief          pid 
-  * @param[out]     pid: PIDṹָ
+  * @brief          pid, setfdb(Լff), bank->out
+  * @param[out]     bank: pidָ
+  * @param[in]      flag: pid, ӦΪ, ʹPID_EXT_RATEPID_ANGLE
+  * @param[in]      dt: ϴμʱ λ s
   * @retval         none
   */
-extern void PID_clear(pid_type_def *pid);
+static __inline void PID_bank_calc(pid_bank_t *bank, uint8_t flag, fp32 dt)
+{
+    const fp32 kp = bank->Kp;
+    const fp32 ki_dt = bank->Ki * dt;
+    const fp32 kd_dt = bank->Kd / dt;
+    const fp32 kaw_dt = bank->Kaw * dt;
+    const fp32 max_out = bank->max_out;
+    const fp32 max_iout = bank->max_iout;
+    //no D at the first calculation, instead of a branch per loop
+    //״μʱûD, ÿ·ķ֧
+    const fp32 d_on = bank->d_ready ? kd_dt : 0.0f;
+    const fp32 d_alpha = (flag & PID_D_FILTER) ? dt / (bank->d_tau + dt) : 1.0f;
+    fp32 err;
+    fp32 x;
+    fp32 out;
+    uint8_t i;
+
+    //the pragma takes no macro, keep it PID_BANK_NUM. gcc before 8 has no unroll pragma and warns
+    //pragmaչ, PID_BANK_NUMһ. gcc 8֮ǰûиpragma, ᾯ
+#if defined(__GNUC__) && (__GNUC__ >= 8)
+#pragma GCC unroll 4
+#endif
+    for (i = 0; i < PID_BANK_NUM; i++)
+    {
+        err = bank->set[i] - bank->fdb[i];
+        out = kp * err;
+        if (flag & PID_D)
+        {
+            x = (flag & PID_D_ON_MEASURE) ? -bank->fdb[i] : err;
+            bank->Dout[i] += d_alpha * (d_on * (x - bank->last[i]) - bank->Dout[i]);
+            bank->last[i] = x;
+            out += bank->Dout[i];
+        }
+        if (flag & PID_FEEDFORWARD)
+        {
+            out += bank->ff[i];
+        }
+        if (flag & PID_I)
+        {
+            x = bank->Iout[i] + ki_dt * err;
+            if (flag & PID_ANTI_WINDUP)
+            {
+                //the part of out over the limit, 0 within
+                //޷Ĳ, ޷Ϊ0
+                x -= kaw_dt * (out + x - PID_bank_limit(out + x, max_out));
+            }
+            x = PID_bank_limit(x, max_iout);
+            bank->Iout[i] = x;
+            out += x;
+        }
+        bank->out[i] = PID_bank_limit(out, max_out);
+    }
+    bank->d_ready = 1;
+}
 
 #endif
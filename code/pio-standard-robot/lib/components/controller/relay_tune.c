@@ -0,0 +1,263 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       relay_tune.c/h
+  * @brief      relay feedback experiment (Astrom-Hagglund) for the pid auto-tune,
+  *             finds the ultimate gain and period of a loop.
+  *             ̵練ʵ(Astrom-Hagglund), pid, ȡ·ٽ
+  *             ٽ.
+  * @note
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *  V1.1.0     Oct-16-2026     RM              1. time of the last switch kept
+  *
+  @verbatim
+  ==============================================================================
+
+  ==============================================================================
+  @endverbatim
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+
+#include "relay_tune.h"
+#include "main.h"
+#include "arm_math.h"
+#include "user_lib.h"
+
+static void relay_tune_period(relay_tune_t *tune, fp32 err);
+
+/**
+  * @brief          start a relay experiment
+  * @param[out]     tune: relay tune point
+  * @param[in]      amp: relay amplitude
+  * @param[in]      hyst: hysteresis of err
+  * @param[in]      bias: out at the start, e.g. the out of the pid just before
+  * @param[in]      max_out: limit of bias and out
+  * @param[in]      timeout: RELAY_TUNE_FAIL after it, unit s
+  * @retval         none
+  */
+/**
+  * @brief          ʼ̵練ʵ
+  * @param[out]     tune: ̵ṹָ
+  * @param[in]      amp: ̵ֵ
+  * @param[in]      hyst: errͻ
+  * @param[in]      bias: ʼʱ, лǰpid
+  * @param[in]      max_out: biasout޷
+  * @param[in]      timeout: ʱΪRELAY_TUNE_FAIL λ s
+  * @retval         none
+  */
+void relay_tune_init(relay_tune_t *tune, fp32 amp, fp32 hyst, fp32 bias, fp32 max_out, fp32 timeout)
+{
+    if (tune == NULL)
+    {
+        return;
+    }
+    tune->amp = amp;
+    tune->hyst = hyst;
+    tune->max_out = max_out;
+    tune->timeout = timeout;
+
+    tune->bias = bias;
+    abs_limit(&tune->bias, max_out);
+    tune->out = 0.0f;
+    tune->time = 0.0f;
+    tune->rise_time = -1.0f;
+    tune->high_time = 0.0f;
+    tune->switch_time = 0.0f;
+    tune->err_max = tune->err_min = 0.0f;
+    tune->last_period = tune->last_a = 0.0f;
+    tune->period_sum = tune->a_sum = 0.0f;
+    tune->period_num = 0;
+    tune->match_num = 0;
+    tune->side = 1;
+    tune->Ku = tune->Tu = 0.0f;
+    tune->state = RELAY_TUNE_RUN;
+}
+
+/**
+  * @brief          relay calculate, called every control period in place of the pid
+  * @param[out]     tune: relay tune point
+  * @param[in]      err: set - fdb
+  * @param[in]      dt: time since last calculation, unit s
+  * @retval         out, 0 when not RELAY_TUNE_RUN
+  */
+/**
+  * @brief          ̵, ÿڴpid
+  * @param[out]     tune: ̵ṹָ
+  * @param[in]      err: set - fdb
+  * @param[in]      dt: ϴμʱ λ s
+  * @retval         , RELAY_TUNE_RUNʱΪ0
+  */
+fp32 relay_tune_calc(relay_tune_t *tune, fp32 err, fp32 dt)
+{
+    if (tune == NULL)
+    {
+        return 0.0f;
+    }
+    if (tune->state != RELAY_TUNE_RUN)
+    {
+        tune->out = 0.0f;
+        return 0.0f;
+    }
+
+    tune->time += dt;
+    if (tune->time > tune->timeout)
+    {
+        relay_tune_abort(tune);
+        return 0.0f;
+    }
+
+    if (err > tune->err_max)
+    {
+        tune->err_max = err;
+    }
+    if (err < tune->err_min)
+    {
+        tune->err_min = err;
+    }
+
+    if (tune->side > 0)
+    {
+        tune->high_time += dt;
+        if (err < -tune->hyst)
+        {
+            tune->side = -1;
+            tune->switch_time = tune->time;
+        }
+    }
+    else if (err > tune->hyst)
+    {
+        //a period ends at the switch to +
+        //лΪʱһڽ
+        tune->side = 1;
+        tune->switch_time = tune->time;
+        relay_tune_period(tune, err);
+    }
+
+    if (tune->state != RELAY_TUNE_RUN)
+    {
+        tune->out = 0.0f;
+        return 0.0f;
+    }
+    tune->out = tune->bias + tune->side * tune->amp;
+    abs_limit(&tune->out, tune->max_out);
+    return tune->out;
+}
+
+/**
+  * @brief          stop a running experiment, it ends in RELAY_TUNE_FAIL
+  * @param[out]     tune: relay tune point
+  * @retval         none
+  */
+/**
+  * @brief          ֹͣڽеʵ, ΪRELAY_TUNE_FAIL
+  * @param[out]     tune: ̵ṹָ
+  * @retval         none
+  */
+void relay_tune_abort(relay_tune_t *tune)
+{
+    if (tune == NULL)
+    {
+        return;
+    }
+    if (tune->state == RELAY_TUNE_RUN)
+    {
+        tune->state = RELAY_TUNE_FAIL;
+    }
+    tune->out = 0.0f;
+}
+
+/**
+  * @brief          PI gains from Ku and Tu
+  * @param[in]      tune: relay tune point
+  * @param[out]     kp: Kp
+  * @param[out]     ki: Ki, unit 1/s as pid_config_t
+  * @retval         1: done, 0: no result, kp and ki not changed
+  */
+/**
+  * @brief          KuTuPI
+  * @param[in]      tune: ̵ṹָ
+  * @param[out]     kp: Kp
+  * @param[out]     ki: Ki, λ 1/s pid_config_tͬ
+  * @retval         1: , 0: ûн, kpki
+  */
+bool_t relay_tune_pi(const relay_tune_t *tune, fp32 *kp, fp32 *ki)
+{
+    if (tune == NULL || kp == NULL || ki == NULL || tune->state != RELAY_TUNE_DONE)
+    {
+        return 0;
+    }
+    *kp = RELAY_TUNE_KP_RATIO * tune->Ku;
+    *ki = *kp / (RELAY_TUNE_TI_RATIO * tune->Tu);
+    return 1;
+}
+
+/**
+  * @brief          a period of the limit cycle ends, the bias follows the mean out,
+  *                 and Ku, Tu are taken after RELAY_TUNE_CYCLES periods alike
+  * @param[out]     tune: relay tune point
+  * @param[in]      err: err at the end, the first of the next period
+  * @retval         none
+  */
+/**
+  * @brief          ޻һڽ, biasֵ, RELAY_TUNE_CYCLES
+  *                 ںõKuTu
+  * @param[out]     tune: ̵ṹָ
+  * @param[in]      err: ʱerr, һڵĵһֵ
+  * @retval         none
+  */
+static void relay_tune_period(relay_tune_t *tune, fp32 err)
+{
+    fp32 period;
+    fp32 a;
+
+    if (tune->rise_time >= 0.0f)
+    {
+        period = tune->time - tune->rise_time;
+        a = 0.5f * (tune->err_max - tune->err_min);
+
+        //mean out of the period, bias + amp * (high - low) / period
+        //ֵ, bias + amp * ( - ) / 
+        tune->bias += tune->amp * (2.0f * tune->high_time - period) / period;
+        abs_limit(&tune->bias, tune->max_out);
+
+        if (tune->period_num < RELAY_TUNE_SKIP)
+        {
+            tune->period_num++;
+        }
+        else if (tune->match_num > 0 && fabsf(period - tune->last_period) < RELAY_TUNE_TOL * period &&
+                 fabsf(a - tune->last_a) < RELAY_TUNE_TOL * a)
+        {
+            tune->match_num++;
+            tune->period_sum += period;
+            tune->a_sum += a;
+        }
+        else
+        {
+            tune->match_num = 1;
+            tune->period_sum = period;
+            tune->a_sum = a;
+        }
+        tune->last_period = period;
+        tune->last_a = a;
+
+        if (tune->match_num >= RELAY_TUNE_CYCLES)
+        {
+            a = tune->a_sum / tune->match_num;
+            if (a > tune->hyst)
+            {
+                tune->Tu = tune->period_sum / tune->match_num;
+                tune->Ku = 4.0f * tune->amp / (PI * sqrtf(a * a - tune->hyst * tune->hyst));
+                tune->state = RELAY_TUNE_DONE;
+            }
+            else
+            {
+                tune->state = RELAY_TUNE_FAIL;
+            }
+        }
+    }
+
+    tune->rise_time = tune->time;
+    tune->high_time = 0.0f;
+    tune->err_max = tune->err_min = err;
+}
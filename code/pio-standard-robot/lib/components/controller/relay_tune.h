@@ -0,0 +1,159 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       relay_tune.c/h
+  * @brief      relay feedback experiment (Astrom-Hagglund) for the pid auto-tune,
+  *             finds the ultimate gain and period of a loop.
+  *             ̵練ʵ(Astrom-Hagglund), pid, ȡ·ٽ
+  *             ٽ.
+  * @note
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *  V1.1.0     Oct-16-2026     RM              1. time of the last switch kept
+  *
+  @verbatim
+  ==============================================================================
+  the relay takes the place of the pid, out = bias + amp or bias - amp, it goes
+  to - when err < -hyst and to + when err > hyst, e = set - fdb as the pid. the
+  loop settles into a limit cycle at the ultimate period Tu, a is half the peak
+  to peak of e:
+  Ku = 4 * amp / (pi * sqrt(a^2 - hyst^2))
+  bias is set to the mean out of every period, a constant load such as gravity
+  is taken by it and the limit cycle stays symmetric.
+  the first RELAY_TUNE_SKIP periods are dropped, the result is the mean of
+  RELAY_TUNE_CYCLES periods in a row, all within RELAY_TUNE_TOL of the last.
+  PI from Ku and Tu: Kp = RELAY_TUNE_KP_RATIO * Ku, Ti = RELAY_TUNE_TI_RATIO * Tu.
+
+  ̵pid, out = bias + amp  bias - amp, err < -hystʱлΪ,
+  err > hystʱлΪ, e = set - fdb pidͬ. ·ٽTuļ޻,
+  aΪeķֵһ:
+  Ku = 4 * amp / (pi * sqrt(a^2 - hyst^2))
+  ÿڽbiasΪoutľֵ, Ⱥ㶨biasе, ޻ֶԳ.
+  RELAY_TUNE_SKIP, ΪRELAY_TUNE_CYCLESڵľֵ,
+  һRELAY_TUNE_TOL.
+  KuTuPI: Kp = RELAY_TUNE_KP_RATIO * Ku, Ti = RELAY_TUNE_TI_RATIO * Tu.
+  ==============================================================================
+  @endverbatim
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+#ifndef RELAY_TUNE_H
+#define RELAY_TUNE_H
+#include "struct_typedef.h"
+
+//PI of Ziegler-Nichols, Kp = 0.45 Ku, Ti = Tu / 1.2. for less overshoot use
+//Tyreus-Luyben, 0.31 and 2.2
+//Ziegler-NicholsPI, Kp = 0.45 Ku, Ti = Tu / 1.2. ҪСʱʹ
+//Tyreus-Luyben, 0.312.2
+#define RELAY_TUNE_KP_RATIO 0.45f
+#define RELAY_TUNE_TI_RATIO 0.833f
+
+//periods dropped at the start
+//ʼʱ
+#define RELAY_TUNE_SKIP     2
+//periods in a row to take the result
+//õ
+#define RELAY_TUNE_CYCLES   3
+//relative difference of the period and amplitude to the last period
+//ںͷֵһڵԲ
+#define RELAY_TUNE_TOL      0.1f
+
+#define RELAY_TUNE_IDLE     0
+#define RELAY_TUNE_RUN      1
+#define RELAY_TUNE_DONE     2
+#define RELAY_TUNE_FAIL     3
+
+typedef struct
+{
+    fp32 amp;           //relay amplitude, unit of out.̵ֵ, λͬout
+    fp32 hyst;          //hysteresis, unit of err.ͻ, λͬerr
+    fp32 max_out;       //limit of bias and out.biasout޷
+    fp32 timeout;       //unit s
+
+    fp32 bias;
+    fp32 out;
+    fp32 time;          //since init, unit s.Գʼʱ λ s
+    fp32 rise_time;     //time of the last switch to +, < 0 before it.ϴлΪʱ, ֮ǰС0
+    fp32 high_time;     //time on + in this period.Ϊʱ
+    fp32 switch_time;   //time of the last switch, 0 before it.ϴлʱ, ֮ǰΪ0
+    fp32 err_max;
+    fp32 err_min;
+    fp32 last_period;
+    fp32 last_a;
+    fp32 period_sum;
+    fp32 a_sum;
+    uint8_t period_num; //periods measured.Ѳ
+    uint8_t match_num;  //periods in a row within RELAY_TUNE_TOL.RELAY_TUNE_TOLڵ
+    int8_t side;
+    uint8_t state;
+
+    fp32 Ku;            //unit of out / err.λ out / err
+    fp32 Tu;            //unit s
+} relay_tune_t;
+
+/**
+  * @brief          start a relay experiment
+  * @param[out]     tune: relay tune point
+  * @param[in]      amp: relay amplitude
+  * @param[in]      hyst: hysteresis of err
+  * @param[in]      bias: out at the start, e.g. the out of the pid just before
+  * @param[in]      max_out: limit of bias and out
+  * @param[in]      timeout: RELAY_TUNE_FAIL after it, unit s
+  * @retval         none
+  */
+/**
+  * @brief          ʼ̵練ʵ
+  * @param[out]     tune: ̵ṹָ
+  * @param[in]      amp: ̵ֵ
+  * @param[in]      hyst: errͻ
+  * @param[in]      bias: ʼʱ, лǰpid
+  * @param[in]      max_out: biasout޷
+  * @param[in]      timeout: ʱΪRELAY_TUNE_FAIL λ s
+  * @retval         none
+  */
+extern void relay_tune_init(relay_tune_t *tune, fp32 amp, fp32 hyst, fp32 bias, fp32 max_out, fp32 timeout);
+
+/**
+  * @brief          relay calculate, called every control period in place of the pid
+  * @param[out]     tune: relay tune point
+  * @param[in]      err: set - fdb
+  * @param[in]      dt: time since last calculation, unit s
+  * @retval         out, 0 when not RELAY_TUNE_RUN
+  */
+/**
+  * @brief          ̵, ÿڴpid
+  * @param[out]     tune: ̵ṹָ
+  * @param[in]      err: set - fdb
+  * @param[in]      dt: ϴμʱ λ s
+  * @retval         , RELAY_TUNE_RUNʱΪ0
+  */
+extern fp32 relay_tune_calc(relay_tune_t *tune, fp32 err, fp32 dt);
+
+/**
+  * @brief          stop a running experiment, it ends in RELAY_TUNE_FAIL
+  * @param[out]     tune: relay tune point
+  * @retval         none
+  */
+/**
+  * @brief          ֹͣڽеʵ, ΪRELAY_TUNE_FAIL
+  * @param[out]     tune: ̵ṹָ
+  * @retval         none
+  */
+extern void relay_tune_abort(relay_tune_t *tune);
+
+/**
+  * @brief          PI gains from Ku and Tu
+  * @param[in]      tune: relay tune point
+  * @param[out]     kp: Kp
+  * @param[out]     ki: Ki, unit 1/s as pid_config_t
+  * @retval         1: done, 0: no result, kp and ki not changed
+  */
+/**
+  * @brief          KuTuPI
+  * @param[in]      tune: ̵ṹָ
+  * @param[out]     kp: Kp
+  * @param[out]     ki: Ki, λ 1/s pid_config_tͬ
+  * @retval         1: , 0: ûн, kpki
+  */
+extern bool_t relay_tune_pi(const relay_tune_t *tune, fp32 *kp, fp32 *ki);
+
+#endif
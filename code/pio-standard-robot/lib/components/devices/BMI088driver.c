@@ -74,6 +74,21 @@ static uint8_t write_BMI088_accel_reg_data_error[BMI088_WRITE_ACCEL_REG_NUM][3]
 
 };
 
+#if defined(BMI088_GYRO_FIFO_ENABLE)
+static uint8_t write_BMI088_gyro_reg_data_error[BMI088_WRITE_GYRO_REG_NUM][3] =
+    {
+        {BMI088_GYRO_RANGE, BMI088_GYRO_2000, BMI088_GYRO_RANGE_ERROR},
+        {BMI088_GYRO_BANDWIDTH, BMI088_GYRO_2000_230_HZ | BMI088_GYRO_BANDWIDTH_MUST_Set, BMI088_GYRO_BANDWIDTH_ERROR},
+        {BMI088_GYRO_LPM1, BMI088_GYRO_NORMAL_MODE, BMI088_GYRO_LPM1_ERROR},
+        {BMI088_GYRO_FIFO_CONFIG_0, BMI088_GYRO_FIFO_FRAME_NUM, BMI088_GYRO_FIFO_ERROR},
+        {BMI088_GYRO_FIFO_CONFIG_1, BMI088_GYRO_FIFO_MODE_STREAM | BMI088_GYRO_FIFO_DATA_XYZ, BMI088_GYRO_FIFO_ERROR},
+        {BMI088_GYRO_FIFO_WM_ENABLE, BMI088_GYRO_FIFO_WM_ON, BMI088_GYRO_FIFO_ERROR},
+        {BMI088_GYRO_CTRL, BMI088_FIFO_INT_ON, BMI088_GYRO_CTRL_ERROR},
+        {BMI088_GYRO_INT3_INT4_IO_CONF, BMI088_GYRO_INT3_GPIO_PP | BMI088_GYRO_INT3_GPIO_LOW, BMI088_GYRO_INT3_INT4_IO_CONF_ERROR},
+        {BMI088_GYRO_INT3_INT4_IO_MAP, BMI088_GYRO_FIFO_IO_INT3, BMI088_GYRO_INT3_INT4_IO_MAP_ERROR}
+
+};
+#else
 static uint8_t write_BMI088_gyro_reg_data_error[BMI088_WRITE_GYRO_REG_NUM][3] =
     {
         {BMI088_GYRO_RANGE, BMI088_GYRO_2000, BMI088_GYRO_RANGE_ERROR},
@@ -84,6 +99,7 @@ static uint8_t write_BMI088_gyro_reg_data_error[BMI088_WRITE_GYRO_REG_NUM][3] =
         {BMI088_GYRO_INT3_INT4_IO_MAP, BMI088_GYRO_DRDY_IO_INT3, BMI088_GYRO_INT3_INT4_IO_MAP_ERROR}
 
 };
+#endif
 
 uint8_t BMI088_init(void)
 {
@@ -416,6 +432,16 @@ void BMI088_gyro_read_over(uint8_t *rx_buf, fp32 gyro[3])
     gyro[2] = bmi088_raw_temp * BMI088_GYRO_SEN;
 }
 
+//rx_buf holds frame_num FIFO frames, each one has the layout of the gyro data registers
+void BMI088_gyro_fifo_read_over(uint8_t *rx_buf, fp32 gyro[][3], uint8_t frame_num)
+{
+    uint8_t i;
+    for (i = 0; i < frame_num; i++)
+    {
+        BMI088_gyro_read_over(rx_buf + i * BMI088_GYRO_FIFO_FRAME_SIZE, gyro[i]);
+    }
+}
+
 void BMI088_read(fp32 gyro[3], fp32 accel[3], fp32 *temperate)
 {
     uint8_t buf[8] = {0, 0, 0, 0, 0, 0};
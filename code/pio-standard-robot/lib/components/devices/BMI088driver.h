@@ -7,8 +7,27 @@
 #define BMI088_TEMP_FACTOR 0.125f
 #define BMI088_TEMP_OFFSET 23.0f
 
+//gyro hardware FIFO in stream mode, the watermark interrupt on INT3 replaces data ready.
+//at the watermark FIFO_STATUS is read and one SPI burst drains every frame counted in it,
+//the watermark is reached at frame BMI088_GYRO_FIFO_FRAME_NUM - 1 of the burst (0 is the oldest),
+//so frame i was sampled at watermark time + (i + 1 - BMI088_GYRO_FIFO_FRAME_NUM) * BMI088_GYRO_FIFO_FRAME_US.
+//at an overrun frames are lost, the FIFO is cleared and the burst is dropped.
+//ӲFIFOģʽ, INT3ϵˮλжϴݾ. ˮλжʱȶFIFO_STATUS, һζ
+//ȫ֡, ˮλڵBMI088_GYRO_FIFO_FRAME_NUM - 1֡ﵽ, ɴ˵õÿһ֡Ĳʱ.
+//ʱ֡ʧ, FIFO.
+//#define BMI088_GYRO_FIFO_ENABLE
+#define BMI088_GYRO_FIFO_FRAME_NUM  2
+#define BMI088_GYRO_FIFO_DEPTH      100
+#define BMI088_GYRO_FIFO_ODR        2000
+#define BMI088_GYRO_FIFO_FRAME_US   (1000000 / BMI088_GYRO_FIFO_ODR)
+#define BMI088_GYRO_FIFO_FRAME_SIZE 6
+
 #define BMI088_WRITE_ACCEL_REG_NUM  6
+#if defined(BMI088_GYRO_FIFO_ENABLE)
+#define BMI088_WRITE_GYRO_REG_NUM   9
+#else
 #define BMI088_WRITE_GYRO_REG_NUM   6
+#endif
 
 #define BMI088_GYRO_DATA_READY_BIT          0
 #define BMI088_ACCEL_DATA_READY_BIT         1
@@ -80,6 +99,7 @@ enum
     BMI088_GYRO_CTRL_ERROR              = 0x0B,
     BMI088_GYRO_INT3_INT4_IO_CONF_ERROR = 0x0C,
     BMI088_GYRO_INT3_INT4_IO_MAP_ERROR  = 0x0D,
+    BMI088_GYRO_FIFO_ERROR              = 0x0E,
 
     BMI088_SELF_TEST_ACCEL_ERROR        = 0x80,
     BMI088_SELF_TEST_GYRO_ERROR         = 0x40,
@@ -98,6 +118,7 @@ extern bool_t bmi088_gyro_init(void);
 
 extern void BMI088_accel_read_over(uint8_t *rx_buf, fp32 accel[3], fp32 *time);
 extern void BMI088_gyro_read_over(uint8_t *rx_buf, fp32 gyro[3]);
+extern void BMI088_gyro_fifo_read_over(uint8_t *rx_buf, fp32 gyro[][3], uint8_t frame_num);
 extern void BMI088_temperature_read_over(uint8_t *rx_buf, fp32 *temperate);
 extern void BMI088_read(fp32 gyro[3], fp32 accel[3], fp32 *temperate);
 extern uint32_t get_BMI088_sensor_time(void);
@@ -9,6 +9,7 @@
   * @history
   *  Version    Date            Author          Modification
   *  V1.0.0     Dec-26-2018     RM              1. 
+  *  V1.1.0     Oct-16-2026     RM              1. DRDYDMAȡ
   *
   @verbatim
   ==============================================================================
@@ -24,6 +25,7 @@
 #define MAG_SEN 0.3f //ת uT
 
 #define IST8310_WHO_AM_I 0x00       //ist8310 who am I Ĵ
+#define IST8310_STAT1 0x02          //״̬Ĵ, Ϊ6ֽ
 #define IST8310_WHO_AM_I_VALUE 0x10 //豸 ID
 
 #define IST8310_WRITE_REG_NUM 4 //IST8310ҪõļĴĿ
@@ -106,3 +108,9 @@ void ist8310_read_mag(fp32 mag[3])
     temp_ist8310_data = (int16_t)((buf[5] << 8) | buf[4]);
     mag[2] = MAG_SEN * temp_ist8310_data;
 }
+
+//DRDYжDMAȡSTAT1, ɺist8310_read_over
+bool_t ist8310_read_mag_DMA(uint8_t *rx_buf)
+{
+    return ist8310_IIC_read_muli_reg_DMA(IST8310_STAT1, rx_buf, IST8310_DMA_RX_LENGTH);
+}
@@ -9,6 +9,7 @@
   * @history
   *  Version    Date            Author          Modification
   *  V1.0.0     Dec-26-2018     RM              1. 
+  *  V1.1.0     Oct-16-2026     RM              1. DRDYDMAȡ
   *
   @verbatim
   ==============================================================================
@@ -29,6 +30,8 @@
 
 #define IST8310_NO_SENSOR 0x40
 
+#define IST8310_DMA_RX_LENGTH 7 //STAT1 + 6ֽ, ʽͬist8310_read_overstatus_buf
+
 typedef struct ist8310_real_data_t
 {
   uint8_t status;
@@ -38,4 +41,5 @@ typedef struct ist8310_real_data_t
 extern uint8_t ist8310_init(void);
 extern void ist8310_read_over(uint8_t *status_buf, ist8310_real_data_t *mpu6500_real_data);
 extern void ist8310_read_mag(fp32 mag[3]);
+extern bool_t ist8310_read_mag_DMA(uint8_t *rx_buf);
 #endif
@@ -7,6 +7,7 @@
   * @history
   *  Version    Date            Author          Modification
   *  V1.0.0     Dec-26-2018     RM              1. 
+  *  V1.1.0     Oct-16-2026     RM              1. DMAȡ
   *
   @verbatim
   ==============================================================================
@@ -49,6 +50,15 @@ void ist8310_IIC_read_muli_reg(uint8_t reg, uint8_t *buf, uint8_t len)
 {
     HAL_I2C_Mem_Read(&hi2c3, IST8310_IIC_ADDRESS, reg, I2C_MEMADD_SIZE_8BIT, buf, len, 100);
 }
+bool_t ist8310_IIC_read_muli_reg_DMA(uint8_t reg, uint8_t *buf, uint8_t len)
+{
+    //HALæʱæ־, жеʱֱӷζȡ
+    if (hi2c3.State != HAL_I2C_STATE_READY || __HAL_I2C_GET_FLAG(&hi2c3, I2C_FLAG_BUSY))
+    {
+        return 0;
+    }
+    return HAL_I2C_Mem_Read_DMA(&hi2c3, IST8310_IIC_ADDRESS, reg, I2C_MEMADD_SIZE_8BIT, buf, len) == HAL_OK;
+}
 void ist8310_IIC_write_muli_reg(uint8_t reg, uint8_t *data, uint8_t len)
 {
     HAL_I2C_Mem_Write(&hi2c3, IST8310_IIC_ADDRESS, reg, I2C_MEMADD_SIZE_8BIT, data, len, 100);
@@ -7,6 +7,7 @@
   * @history
   *  Version    Date            Author          Modification
   *  V1.0.0     Dec-26-2018     RM              1. 
+  *  V1.1.0     Oct-16-2026     RM              1. DMAȡ
   *
   @verbatim
   ==============================================================================
@@ -29,6 +30,8 @@ extern void ist8310_com_init(void);  //ist8310
 extern uint8_t ist8310_IIC_read_single_reg(uint8_t reg);
 extern void ist8310_IIC_write_single_reg(uint8_t reg, uint8_t data);
 extern void ist8310_IIC_read_muli_reg(uint8_t reg, uint8_t *buf, uint8_t len);
+//DMAȡ, 1Ϊ, ɺHAL_I2C_MemRxCpltCallback
+extern bool_t ist8310_IIC_read_muli_reg_DMA(uint8_t reg, uint8_t *buf, uint8_t len);
 extern void ist8310_IIC_write_muli_reg(uint8_t reg, uint8_t *data, uint8_t len);
 extern void ist8310_delay_ms(uint16_t ms);
 extern void ist8310_delay_us(uint16_t us);
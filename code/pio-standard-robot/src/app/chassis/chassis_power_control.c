@@ -11,6 +11,7 @@
   * @history
   *  Version    Date            Author          Modification
   *  V1.0.0     Nov-11-2019     RM              1. add chassis power control
+  *  V1.1.0     Oct-16-2026     RM              1. scale the out array of the wheel pid bank
   *
   @verbatim
   ==============================================================================
@@ -120,16 +121,16 @@ void chassis_power_control(chassis_move_t *chassis_power_control)
     //ԭ趨
     for(uint8_t i = 0; i < 4; i++)
     {
-        total_current += fabs(chassis_power_control->motor_speed_pid[i].out);
+        total_current += fabs(chassis_power_control->motor_speed_pid.out[i]);
     }
     
 
     if(total_current > total_current_limit)
     {
         fp32 current_scale = total_current_limit / total_current;
-        chassis_power_control->motor_speed_pid[0].out*=current_scale;
-        chassis_power_control->motor_speed_pid[1].out*=current_scale;
-        chassis_power_control->motor_speed_pid[2].out*=current_scale;
-        chassis_power_control->motor_speed_pid[3].out*=current_scale;
+        for(uint8_t i = 0; i < 4; i++)
+        {
+            chassis_power_control->motor_speed_pid.out[i] *= current_scale;
+        }
     }
 }
@@ -8,6 +8,11 @@
   *  Version    Date            Author          Modification
   *  V1.0.0     Dec-26-2018     RM              1. done
   *  V1.1.0     Nov-11-2019     RM              1. add chassis power control
+  *  V1.2.0     Oct-16-2026     RM              1. motor speed and accel from motor state estimator
+  *  V1.3.0     Oct-16-2026     RM              1. use one INS snapshot per control cycle
+  *  V1.4.0     Oct-16-2026     RM              1. option to run at INS samples
+  *  V1.5.0     Oct-16-2026     RM              1. pid with real dt
+  *  V1.6.0     Oct-16-2026     RM              1. wheel speed pid as one pid bank
   *
   @verbatim
   ==============================================================================
@@ -28,6 +33,7 @@
 #include "detect_task.h"
 #include "INS_task.h"
 #include "chassis_power_control.h"
+#include "bsp_dwt.h"
 
 #define rc_deadband_limit(input, output, dealine)        \
     {                                                    \
@@ -41,6 +47,12 @@
         }                                                \
     }
 
+//terms of the chassis loops, add PID_I or PID_D when KI or KD is tuned
+//the speed loop keeps the clamp only integral of the old PID_calc until retuned with PID_ANTI_WINDUP
+//̸, KIKDʱPID_IPID_D
+//ٶȻԭPID_calcֻ޷Ļ, ټPID_ANTI_WINDUP
+#define CHASSIS_SPEED_PID_FLAG  (PID_I)
+#define CHASSIS_ANGLE_PID_FLAG  0
 
 /**
   * @brief          "chassis_move" valiable initialization, include pid initialization, remote control data point initialization, 3508 chassis motors
@@ -135,6 +147,9 @@ chassis_move_t chassis_move;
   */
 void chassis_task(void const *pvParameters)
 {
+#if CHASSIS_IMU_TRIGGER
+    uint32_t chassis_trigger_seq;
+#endif
     //wait a time 
     //һʱ
     vTaskDelay(CHASSIS_TASK_INIT_TIME);
@@ -170,6 +185,7 @@ void chassis_task(void const *pvParameters)
         //ȷһߣ CANưԱյ
         if (!(toe_is_error(CHASSIS_MOTOR1_TOE) && toe_is_error(CHASSIS_MOTOR2_TOE) && toe_is_error(CHASSIS_MOTOR3_TOE) && toe_is_error(CHASSIS_MOTOR4_TOE)))
         {
+            CAN_tx_mark(CAN_TX_CHASSIS_GROUP, chassis_move.chassis_INS.sample_cycle);
             //when remote control is offline, chassis motor should receive zero current. 
             //ңߵʱ򣬷͸̵.
             if (toe_is_error(DBUS_TOE))
@@ -183,10 +199,26 @@ void chassis_task(void const *pvParameters)
                 CAN_cmd_chassis(chassis_move.motor_chassis[0].give_current, chassis_move.motor_chassis[1].give_current,
                                 chassis_move.motor_chassis[2].give_current, chassis_move.motor_chassis[3].give_current);
             }
+#if CHASSIS_IMU_TRIGGER
+            CAN_tx_now(CAN_TX_CHASSIS_GROUP);
+#endif
         }
+#if CHASSIS_IMU_TRIGGER
+        //wait CHASSIS_IMU_TRIGGER_DIV samples after the one just used
+        //ȴ֮CHASSIS_IMU_TRIGGER_DIVβ
+        chassis_trigger_seq = chassis_move.chassis_INS.seq;
+        do
+        {
+            if (!INS_wait_snapshot(&chassis_move.chassis_INS, chassis_move.chassis_INS.seq, CHASSIS_IMU_TRIGGER_TIMEOUT))
+            {
+                break;
+            }
+        } while (chassis_move.chassis_INS.seq - chassis_trigger_seq < CHASSIS_IMU_TRIGGER_DIV);
+#else
         //os delay
         //ϵͳʱ
         vTaskDelay(CHASSIS_CONTROL_TIME_MS);
+#endif
 
 #if INCLUDE_uxTaskGetStackHighWaterMark
         chassis_high_water = uxTaskGetStackHighWaterMark(NULL);
@@ -212,13 +244,15 @@ static void chassis_init(chassis_move_t *chassis_move_init)
         return;
     }
 
-    //chassis motor speed PID
-    //ٶȻpidֵ
-    const static fp32 motor_speed_pid[3] = {M3505_MOTOR_SPEED_PID_KP, M3505_MOTOR_SPEED_PID_KI, M3505_MOTOR_SPEED_PID_KD};
+    //chassis motor speed PID, Kaw = Ki / Kp once PID_ANTI_WINDUP is added
+    //ٶȻpidֵ, PID_ANTI_WINDUPKaw = Ki / Kp
+    const static pid_config_t motor_speed_pid = {M3505_MOTOR_SPEED_PID_KP, M3505_MOTOR_SPEED_PID_KI / CHASSIS_CONTROL_TIME, M3505_MOTOR_SPEED_PID_KD * CHASSIS_CONTROL_TIME,
+                                                 M3505_MOTOR_SPEED_PID_MAX_OUT, M3505_MOTOR_SPEED_PID_MAX_IOUT, M3505_MOTOR_SPEED_PID_KI / M3505_MOTOR_SPEED_PID_KP / CHASSIS_CONTROL_TIME, 0.0f};
     
     //chassis angle PID
     //̽Ƕpidֵ
-    const static fp32 chassis_yaw_pid[3] = {CHASSIS_FOLLOW_GIMBAL_PID_KP, CHASSIS_FOLLOW_GIMBAL_PID_KI, CHASSIS_FOLLOW_GIMBAL_PID_KD};
+    const static pid_config_t chassis_yaw_pid = {CHASSIS_FOLLOW_GIMBAL_PID_KP, CHASSIS_FOLLOW_GIMBAL_PID_KI / CHASSIS_CONTROL_TIME, CHASSIS_FOLLOW_GIMBAL_PID_KD * CHASSIS_CONTROL_TIME,
+                                                 CHASSIS_FOLLOW_GIMBAL_PID_MAX_OUT, CHASSIS_FOLLOW_GIMBAL_PID_MAX_IOUT, 0.0f, 0.0f};
     
     const static fp32 chassis_x_order_filter[1] = {CHASSIS_ACCEL_X_NUM};
     const static fp32 chassis_y_order_filter[1] = {CHASSIS_ACCEL_Y_NUM};
@@ -230,9 +264,6 @@ static void chassis_init(chassis_move_t *chassis_move_init)
     //get remote control point
     //ȡңָ
     chassis_move_init->chassis_RC = get_remote_control_point();
-    //get gyro sensor euler angle point
-    //ȡָ̬
-    chassis_move_init->chassis_INS_angle = get_INS_angle_point();
     //get gimbal motor data point
     //ȡָ̨
     chassis_move_init->chassis_yaw_motor = get_yaw_motor_point();
@@ -242,12 +273,12 @@ static void chassis_init(chassis_move_t *chassis_move_init)
     //ȡ̵ָ룬ʼPID 
     for (i = 0; i < 4; i++)
     {
-        chassis_move_init->motor_chassis[i].chassis_motor_measure = get_chassis_motor_measure_point(i);
-        PID_init(&chassis_move_init->motor_speed_pid[i], PID_POSITION, motor_speed_pid, M3505_MOTOR_SPEED_PID_MAX_OUT, M3505_MOTOR_SPEED_PID_MAX_IOUT);
+        chassis_move_init->motor_chassis[i].chassis_motor_measure = &chassis_move_init->motor_chassis[i].chassis_motor_feedback.measure;
     }
+    PID_bank_init(&chassis_move_init->motor_speed_pid, &motor_speed_pid);
     //initialize angle PID
     //ʼǶPID
-    PID_init(&chassis_move_init->chassis_angle_pid, PID_POSITION, chassis_yaw_pid, CHASSIS_FOLLOW_GIMBAL_PID_MAX_OUT, CHASSIS_FOLLOW_GIMBAL_PID_MAX_IOUT);
+    PID_init(&chassis_move_init->chassis_angle_pid, &chassis_yaw_pid);
     
     //first order low-pass filter  replace ramp function
     //һ˲б
@@ -349,12 +380,16 @@ static void chassis_feedback_update(chassis_move_t *chassis_move_update)
     }
 
     uint8_t i = 0;
+    chassis_move_update->dt = dwt_get_dt(&chassis_move_update->dt_cycle, CHASSIS_CONTROL_TIME);
     for (i = 0; i < 4; i++)
     {
-        //update motor speed, accel is differential of speed PID
-        //µٶȣٶٶȵPID΢
-        chassis_move_update->motor_chassis[i].speed = CHASSIS_MOTOR_RPM_TO_VECTOR_SEN * chassis_move_update->motor_chassis[i].chassis_motor_measure->speed_rpm;
-        chassis_move_update->motor_chassis[i].accel = chassis_move_update->motor_speed_pid[i].Dbuf[0] * CHASSIS_CONTROL_FREQUENCE;
+        //motor feedback snapshot of this cycle
+        //ݿ
+        get_motor_feedback(CAN_CHASSIS_M1_INDEX + i, &chassis_move_update->motor_chassis[i].chassis_motor_feedback);
+        //update motor speed and accel from motor state estimated in CAN receive
+        //CANжеĵ״̬ƸµٶȺͼٶ
+        chassis_move_update->motor_chassis[i].speed = CHASSIS_MOTOR_RPM_TO_VECTOR_SEN * MOTOR_STATE_RADS_TO_RPM * chassis_move_update->motor_chassis[i].chassis_motor_feedback.state.velocity;
+        chassis_move_update->motor_chassis[i].accel = CHASSIS_MOTOR_RPM_TO_VECTOR_SEN * MOTOR_STATE_RADS_TO_RPM * chassis_move_update->motor_chassis[i].chassis_motor_feedback.state.accel;
     }
 
     //calculate vertical speed, horizontal speed ,rotation speed, left hand rule 
@@ -365,9 +400,10 @@ static void chassis_feedback_update(chassis_move_t *chassis_move_update)
 
     //calculate chassis euler angle, if chassis add a new gyro sensor,please change this code
     //̬Ƕ, ⲿִ
-    chassis_move_update->chassis_yaw = rad_format(*(chassis_move_update->chassis_INS_angle + INS_YAW_ADDRESS_OFFSET) - chassis_move_update->chassis_yaw_motor->relative_angle);
-    chassis_move_update->chassis_pitch = rad_format(*(chassis_move_update->chassis_INS_angle + INS_PITCH_ADDRESS_OFFSET) - chassis_move_update->chassis_pitch_motor->relative_angle);
-    chassis_move_update->chassis_roll = *(chassis_move_update->chassis_INS_angle + INS_ROLL_ADDRESS_OFFSET);
+    get_INS_snapshot(&chassis_move_update->chassis_INS);
+    chassis_move_update->chassis_yaw = rad_format(chassis_move_update->chassis_INS.angle[INS_YAW_ADDRESS_OFFSET] - chassis_move_update->chassis_yaw_motor->relative_angle);
+    chassis_move_update->chassis_pitch = rad_format(chassis_move_update->chassis_INS.angle[INS_PITCH_ADDRESS_OFFSET] - chassis_move_update->chassis_pitch_motor->relative_angle);
+    chassis_move_update->chassis_roll = chassis_move_update->chassis_INS.angle[INS_ROLL_ADDRESS_OFFSET];
 }
 /**
   * @brief          accroding to the channel value of remote control, calculate chassis vertical and horizontal speed set-point
@@ -480,7 +516,7 @@ static void chassis_set_contorl(chassis_move_t *chassis_move_control)
         chassis_move_control->chassis_relative_angle_set = rad_format(angle_set);
         //calculate ratation speed
         //תPIDٶ
-        chassis_move_control->wz_set = -PID_calc(&chassis_move_control->chassis_angle_pid, chassis_move_control->chassis_yaw_motor->relative_angle, chassis_move_control->chassis_relative_angle_set);
+        chassis_move_control->wz_set = -PID_calc(&chassis_move_control->chassis_angle_pid, CHASSIS_ANGLE_PID_FLAG, chassis_move_control->chassis_yaw_motor->relative_angle, chassis_move_control->chassis_relative_angle_set, chassis_move_control->dt);
         //speed limit
         //ٶ޷
         chassis_move_control->vx_set = fp32_constrain(chassis_move_control->vx_set, chassis_move_control->vx_min_speed, chassis_move_control->vx_max_speed);
@@ -495,7 +531,7 @@ static void chassis_set_contorl(chassis_move_t *chassis_move_control)
         delat_angle = rad_format(chassis_move_control->chassis_yaw_set - chassis_move_control->chassis_yaw);
         //calculate rotation speed
         //תĽٶ
-        chassis_move_control->wz_set = PID_calc(&chassis_move_control->chassis_angle_pid, 0.0f, delat_angle);
+        chassis_move_control->wz_set = PID_calc(&chassis_move_control->chassis_angle_pid, CHASSIS_ANGLE_PID_FLAG, 0.0f, delat_angle, chassis_move_control->dt);
         //speed limit
         //ٶ޷
         chassis_move_control->vx_set = fp32_constrain(vx_set, chassis_move_control->vx_min_speed, chassis_move_control->vx_max_speed);
@@ -604,12 +640,14 @@ static void chassis_control_loop(chassis_move_t *chassis_move_control_loop)
         }
     }
 
-    //calculate pid
-    //pid
+    //calculate pid, the 4 wheels in one pass
+    //pid, 4һμ
     for (i = 0; i < 4; i++)
     {
-        PID_calc(&chassis_move_control_loop->motor_speed_pid[i], chassis_move_control_loop->motor_chassis[i].speed, chassis_move_control_loop->motor_chassis[i].speed_set);
+        chassis_move_control_loop->motor_speed_pid.fdb[i] = chassis_move_control_loop->motor_chassis[i].speed;
+        chassis_move_control_loop->motor_speed_pid.set[i] = chassis_move_control_loop->motor_chassis[i].speed_set;
     }
+    PID_bank_calc(&chassis_move_control_loop->motor_speed_pid, CHASSIS_SPEED_PID_FLAG, chassis_move_control_loop->dt);
 
 
     //ʿ
@@ -619,6 +657,6 @@ static void chassis_control_loop(chassis_move_t *chassis_move_control_loop)
     //ֵֵ
     for (i = 0; i < 4; i++)
     {
-        chassis_move_control_loop->motor_chassis[i].give_current = (int16_t)(chassis_move_control_loop->motor_speed_pid[i].out);
+        chassis_move_control_loop->motor_chassis[i].give_current = (int16_t)(chassis_move_control_loop->motor_speed_pid.out[i]);
     }
 }
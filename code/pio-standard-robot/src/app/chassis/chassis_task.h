@@ -8,6 +8,10 @@
   *  Version    Date            Author          Modification
   *  V1.0.0     Dec-26-2018     RM              1. 
   *  V1.1.0     Nov-11-2019     RM              1. add chassis power control
+  *  V1.2.0     Oct-16-2026     RM              1. use one INS snapshot per control cycle
+  *  V1.3.0     Oct-16-2026     RM              1. option to run at INS samples
+  *  V1.4.0     Oct-16-2026     RM              1. pid with real dt
+  *  V1.5.0     Oct-16-2026     RM              1. wheel speed pid as one pid bank
   *
   @verbatim
   ==============================================================================
@@ -76,6 +80,15 @@
 //chassis task control time 0.002s
 //Ƽ 0.002s
 #define CHASSIS_CONTROL_TIME 0.002f
+//1: run every CHASSIS_IMU_TRIGGER_DIV INS samples and send at once, 0: free running with CHASSIS_CONTROL_TIME_MS
+//1: ÿCHASSIS_IMU_TRIGGER_DIVINSһβ, 0: CHASSIS_CONTROL_TIME_MS
+#define CHASSIS_IMU_TRIGGER 0
+//INS samples per control cycle, keep it with CHASSIS_CONTROL_TIME
+//ÿڵINS, CHASSIS_CONTROL_TIMEһ
+#define CHASSIS_IMU_TRIGGER_DIV (CHASSIS_CONTROL_TIME_MS * 1000 / INS_DT_NOMINAL_US)
+//longest wait for a sample, then run without it
+//ȴʱ, ʱ򲻵ȴֱ
+#define CHASSIS_IMU_TRIGGER_TIMEOUT 5
 //chassis control frequence, no use now.
 //Ƶʣδʹ
 #define CHASSIS_CONTROL_FREQUENCE 500.0f
@@ -116,6 +129,8 @@
 //ҡڹ̵˶Ƕ(rad)
 #define SWING_MOVE_ANGLE 0.31415926535897932384626433832795f
 
+//KI and KD below are per CHASSIS_CONTROL_TIME, turned to per second in the pid config
+//KIKDCHASSIS_CONTROL_TIME, pidлΪ
 //chassis motor speed PID
 //̵ٶȻPID
 #define M3505_MOTOR_SPEED_PID_KP 15000.0f
@@ -144,6 +159,7 @@ typedef enum
 typedef struct
 {
   const motor_measure_t *chassis_motor_measure;
+  motor_feedback_t chassis_motor_feedback;
   fp32 accel;
   fp32 speed;
   fp32 speed_set;
@@ -155,11 +171,11 @@ typedef struct
   const RC_ctrl_t *chassis_RC;               //ʹõңָ, the point to remote control
   const gimbal_motor_t *chassis_yaw_motor;   //will use the relative angle of yaw gimbal motor to calculate the euler angle.ʹõyaw̨ԽǶ̵ŷ.
   const gimbal_motor_t *chassis_pitch_motor; //will use the relative angle of pitch gimbal motor to calculate the euler angle.ʹõpitch̨ԽǶ̵ŷ
-  const fp32 *chassis_INS_angle;             //the point to the euler angle of gyro sensor.ȡǽŷָ
+  INS_snapshot_t chassis_INS;                //gyro sensor snapshot of this cycle.ݿ
   chassis_mode_e chassis_mode;               //state machine. ̿״̬
   chassis_mode_e last_chassis_mode;          //last state machine.ϴο״̬
   chassis_motor_t motor_chassis[4];          //chassis motor data.̵
-  pid_type_def motor_speed_pid[4];             //motor speed PID.̵ٶpid
+  pid_bank_t motor_speed_pid;                  //motor speed PID of the 4 wheels.4ٶpid
   pid_type_def chassis_angle_pid;              //follow angle PID.̸Ƕpid
 
   first_order_filter_type_t chassis_cmd_slow_set_vx;  //use first order filter to slow set-point.ʹһ׵ͨ˲趨ֵ
@@ -182,6 +198,8 @@ typedef struct
   fp32 chassis_yaw;   //the yaw angle calculated by gyro sensor and gimbal motor.Ą̊́ӵyawǶ
   fp32 chassis_pitch; //the pitch angle calculated by gyro sensor and gimbal motor.Ą̊́ӵpitchǶ
   fp32 chassis_roll;  //the roll angle calculated by gyro sensor and gimbal motor.Ą̊́ӵrollǶ
+  fp32 dt;            //measured control period, unit s.ʵ λ s
+  uint32_t dt_cycle;
 
 } chassis_move_t;
 
@@ -9,6 +9,18 @@
   *  Version    Date            Author          Modification
   *  V1.0.0     Dec-26-2018     RM              1. done
   *  V1.1.0     Nov-11-2019     RM              1. support hal lib
+  *  V1.2.0     Oct-16-2026     RM              1. seqlock feedback snapshot with
+  *                                                receive timestamp and sequence
+  *  V1.3.0     Oct-16-2026     RM              1. table driven rx on both CAN buses and fifos
+  *  V1.4.0     Oct-16-2026     RM              1. tx scheduler, commands are posted and sent
+  *                                                by TIM7 at fixed phase of 1ms cycle
+  *  V1.5.0     Oct-16-2026     RM              1. bus load, error counter and per ID rate statistics
+  *  V1.6.0     Oct-16-2026     RM              1. motor state estimated at frame rate
+  *  V1.7.0     Oct-16-2026     RM              1. Damiao motor in MIT mode
+  *  V1.8.0     Oct-16-2026     RM              1. record rx and tx frames in can_recorder
+  *  V1.9.0     Oct-16-2026     RM              1. send a group at once, source to mailbox latency
+  *  V1.10.0    Oct-16-2026     RM              1. receive RM IMU module frames
+  *  V1.11.0    Oct-16-2026     RM              1. DWT extension of the recorder time kept every second
   *
   @verbatim
   ==============================================================================
@@ -24,12 +36,20 @@
 
 #include "main.h"
 #include "bsp_rng.h"
+#include "bsp_dwt.h"
+#include "bsp_can.h"
+#include "can_recorder.h"
+#include "rm_imu.h"
 
 
 #include "detect_task.h"
 
 extern CAN_HandleTypeDef hcan1;
 extern CAN_HandleTypeDef hcan2;
+extern TIM_HandleTypeDef htim7;
+//bus index of a CAN handle
+//CANӦ
+#define CAN_BUS_INDEX(hcan) (((hcan) == &hcan2) ? CAN_BUS_2 : CAN_BUS_1)
 //motor data read
 #define get_motor_measure(ptr, data)                                    \
     {                                                                   \
@@ -44,57 +64,680 @@ motor data,  0:chassis motor1 3508;1:chassis motor3 3508;2:chassis motor3 3508;3
 4:yaw gimbal motor 6020;5:pitch gimbal motor 6020;6:trigger motor 2006;
 , 0:̵1 3508,  1:̵2 3508,2:̵3 3508,3:̵4 3508;
 4:yaw̨ 6020; 5:pitch̨ 6020; 6: 2006*/
-static motor_measure_t motor_chassis[7];
+static motor_feedback_t motor_chassis[CAN_MOTOR_NUM];
+//seqlock of motor_chassis, odd while the CAN interrupt is writing
+//motor_chassis˳,CANждʱΪ
+static volatile uint32_t motor_chassis_lock[CAN_MOTOR_NUM];
 
-static CAN_TxHeaderTypeDef  gimbal_tx_message;
-static uint8_t              gimbal_can_send_data[8];
-static CAN_TxHeaderTypeDef  chassis_tx_message;
-static uint8_t              chassis_can_send_data[8];
+//tx group config, the group is sent at its phase of the 1ms cycle
+//, ÿ1msй̶λ
+typedef struct
+{
+    CAN_HandleTypeDef *hcan;
+    uint32_t std_id;
+    uint8_t phase;
+} can_tx_cfg_t;
+
+//tx group state, tasks write data[index ^ 1] then flip index, TIM7 sends data[index]
+//״̬, дdata[index ^ 1]תindex, TIM7data[index]
+typedef struct
+{
+    uint8_t data[2][8];
+    volatile uint8_t index;
+    volatile uint8_t pending;
+    volatile uint8_t hold;      //a command frame waits, later data is not posted until it is sent
+    uint8_t late;
+    uint8_t queued;
+    uint32_t mailbox;
+    uint32_t src_cycle[2];      //source DWT cycle of data[], 0: not marked.data[]ԴDWT, 0Ϊδ
+    uint32_t mark_cycle;
+    can_tx_stat_t stat;
+} can_tx_group_t;
+
+static const can_tx_cfg_t can_tx_cfg[CAN_TX_GROUP_NUM] =
+{
+    [CAN_TX_GIMBAL_GROUP]           = {&GIMBAL_CAN,  CAN_GIMBAL_ALL_ID,  0},
+    [CAN_TX_CHASSIS_GROUP]          = {&CHASSIS_CAN, CAN_CHASSIS_ALL_ID, 1},
+    [CAN_TX_CHASSIS_RESET_ID_GROUP] = {&CHASSIS_CAN, CAN_CHASSIS_RESET_ID, 2},
+#define CAN_DM_TX_CFG_ENTRY(index, bus, can_id, master_id, fifo, toe, p_max, v_max, t_max) \
+    [CAN_TX_DM_GROUP_BASE + (index) - CAN_DM_MOTOR_INDEX_BASE] = {((bus) == CAN_BUS_2) ? &hcan2 : &hcan1, can_id, 0},
+    CAN_DM_MOTOR_TABLE(CAN_DM_TX_CFG_ENTRY)
+#undef CAN_DM_TX_CFG_ENTRY
+};
+
+static can_tx_group_t can_tx_group[CAN_TX_GROUP_NUM];
+static uint8_t can_tx_phase = CAN_TX_PHASE_NUM - 1;
+
+//bits of a standard data frame with worst case bit stuffing and 3 bits interframe space
+//׼֡λ, λ, 3λ֡
+#define CAN_STD_FRAME_BIT(dlc) (47 + 8 * (dlc) + (34 + 8 * (dlc) - 1) / 4)
+//statistic window, unit ms
+//ͳƴ, λms
+#define CAN_STAT_WINDOW_MS 1000
+
+//bus counters, rx_* are written by CAN rx interrupt, the others by TIM7
+//߼, rx_*CANжд, TIM7д
+typedef struct
+{
+    volatile uint32_t rx_frame;
+    volatile uint32_t rx_bit;
+    uint32_t tx_frame;
+    uint32_t tx_bit;
+    uint32_t last_rx_frame;
+    uint32_t last_rx_bit;
+    uint32_t last_tx_frame;
+    uint32_t last_tx_bit;
+    can_bus_stat_t stat;
+} can_bus_counter_t;
+
+static can_bus_counter_t can_bus_counter[CAN_BUS_NUM];
+static uint32_t can_rx_last_seq[CAN_MOTOR_NUM];
+static uint32_t can_rx_rate[CAN_MOTOR_NUM];
+static uint32_t can_tx_last_sent[CAN_TX_GROUP_NUM];
+static uint32_t can_tx_rate[CAN_TX_GROUP_NUM];
+static uint16_t can_stat_tick;
+
+//feedback protocol of a motor
+//Э
+typedef enum
+{
+    CAN_MOTOR_DJI = 0,
+    CAN_MOTOR_DM_MIT,
+} can_motor_protocol_e;
+
+//receive config of a motor, generated from CAN_MOTOR_TABLE and CAN_DM_MOTOR_TABLE
+//, CAN_MOTOR_TABLECAN_DM_MOTOR_TABLE
+typedef struct
+{
+    uint8_t bus;
+    uint16_t std_id;
+    uint8_t toe;
+    uint8_t protocol;
+    uint8_t dm_id;
+    dm_motor_range_t dm_range;
+} can_motor_cfg_t;
+
+#define CAN_MOTOR_CFG_ENTRY(index, bus, id, fifo, toe) [index] = {bus, id, toe, CAN_MOTOR_DJI, 0, {0.0f, 0.0f, 0.0f}},
+#define CAN_DM_MOTOR_CFG_ENTRY(index, bus, can_id, master_id, fifo, toe, p_max, v_max, t_max) \
+    [index] = {bus, master_id, toe, CAN_MOTOR_DM_MIT, can_id, {p_max, v_max, t_max}},
+static const can_motor_cfg_t can_motor_cfg[CAN_MOTOR_NUM] =
+{
+    CAN_MOTOR_TABLE(CAN_MOTOR_CFG_ENTRY)
+    CAN_DM_MOTOR_TABLE(CAN_DM_MOTOR_CFG_ENTRY)
+};
+#undef CAN_MOTOR_CFG_ENTRY
+#undef CAN_DM_MOTOR_CFG_ENTRY
+
+/*
+lookup table keyed by (bus, rx id - CAN_RX_ID_BASE), the value is motor index + 1, 0 means no motor.
+ղұ, (, ID - CAN_RX_ID_BASE)Ϊ, ֵΪ+1, 0ʾûе.
+*/
+#define CAN_RX_LOOKUP_ENTRY(index, bus, id, fifo, toe) [bus][(id) - CAN_RX_ID_BASE] = (index) + 1,
+#define CAN_DM_RX_LOOKUP_ENTRY(index, bus, can_id, master_id, fifo, toe, p_max, v_max, t_max) \
+    [bus][(master_id) - CAN_RX_ID_BASE] = (index) + 1,
+static const uint8_t can_rx_lookup[CAN_BUS_NUM][CAN_RX_ID_RANGE] =
+{
+    CAN_MOTOR_TABLE(CAN_RX_LOOKUP_ENTRY)
+    CAN_DM_MOTOR_TABLE(CAN_DM_RX_LOOKUP_ENTRY)
+};
+#undef CAN_RX_LOOKUP_ENTRY
+#undef CAN_DM_RX_LOOKUP_ENTRY
 
 /**
-  * @brief          hal CAN fifo call back, receive motor data
+  * @brief          read all frames in a rx fifo, route motor feedback by (bus, ID)
   * @param[in]      hcan, the point to CAN handle
+  * @param[in]      fifo: CAN_RX_FIFO0 or CAN_RX_FIFO1
   * @retval         none
   */
 /**
-  * @brief          halCANص,յ
+  * @brief          ȡFIFOе֡, (, ID)ַ
   * @param[in]      hcan:CANָ
+  * @param[in]      fifo: CAN_RX_FIFO0  CAN_RX_FIFO1
   * @retval         none
   */
-void HAL_CAN_RxFifo0MsgPendingCallback(CAN_HandleTypeDef *hcan)
+static void can_rx_dispatch(CAN_HandleTypeDef *hcan, uint32_t fifo)
 {
     CAN_RxHeaderTypeDef rx_header;
     uint8_t rx_data[8];
+    uint32_t rx_cycle;
+    uint32_t bus = CAN_BUS_INDEX(hcan);
+    uint32_t overrun_flag = (fifo == CAN_RX_FIFO0) ? CAN_FLAG_FOV0 : CAN_FLAG_FOV1;
+    uint32_t offset;
+    uint8_t i;
 
-    HAL_CAN_GetRxMessage(hcan, CAN_RX_FIFO0, &rx_header, rx_data);
+    //releasing the fifo output clears the overrun flag, so check it before reading
+    //ͷFIFO־, ڶȡǰ
+    if (__HAL_CAN_GET_FLAG(hcan, overrun_flag))
+    {
+        __HAL_CAN_CLEAR_FLAG(hcan, overrun_flag);
+        can_bus_counter[bus].stat.fifo_overrun[fifo]++;
+    }
 
-    switch (rx_header.StdId)
+    while (HAL_CAN_GetRxFifoFillLevel(hcan, fifo) > 0)
     {
-        case CAN_3508_M1_ID:
-        case CAN_3508_M2_ID:
-        case CAN_3508_M3_ID:
-        case CAN_3508_M4_ID:
-        case CAN_YAW_MOTOR_ID:
-        case CAN_PIT_MOTOR_ID:
-        case CAN_TRIGGER_MOTOR_ID:
+        rx_cycle = dwt_get_cycle();
+        if (HAL_CAN_GetRxMessage(hcan, fifo, &rx_header, rx_data) != HAL_OK)
+        {
+            return;
+        }
+        can_recorder_write(bus, CAN_RECORD_RX, rx_header.StdId, rx_header.DLC, rx_data);
+        can_bus_counter[bus].rx_frame++;
+        can_bus_counter[bus].rx_bit += CAN_STD_FRAME_BIT(rx_header.DLC);
+
+#if RM_IMU_ENABLE
+        //RM IMU module IDs are out of the motor lookup range
+        //RM IMUģIDڵұΧ
+        if (bus == RM_IMU_CAN_BUS && rx_header.IDE == CAN_ID_STD && rm_imu_decode(rx_header.StdId, rx_data, rx_cycle))
+        {
+            continue;
+        }
+#endif
+
+        offset = rx_header.StdId - CAN_RX_ID_BASE;
+        if (rx_header.IDE != CAN_ID_STD || offset >= CAN_RX_ID_RANGE || can_rx_lookup[bus][offset] == 0)
         {
-            static uint8_t i = 0;
-            //get motor id
-            i = rx_header.StdId - CAN_3508_M1_ID;
-            get_motor_measure(&motor_chassis[i], rx_data);
-            detect_hook(CHASSIS_MOTOR1_TOE + i);
-            break;
+            continue;
         }
 
-        default:
+        i = can_rx_lookup[bus][offset] - 1;
+        //Damiao feedback carries the motor CAN ID in the low 4 bits of byte 0
+        //0ֽڵ4λΪCAN ID
+        if (can_motor_cfg[i].protocol == CAN_MOTOR_DM_MIT && (rx_data[0] & 0x0F) != (can_motor_cfg[i].dm_id & 0x0F))
         {
-            break;
+            continue;
         }
+
+        motor_chassis_lock[i]++;
+        __DMB();
+        if (can_motor_cfg[i].protocol == CAN_MOTOR_DM_MIT)
+        {
+            dm_motor_decode(&motor_chassis[i].dm, &can_motor_cfg[i].dm_range, rx_data);
+        }
+        else
+        {
+            get_motor_measure(&motor_chassis[i].measure, rx_data);
+            motor_state_update(&motor_chassis[i].state, motor_chassis[i].measure.ecd, motor_chassis[i].measure.speed_rpm,
+                               motor_chassis[i].seq ? dwt_cycle_to_us(rx_cycle - motor_chassis[i].rx_cycle) * 0.000001f : 0.0f);
+        }
+        motor_chassis[i].rx_cycle = rx_cycle;
+        motor_chassis[i].seq++;
+        __DMB();
+        motor_chassis_lock[i]++;
+        detect_hook(can_motor_cfg[i].toe);
     }
 }
 
+/**
+  * @brief          hal CAN fifo0 call back, receive motor data
+  * @param[in]      hcan, the point to CAN handle
+  * @retval         none
+  */
+/**
+  * @brief          halCAN FIFO0ص,յ
+  * @param[in]      hcan:CANָ
+  * @retval         none
+  */
+void HAL_CAN_RxFifo0MsgPendingCallback(CAN_HandleTypeDef *hcan)
+{
+    can_rx_dispatch(hcan, CAN_RX_FIFO0);
+}
+
+/**
+  * @brief          hal CAN fifo1 call back, receive motor data
+  * @param[in]      hcan, the point to CAN handle
+  * @retval         none
+  */
+/**
+  * @brief          halCAN FIFO1ص,յ
+  * @param[in]      hcan:CANָ
+  * @retval         none
+  */
+void HAL_CAN_RxFifo1MsgPendingCallback(CAN_HandleTypeDef *hcan)
+{
+    can_rx_dispatch(hcan, CAN_RX_FIFO1);
+}
+
 
 
+/**
+  * @brief          post a group command, it replaces the data not sent yet
+  * @param[in]      group: tx group, CAN_TX_GIMBAL_GROUP etc.
+  * @param[in]      data: 8 bytes of data
+  * @param[in]      hold: 1: a command frame, it is not replaced by later data before it is sent
+  * @retval         none
+  */
+/**
+  * @brief          ύһ鷢, Ḳδ
+  * @param[in]      group: , CAN_TX_GIMBAL_GROUP
+  * @param[in]      data: 8ֽ
+  * @param[in]      hold: 1: ֡, ֮ǰᱻ֮ݸ
+  * @retval         none
+  */
+static void can_tx_post(uint8_t group, const uint8_t data[8], bool_t hold)
+{
+    can_tx_group_t *tx = &can_tx_group[group];
+    uint8_t next = tx->index ^ 1;
+    uint8_t i;
+
+    //TIM7 does not read data[next] before index flips, only this task flips index
+    //indexתǰTIM7ȡdata[next], ֻбתindex
+    for (i = 0; i < 8; i++)
+    {
+        tx->data[next][i] = data[i];
+    }
+
+    //TIM7 sends data[index] and clears pending and hold, so index, pending and hold change together,
+    //or TIM7 may send the new data between them and the frame goes out twice
+    //TIM7data[index]pendinghold, һ޸, TIM7м䷢, ֡
+    taskENTER_CRITICAL();
+    if (tx->hold && !hold)
+    {
+        tx->stat.coalesced++;
+    }
+    else
+    {
+        tx->src_cycle[next] = tx->mark_cycle;
+        tx->mark_cycle = 0;
+        tx->index = next;
+        if (tx->pending)
+        {
+            tx->stat.coalesced++;
+        }
+        tx->hold = hold;
+        tx->pending = 1;
+    }
+    taskEXIT_CRITICAL();
+}
+
+/**
+  * @brief          put the latest data of a group into a free mailbox
+  * @param[in]      group: tx group
+  * @retval         1: in mailbox, 0: no free mailbox
+  */
+/**
+  * @brief          һݷ
+  * @param[in]      group: 
+  * @retval         1: ѷ, 0: ûп
+  */
+static bool_t can_tx_send(uint8_t group)
+{
+    CAN_TxHeaderTypeDef tx_header;
+    const can_tx_cfg_t *cfg = &can_tx_cfg[group];
+    can_tx_group_t *tx = &can_tx_group[group];
+
+    if (HAL_CAN_GetTxMailboxesFreeLevel(cfg->hcan) == 0)
+    {
+        return 0;
+    }
+
+    tx_header.StdId = cfg->std_id;
+    tx_header.ExtId = 0;
+    tx_header.IDE = CAN_ID_STD;
+    tx_header.RTR = CAN_RTR_DATA;
+    tx_header.DLC = 0x08;
+    tx_header.TransmitGlobalTime = DISABLE;
+    tx->pending = 0;
+    if (HAL_CAN_AddTxMessage(cfg->hcan, &tx_header, tx->data[tx->index], &tx->mailbox) != HAL_OK)
+    {
+        tx->pending = 1;
+        return 0;
+    }
+    tx->queued = 1;
+    tx->hold = 0;
+    if (tx->src_cycle[tx->index])
+    {
+        tx->stat.latency_us = dwt_cycle_to_us(dwt_get_cycle() - tx->src_cycle[tx->index]);
+        tx->stat.latency_sum_us += tx->stat.latency_us;
+        tx->stat.latency_num++;
+        if (tx->stat.latency_max_us < tx->stat.latency_us)
+        {
+            tx->stat.latency_max_us = tx->stat.latency_us;
+        }
+        tx->src_cycle[tx->index] = 0;
+    }
+    can_recorder_write(CAN_BUS_INDEX(cfg->hcan), CAN_RECORD_TX, cfg->std_id, 8, tx->data[tx->index]);
+    return 1;
+}
+
+/**
+  * @brief          count a frame put into mailbox
+  * @param[in]      group: tx group
+  * @retval         none
+  */
+/**
+  * @brief          ͳƷһ֡
+  * @param[in]      group: 
+  * @retval         none
+  */
+static void can_tx_count(uint8_t group)
+{
+    can_tx_group_t *tx = &can_tx_group[group];
+    can_bus_counter_t *counter = &can_bus_counter[CAN_BUS_INDEX(can_tx_cfg[group].hcan)];
+
+    tx->stat.sent++;
+    counter->tx_frame++;
+    counter->tx_bit += CAN_STD_FRAME_BIT(8);
+    if (tx->late)
+    {
+        tx->stat.late++;
+        tx->late = 0;
+    }
+}
+
+/**
+  * @brief          sample error registers and mailbox use, update per second rates,
+  *                 called by TIM7 once per 1ms cycle
+  * @param[in]      none
+  * @retval         none
+  */
+/**
+  * @brief          Ĵռ, ÿ, TIM7ÿ1msһ
+  * @param[in]      none
+  * @retval         none
+  */
+static void can_stat_sample(void)
+{
+    can_bus_reg_t reg;
+    can_bus_counter_t *counter;
+    uint32_t seq;
+    uint8_t i;
+
+    for (i = 0; i < CAN_BUS_NUM; i++)
+    {
+        counter = &can_bus_counter[i];
+        can_bus_reg_read(i, &reg);
+        if (reg.bus_off && !counter->stat.bus_off)
+        {
+            counter->stat.bus_off_count++;
+        }
+        counter->stat.tec = reg.tec;
+        counter->stat.rec = reg.rec;
+        counter->stat.error_passive = reg.error_passive;
+        counter->stat.bus_off = reg.bus_off;
+        if (reg.mailbox_used > counter->stat.mailbox_high_water)
+        {
+            counter->stat.mailbox_high_water = reg.mailbox_used;
+        }
+    }
+
+    can_stat_tick++;
+    if (can_stat_tick < CAN_STAT_WINDOW_MS)
+    {
+        return;
+    }
+    can_stat_tick = 0;
+
+    //dwt_get_us of the recorder is only called on CAN traffic, keep its CYCCNT extension right over a silent bus
+    //¼dwt_get_usֻCANʱ, ߾Ĭʱɴ˱CYCCNTչȷ
+    dwt_update();
+    for (i = 0; i < CAN_BUS_NUM; i++)
+    {
+        counter = &can_bus_counter[i];
+        counter->stat.rx_rate = counter->rx_frame - counter->last_rx_frame;
+        counter->stat.tx_rate = counter->tx_frame - counter->last_tx_frame;
+        counter->stat.load = (uint16_t)((counter->rx_bit - counter->last_rx_bit + counter->tx_bit - counter->last_tx_bit) / (CAN_BIT_RATE / 1000));
+        counter->last_rx_frame = counter->rx_frame;
+        counter->last_rx_bit = counter->rx_bit;
+        counter->last_tx_frame = counter->tx_frame;
+        counter->last_tx_bit = counter->tx_bit;
+    }
+    for (i = 0; i < CAN_MOTOR_NUM; i++)
+    {
+        seq = motor_chassis[i].seq;
+        can_rx_rate[i] = seq - can_rx_last_seq[i];
+        can_rx_last_seq[i] = seq;
+    }
+    for (i = 0; i < CAN_TX_GROUP_NUM; i++)
+    {
+        can_tx_rate[i] = can_tx_group[i].stat.sent - can_tx_last_sent[i];
+        can_tx_last_sent[i] = can_tx_group[i].stat.sent;
+    }
+}
+
+/**
+  * @brief          tx stage, called by TIM7 at CAN_TX_PHASE_NUM times per ms.
+  *                 a pending group is sent at its own phase, if all mailboxes are busy
+  *                 it is retried at every following tick and counted as late.
+  *                 when its phase comes again, its own frame still in a mailbox is aborted.
+  * @param[in]      none
+  * @retval         none
+  */
+/**
+  * @brief          ͵, TIM7ÿCAN_TX_PHASE_NUM.
+  *                 ͵Լλ, ȫʱ֮ÿһԲΪӳ.
+  *                 ٴεԼλʱ, еı֡ᱻֹ.
+  * @param[in]      none
+  * @retval         none
+  */
+static void can_tx_schedule(void)
+{
+    const can_tx_cfg_t *cfg;
+    can_tx_group_t *tx;
+    uint8_t i;
+
+    can_tx_phase++;
+    if (can_tx_phase >= CAN_TX_PHASE_NUM)
+    {
+        can_tx_phase = 0;
+    }
+
+    for (i = 0; i < CAN_TX_GROUP_NUM; i++)
+    {
+        cfg = &can_tx_cfg[i];
+        tx = &can_tx_group[i];
+
+        if (tx->queued && !HAL_CAN_IsTxMessagePending(cfg->hcan, tx->mailbox))
+        {
+            tx->queued = 0;
+        }
+
+        if (!tx->pending || (cfg->phase != can_tx_phase && !tx->late))
+        {
+            continue;
+        }
+
+        //preempt: the frame of last cycle is still waiting, the new one replaces it
+        //ռ: һڵ֡ڵȴ, ֡滻
+        if (cfg->phase == can_tx_phase && tx->queued &&
+            HAL_CAN_GetTxMailboxesFreeLevel(cfg->hcan) == 0 &&
+            HAL_CAN_AbortTxRequest(cfg->hcan, tx->mailbox) == HAL_OK)
+        {
+            tx->queued = 0;
+            tx->stat.dropped++;
+        }
+
+        if (can_tx_send(i))
+        {
+            can_tx_count(i);
+        }
+        else
+        {
+            tx->late = 1;
+        }
+    }
+
+    if (can_tx_phase == CAN_TX_PHASE_NUM - 1)
+    {
+        can_stat_sample();
+    }
+}
+
+/**
+  * @brief          start the tx scheduler timer
+  * @param[in]      none
+  * @retval         none
+  */
+/**
+  * @brief          ͵ȶʱ
+  * @param[in]      none
+  * @retval         none
+  */
+void can_tx_init(void)
+{
+    HAL_TIM_Base_Start_IT(&htim7);
+}
+
+/**
+  * @brief          mark the next post of a group with the DWT cycle of the data it comes from,
+  *                 the latency from that cycle to mailbox is counted in can_tx_stat_t
+  * @param[in]      group: tx group, CAN_TX_GIMBAL_GROUP etc.
+  * @param[in]      src_cycle: DWT cycle of the source data, such as an INS sample
+  * @retval         none
+  */
+/**
+  * @brief          һһύԴDWT, Ӹüӳټcan_tx_stat_t
+  * @param[in]      group: , CAN_TX_GIMBAL_GROUP
+  * @param[in]      src_cycle: ԴDWT, INS
+  * @retval         none
+  */
+void CAN_tx_mark(uint8_t group, uint32_t src_cycle)
+{
+    if (group >= CAN_TX_GROUP_NUM)
+    {
+        return;
+    }
+    can_tx_group[group].mark_cycle = src_cycle;
+}
+
+/**
+  * @brief          send the pending data of a group now instead of at its phase,
+  *                 if no mailbox is free it is left to the scheduler
+  * @param[in]      group: tx group, CAN_TX_GIMBAL_GROUP etc.
+  * @retval         none
+  */
+/**
+  * @brief          һ, ǵȵλ, ûпʱɵȷ
+  * @param[in]      group: , CAN_TX_GIMBAL_GROUP
+  * @retval         none
+  */
+void CAN_tx_now(uint8_t group)
+{
+    if (group >= CAN_TX_GROUP_NUM)
+    {
+        return;
+    }
+    //TIM7 shares the mailboxes and the group state
+    //TIM7ͷ״̬
+    taskENTER_CRITICAL();
+    if (can_tx_group[group].pending && can_tx_send(group))
+    {
+        can_tx_count(group);
+    }
+    taskEXIT_CRITICAL();
+}
+
+/**
+  * @brief          hal timer period elapsed call back, run the CAN tx stage
+  * @param[in]      htim, the point to TIM handle
+  * @retval         none
+  */
+/**
+  * @brief          halⶨʱص, CAN͵
+  * @param[in]      htim:ʱָ
+  * @retval         none
+  */
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+{
+    if (htim == &htim7)
+    {
+        can_tx_schedule();
+    }
+}
+
+/**
+  * @brief          get the tx counters of a group
+  * @param[in]      group: tx group, CAN_TX_GIMBAL_GROUP etc.
+  * @param[out]     stat: counters copy
+  * @retval         1: ok, 0: group out of range
+  */
+/**
+  * @brief          ȡļ
+  * @param[in]      group: , CAN_TX_GIMBAL_GROUP
+  * @param[out]     stat: 
+  * @retval         1: ɹ, 0: 鳬Χ
+  */
+bool_t get_can_tx_stat(uint8_t group, can_tx_stat_t *stat)
+{
+    if (group >= CAN_TX_GROUP_NUM || stat == NULL)
+    {
+        return 0;
+    }
+    *stat = can_tx_group[group].stat;
+    return 1;
+}
+
+/**
+  * @brief          get the statistics of a CAN bus
+  * @param[in]      bus: CAN_BUS_1 or CAN_BUS_2
+  * @param[out]     stat: statistics copy
+  * @retval         1: ok, 0: bus out of range
+  */
+/**
+  * @brief          ȡCANͳ
+  * @param[in]      bus: CAN_BUS_1  CAN_BUS_2
+  * @param[out]     stat: ͳƿ
+  * @retval         1: ɹ, 0: ߳Χ
+  */
+bool_t get_can_bus_stat(uint8_t bus, can_bus_stat_t *stat)
+{
+    if (bus >= CAN_BUS_NUM || stat == NULL)
+    {
+        return 0;
+    }
+    *stat = can_bus_counter[bus].stat;
+    return 1;
+}
+
+/**
+  * @brief          get the rx statistics of a motor feedback ID
+  * @param[in]      motor_index: CAN_CHASSIS_M1_INDEX etc.
+  * @param[out]     stat: statistics copy
+  * @retval         1: ok, 0: index out of range
+  */
+/**
+  * @brief          ȡIDĽͳ
+  * @param[in]      motor_index: CAN_CHASSIS_M1_INDEX
+  * @param[out]     stat: ͳƿ
+  * @retval         1: ɹ, 0: ųΧ
+  */
+bool_t get_can_rx_id_stat(uint8_t motor_index, can_id_stat_t *stat)
+{
+    if (motor_index >= CAN_MOTOR_NUM || stat == NULL)
+    {
+        return 0;
+    }
+    stat->bus = can_motor_cfg[motor_index].bus;
+    stat->std_id = can_motor_cfg[motor_index].std_id;
+    stat->frame = motor_chassis[motor_index].seq;
+    stat->rate = can_rx_rate[motor_index];
+    return 1;
+}
+
+/**
+  * @brief          get the tx statistics of a tx group ID
+  * @param[in]      group: CAN_TX_GIMBAL_GROUP etc.
+  * @param[out]     stat: statistics copy
+  * @retval         1: ok, 0: group out of range
+  */
+/**
+  * @brief          ȡIDķͳ
+  * @param[in]      group: CAN_TX_GIMBAL_GROUP
+  * @param[out]     stat: ͳƿ
+  * @retval         1: ɹ, 0: 鳬Χ
+  */
+bool_t get_can_tx_id_stat(uint8_t group, can_id_stat_t *stat)
+{
+    if (group >= CAN_TX_GROUP_NUM || stat == NULL)
+    {
+        return 0;
+    }
+    stat->bus = CAN_BUS_INDEX(can_tx_cfg[group].hcan);
+    stat->std_id = can_tx_cfg[group].std_id;
+    stat->frame = can_tx_group[group].stat.sent;
+    stat->rate = can_tx_rate[group];
+    return 1;
+}
+
 /**
   * @brief          send control current of motor (0x205, 0x206, 0x207, 0x208)
   * @param[in]      yaw: (0x205) 6020 motor control current, range [-30000,30000] 
@@ -113,20 +756,16 @@ void HAL_CAN_RxFifo0MsgPendingCallback(CAN_HandleTypeDef *hcan)
   */
 void CAN_cmd_gimbal(int16_t yaw, int16_t pitch, int16_t shoot, int16_t rev)
 {
-    uint32_t send_mail_box;
-    gimbal_tx_message.StdId = CAN_GIMBAL_ALL_ID;
-    gimbal_tx_message.IDE = CAN_ID_STD;
-    gimbal_tx_message.RTR = CAN_RTR_DATA;
-    gimbal_tx_message.DLC = 0x08;
-    gimbal_can_send_data[0] = (yaw >> 8);
-    gimbal_can_send_data[1] = yaw;
-    gimbal_can_send_data[2] = (pitch >> 8);
-    gimbal_can_send_data[3] = pitch;
-    gimbal_can_send_data[4] = (shoot >> 8);
-    gimbal_can_send_data[5] = shoot;
-    gimbal_can_send_data[6] = (rev >> 8);
-    gimbal_can_send_data[7] = rev;
-    HAL_CAN_AddTxMessage(&GIMBAL_CAN, &gimbal_tx_message, gimbal_can_send_data, &send_mail_box);
+    uint8_t data[8];
+    data[0] = (yaw >> 8);
+    data[1] = yaw;
+    data[2] = (pitch >> 8);
+    data[3] = pitch;
+    data[4] = (shoot >> 8);
+    data[5] = shoot;
+    data[6] = (rev >> 8);
+    data[7] = rev;
+    can_tx_post(CAN_TX_GIMBAL_GROUP, data, 0);
 }
 
 /**
@@ -141,21 +780,8 @@ void CAN_cmd_gimbal(int16_t yaw, int16_t pitch, int16_t shoot, int16_t rev)
   */
 void CAN_cmd_chassis_reset_ID(void)
 {
-    uint32_t send_mail_box;
-    chassis_tx_message.StdId = 0x700;
-    chassis_tx_message.IDE = CAN_ID_STD;
-    chassis_tx_message.RTR = CAN_RTR_DATA;
-    chassis_tx_message.DLC = 0x08;
-    chassis_can_send_data[0] = 0;
-    chassis_can_send_data[1] = 0;
-    chassis_can_send_data[2] = 0;
-    chassis_can_send_data[3] = 0;
-    chassis_can_send_data[4] = 0;
-    chassis_can_send_data[5] = 0;
-    chassis_can_send_data[6] = 0;
-    chassis_can_send_data[7] = 0;
-
-    HAL_CAN_AddTxMessage(&CHASSIS_CAN, &chassis_tx_message, chassis_can_send_data, &send_mail_box);
+    static const uint8_t data[8] = {0};
+    can_tx_post(CAN_TX_CHASSIS_RESET_ID_GROUP, data, 1);
 }
 
 
@@ -177,21 +803,72 @@ void CAN_cmd_chassis_reset_ID(void)
   */
 void CAN_cmd_chassis(int16_t motor1, int16_t motor2, int16_t motor3, int16_t motor4)
 {
-    uint32_t send_mail_box;
-    chassis_tx_message.StdId = CAN_CHASSIS_ALL_ID;
-    chassis_tx_message.IDE = CAN_ID_STD;
-    chassis_tx_message.RTR = CAN_RTR_DATA;
-    chassis_tx_message.DLC = 0x08;
-    chassis_can_send_data[0] = motor1 >> 8;
-    chassis_can_send_data[1] = motor1;
-    chassis_can_send_data[2] = motor2 >> 8;
-    chassis_can_send_data[3] = motor2;
-    chassis_can_send_data[4] = motor3 >> 8;
-    chassis_can_send_data[5] = motor3;
-    chassis_can_send_data[6] = motor4 >> 8;
-    chassis_can_send_data[7] = motor4;
-
-    HAL_CAN_AddTxMessage(&CHASSIS_CAN, &chassis_tx_message, chassis_can_send_data, &send_mail_box);
+    uint8_t data[8];
+    data[0] = motor1 >> 8;
+    data[1] = motor1;
+    data[2] = motor2 >> 8;
+    data[3] = motor2;
+    data[4] = motor3 >> 8;
+    data[5] = motor3;
+    data[6] = motor4 >> 8;
+    data[7] = motor4;
+    can_tx_post(CAN_TX_CHASSIS_GROUP, data, 0);
+}
+
+/**
+  * @brief          send a special command to a Damiao motor, enable, disable, save zero or clear error
+  * @param[in]      motor_index: index in CAN_DM_MOTOR_TABLE
+  * @param[in]      cmd: DM_MOTOR_CMD_ENABLE etc.
+  * @retval         none
+  */
+/**
+  * @brief          , ʹ, ʧ, 
+  * @param[in]      motor_index: CAN_DM_MOTOR_TABLEе
+  * @param[in]      cmd: DM_MOTOR_CMD_ENABLE
+  * @retval         none
+  */
+void CAN_cmd_dm_motor(uint8_t motor_index, uint8_t cmd)
+{
+    uint8_t data[8];
+
+    if (motor_index < CAN_DM_MOTOR_INDEX_BASE || motor_index >= CAN_MOTOR_NUM)
+    {
+        return;
+    }
+    dm_motor_pack_cmd(data, cmd);
+    can_tx_post(CAN_TX_DM_GROUP_BASE + motor_index - CAN_DM_MOTOR_INDEX_BASE, data, 1);
+}
+
+/**
+  * @brief          send MIT command to a Damiao motor
+  * @param[in]      motor_index: index in CAN_DM_MOTOR_TABLE
+  * @param[in]      position: target position, rad
+  * @param[in]      velocity: target velocity, rad/s
+  * @param[in]      kp: position gain, [0, 500]
+  * @param[in]      kd: velocity gain, [0, 5]
+  * @param[in]      torque: feedforward torque, N.m
+  * @retval         none
+  */
+/**
+  * @brief          MIT֡
+  * @param[in]      motor_index: CAN_DM_MOTOR_TABLEе
+  * @param[in]      position: Ŀλ, rad
+  * @param[in]      velocity: Ŀٶ, rad/s
+  * @param[in]      kp: λ, [0, 500]
+  * @param[in]      kd: ٶ, [0, 5]
+  * @param[in]      torque: ǰ, N.m
+  * @retval         none
+  */
+void CAN_cmd_dm_mit(uint8_t motor_index, fp32 position, fp32 velocity, fp32 kp, fp32 kd, fp32 torque)
+{
+    uint8_t data[8];
+
+    if (motor_index < CAN_DM_MOTOR_INDEX_BASE || motor_index >= CAN_MOTOR_NUM)
+    {
+        return;
+    }
+    dm_motor_pack_mit(data, &can_motor_cfg[motor_index].dm_range, position, velocity, kp, kd, torque);
+    can_tx_post(CAN_TX_DM_GROUP_BASE + motor_index - CAN_DM_MOTOR_INDEX_BASE, data, 0);
 }
 
 /**
@@ -206,7 +883,7 @@ void CAN_cmd_chassis(int16_t motor1, int16_t motor2, int16_t motor3, int16_t mot
   */
 const motor_measure_t *get_yaw_gimbal_motor_measure_point(void)
 {
-    return &motor_chassis[4];
+    return &motor_chassis[CAN_YAW_MOTOR_INDEX].measure;
 }
 
 /**
@@ -221,7 +898,7 @@ const motor_measure_t *get_yaw_gimbal_motor_measure_point(void)
   */
 const motor_measure_t *get_pitch_gimbal_motor_measure_point(void)
 {
-    return &motor_chassis[5];
+    return &motor_chassis[CAN_PIT_MOTOR_INDEX].measure;
 }
 
 
@@ -237,7 +914,7 @@ const motor_measure_t *get_pitch_gimbal_motor_measure_point(void)
   */
 const motor_measure_t *get_trigger_motor_measure_point(void)
 {
-    return &motor_chassis[6];
+    return &motor_chassis[CAN_TRIGGER_MOTOR_INDEX].measure;
 }
 
 
@@ -253,5 +930,61 @@ const motor_measure_t *get_trigger_motor_measure_point(void)
   */
 const motor_measure_t *get_chassis_motor_measure_point(uint8_t i)
 {
-    return &motor_chassis[(i & 0x03)];
+    return &motor_chassis[(i & 0x03)].measure;
+}
+
+/**
+  * @brief          copy the latest feedback frame of a motor, never torn by the CAN interrupt.
+  *                 the data pointed by get_xxx_measure_point may change while it is read,
+  *                 control loop should use this function once per cycle.
+  * @param[in]      motor_index: motor index, see can_motor_index_e
+  * @param[out]     feedback: the copy of feedback frame
+  * @retval         1: at least one frame has been received, 0: no frame or invalid index
+  */
+/**
+  * @brief          Ƶµһ֡,ᱻCANжд.
+  *                 get_xxx_measure_pointصݿڶȡбд,
+  *                 ѭӦÿڵһα
+  * @param[in]      motor_index: ,can_motor_index_e
+  * @param[out]     feedback: ݸ
+  * @retval         1:Ѿյ, 0:δյݻŴ
+  */
+bool_t get_motor_feedback(uint8_t motor_index, motor_feedback_t *feedback)
+{
+    uint32_t lock;
+    if (feedback == NULL || motor_index >= CAN_MOTOR_NUM)
+    {
+        return 0;
+    }
+
+    //the CAN interrupt cannot be blocked by a task, so retry until the lock is unchanged
+    //CANж,ȡǰֵһ֡
+    do
+    {
+        lock = motor_chassis_lock[motor_index];
+        __DMB();
+        *feedback = motor_chassis[motor_index];
+        __DMB();
+    } while ((lock & 0x01) || lock != motor_chassis_lock[motor_index]);
+
+    return feedback->seq != 0;
+}
+
+/**
+  * @brief          return the age of a feedback frame, unit us
+  * @param[in]      feedback: the copy from get_motor_feedback
+  * @retval         time since the frame was received, unit us
+  */
+/**
+  * @brief          طݵʱ, λ us
+  * @param[in]      feedback: get_motor_feedbackõ
+  * @retval         ո֡ʱ, λ us
+  */
+uint32_t get_motor_feedback_age_us(const motor_feedback_t *feedback)
+{
+    if (feedback == NULL)
+    {
+        return 0;
+    }
+    return dwt_elapsed_us(feedback->rx_cycle);
 }
@@ -0,0 +1,135 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       can_recorder.c/h
+  * @brief      CAN flight recorder, a RAM ring of every rx and tx CAN frame with
+  *             us timestamp. it is frozen and drained by usb_task.
+  *             CAN¼, RAMλм¼ÿһ֡շCANݼusʱ,
+  *             usb_task.
+  * @note       
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *
+  @verbatim
+  ==============================================================================
+  writers are CAN rx interrupt and TIM7 tx stage, a slot is reserved with
+  interrupts masked for a few cycles, then filled without lock.
+  дΪCANжϺTIM7͵, ڶݹжʱԤ¼λ, ֮д.
+  ==============================================================================
+  @endverbatim
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+
+#include "can_recorder.h"
+#include "main.h"
+#include "bsp_dwt.h"
+
+static can_record_t can_record[CAN_RECORDER_SIZE];
+//total records written, the next slot is can_record_head % CAN_RECORDER_SIZE
+//дļ¼
+static volatile uint32_t can_record_head;
+static volatile uint8_t can_record_frozen;
+
+/**
+  * @brief          record a CAN frame, called in CAN rx interrupt and tx stage
+  * @param[in]      bus: CAN_BUS_1 or CAN_BUS_2
+  * @param[in]      dir: CAN_RECORD_RX or CAN_RECORD_TX
+  * @param[in]      std_id: standard ID
+  * @param[in]      dlc: data length, [0,8]
+  * @param[in]      data: frame data
+  * @retval         none
+  */
+/**
+  * @brief          ¼һ֡CAN, CANжϺͷ͵е
+  * @param[in]      bus: CAN_BUS_1  CAN_BUS_2
+  * @param[in]      dir: CAN_RECORD_RX  CAN_RECORD_TX
+  * @param[in]      std_id: ׼ID
+  * @param[in]      dlc: ݳ, [0,8]
+  * @param[in]      data: ֡
+  * @retval         none
+  */
+void can_recorder_write(uint8_t bus, uint8_t dir, uint32_t std_id, uint8_t dlc, const uint8_t *data)
+{
+    can_record_t *record;
+    uint32_t primask;
+    uint32_t index;
+    uint8_t i;
+
+    if (can_record_frozen || data == NULL)
+    {
+        return;
+    }
+    if (dlc > 8)
+    {
+        dlc = 8;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    index = can_record_head++;
+    __set_PRIMASK(primask);
+
+    record = &can_record[index & (CAN_RECORDER_SIZE - 1)];
+    record->time_us = dwt_get_us();
+    record->std_id = (uint16_t)std_id;
+    record->bus = bus;
+    record->dir_dlc = (uint8_t)((dir << 7) | dlc);
+    for (i = 0; i < 8; i++)
+    {
+        record->data[i] = i < dlc ? data[i] : 0;
+    }
+}
+
+/**
+  * @brief          freeze or resume recording, records can be read only when frozen
+  * @param[in]      freeze: 1: freeze, 0: resume
+  * @retval         none
+  */
+/**
+  * @brief          ָ¼, ʱܶȡ¼
+  * @param[in]      freeze: 1: , 0: ָ
+  * @retval         none
+  */
+void can_recorder_freeze(bool_t freeze)
+{
+    can_record_frozen = freeze;
+}
+
+/**
+  * @brief          number of records in the ring
+  * @param[in]      none
+  * @retval         record number, [0, CAN_RECORDER_SIZE]
+  */
+/**
+  * @brief          λеļ¼
+  * @param[in]      none
+  * @retval         ¼, [0, CAN_RECORDER_SIZE]
+  */
+uint16_t can_recorder_count(void)
+{
+    return can_record_head < CAN_RECORDER_SIZE ? can_record_head : CAN_RECORDER_SIZE;
+}
+
+/**
+  * @brief          read a record, 0 is the oldest
+  * @param[in]      n: record order, [0, can_recorder_count())
+  * @param[out]     record: record copy
+  * @retval         1: ok, 0: out of range
+  */
+/**
+  * @brief          ȡһ¼, 0Ϊһ
+  * @param[in]      n: ¼, [0, can_recorder_count())
+  * @param[out]     record: ¼
+  * @retval         1: ɹ, 0: Χ
+  */
+bool_t can_recorder_read(uint16_t n, can_record_t *record)
+{
+    uint16_t count = can_recorder_count();
+
+    if (record == NULL || n >= count)
+    {
+        return 0;
+    }
+    *record = can_record[(can_record_head - count + n) & (CAN_RECORDER_SIZE - 1)];
+    return 1;
+}
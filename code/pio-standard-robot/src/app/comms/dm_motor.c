@@ -0,0 +1,187 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       dm_motor.c/h
+  * @brief      Damiao motor protocol in MIT mode, command packing and feedback decode.
+  *             the frames are sent and received by CAN_receive.c.
+  *             MITģʽЭ, ֡뷴, շCAN_receive.c.
+  * @note       position, velocity and torque ranges must be the same as PMAX, VMAX, TMAX
+  *             set in the motor by the Damiao debug tool.
+  *             λ, ٶ, طΧԹõPMAX, VMAX, TMAXһ.
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *
+  @verbatim
+  ==============================================================================
+
+  ==============================================================================
+  @endverbatim
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+
+#include "dm_motor.h"
+#include "main.h"
+
+/**
+  * @brief          map a float in [x_min, x_max] to an unsigned int of bits
+  * @param[in]      x: value, limited to [x_min, x_max]
+  * @param[in]      x_min: minimum
+  * @param[in]      x_max: maximum
+  * @param[in]      bits: bits of result
+  * @retval         unsigned int value
+  */
+/**
+  * @brief          [x_min, x_max]ڵĸӳΪbitsλ޷
+  * @param[in]      x: ֵ, [x_min, x_max]
+  * @param[in]      x_min: Сֵ
+  * @param[in]      x_max: ֵ
+  * @param[in]      bits: λ
+  * @retval         ޷
+  */
+uint16_t dm_float_to_uint(fp32 x, fp32 x_min, fp32 x_max, uint8_t bits)
+{
+    fp32 span = x_max - x_min;
+
+    if (x < x_min)
+    {
+        x = x_min;
+    }
+    else if (x > x_max)
+    {
+        x = x_max;
+    }
+    return (uint16_t)((x - x_min) * ((fp32)((1 << bits) - 1)) / span);
+}
+
+/**
+  * @brief          map an unsigned int of bits to a float in [x_min, x_max]
+  * @param[in]      x_int: unsigned int value
+  * @param[in]      x_min: minimum
+  * @param[in]      x_max: maximum
+  * @param[in]      bits: bits of x_int
+  * @retval         float value
+  */
+/**
+  * @brief          bitsλ޷ӳΪ[x_min, x_max]ڵĸ
+  * @param[in]      x_int: ޷
+  * @param[in]      x_min: Сֵ
+  * @param[in]      x_max: ֵ
+  * @param[in]      bits: x_intλ
+  * @retval         
+  */
+fp32 dm_uint_to_float(uint16_t x_int, fp32 x_min, fp32 x_max, uint8_t bits)
+{
+    fp32 span = x_max - x_min;
+    return ((fp32)x_int) * span / ((fp32)((1 << bits) - 1)) + x_min;
+}
+
+/**
+  * @brief          pack a MIT command, torque = kp * (position - p) + kd * (velocity - v) + torque
+  * @param[out]     data: 8 bytes of frame data
+  * @param[in]      range: ranges set in the motor
+  * @param[in]      position: target position, rad
+  * @param[in]      velocity: target velocity, rad/s
+  * @param[in]      kp: position gain, [0, 500]
+  * @param[in]      kd: velocity gain, [0, 5]
+  * @param[in]      torque: feedforward torque, N.m
+  * @retval         none
+  */
+/**
+  * @brief          MIT֡,  = kp * (λ - p) + kd * (ٶ - v) + ǰ
+  * @param[out]     data: 8ֽ֡
+  * @param[in]      range: õķΧ
+  * @param[in]      position: Ŀλ, rad
+  * @param[in]      velocity: Ŀٶ, rad/s
+  * @param[in]      kp: λ, [0, 500]
+  * @param[in]      kd: ٶ, [0, 5]
+  * @param[in]      torque: ǰ, N.m
+  * @retval         none
+  */
+void dm_motor_pack_mit(uint8_t data[8], const dm_motor_range_t *range, fp32 position, fp32 velocity, fp32 kp, fp32 kd, fp32 torque)
+{
+    uint16_t p_int, v_int, kp_int, kd_int, t_int;
+
+    if (data == NULL || range == NULL)
+    {
+        return;
+    }
+
+    p_int = dm_float_to_uint(position, -range->p_max, range->p_max, 16);
+    v_int = dm_float_to_uint(velocity, -range->v_max, range->v_max, 12);
+    kp_int = dm_float_to_uint(kp, DM_MIT_KP_MIN, DM_MIT_KP_MAX, 12);
+    kd_int = dm_float_to_uint(kd, DM_MIT_KD_MIN, DM_MIT_KD_MAX, 12);
+    t_int = dm_float_to_uint(torque, -range->t_max, range->t_max, 12);
+
+    data[0] = p_int >> 8;
+    data[1] = p_int;
+    data[2] = v_int >> 4;
+    data[3] = ((v_int & 0x0F) << 4) | (kp_int >> 8);
+    data[4] = kp_int;
+    data[5] = kd_int >> 4;
+    data[6] = ((kd_int & 0x0F) << 4) | (t_int >> 8);
+    data[7] = t_int;
+}
+
+/**
+  * @brief          pack a special command, enable, disable, save zero or clear error
+  * @param[out]     data: 8 bytes of frame data
+  * @param[in]      cmd: DM_MOTOR_CMD_ENABLE etc.
+  * @retval         none
+  */
+/**
+  * @brief          , ʹ, ʧ, 
+  * @param[out]     data: 8ֽ֡
+  * @param[in]      cmd: DM_MOTOR_CMD_ENABLE
+  * @retval         none
+  */
+void dm_motor_pack_cmd(uint8_t data[8], uint8_t cmd)
+{
+    uint8_t i;
+
+    if (data == NULL)
+    {
+        return;
+    }
+
+    for (i = 0; i < 7; i++)
+    {
+        data[i] = 0xFF;
+    }
+    data[7] = cmd;
+}
+
+/**
+  * @brief          decode a feedback frame
+  * @param[out]     measure: motor feedback
+  * @param[in]      range: ranges set in the motor
+  * @param[in]      data: 8 bytes of frame data
+  * @retval         none
+  */
+/**
+  * @brief          뷴֡
+  * @param[out]     measure: 
+  * @param[in]      range: õķΧ
+  * @param[in]      data: 8ֽ֡
+  * @retval         none
+  */
+void dm_motor_decode(dm_motor_measure_t *measure, const dm_motor_range_t *range, const uint8_t data[8])
+{
+    uint16_t p_int, v_int, t_int;
+
+    if (measure == NULL || range == NULL || data == NULL)
+    {
+        return;
+    }
+
+    p_int = (uint16_t)(data[1] << 8 | data[2]);
+    v_int = (uint16_t)(data[3] << 4 | data[4] >> 4);
+    t_int = (uint16_t)((data[4] & 0x0F) << 8 | data[5]);
+
+    measure->id = data[0] & 0x0F;
+    measure->state = data[0] >> 4;
+    measure->position = dm_uint_to_float(p_int, -range->p_max, range->p_max, 16);
+    measure->velocity = dm_uint_to_float(v_int, -range->v_max, range->v_max, 12);
+    measure->torque = dm_uint_to_float(t_int, -range->t_max, range->t_max, 12);
+    measure->t_mos = data[6];
+    measure->t_rotor = data[7];
+}
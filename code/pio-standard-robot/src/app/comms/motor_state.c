@@ -0,0 +1,96 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       motor_state.c/h
+  * @brief      motor state estimator, updated in CAN receive interrupt at frame rate.
+  *             it gives multi-turn position, filtered velocity and acceleration
+  *             of rotor from encoder and speed feedback.
+  *             ״̬, CANж֡, ɱתٷ
+  *             õתӵĶȦλ, ˲ٶȺͼٶ.
+  * @note       
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *  V1.1.0     Oct-16-2026     RM              1. position kept as integer turns and encoder, angle of the last turns by motor_state_angle
+  *
+  @verbatim
+  ==============================================================================
+  velocity is encoder differential speed fused with speed_rpm, then first order
+  low pass filtered with the measured frame interval. acceleration is the
+  differential of the filtered velocity, low pass filtered again.
+  ٶΪٶspeed_rpmں, ʵ֡һ׵ͨ˲.
+  ٶΪ˲ٶȵĲ, һεͨ˲.
+  ==============================================================================
+  @endverbatim
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+
+#include "motor_state.h"
+#include "main.h"
+
+//rpm to rad/s
+#define MOTOR_STATE_RPM_TO_RADS 0.10471975511965977461542144610932f
+
+/**
+  * @brief          update motor state with a feedback frame
+  * @param[out]     state: motor state
+  * @param[in]      ecd: encoder value, [0,8191]
+  * @param[in]      speed_rpm: rotor speed, rpm
+  * @param[in]      dt: time since last frame, unit s, 0 means the first frame
+  * @retval         none
+  */
+/**
+  * @brief          һ֡µ״̬
+  * @param[out]     state: ״̬
+  * @param[in]      ecd: ֵ, [0,8191]
+  * @param[in]      speed_rpm: תٶ, rpm
+  * @param[in]      dt: һ֡ʱ, λ s, 0ʾһ֡
+  * @retval         none
+  */
+void motor_state_update(motor_state_t *state, uint16_t ecd, int16_t speed_rpm, fp32 dt)
+{
+    int32_t delta_ecd;
+    fp32 speed_rpm_rads = speed_rpm * MOTOR_STATE_RPM_TO_RADS;
+    fp32 velocity_raw;
+    fp32 last_velocity;
+
+    if (state == NULL)
+    {
+        return;
+    }
+
+    //first frame or frames lost, restart from this frame
+    //һ֡߶֡, һ֡¿ʼ
+    if (dt <= 0.0f || dt > MOTOR_STATE_DT_MAX)
+    {
+        if (dt <= 0.0f)
+        {
+            state->round = 0;
+        }
+        state->last_ecd = ecd;
+        state->velocity = speed_rpm_rads;
+        state->accel = 0.0f;
+        return;
+    }
+
+    //encoder wrap, count rotor turns
+    //, תȦ
+    delta_ecd = (int32_t)ecd - (int32_t)state->last_ecd;
+    if (delta_ecd > MOTOR_STATE_HALF_ECD_RANGE)
+    {
+        delta_ecd -= MOTOR_STATE_ECD_RANGE;
+        state->round--;
+    }
+    else if (delta_ecd < -MOTOR_STATE_HALF_ECD_RANGE)
+    {
+        delta_ecd += MOTOR_STATE_ECD_RANGE;
+        state->round++;
+    }
+    state->last_ecd = ecd;
+
+    //fuse encoder differential speed and speed_rpm, then low pass filter
+    //ںϱٶspeed_rpm, ٵͨ˲
+    velocity_raw = MOTOR_STATE_ECD_WEIGHT * (delta_ecd * MOTOR_STATE_ECD_TO_RAD / dt) + (1.0f - MOTOR_STATE_ECD_WEIGHT) * speed_rpm_rads;
+    last_velocity = state->velocity;
+    state->velocity += (velocity_raw - state->velocity) * dt / (MOTOR_STATE_VELOCITY_TAU + dt);
+    state->accel += ((state->velocity - last_velocity) / dt - state->accel) * dt / (MOTOR_STATE_ACCEL_TAU + dt);
+}
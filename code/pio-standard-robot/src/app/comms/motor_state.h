@@ -0,0 +1,109 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       motor_state.c/h
+  * @brief      motor state estimator, updated in CAN receive interrupt at frame rate.
+  *             it gives multi-turn position, filtered velocity and acceleration
+  *             of rotor from encoder and speed feedback.
+  *             ״̬, CANж֡, ɱתٷ
+  *             õתӵĶȦλ, ˲ٶȺͼٶ.
+  * @note       
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *  V1.1.0     Oct-16-2026     RM              1. position kept as integer turns and encoder, angle of the last turns by motor_state_angle
+  *
+  @verbatim
+  ==============================================================================
+
+  ==============================================================================
+  @endverbatim
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+
+#ifndef MOTOR_STATE_H
+#define MOTOR_STATE_H
+
+#include "struct_typedef.h"
+
+//encoder value of one rotor turn
+//תһȦıֵ
+#define MOTOR_STATE_ECD_RANGE 8192
+#define MOTOR_STATE_HALF_ECD_RANGE 4096
+
+//encoder value to rad
+//ֵתΪ
+#define MOTOR_STATE_ECD_TO_RAD 0.00076699039394282061485904308358f
+//most turns motor_state_angle keeps to one encoder count, 2^24 / 8192, fp32 has a 24 bit mantissa
+//motor_state_angleȷһֵȦ, 2^24 / 8192, fp32βΪ24λ
+#define MOTOR_STATE_ANGLE_TURNS_MAX 2048
+
+//rotor rad/s to rpm
+//תrad/sתΪrpm
+#define MOTOR_STATE_RADS_TO_RPM 9.5492965855137201461330258023509f
+
+//weight of encoder differential speed in the fused speed, the rest is speed_rpm
+//ںٶбٶȵȨ, Ϊspeed_rpm
+#define MOTOR_STATE_ECD_WEIGHT 0.5f
+//time constant of velocity and acceleration low pass filter, unit s
+//ٶȺͼٶȵͨ˲ʱ䳣, λ s
+#define MOTOR_STATE_VELOCITY_TAU 0.005f
+#define MOTOR_STATE_ACCEL_TAU 0.01f
+//frame interval longer than it restarts the filter, unit s
+//ֵ֡ʱ¿ʼ˲, λ s
+#define MOTOR_STATE_DT_MAX 0.1f
+
+//the multi-turn position is round turns plus last_ecd, both integers, it does not lose resolution
+//over a match. an fp32 angle of it would, so take the angle of the last turns by motor_state_angle.
+//round overflows after 2^31 turns, 74 days at 20000 rpm
+//ȦλΪroundȦlast_ecd, Ϊ, вʧֱ. fp32ǶȻʧ, motor_state_angle
+//ȡȦڵĽǶ. round2^31Ȧ, 20000 rpmʱΪ74
+typedef struct
+{
+    int32_t round;      //rotor turns.תȦ
+    uint16_t last_ecd;  //encoder of the last frame, [0,8191].һֵ֡
+    fp32 velocity;      //filtered rotor speed, rad/s.˲תٶ
+    fp32 accel;         //filtered rotor acceleration, rad/s^2.˲תӼٶ
+} motor_state_t;
+
+/**
+  * @brief          update motor state with a feedback frame
+  * @param[out]     state: motor state
+  * @param[in]      ecd: encoder value, [0,8191]
+  * @param[in]      speed_rpm: rotor speed, rpm
+  * @param[in]      dt: time since last frame, unit s, 0 means the first frame
+  * @retval         none
+  */
+/**
+  * @brief          һ֡µ״̬
+  * @param[out]     state: ״̬
+  * @param[in]      ecd: ֵ, [0,8191]
+  * @param[in]      speed_rpm: תٶ, rpm
+  * @param[in]      dt: һ֡ʱ, λ s, 0ʾһ֡
+  * @retval         none
+  */
+extern void motor_state_update(motor_state_t *state, uint16_t ecd, int16_t speed_rpm, fp32 dt);
+
+/**
+  * @brief          rotor angle within the last turns, round mod turns plus the encoder,
+  *                 in integers before the one conversion to rad
+  * @param[in]      state: motor state
+  * @param[in]      turns: turns of the range, [1, MOTOR_STATE_ANGLE_TURNS_MAX]
+  * @retval         angle, [0, turns * 2pi), unit rad
+  */
+/**
+  * @brief          תȦڵĽǶ, roundturnsȡģټӱֵ, תΪ
+  * @param[in]      state: ״̬
+  * @param[in]      turns: ΧȦ, [1, MOTOR_STATE_ANGLE_TURNS_MAX]
+  * @retval         Ƕ, [0, turns * 2pi), λ rad
+  */
+static __inline fp32 motor_state_angle(const motor_state_t *state, int32_t turns)
+{
+    int32_t round = state->round % turns;
+    if (round < 0)
+    {
+        round += turns;
+    }
+    return (fp32)(round * MOTOR_STATE_ECD_RANGE + state->last_ecd) * MOTOR_STATE_ECD_TO_RAD;
+}
+
+#endif
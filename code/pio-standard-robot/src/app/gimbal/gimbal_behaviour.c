@@ -16,6 +16,7 @@
   *  Version    Date            Author          Modification
   *  V1.0.0     Dec-26-2018     RM              1. done
   *  V1.1.0     Nov-11-2019     RM              1. add some annotation
+  *  V1.2.0     Oct-16-2026     RM              1. GIMBAL_TUNE, relay feedback pid auto-tune
   *
   @verbatim
   ==============================================================================
@@ -221,6 +222,24 @@ static void gimbal_init_control(fp32 *yaw, fp32 *pitch, gimbal_control_t *gimbal
   */
 static void gimbal_cali_control(fp32 *yaw, fp32 *pitch, gimbal_control_t *gimbal_control_set);
 
+/**
+  * @brief          when gimbal behaviour mode is GIMBAL_TUNE, the function is called.
+  *                 the tuned axis is driven by the relay in gimbal_task, the other
+  *                 one keeps its relative angle.
+  * @param[out]     yaw: yaw axia relative angle increment, unit rad
+  * @param[out]     pitch: pitch axia relative angle increment, unit rad
+  * @param[in]      gimbal_control_set: gimbal data
+  * @retval         none
+  */
+/**
+  * @brief          ̨pidƣgimbal_taskеļ̵ƣһᱣԽǶ
+  * @param[out]     yaw: yawԽǶ λ rad
+  * @param[out]     pitch: pitchԽǶ λ rad
+  * @param[in]      gimbal_control_set:ָ̨
+  * @retval         none
+  */
+static void gimbal_tune_control(fp32 *yaw, fp32 *pitch, gimbal_control_t *gimbal_control_set);
+
 /**
   * @brief          when gimbal behaviour mode is GIMBAL_ABSOLUTE_ANGLE, the function is called
   *                 and gimbal control mode is gyro mode. 
@@ -330,6 +349,19 @@ void gimbal_behaviour_mode_set(gimbal_control_t *gimbal_mode_set)
         gimbal_mode_set->gimbal_yaw_motor.gimbal_motor_mode = GIMBAL_MOTOR_ENCONDE;
         gimbal_mode_set->gimbal_pitch_motor.gimbal_motor_mode = GIMBAL_MOTOR_ENCONDE;
     }
+    else if (gimbal_behaviour == GIMBAL_TUNE)
+    {
+        gimbal_mode_set->gimbal_yaw_motor.gimbal_motor_mode = GIMBAL_MOTOR_ENCONDE;
+        gimbal_mode_set->gimbal_pitch_motor.gimbal_motor_mode = GIMBAL_MOTOR_ENCONDE;
+        if (gimbal_mode_set->gimbal_tune.loop == PID_TUNE_YAW_SPEED)
+        {
+            gimbal_mode_set->gimbal_yaw_motor.gimbal_motor_mode = GIMBAL_MOTOR_TUNE;
+        }
+        else if (gimbal_mode_set->gimbal_tune.loop == PID_TUNE_PITCH_SPEED)
+        {
+            gimbal_mode_set->gimbal_pitch_motor.gimbal_motor_mode = GIMBAL_MOTOR_TUNE;
+        }
+    }
 }
 
 /**
@@ -380,6 +412,10 @@ void gimbal_behaviour_control_set(fp32 *add_yaw, fp32 *add_pitch, gimbal_control
     {
         gimbal_motionless_control(add_yaw, add_pitch, gimbal_control_set);
     }
+    else if (gimbal_behaviour == GIMBAL_TUNE)
+    {
+        gimbal_tune_control(add_yaw, add_pitch, gimbal_control_set);
+    }
 
 }
 
@@ -396,7 +432,7 @@ void gimbal_behaviour_control_set(fp32 *add_yaw, fp32 *add_pitch, gimbal_control
 
 bool_t gimbal_cmd_to_chassis_stop(void)
 {
-    if (gimbal_behaviour == GIMBAL_INIT || gimbal_behaviour == GIMBAL_CALI || gimbal_behaviour == GIMBAL_MOTIONLESS || gimbal_behaviour == GIMBAL_ZERO_FORCE)
+    if (gimbal_behaviour == GIMBAL_INIT || gimbal_behaviour == GIMBAL_CALI || gimbal_behaviour == GIMBAL_MOTIONLESS || gimbal_behaviour == GIMBAL_ZERO_FORCE || gimbal_behaviour == GIMBAL_TUNE)
     {
         return 1;
     }
@@ -419,7 +455,7 @@ bool_t gimbal_cmd_to_chassis_stop(void)
 
 bool_t gimbal_cmd_to_shoot_stop(void)
 {
-    if (gimbal_behaviour == GIMBAL_INIT || gimbal_behaviour == GIMBAL_CALI || gimbal_behaviour == GIMBAL_ZERO_FORCE)
+    if (gimbal_behaviour == GIMBAL_INIT || gimbal_behaviour == GIMBAL_CALI || gimbal_behaviour == GIMBAL_ZERO_FORCE || gimbal_behaviour == GIMBAL_TUNE)
     {
         return 1;
     }
@@ -459,6 +495,19 @@ static void gimbal_behavour_set(gimbal_control_t *gimbal_mode_set)
         gimbal_behaviour = GIMBAL_CALI;
         return;
     }
+    //in pid auto-tune mode, return
+    //pidΪreturn ģʽ
+    if (gimbal_behaviour == GIMBAL_TUNE && gimbal_mode_set->gimbal_tune.step != GIMBAL_TUNE_END_STEP)
+    {
+        return;
+    }
+    //if other operate make tune step change to start, means enter pid auto-tune mode
+    //ⲿʹ0  startpidģʽ
+    if (gimbal_mode_set->gimbal_tune.step == GIMBAL_TUNE_START_STEP && !toe_is_error(DBUS_TOE))
+    {
+        gimbal_behaviour = GIMBAL_TUNE;
+        return;
+    }
 
     //init mode, judge if gimbal is in middle place
     //ʼģʽжǷ񵽴ֵλ
@@ -668,6 +717,32 @@ static void gimbal_cali_control(fp32 *yaw, fp32 *pitch, gimbal_control_t *gimbal
     }
 }
 
+/**
+  * @brief          when gimbal behaviour mode is GIMBAL_TUNE, the function is called.
+  *                 the tuned axis is driven by the relay in gimbal_task, the other
+  *                 one keeps its relative angle.
+  * @param[out]     yaw: yaw axia relative angle increment, unit rad
+  * @param[out]     pitch: pitch axia relative angle increment, unit rad
+  * @param[in]      gimbal_control_set: gimbal data
+  * @retval         none
+  */
+/**
+  * @brief          ̨pidƣgimbal_taskеļ̵ƣһᱣԽǶ
+  * @param[out]     yaw: yawԽǶ λ rad
+  * @param[out]     pitch: pitchԽǶ λ rad
+  * @param[in]      gimbal_control_set:ָ̨
+  * @retval         none
+  */
+static void gimbal_tune_control(fp32 *yaw, fp32 *pitch, gimbal_control_t *gimbal_control_set)
+{
+    if (yaw == NULL || pitch == NULL || gimbal_control_set == NULL)
+    {
+        return;
+    }
+    *yaw = 0.0f;
+    *pitch = 0.0f;
+}
+
 
 /**
   * @brief          when gimbal behaviour mode is GIMBAL_ABSOLUTE_ANGLE, the function is called
@@ -16,6 +16,17 @@
   *  Version    Date            Author          Modification
   *  V1.0.0     Dec-26-2018     RM              1. done
   *  V1.1.0     Nov-11-2019     RM              1. add some annotation
+  *  V1.2.0     Oct-16-2026     RM              1. use one INS snapshot per control cycle
+  *  V1.3.0     Oct-16-2026     RM              1. option to run at every INS sample
+  *  V1.4.0     Oct-16-2026     RM              1. attitude from RM IMU module when enabled
+  *  V1.5.0     Oct-16-2026     RM              1. angle loops on the pid of pid.c, real dt
+  *  V1.6.0     Oct-16-2026     RM              1. relay feedback pid auto-tune of the speed loops and trigger
+  *  V1.7.0     Oct-16-2026     RM              1. lqr with gravity feedforward for pitch, chosen at compile time
+  *  V1.8.0     Oct-16-2026     RM              1. adrc option of yaw and pitch, the law of each axis chosen at compile time
+  *  V1.9.0     Oct-16-2026     RM              1. sign of the angle loop KD made explicit
+  *  V1.10.0    Oct-16-2026     RM              1. pid flags and KD sign moved to gimbal_task.h for the host simulation
+  *  V1.11.0    Oct-16-2026     RM              1. motor rate of the encoder fed to the adrc observer
+  *  V1.12.0    Oct-16-2026     RM              1. relay tune from the gravity feedforward, stopped when it does not switch
   *
   @verbatim
   ==============================================================================
@@ -35,9 +46,11 @@
 #include "CAN_receive.h"
 #include "user_lib.h"
 #include "detect_task.h"
+#include "bsp_dwt.h"
 #include "remote_control.h"
 #include "gimbal_behaviour.h"
 #include "INS_task.h"
+#include "rm_imu.h"
 #include "shoot.h"
 #include "pid.h"
 
@@ -54,13 +67,18 @@
 
 #define gimbal_total_pid_clear(gimbal_clear)                                                   \
     {                                                                                          \
-        gimbal_PID_clear(&(gimbal_clear)->gimbal_yaw_motor.gimbal_motor_absolute_angle_pid);   \
-        gimbal_PID_clear(&(gimbal_clear)->gimbal_yaw_motor.gimbal_motor_relative_angle_pid);   \
+        PID_clear(&(gimbal_clear)->gimbal_yaw_motor.gimbal_motor_absolute_angle_pid);          \
+        PID_clear(&(gimbal_clear)->gimbal_yaw_motor.gimbal_motor_relative_angle_pid);          \
         PID_clear(&(gimbal_clear)->gimbal_yaw_motor.gimbal_motor_gyro_pid);                    \
                                                                                                \
-        gimbal_PID_clear(&(gimbal_clear)->gimbal_pitch_motor.gimbal_motor_absolute_angle_pid); \
-        gimbal_PID_clear(&(gimbal_clear)->gimbal_pitch_motor.gimbal_motor_relative_angle_pid); \
+        PID_clear(&(gimbal_clear)->gimbal_pitch_motor.gimbal_motor_absolute_angle_pid);        \
+        PID_clear(&(gimbal_clear)->gimbal_pitch_motor.gimbal_motor_relative_angle_pid);        \
         PID_clear(&(gimbal_clear)->gimbal_pitch_motor.gimbal_motor_gyro_pid);                  \
+                                                                                               \
+        LQR_clear(&(gimbal_clear)->gimbal_yaw_motor.gimbal_motor_lqr);                         \
+        LQR_clear(&(gimbal_clear)->gimbal_pitch_motor.gimbal_motor_lqr);                       \
+        ADRC_clear(&(gimbal_clear)->gimbal_yaw_motor.gimbal_motor_adrc);                       \
+        ADRC_clear(&(gimbal_clear)->gimbal_pitch_motor.gimbal_motor_adrc);                     \
     }
 
 #if INCLUDE_uxTaskGetStackHighWaterMark
@@ -157,25 +175,29 @@ static void gimbal_control_loop(gimbal_control_t *control_loop);
 /**
   * @brief          gimbal control mode :GIMBAL_MOTOR_GYRO, use euler angle calculated by gyro sensor to control. 
   * @param[out]     gimbal_motor: yaw motor or pitch motor
+  * @param[in]      dt: control period, unit s
   * @retval         none
   */
 /**
   * @brief          ̨ģʽ:GIMBAL_MOTOR_GYROʹǼŷǽп
   * @param[out]     gimbal_motor:yawpitch
+  * @param[in]      dt:  λ s
   * @retval         none
   */
-static void gimbal_motor_absolute_angle_control(gimbal_motor_t *gimbal_motor);
+static void gimbal_motor_absolute_angle_control(gimbal_motor_t *gimbal_motor, fp32 dt);
 /**
   * @brief          gimbal control mode :GIMBAL_MOTOR_ENCONDE, use the encode relative angle  to control. 
   * @param[out]     gimbal_motor: yaw motor or pitch motor
+  * @param[in]      dt: control period, unit s
   * @retval         none
   */
 /**
   * @brief          ̨ģʽ:GIMBAL_MOTOR_ENCONDEʹñԽǽп
   * @param[out]     gimbal_motor:yawpitch
+  * @param[in]      dt:  λ s
   * @retval         none
   */
-static void gimbal_motor_relative_angle_control(gimbal_motor_t *gimbal_motor);
+static void gimbal_motor_relative_angle_control(gimbal_motor_t *gimbal_motor, fp32 dt);
 /**
   * @brief          gimbal control mode :GIMBAL_MOTOR_RAW, current  is sent to CAN bus. 
   * @param[out]     gimbal_motor: yaw motor or pitch motor
@@ -188,78 +210,79 @@ static void gimbal_motor_relative_angle_control(gimbal_motor_t *gimbal_motor);
   */
 static void gimbal_motor_raw_angle_control(gimbal_motor_t *gimbal_motor);
 /**
-  * @brief          limit angle set in GIMBAL_MOTOR_GYRO mode, avoid exceeding the max angle
+  * @brief          gravity feedforward of GIMBAL_LAW_LQR, by the INS angle of the axis
+  * @param[in]      gimbal_motor: yaw motor or pitch motor
+  * @retval         current
+  */
+/**
+  * @brief          GIMBAL_LAW_LQRǰ, ɸINSǶȼ
+  * @param[in]      gimbal_motor:yawpitch
+  * @retval         ֵ
+  */
+static fp32 gimbal_gravity_feedforward(const gimbal_motor_t *gimbal_motor);
+/**
+  * @brief          gimbal control mode :GIMBAL_MOTOR_TUNE, the relay of the pid auto-tune
+  *                 takes the place of the speed loop, set 0.
   * @param[out]     gimbal_motor: yaw motor or pitch motor
+  * @param[out]     tune: relay tune point
+  * @param[in]      dt: control period, unit s
   * @retval         none
   */
 /**
-  * @brief          GIMBAL_MOTOR_GYROģʽƽǶ趨,ֹ
+  * @brief          ̨ģʽ:GIMBAL_MOTOR_TUNEpidļ̵ٶȻ, 趨ֵΪ0.
   * @param[out]     gimbal_motor:yawpitch
+  * @param[out]     tune: ̵ṹָ
+  * @param[in]      dt:  λ s
   * @retval         none
   */
-static void gimbal_absolute_angle_limit(gimbal_motor_t *gimbal_motor, fp32 add);
+static void gimbal_motor_tune_control(gimbal_motor_t *gimbal_motor, relay_tune_t *tune, fp32 dt);
 /**
-  * @brief          limit angle set in GIMBAL_MOTOR_ENCONDE mode, avoid exceeding the max angle
-  * @param[out]     gimbal_motor: yaw motor or pitch motor
+  * @brief          pid auto-tune steps: start the relay, stop it when it ends or
+  *                 is not safe, then take the gains
+  * @param[out]     tune_update: "gimbal_control" valiable point
   * @retval         none
   */
 /**
-  * @brief          GIMBAL_MOTOR_ENCONDEģʽƽǶ趨,ֹ
-  * @param[out]     gimbal_motor:yawpitch
+  * @brief          pid: ʼ̵ʵ, 򲻰ȫʱֹͣ, ȻʹõõĲ
+  * @param[out]     tune_update:"gimbal_control"ָ.
   * @retval         none
   */
-static void gimbal_relative_angle_limit(gimbal_motor_t *gimbal_motor, fp32 add);
-
+static void gimbal_tune_update(gimbal_control_t *tune_update);
 /**
-  * @brief          gimbal angle pid init, because angle is in range(-pi,pi),can't use PID in pid.c
-  * @param[out]     pid: pid data pointer stucture
-  * @param[in]      maxout: pid max out
-  * @param[in]      intergral_limit: pid max iout
-  * @param[in]      kp: pid kp
-  * @param[in]      ki: pid ki
-  * @param[in]      kd: pid kd
+  * @brief          use the tuned gains of a loop, nothing if its kp is 0
+  * @param[out]     apply: "gimbal_control" valiable point
+  * @param[in]      loop: PID_TUNE_YAW_SPEED, PID_TUNE_PITCH_SPEED or PID_TUNE_TRIGGER
   * @retval         none
   */
 /**
-  * @brief          ̨ǶPIDʼ, ΪǶȷΧ(-pi,pi)PID.cPID
-  * @param[out]     pid:̨PIDָ
-  * @param[in]      maxout: pid
-  * @param[in]      intergral_limit: pid
-  * @param[in]      kp: pid kp
-  * @param[in]      ki: pid ki
-  * @param[in]      kd: pid kd
+  * @brief          ʹһ·Ĳ, kpΪ0ʱ
+  * @param[out]     apply:"gimbal_control"ָ.
+  * @param[in]      loop: PID_TUNE_YAW_SPEED, PID_TUNE_PITCH_SPEED  PID_TUNE_TRIGGER
   * @retval         none
   */
-static void gimbal_PID_init(gimbal_PID_t *pid, fp32 maxout, fp32 intergral_limit, fp32 kp, fp32 ki, fp32 kd);
-
+static void gimbal_tune_apply(gimbal_control_t *apply, uint8_t loop);
 /**
-  * @brief          gimbal PID clear, clear pid.out, iout.
-  * @param[out]     pid_clear: "gimbal_control" valiable point
+  * @brief          limit angle set in GIMBAL_MOTOR_GYRO mode, avoid exceeding the max angle
+  * @param[out]     gimbal_motor: yaw motor or pitch motor
   * @retval         none
   */
 /**
-  * @brief          ̨PIDpidout,iout
-  * @param[out]     pid_clear:"gimbal_control"ָ.
+  * @brief          GIMBAL_MOTOR_GYROģʽƽǶ趨,ֹ
+  * @param[out]     gimbal_motor:yawpitch
   * @retval         none
   */
-static void gimbal_PID_clear(gimbal_PID_t *pid_clear);
+static void gimbal_absolute_angle_limit(gimbal_motor_t *gimbal_motor, fp32 add);
 /**
-  * @brief          gimbal angle pid calc, because angle is in range(-pi,pi),can't use PID in pid.c
-  * @param[out]     pid: pid data pointer stucture
-  * @param[in]      get: angle feeback
-  * @param[in]      set: angle set-point
-  * @param[in]      error_delta: rotation speed
-  * @retval         pid out
+  * @brief          limit angle set in GIMBAL_MOTOR_ENCONDE mode, avoid exceeding the max angle
+  * @param[out]     gimbal_motor: yaw motor or pitch motor
+  * @retval         none
   */
 /**
-  * @brief          ̨ǶPID, ΪǶȷΧ(-pi,pi)PID.cPID
-  * @param[out]     pid:̨PIDָ
-  * @param[in]      get: Ƕȷ
-  * @param[in]      set: Ƕ趨
-  * @param[in]      error_delta: ٶ
-  * @retval         pid 
+  * @brief          GIMBAL_MOTOR_ENCONDEģʽƽǶ趨,ֹ
+  * @param[out]     gimbal_motor:yawpitch
+  * @retval         none
   */
-static fp32 gimbal_PID_calc(gimbal_PID_t *pid, fp32 get, fp32 set, fp32 error_delta);
+static void gimbal_relative_angle_limit(gimbal_motor_t *gimbal_motor, fp32 add);
 
 /**
   * @brief          gimbal calibration calculate
@@ -324,6 +347,12 @@ void gimbal_task(void const *pvParameters)
     //shoot init
     //ʼ
     shoot_init();
+    //gains of the pid auto-tune saved in flash
+    //flashбpid
+    for (uint8_t i = 0; i < PID_TUNE_LOOP_NUM; i++)
+    {
+        gimbal_tune_apply(&gimbal_control, i);
+    }
     //wait for all motor online
     //жϵǷ
     while (toe_is_error(YAW_GIMBAL_MOTOR_TOE) || toe_is_error(PITCH_GIMBAL_MOTOR_TOE))
@@ -354,6 +383,7 @@ void gimbal_task(void const *pvParameters)
 
         if (!(toe_is_error(YAW_GIMBAL_MOTOR_TOE) && toe_is_error(PITCH_GIMBAL_MOTOR_TOE) && toe_is_error(TRIGGER_MOTOR_TOE)))
         {
+            CAN_tx_mark(CAN_TX_GIMBAL_GROUP, gimbal_control.gimbal_INS.sample_cycle);
             if (toe_is_error(DBUS_TOE))
             {
                 CAN_cmd_gimbal(0, 0, 0, 0);
@@ -362,13 +392,22 @@ void gimbal_task(void const *pvParameters)
             {
                 CAN_cmd_gimbal(yaw_can_set_current, pitch_can_set_current, shoot_can_set_current, 0);
             }
+#if GIMBAL_IMU_TRIGGER
+            CAN_tx_now(CAN_TX_GIMBAL_GROUP);
+#endif
         }
 
 #if GIMBAL_TEST_MODE
         J_scope_gimbal_test();
 #endif
 
+#if GIMBAL_IMU_TRIGGER
+        //wait for the sample after the one just used
+        //ȴ֮һβ
+        INS_wait_snapshot(&gimbal_control.gimbal_INS, gimbal_control.gimbal_INS.seq, GIMBAL_IMU_TRIGGER_TIMEOUT);
+#else
         vTaskDelay(GIMBAL_CONTROL_TIME);
+#endif
 
 #if INCLUDE_uxTaskGetStackHighWaterMark
         gimbal_high_water = uxTaskGetStackHighWaterMark(NULL);
@@ -469,6 +508,77 @@ bool_t cmd_cali_gimbal_hook(uint16_t *yaw_offset, uint16_t *pitch_offset, fp32 *
     }
 }
 
+/**
+  * @brief          pid auto-tune of a loop, called by calibrate_task until it returns 1
+  * @param[in]      loop: PID_TUNE_YAW_SPEED, PID_TUNE_PITCH_SPEED or PID_TUNE_TRIGGER
+  * @param[out]     kp: Kp found, not changed if it fails
+  * @param[out]     ki: Ki found, unit 1/s, not changed if it fails
+  * @retval         1: ended, 0: running
+  */
+/**
+  * @brief          һ·pid, calibrate_taskֱ1
+  * @param[in]      loop: PID_TUNE_YAW_SPEED, PID_TUNE_PITCH_SPEED  PID_TUNE_TRIGGER
+  * @param[out]     kp: õKp, ʧʱ
+  * @param[out]     ki: õKi λ 1/s, ʧʱ
+  * @retval         1: , 0: 
+  * @waring         ʹõgimbal_control ̬ºָͨ븴
+  */
+bool_t cmd_cali_pid_tune_hook(uint8_t loop, fp32 *kp, fp32 *ki)
+{
+    if (loop >= PID_TUNE_LOOP_NUM || kp == NULL || ki == NULL)
+    {
+        return 1;
+    }
+
+    if (gimbal_control.gimbal_tune.step == 0)
+    {
+        gimbal_control.gimbal_tune.loop = loop;
+        __DMB();
+        gimbal_control.gimbal_tune.step = GIMBAL_TUNE_START_STEP;
+        return 0;
+    }
+    else if (gimbal_control.gimbal_tune.step == GIMBAL_TUNE_END_STEP)
+    {
+        __DMB();
+        if (gimbal_control.gimbal_tune.relay.state == RELAY_TUNE_DONE)
+        {
+            *kp = gimbal_control.gimbal_tune.kp[loop];
+            *ki = gimbal_control.gimbal_tune.ki[loop];
+        }
+        gimbal_control.gimbal_tune.step = 0;
+        return 1;
+    }
+    else
+    {
+        return 0;
+    }
+}
+
+/**
+  * @brief          set the tuned gains of a loop, called before gimbal_task starts
+  * @param[in]      loop: PID_TUNE_YAW_SPEED, PID_TUNE_PITCH_SPEED or PID_TUNE_TRIGGER
+  * @param[in]      kp: Kp, 0 keeps the define
+  * @param[in]      ki: Ki, unit 1/s
+  * @retval         none
+  */
+/**
+  * @brief          һ·Ĳ, gimbal_taskʼǰ
+  * @param[in]      loop: PID_TUNE_YAW_SPEED, PID_TUNE_PITCH_SPEED  PID_TUNE_TRIGGER
+  * @param[in]      kp: Kp, Ϊ0ʱʹú궨
+  * @param[in]      ki: Ki λ 1/s
+  * @retval         none
+  * @waring         ʹõgimbal_control ̬ºָͨ븴
+  */
+void set_cali_pid_tune_hook(uint8_t loop, fp32 kp, fp32 ki)
+{
+    if (loop >= PID_TUNE_LOOP_NUM)
+    {
+        return;
+    }
+    gimbal_control.gimbal_tune.kp[loop] = kp;
+    gimbal_control.gimbal_tune.ki[loop] = ki;
+}
+
 /**
   * @brief          calc motor offset encode, max and min relative angle
   * @param[out]     yaw_offse:yaw middle place encode
@@ -639,27 +749,47 @@ const gimbal_motor_t *get_pitch_motor_point(void)
 static void gimbal_init(gimbal_control_t *init)
 {
 
-    static const fp32 Pitch_speed_pid[3] = {PITCH_SPEED_PID_KP, PITCH_SPEED_PID_KI, PITCH_SPEED_PID_KD};
-    static const fp32 Yaw_speed_pid[3] = {YAW_SPEED_PID_KP, YAW_SPEED_PID_KI, YAW_SPEED_PID_KD};
+    static const pid_config_t yaw_absolute_angle_pid = {YAW_GYRO_ABSOLUTE_PID_KP, YAW_GYRO_ABSOLUTE_PID_KI / GIMBAL_CONTROL_TIME_S, GIMBAL_ANGLE_PID_KD_SIGN * YAW_GYRO_ABSOLUTE_PID_KD,
+                                                        YAW_GYRO_ABSOLUTE_PID_MAX_OUT, YAW_GYRO_ABSOLUTE_PID_MAX_IOUT, 0.0f, 0.0f};
+    static const pid_config_t yaw_relative_angle_pid = {YAW_ENCODE_RELATIVE_PID_KP, YAW_ENCODE_RELATIVE_PID_KI / GIMBAL_CONTROL_TIME_S, GIMBAL_ANGLE_PID_KD_SIGN * YAW_ENCODE_RELATIVE_PID_KD,
+                                                        YAW_ENCODE_RELATIVE_PID_MAX_OUT, YAW_ENCODE_RELATIVE_PID_MAX_IOUT, 0.0f, 0.0f};
+    static const pid_config_t pitch_absolute_angle_pid = {PITCH_GYRO_ABSOLUTE_PID_KP, PITCH_GYRO_ABSOLUTE_PID_KI / GIMBAL_CONTROL_TIME_S, GIMBAL_ANGLE_PID_KD_SIGN * PITCH_GYRO_ABSOLUTE_PID_KD,
+                                                          PITCH_GYRO_ABSOLUTE_PID_MAX_OUT, PITCH_GYRO_ABSOLUTE_PID_MAX_IOUT, 0.0f, 0.0f};
+    static const pid_config_t pitch_relative_angle_pid = {PITCH_ENCODE_RELATIVE_PID_KP, PITCH_ENCODE_RELATIVE_PID_KI / GIMBAL_CONTROL_TIME_S, GIMBAL_ANGLE_PID_KD_SIGN * PITCH_ENCODE_RELATIVE_PID_KD,
+                                                          PITCH_ENCODE_RELATIVE_PID_MAX_OUT, PITCH_ENCODE_RELATIVE_PID_MAX_IOUT, 0.0f, 0.0f};
+    //Kaw = Ki / Kp, I is bled back at the integral time once PID_ANTI_WINDUP is added
+    //Kaw = Ki / Kp, PID_ANTI_WINDUPԻʱ䷴
+    static const pid_config_t yaw_speed_pid = {YAW_SPEED_PID_KP, YAW_SPEED_PID_KI / GIMBAL_CONTROL_TIME_S, YAW_SPEED_PID_KD * GIMBAL_CONTROL_TIME_S,
+                                               YAW_SPEED_PID_MAX_OUT, YAW_SPEED_PID_MAX_IOUT, YAW_SPEED_PID_KI / YAW_SPEED_PID_KP / GIMBAL_CONTROL_TIME_S, 0.0f};
+    static const pid_config_t pitch_speed_pid = {PITCH_SPEED_PID_KP, PITCH_SPEED_PID_KI / GIMBAL_CONTROL_TIME_S, PITCH_SPEED_PID_KD * GIMBAL_CONTROL_TIME_S,
+                                                 PITCH_SPEED_PID_MAX_OUT, PITCH_SPEED_PID_MAX_IOUT, PITCH_SPEED_PID_KI / PITCH_SPEED_PID_KP / GIMBAL_CONTROL_TIME_S, 0.0f};
+    static const lqr_config_t pitch_lqr = {PITCH_LQR_K_ANGLE, PITCH_LQR_K_RATE, PITCH_LQR_K_I, PITCH_LQR_MAX_OUT, PITCH_LQR_MAX_IOUT, PITCH_LQR_I_BAND};
+    static const adrc_config_t yaw_adrc = {YAW_ADRC_B0, YAW_ADRC_WC, YAW_ADRC_WO, YAW_ADRC_C, YAW_ADRC_MAX_OUT};
+    static const adrc_config_t pitch_adrc = {PITCH_ADRC_B0, PITCH_ADRC_WC, PITCH_ADRC_WO, PITCH_ADRC_C, PITCH_ADRC_MAX_OUT};
     //ָȡ
-    init->gimbal_yaw_motor.gimbal_motor_measure = get_yaw_gimbal_motor_measure_point();
-    init->gimbal_pitch_motor.gimbal_motor_measure = get_pitch_gimbal_motor_measure_point();
-    //ָȡ
-    init->gimbal_INT_angle_point = get_INS_angle_point();
-    init->gimbal_INT_gyro_point = get_gyro_data_point();
+    init->gimbal_yaw_motor.gimbal_motor_measure = &init->gimbal_yaw_motor.gimbal_motor_feedback.measure;
+    init->gimbal_pitch_motor.gimbal_motor_measure = &init->gimbal_pitch_motor.gimbal_motor_feedback.measure;
     //ңָȡ
     init->gimbal_rc_ctrl = get_remote_control_point();
     //ʼģʽ
     init->gimbal_yaw_motor.gimbal_motor_mode = init->gimbal_yaw_motor.last_gimbal_motor_mode = GIMBAL_MOTOR_RAW;
     init->gimbal_pitch_motor.gimbal_motor_mode = init->gimbal_pitch_motor.last_gimbal_motor_mode = GIMBAL_MOTOR_RAW;
     //ʼyawpid
-    gimbal_PID_init(&init->gimbal_yaw_motor.gimbal_motor_absolute_angle_pid, YAW_GYRO_ABSOLUTE_PID_MAX_OUT, YAW_GYRO_ABSOLUTE_PID_MAX_IOUT, YAW_GYRO_ABSOLUTE_PID_KP, YAW_GYRO_ABSOLUTE_PID_KI, YAW_GYRO_ABSOLUTE_PID_KD);
-    gimbal_PID_init(&init->gimbal_yaw_motor.gimbal_motor_relative_angle_pid, YAW_ENCODE_RELATIVE_PID_MAX_OUT, YAW_ENCODE_RELATIVE_PID_MAX_IOUT, YAW_ENCODE_RELATIVE_PID_KP, YAW_ENCODE_RELATIVE_PID_KI, YAW_ENCODE_RELATIVE_PID_KD);
-    PID_init(&init->gimbal_yaw_motor.gimbal_motor_gyro_pid, PID_POSITION, Yaw_speed_pid, YAW_SPEED_PID_MAX_OUT, YAW_SPEED_PID_MAX_IOUT);
+    PID_init(&init->gimbal_yaw_motor.gimbal_motor_absolute_angle_pid, &yaw_absolute_angle_pid);
+    PID_init(&init->gimbal_yaw_motor.gimbal_motor_relative_angle_pid, &yaw_relative_angle_pid);
+    PID_init(&init->gimbal_yaw_motor.gimbal_motor_gyro_pid, &yaw_speed_pid);
     //ʼpitchpid
-    gimbal_PID_init(&init->gimbal_pitch_motor.gimbal_motor_absolute_angle_pid, PITCH_GYRO_ABSOLUTE_PID_MAX_OUT, PITCH_GYRO_ABSOLUTE_PID_MAX_IOUT, PITCH_GYRO_ABSOLUTE_PID_KP, PITCH_GYRO_ABSOLUTE_PID_KI, PITCH_GYRO_ABSOLUTE_PID_KD);
-    gimbal_PID_init(&init->gimbal_pitch_motor.gimbal_motor_relative_angle_pid, PITCH_ENCODE_RELATIVE_PID_MAX_OUT, PITCH_ENCODE_RELATIVE_PID_MAX_IOUT, PITCH_ENCODE_RELATIVE_PID_KP, PITCH_ENCODE_RELATIVE_PID_KI, PITCH_ENCODE_RELATIVE_PID_KD);
-    PID_init(&init->gimbal_pitch_motor.gimbal_motor_gyro_pid, PID_POSITION, Pitch_speed_pid, PITCH_SPEED_PID_MAX_OUT, PITCH_SPEED_PID_MAX_IOUT);
+    PID_init(&init->gimbal_pitch_motor.gimbal_motor_absolute_angle_pid, &pitch_absolute_angle_pid);
+    PID_init(&init->gimbal_pitch_motor.gimbal_motor_relative_angle_pid, &pitch_relative_angle_pid);
+    PID_init(&init->gimbal_pitch_motor.gimbal_motor_gyro_pid, &pitch_speed_pid);
+    //
+    init->gimbal_yaw_motor.control_law = YAW_CONTROL_LAW;
+    init->gimbal_pitch_motor.control_law = PITCH_CONTROL_LAW;
+    LQR_init(&init->gimbal_pitch_motor.gimbal_motor_lqr, &pitch_lqr);
+    ADRC_init(&init->gimbal_yaw_motor.gimbal_motor_adrc, &yaw_adrc);
+    ADRC_init(&init->gimbal_pitch_motor.gimbal_motor_adrc, &pitch_adrc);
+    init->gimbal_pitch_motor.gravity_current = PITCH_GRAVITY_CURRENT;
+    init->gimbal_pitch_motor.gravity_phase = PITCH_GRAVITY_PHASE;
 
     //PID
     gimbal_total_pid_clear(init);
@@ -712,32 +842,48 @@ static void gimbal_feedback_update(gimbal_control_t *feedback_update)
     {
         return;
     }
+    //ݿ,ʹͬһ֡
+    get_motor_feedback(CAN_YAW_MOTOR_INDEX, &feedback_update->gimbal_yaw_motor.gimbal_motor_feedback);
+    get_motor_feedback(CAN_PIT_MOTOR_INDEX, &feedback_update->gimbal_pitch_motor.gimbal_motor_feedback);
+    //ݿ,ڵĽǶȺͽٶͬһβ
+    get_INS_snapshot(&feedback_update->gimbal_INS);
+    feedback_update->dt = dwt_get_dt(&feedback_update->dt_cycle, GIMBAL_CONTROL_TIME_S);
+#if RM_IMU_ENABLE
+    //gimbal mounted RM IMU, the board INS takes over when it is lost
+    //̨ϵRM IMUģ, ʱɰINS
+    rm_imu_fusion_update(&feedback_update->gimbal_INS);
+#endif
+
     //̨ݸ
-    feedback_update->gimbal_pitch_motor.absolute_angle = *(feedback_update->gimbal_INT_angle_point + INS_PITCH_ADDRESS_OFFSET);
+    feedback_update->gimbal_pitch_motor.absolute_angle = feedback_update->gimbal_INS.angle[INS_PITCH_ADDRESS_OFFSET];
 
 #if PITCH_TURN
     feedback_update->gimbal_pitch_motor.relative_angle = -motor_ecd_to_angle_change(feedback_update->gimbal_pitch_motor.gimbal_motor_measure->ecd,
                                                                                           feedback_update->gimbal_pitch_motor.offset_ecd);
+    feedback_update->gimbal_pitch_motor.motor_speed = -feedback_update->gimbal_pitch_motor.gimbal_motor_feedback.state.velocity;
 #else
 
     feedback_update->gimbal_pitch_motor.relative_angle = motor_ecd_to_angle_change(feedback_update->gimbal_pitch_motor.gimbal_motor_measure->ecd,
                                                                                           feedback_update->gimbal_pitch_motor.offset_ecd);
+    feedback_update->gimbal_pitch_motor.motor_speed = feedback_update->gimbal_pitch_motor.gimbal_motor_feedback.state.velocity;
 #endif
 
-    feedback_update->gimbal_pitch_motor.motor_gyro = *(feedback_update->gimbal_INT_gyro_point + INS_GYRO_Y_ADDRESS_OFFSET);
+    feedback_update->gimbal_pitch_motor.motor_gyro = feedback_update->gimbal_INS.gyro[INS_GYRO_Y_ADDRESS_OFFSET];
 
-    feedback_update->gimbal_yaw_motor.absolute_angle = *(feedback_update->gimbal_INT_angle_point + INS_YAW_ADDRESS_OFFSET);
+    feedback_update->gimbal_yaw_motor.absolute_angle = feedback_update->gimbal_INS.angle[INS_YAW_ADDRESS_OFFSET];
 
 #if YAW_TURN
     feedback_update->gimbal_yaw_motor.relative_angle = -motor_ecd_to_angle_change(feedback_update->gimbal_yaw_motor.gimbal_motor_measure->ecd,
                                                                                         feedback_update->gimbal_yaw_motor.offset_ecd);
+    feedback_update->gimbal_yaw_motor.motor_speed = -feedback_update->gimbal_yaw_motor.gimbal_motor_feedback.state.velocity;
 
 #else
     feedback_update->gimbal_yaw_motor.relative_angle = motor_ecd_to_angle_change(feedback_update->gimbal_yaw_motor.gimbal_motor_measure->ecd,
                                                                                         feedback_update->gimbal_yaw_motor.offset_ecd);
+    feedback_update->gimbal_yaw_motor.motor_speed = feedback_update->gimbal_yaw_motor.gimbal_motor_feedback.state.velocity;
 #endif
-    feedback_update->gimbal_yaw_motor.motor_gyro = arm_cos_f32(feedback_update->gimbal_pitch_motor.relative_angle) * (*(feedback_update->gimbal_INT_gyro_point + INS_GYRO_Z_ADDRESS_OFFSET))
-                                                        - arm_sin_f32(feedback_update->gimbal_pitch_motor.relative_angle) * (*(feedback_update->gimbal_INT_gyro_point + INS_GYRO_X_ADDRESS_OFFSET));
+    feedback_update->gimbal_yaw_motor.motor_gyro = arm_cos_f32(feedback_update->gimbal_pitch_motor.relative_angle) * feedback_update->gimbal_INS.gyro[INS_GYRO_Z_ADDRESS_OFFSET]
+                                                        - arm_sin_f32(feedback_update->gimbal_pitch_motor.relative_angle) * feedback_update->gimbal_INS.gyro[INS_GYRO_X_ADDRESS_OFFSET];
 }
 
 /**
@@ -958,6 +1104,8 @@ static void gimbal_control_loop(gimbal_control_t *control_loop)
     {
         return;
     }
+
+    gimbal_tune_update(control_loop);
     
     if (control_loop->gimbal_yaw_motor.gimbal_motor_mode == GIMBAL_MOTOR_RAW)
     {
@@ -965,11 +1113,15 @@ static void gimbal_control_loop(gimbal_control_t *control_loop)
     }
     else if (control_loop->gimbal_yaw_motor.gimbal_motor_mode == GIMBAL_MOTOR_GYRO)
     {
-        gimbal_motor_absolute_angle_control(&control_loop->gimbal_yaw_motor);
+        gimbal_motor_absolute_angle_control(&control_loop->gimbal_yaw_motor, control_loop->dt);
     }
     else if (control_loop->gimbal_yaw_motor.gimbal_motor_mode == GIMBAL_MOTOR_ENCONDE)
     {
-        gimbal_motor_relative_angle_control(&control_loop->gimbal_yaw_motor);
+        gimbal_motor_relative_angle_control(&control_loop->gimbal_yaw_motor, control_loop->dt);
+    }
+    else if (control_loop->gimbal_yaw_motor.gimbal_motor_mode == GIMBAL_MOTOR_TUNE)
+    {
+        gimbal_motor_tune_control(&control_loop->gimbal_yaw_motor, &control_loop->gimbal_tune.relay, control_loop->dt);
     }
 
     if (control_loop->gimbal_pitch_motor.gimbal_motor_mode == GIMBAL_MOTOR_RAW)
@@ -978,56 +1130,96 @@ static void gimbal_control_loop(gimbal_control_t *control_loop)
     }
     else if (control_loop->gimbal_pitch_motor.gimbal_motor_mode == GIMBAL_MOTOR_GYRO)
     {
-        gimbal_motor_absolute_angle_control(&control_loop->gimbal_pitch_motor);
+        gimbal_motor_absolute_angle_control(&control_loop->gimbal_pitch_motor, control_loop->dt);
     }
     else if (control_loop->gimbal_pitch_motor.gimbal_motor_mode == GIMBAL_MOTOR_ENCONDE)
     {
-        gimbal_motor_relative_angle_control(&control_loop->gimbal_pitch_motor);
+        gimbal_motor_relative_angle_control(&control_loop->gimbal_pitch_motor, control_loop->dt);
+    }
+    else if (control_loop->gimbal_pitch_motor.gimbal_motor_mode == GIMBAL_MOTOR_TUNE)
+    {
+        gimbal_motor_tune_control(&control_loop->gimbal_pitch_motor, &control_loop->gimbal_tune.relay, control_loop->dt);
     }
 }
 
 /**
   * @brief          gimbal control mode :GIMBAL_MOTOR_GYRO, use euler angle calculated by gyro sensor to control. 
   * @param[out]     gimbal_motor: yaw motor or pitch motor
+  * @param[in]      dt: control period, unit s
   * @retval         none
   */
 /**
   * @brief          ̨ģʽ:GIMBAL_MOTOR_GYROʹǼŷǽп
   * @param[out]     gimbal_motor:yawpitch
+  * @param[in]      dt:  λ s
   * @retval         none
   */
-static void gimbal_motor_absolute_angle_control(gimbal_motor_t *gimbal_motor)
+static void gimbal_motor_absolute_angle_control(gimbal_motor_t *gimbal_motor, fp32 dt)
 {
     if (gimbal_motor == NULL)
     {
         return;
     }
-    //ǶȻٶȻpid
-    gimbal_motor->motor_gyro_set = gimbal_PID_calc(&gimbal_motor->gimbal_motor_absolute_angle_pid, gimbal_motor->absolute_angle, gimbal_motor->absolute_angle_set, gimbal_motor->motor_gyro);
-    gimbal_motor->current_set = PID_calc(&gimbal_motor->gimbal_motor_gyro_pid, gimbal_motor->motor_gyro, gimbal_motor->motor_gyro_set);
+    if (gimbal_motor->control_law == GIMBAL_LAW_LQR)
+    {
+        //ǶȺͽٶ״̬, ǰ
+        gimbal_motor->motor_gyro_set = 0.0f;
+        gimbal_motor->current_set = LQR_calc(&gimbal_motor->gimbal_motor_lqr, gimbal_motor->absolute_angle, gimbal_motor->motor_gyro, gimbal_motor->absolute_angle_set, gimbal_motor->motor_gyro_set,
+                                             gimbal_gravity_feedforward(gimbal_motor), dt);
+    }
+    else if (gimbal_motor->control_law == GIMBAL_LAW_ADRC)
+    {
+        //Կ, ۲ʹǽٶȺͱת
+        gimbal_motor->motor_gyro_set = 0.0f;
+        gimbal_motor->current_set = ADRC_calc(&gimbal_motor->gimbal_motor_adrc, gimbal_motor->absolute_angle, gimbal_motor->motor_gyro, gimbal_motor->motor_speed, gimbal_motor->absolute_angle_set, gimbal_motor->motor_gyro_set, dt);
+    }
+    else
+    {
+        //ǶȻٶȻpid
+        gimbal_motor->motor_gyro_set = PID_calc_full(&gimbal_motor->gimbal_motor_absolute_angle_pid, GIMBAL_ANGLE_PID_FLAG, gimbal_motor->absolute_angle, gimbal_motor->motor_gyro, gimbal_motor->absolute_angle_set, 0.0f, dt);
+        gimbal_motor->current_set = PID_calc(&gimbal_motor->gimbal_motor_gyro_pid, GIMBAL_SPEED_PID_FLAG, gimbal_motor->motor_gyro, gimbal_motor->motor_gyro_set, dt);
+    }
     //ֵֵ
     gimbal_motor->given_current = (int16_t)(gimbal_motor->current_set);
 }
 /**
   * @brief          gimbal control mode :GIMBAL_MOTOR_ENCONDE, use the encode relative angle  to control. 
   * @param[out]     gimbal_motor: yaw motor or pitch motor
+  * @param[in]      dt: control period, unit s
   * @retval         none
   */
 /**
   * @brief          ̨ģʽ:GIMBAL_MOTOR_ENCONDEʹñԽǽп
   * @param[out]     gimbal_motor:yawpitch
+  * @param[in]      dt:  λ s
   * @retval         none
   */
-static void gimbal_motor_relative_angle_control(gimbal_motor_t *gimbal_motor)
+static void gimbal_motor_relative_angle_control(gimbal_motor_t *gimbal_motor, fp32 dt)
 {
     if (gimbal_motor == NULL)
     {
         return;
     }
 
-    //ǶȻٶȻpid
-    gimbal_motor->motor_gyro_set = gimbal_PID_calc(&gimbal_motor->gimbal_motor_relative_angle_pid, gimbal_motor->relative_angle, gimbal_motor->relative_angle_set, gimbal_motor->motor_gyro);
-    gimbal_motor->current_set = PID_calc(&gimbal_motor->gimbal_motor_gyro_pid, gimbal_motor->motor_gyro, gimbal_motor->motor_gyro_set);
+    if (gimbal_motor->control_law == GIMBAL_LAW_LQR)
+    {
+        //ǶȺͽٶ״̬, ǰ
+        gimbal_motor->motor_gyro_set = 0.0f;
+        gimbal_motor->current_set = LQR_calc(&gimbal_motor->gimbal_motor_lqr, gimbal_motor->relative_angle, gimbal_motor->motor_gyro, gimbal_motor->relative_angle_set, gimbal_motor->motor_gyro_set,
+                                             gimbal_gravity_feedforward(gimbal_motor), dt);
+    }
+    else if (gimbal_motor->control_law == GIMBAL_LAW_ADRC)
+    {
+        //Կ, ۲ʹǽٶȺͱת
+        gimbal_motor->motor_gyro_set = 0.0f;
+        gimbal_motor->current_set = ADRC_calc(&gimbal_motor->gimbal_motor_adrc, gimbal_motor->relative_angle, gimbal_motor->motor_gyro, gimbal_motor->motor_speed, gimbal_motor->relative_angle_set, gimbal_motor->motor_gyro_set, dt);
+    }
+    else
+    {
+        //ǶȻٶȻpid
+        gimbal_motor->motor_gyro_set = PID_calc_full(&gimbal_motor->gimbal_motor_relative_angle_pid, GIMBAL_ANGLE_PID_FLAG, gimbal_motor->relative_angle, gimbal_motor->motor_gyro, gimbal_motor->relative_angle_set, 0.0f, dt);
+        gimbal_motor->current_set = PID_calc(&gimbal_motor->gimbal_motor_gyro_pid, GIMBAL_SPEED_PID_FLAG, gimbal_motor->motor_gyro, gimbal_motor->motor_gyro_set, dt);
+    }
     //ֵֵ
     gimbal_motor->given_current = (int16_t)(gimbal_motor->current_set);
 }
@@ -1052,94 +1244,192 @@ static void gimbal_motor_raw_angle_control(gimbal_motor_t *gimbal_motor)
     gimbal_motor->given_current = (int16_t)(gimbal_motor->current_set);
 }
 
-#if GIMBAL_TEST_MODE
-int32_t yaw_ins_int_1000, pitch_ins_int_1000;
-int32_t yaw_ins_set_1000, pitch_ins_set_1000;
-int32_t pitch_relative_set_1000, pitch_relative_angle_1000;
-int32_t yaw_speed_int_1000, pitch_speed_int_1000;
-int32_t yaw_speed_set_int_1000, pitch_speed_set_int_1000;
-static void J_scope_gimbal_test(void)
+/**
+  * @brief          gravity feedforward of GIMBAL_LAW_LQR, by the INS angle of the axis
+  * @param[in]      gimbal_motor: yaw motor or pitch motor
+  * @retval         current
+  */
+/**
+  * @brief          GIMBAL_LAW_LQRǰ, ɸINSǶȼ
+  * @param[in]      gimbal_motor:yawpitch
+  * @retval         ֵ
+  */
+static fp32 gimbal_gravity_feedforward(const gimbal_motor_t *gimbal_motor)
 {
-    yaw_ins_int_1000 = (int32_t)(gimbal_control.gimbal_yaw_motor.absolute_angle * 1000);
-    yaw_ins_set_1000 = (int32_t)(gimbal_control.gimbal_yaw_motor.absolute_angle_set * 1000);
-    yaw_speed_int_1000 = (int32_t)(gimbal_control.gimbal_yaw_motor.motor_gyro * 1000);
-    yaw_speed_set_int_1000 = (int32_t)(gimbal_control.gimbal_yaw_motor.motor_gyro_set * 1000);
-
-    pitch_ins_int_1000 = (int32_t)(gimbal_control.gimbal_pitch_motor.absolute_angle * 1000);
-    pitch_ins_set_1000 = (int32_t)(gimbal_control.gimbal_pitch_motor.absolute_angle_set * 1000);
-    pitch_speed_int_1000 = (int32_t)(gimbal_control.gimbal_pitch_motor.motor_gyro * 1000);
-    pitch_speed_set_int_1000 = (int32_t)(gimbal_control.gimbal_pitch_motor.motor_gyro_set * 1000);
-    pitch_relative_angle_1000 = (int32_t)(gimbal_control.gimbal_pitch_motor.relative_angle * 1000);
-    pitch_relative_set_1000 = (int32_t)(gimbal_control.gimbal_pitch_motor.relative_angle_set * 1000);
+    //gravity is of the world, the INS angle is used in GIMBAL_MOTOR_ENCONDE too
+    //, GIMBAL_MOTOR_ENCONDEʱͬʹINSǶ
+    return gimbal_motor->gravity_current * arm_cos_f32(gimbal_motor->absolute_angle + gimbal_motor->gravity_phase);
 }
 
-#endif
-
 /**
-  * @brief          "gimbal_control" valiable initialization, include pid initialization, remote control data point initialization, gimbal motors
-  *                 data point initialization, and gyro sensor angle point initialization.
-  * @param[out]     gimbal_init: "gimbal_control" valiable point
+  * @brief          gimbal control mode :GIMBAL_MOTOR_TUNE, the relay of the pid auto-tune
+  *                 takes the place of the speed loop, set 0.
+  * @param[out]     gimbal_motor: yaw motor or pitch motor
+  * @param[out]     tune: relay tune point
+  * @param[in]      dt: control period, unit s
   * @retval         none
   */
 /**
-  * @brief          ʼ"gimbal_control"pidʼ ңָʼָ̨ʼǽǶָʼ
-  * @param[out]     gimbal_init:"gimbal_control"ָ.
+  * @brief          ̨ģʽ:GIMBAL_MOTOR_TUNEpidļ̵ٶȻ, 趨ֵΪ0.
+  * @param[out]     gimbal_motor:yawpitch
+  * @param[out]     tune: ̵ṹָ
+  * @param[in]      dt:  λ s
   * @retval         none
   */
-static void gimbal_PID_init(gimbal_PID_t *pid, fp32 maxout, fp32 max_iout, fp32 kp, fp32 ki, fp32 kd)
+static void gimbal_motor_tune_control(gimbal_motor_t *gimbal_motor, relay_tune_t *tune, fp32 dt)
 {
-    if (pid == NULL)
+    if (gimbal_motor == NULL || tune == NULL)
     {
         return;
     }
-    pid->kp = kp;
-    pid->ki = ki;
-    pid->kd = kd;
-
-    pid->err = 0.0f;
-    pid->get = 0.0f;
-
-    pid->max_iout = max_iout;
-    pid->max_out = maxout;
+    gimbal_motor->motor_gyro_set = 0.0f;
+    gimbal_motor->current_set = relay_tune_calc(tune, gimbal_motor->motor_gyro_set - gimbal_motor->motor_gyro, dt);
+    gimbal_motor->given_current = (int16_t)(gimbal_motor->current_set);
 }
 
-static fp32 gimbal_PID_calc(gimbal_PID_t *pid, fp32 get, fp32 set, fp32 error_delta)
+/**
+  * @brief          pid auto-tune steps: start the relay, stop it when it ends or
+  *                 is not safe, then take the gains
+  * @param[out]     tune_update: "gimbal_control" valiable point
+  * @retval         none
+  */
+/**
+  * @brief          pid: ʼ̵ʵ, 򲻰ȫʱֹͣ, ȻʹõõĲ
+  * @param[out]     tune_update:"gimbal_control"ָ.
+  * @retval         none
+  */
+static void gimbal_tune_update(gimbal_control_t *tune_update)
 {
-    fp32 err;
-    if (pid == NULL)
-    {
-        return 0.0f;
-    }
-    pid->get = get;
-    pid->set = set;
-
-    err = set - get;
-    pid->err = rad_format(err);
-    pid->Pout = pid->kp * pid->err;
-    pid->Iout += pid->ki * pid->err;
-    pid->Dout = pid->kd * error_delta;
-    abs_limit(&pid->Iout, pid->max_iout);
-    pid->out = pid->Pout + pid->Iout + pid->Dout;
-    abs_limit(&pid->out, pid->max_out);
-    return pid->out;
+    gimbal_tune_t *tune;
+    gimbal_motor_t *motor = NULL;
+    fp32 kp, ki;
+
+    if (tune_update == NULL)
+    {
+        return;
+    }
+    tune = &tune_update->gimbal_tune;
+    if (tune->loop == PID_TUNE_YAW_SPEED)
+    {
+        motor = &tune_update->gimbal_yaw_motor;
+    }
+    else if (tune->loop == PID_TUNE_PITCH_SPEED)
+    {
+        motor = &tune_update->gimbal_pitch_motor;
+    }
+
+    if (tune->step == GIMBAL_TUNE_START_STEP)
+    {
+        //gimbal_behaviour enters GIMBAL_TUNE at this step unless the remote control is lost
+        //ң, gimbal_behaviourڴ˲GIMBAL_TUNE
+        if (toe_is_error(DBUS_TOE))
+        {
+            relay_tune_abort(&tune->relay);
+            tune->step = GIMBAL_TUNE_END_STEP;
+            return;
+        }
+        //the relay starts from the gravity feedforward, 0 for yaw. current_set is 0 after GIMBAL_ZERO_FORCE and
+        //a relay smaller than gravity would stay on one side
+        //̵ǰʼ, yawΪ0. GIMBAL_ZERO_FORCEcurrent_setΪ0, ̵ֵСʱͣһ
+        if (tune->loop == PID_TUNE_YAW_SPEED)
+        {
+            relay_tune_init(&tune->relay, YAW_SPEED_TUNE_RELAY, YAW_SPEED_TUNE_HYST, gimbal_gravity_feedforward(motor), YAW_SPEED_PID_MAX_OUT, GIMBAL_TUNE_TIMEOUT);
+        }
+        else if (tune->loop == PID_TUNE_PITCH_SPEED)
+        {
+            relay_tune_init(&tune->relay, PITCH_SPEED_TUNE_RELAY, PITCH_SPEED_TUNE_HYST, gimbal_gravity_feedforward(motor), PITCH_SPEED_PID_MAX_OUT, GIMBAL_TUNE_TIMEOUT);
+        }
+        else
+        {
+            relay_tune_init(&tune->relay, TRIGGER_TUNE_RELAY, TRIGGER_TUNE_HYST, 0.0f, TRIGGER_BULLET_PID_MAX_OUT, GIMBAL_TUNE_TIMEOUT);
+            shoot_tune_trigger(&tune->relay);
+        }
+        tune->step = GIMBAL_TUNE_RUN_STEP;
+    }
+    else if (tune->step == GIMBAL_TUNE_RUN_STEP)
+    {
+        if (toe_is_error(DBUS_TOE) ||
+            (motor != NULL && (motor->relative_angle > motor->max_relative_angle || motor->relative_angle < motor->min_relative_angle)) ||
+            tune->relay.time - tune->relay.switch_time > GIMBAL_TUNE_SWITCH_TIMEOUT)
+        {
+            relay_tune_abort(&tune->relay);
+        }
+        if (tune->relay.state != RELAY_TUNE_RUN)
+        {
+            if (relay_tune_pi(&tune->relay, &kp, &ki))
+            {
+                tune->kp[tune->loop] = kp;
+                tune->ki[tune->loop] = ki;
+                gimbal_tune_apply(tune_update, tune->loop);
+            }
+            shoot_tune_trigger(NULL);
+            __DMB();
+            tune->step = GIMBAL_TUNE_END_STEP;
+        }
+    }
 }
 
 /**
-  * @brief          gimbal PID clear, clear pid.out, iout.
-  * @param[out]     gimbal_pid_clear: "gimbal_control" valiable point
+  * @brief          use the tuned gains of a loop, nothing if its kp is 0
+  * @param[out]     apply: "gimbal_control" valiable point
+  * @param[in]      loop: PID_TUNE_YAW_SPEED, PID_TUNE_PITCH_SPEED or PID_TUNE_TRIGGER
   * @retval         none
   */
 /**
-  * @brief          ̨PIDpidout,iout
-  * @param[out]     gimbal_pid_clear:"gimbal_control"ָ.
+  * @brief          ʹһ·Ĳ, kpΪ0ʱ
+  * @param[out]     apply:"gimbal_control"ָ.
+  * @param[in]      loop: PID_TUNE_YAW_SPEED, PID_TUNE_PITCH_SPEED  PID_TUNE_TRIGGER
   * @retval         none
   */
-static void gimbal_PID_clear(gimbal_PID_t *gimbal_pid_clear)
+static void gimbal_tune_apply(gimbal_control_t *apply, uint8_t loop)
 {
-    if (gimbal_pid_clear == NULL)
+    pid_type_def *pid;
+    fp32 kp, ki;
+
+    if (apply == NULL || loop >= PID_TUNE_LOOP_NUM)
+    {
+        return;
+    }
+    kp = apply->gimbal_tune.kp[loop];
+    ki = apply->gimbal_tune.ki[loop];
+    if (!(kp > 0.0f))
     {
         return;
     }
-    gimbal_pid_clear->err = gimbal_pid_clear->set = gimbal_pid_clear->get = 0.0f;
-    gimbal_pid_clear->out = gimbal_pid_clear->Pout = gimbal_pid_clear->Iout = gimbal_pid_clear->Dout = 0.0f;
+
+    if (loop == PID_TUNE_TRIGGER)
+    {
+        shoot_set_trigger_pid(kp, ki);
+        return;
+    }
+    pid = (loop == PID_TUNE_YAW_SPEED) ? &apply->gimbal_yaw_motor.gimbal_motor_gyro_pid : &apply->gimbal_pitch_motor.gimbal_motor_gyro_pid;
+    //Kaw = Ki / Kp as the config, I is kept
+    //Kaw = Ki / Kp ͬ, ֱ
+    pid->Kp = kp;
+    pid->Ki = ki;
+    pid->Kaw = ki / kp;
+}
+
+#if GIMBAL_TEST_MODE
+int32_t yaw_ins_int_1000, pitch_ins_int_1000;
+int32_t yaw_ins_set_1000, pitch_ins_set_1000;
+int32_t pitch_relative_set_1000, pitch_relative_angle_1000;
+int32_t yaw_speed_int_1000, pitch_speed_int_1000;
+int32_t yaw_speed_set_int_1000, pitch_speed_set_int_1000;
+static void J_scope_gimbal_test(void)
+{
+    yaw_ins_int_1000 = (int32_t)(gimbal_control.gimbal_yaw_motor.absolute_angle * 1000);
+    yaw_ins_set_1000 = (int32_t)(gimbal_control.gimbal_yaw_motor.absolute_angle_set * 1000);
+    yaw_speed_int_1000 = (int32_t)(gimbal_control.gimbal_yaw_motor.motor_gyro * 1000);
+    yaw_speed_set_int_1000 = (int32_t)(gimbal_control.gimbal_yaw_motor.motor_gyro_set * 1000);
+
+    pitch_ins_int_1000 = (int32_t)(gimbal_control.gimbal_pitch_motor.absolute_angle * 1000);
+    pitch_ins_set_1000 = (int32_t)(gimbal_control.gimbal_pitch_motor.absolute_angle_set * 1000);
+    pitch_speed_int_1000 = (int32_t)(gimbal_control.gimbal_pitch_motor.motor_gyro * 1000);
+    pitch_speed_set_int_1000 = (int32_t)(gimbal_control.gimbal_pitch_motor.motor_gyro_set * 1000);
+    pitch_relative_angle_1000 = (int32_t)(gimbal_control.gimbal_pitch_motor.relative_angle * 1000);
+    pitch_relative_set_1000 = (int32_t)(gimbal_control.gimbal_pitch_motor.relative_angle_set * 1000);
 }
+
+#endif
+
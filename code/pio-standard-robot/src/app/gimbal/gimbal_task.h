@@ -16,10 +16,32 @@
   *  Version    Date            Author          Modification
   *  V1.0.0     Dec-26-2018     RM              1. done
   *  V1.1.0     Nov-11-2019     RM              1. add some annotation
+  *  V1.2.0     Oct-16-2026     RM              1. use one INS snapshot per control cycle
+  *  V1.3.0     Oct-16-2026     RM              1. option to run at every INS sample
+  *  V1.4.0     Oct-16-2026     RM              1. angle loops on the pid of pid.c, real dt
+  *  V1.5.0     Oct-16-2026     RM              1. relay feedback pid auto-tune of the speed loops and trigger
+  *  V1.6.0     Oct-16-2026     RM              1. lqr with gravity feedforward for pitch, chosen at compile time
+  *  V1.7.0     Oct-16-2026     RM              1. adrc option of yaw and pitch, the law of each axis chosen at compile time
+  *  V1.8.0     Oct-16-2026     RM              1. sign of the angle loop KD made explicit
+  *  V1.9.0     Oct-16-2026     RM              1. GIMBAL_LAW_LQR refused for yaw at compile time
+  *  V1.10.0    Oct-16-2026     RM              1. pid flags and KD sign of the gimbal loops, used by the host simulation
+  *  V1.11.0    Oct-16-2026     RM              1. adrc damping on the motor rate of the encoder
   *
   @verbatim
   ==============================================================================
-
+  pid auto-tune, started by calibrate_task: the relay of relay_tune.c takes the
+  place of the speed pid of one axis, set 0, while the other axis holds its
+  encode angle. for the trigger both axes hold and shoot.c runs the relay. the
+  PI found is used at once and saved by calibrate_task, it replaces Kp, Ki and
+  Kaw = Ki / Kp of the config at boot. remote control lost, the axis out of its
+  relative angle range, GIMBAL_TUNE_TIMEOUT or no relay switch within
+  GIMBAL_TUNE_SWITCH_TIMEOUT stop it with the gains unchanged.
+  pid, calibrate_taskʼ: relay_tune.cļ̵һٶȻpid,
+  趨ֵΪ0, һᱣֱǶ. ʱᱣ, shoot.cм̵.
+  õPIЧcalibrate_task, ʱ滻еKp, Ki
+  Kaw = Ki / Kp. ң, ᳬԽǶȷΧ, GIMBAL_TUNE_TIMEOUTʱ
+  GIMBAL_TUNE_SWITCH_TIMEOUTڼ̵ûлʱֹͣ,
+  .
   ==============================================================================
   @endverbatim
   ****************************(C) COPYRIGHT 2019 DJI****************************
@@ -31,6 +53,28 @@
 #include "CAN_receive.h"
 #include "pid.h"
 #include "remote_control.h"
+#include "INS_task.h"
+#include "relay_tune.h"
+#include "lqr.h"
+#include "adrc.h"
+
+//terms of the gimbal loops, the same for yaw and pitch, add PID_I or PID_D when KI or KD is tuned.
+//angle loops wrap the error and take D of the gyro
+//̨, yawpitchͬ, KIKDʱPID_IPID_D. ǶȻ(-pi, pi), ΢ʹǽٶ
+#define GIMBAL_ANGLE_PID_FLAG   (PID_D | PID_EXT_RATE | PID_ANGLE)
+//the speed loops keep the clamp only integral of the old PID_calc, PID_ANTI_WINDUP is added when they are retuned
+//ٶȻԭPID_calcֻ޷Ļ, ټPID_ANTI_WINDUP
+#define GIMBAL_SPEED_PID_FLAG   (PID_I)
+//the angle loops add KD * gyro to the out, as gimbal_PID_calc did, and PID_EXT_RATE takes -Kd * rate, so Kd
+//is KD with this sign. a positive KD feeds part of the gyro back to the speed set and lowers the damping of
+//the speed loop, a negative KD adds damping
+//ǶȻKD * ٶ, ԭgimbal_PID_calcͬ, PID_EXT_RATEΪ -Kd * ٶ, KdΪKDԸ÷.
+//KDΪʱֽٶȷٶ趨, ٶȻ, KDΪʱ
+#define GIMBAL_ANGLE_PID_KD_SIGN    (-1.0f)
+
+//KI and KD below are per GIMBAL_CONTROL_TIME, turned to per second in the pid config,
+//except KD of the angle loops, which is of the gyro in rad/s
+//KIKDGIMBAL_CONTROL_TIME, pidлΪ, ǶȻKDǽٶ rad/s, 
 //pitch speed close-loop PID params, max out and max iout
 //pitch ٶȻ PIDԼ PID
 #define PITCH_SPEED_PID_KP        2900.0f
@@ -60,6 +104,8 @@
 //yaw ǶȻ Ƕǽ PIDԼ PID
 #define YAW_GYRO_ABSOLUTE_PID_KP        26.0f
 #define YAW_GYRO_ABSOLUTE_PID_KI        0.0f
+//D of the gyro, KD * gyro is added to the out, see GIMBAL_ANGLE_PID_KD_SIGN
+//΢ǽٶ, KD * ٶȼӵ, GIMBAL_ANGLE_PID_KD_SIGN
 #define YAW_GYRO_ABSOLUTE_PID_KD        0.3f
 #define YAW_GYRO_ABSOLUTE_PID_MAX_OUT   10.0f
 #define YAW_GYRO_ABSOLUTE_PID_MAX_IOUT  0.0f
@@ -81,6 +127,61 @@
 #define YAW_ENCODE_RELATIVE_PID_MAX_OUT   10.0f
 #define YAW_ENCODE_RELATIVE_PID_MAX_IOUT  0.0f
 
+//control law of an axis in GIMBAL_MOTOR_GYRO and GIMBAL_MOTOR_ENCONDE
+//̨GIMBAL_MOTOR_GYROGIMBAL_MOTOR_ENCONDEģʽµĿ
+#define GIMBAL_LAW_PID      0   //angle pid and speed pid cascade.ǶȻٶȻpid
+#define GIMBAL_LAW_LQR      1   //state feedback on angle and rate, gravity feedforward, pitch only.ǶȺͽٶ״̬, ǰ, pitch
+#define GIMBAL_LAW_ADRC     2   //adrc, the observer on the gyro and the encoder takes out load and chassis rotation.Կ, ǺͱϵĹ۲غ͵ת
+#define YAW_CONTROL_LAW     GIMBAL_LAW_PID
+#define PITCH_CONTROL_LAW   GIMBAL_LAW_PID
+//the lqr has a model and gains of pitch only, gimbal_init does not set up one for yaw
+//lqrֻpitchģͺͲ, gimbal_initΪyawʼlqr
+#if YAW_CONTROL_LAW == GIMBAL_LAW_LQR
+#error "GIMBAL_LAW_LQR is designed for pitch only, design and init a yaw lqr before choosing it for YAW_CONTROL_LAW"
+#endif
+
+//pitch lqr, a discrete LQR at GIMBAL_CONTROL_TIME, Q = diag(1, 0.001, 10), R = 3e-10,
+//on the model rate' = a * current - c * rate, a = 0.04 rad/s2, c = 10 1/s, gravity taken
+//by the feedforward. identify a and c from a current step of the robot and redo the design
+//pitch lqr, GIMBAL_CONTROL_TIMEɢLQR, Q = diag(1, 0.001, 10), R = 3e-10,
+//ģ rate' = a * current - c * rate, a = 0.04 rad/s2, c = 10 1/s, ǰе.
+//Ի˵ĵԾʶac
+#define PITCH_LQR_K_ANGLE   62588.5f
+#define PITCH_LQR_K_RATE    2245.9f
+#define PITCH_LQR_K_I       174257.0f
+#define PITCH_LQR_MAX_OUT   30000.0f
+#define PITCH_LQR_MAX_IOUT  5000.0f
+#define PITCH_LQR_I_BAND    0.02f
+
+//gravity feedforward, PITCH_GRAVITY_CURRENT * cos(pitch + PITCH_GRAVITY_PHASE), pitch of the INS.
+//the sign of the current is the direction of the motor, phase is the center of mass off the barrel
+//ǰ, PITCH_GRAVITY_CURRENT * cos(pitch + PITCH_GRAVITY_PHASE), pitchΪINSǶ.
+//Ϊ, λΪƫǹܵĽǶ
+#define PITCH_GRAVITY_CURRENT   6000.0f
+#define PITCH_GRAVITY_PHASE     0.0f
+
+//adrc, B0 is rate' per current, unit rad/s2, the slope of the gyro after a current step of the
+//robot. WC is the loop bandwidth, WO the observer bandwidth, unit rad/s. an over B0 is the safe
+//side, an under B0 or a long delay of the CAN loop wants a smaller WO. C is the damping on the
+//motor rate of the encoder, unit 1/s, the decay rate of the gyro after the current step, the c of
+//the lqr model. with it a chassis rotation reaches the yaw out in the same cycle, 0 leaves it to
+//the observer
+//adrc, B0ΪÿλĽǼٶ λ rad/s2, ȡ˵Ծǵб. WCΪջ,
+//WOΪ۲ λ rad/s. B0ƫϰȫ, B0ƫСCAN·ʱʱӦСWO. CΪת
+//ϵ λ 1/s, ȡԾǵ˥, lqrģ͵c. תͬһõyaw,
+//Ϊ0ʱɹ۲е
+#define YAW_ADRC_B0         0.03f
+#define YAW_ADRC_WC         40.0f
+#define YAW_ADRC_WO         200.0f
+#define YAW_ADRC_C          10.0f
+#define YAW_ADRC_MAX_OUT    30000.0f
+
+#define PITCH_ADRC_B0       0.04f
+#define PITCH_ADRC_WC       40.0f
+#define PITCH_ADRC_WO       200.0f
+#define PITCH_ADRC_C        10.0f
+#define PITCH_ADRC_MAX_OUT  30000.0f
+
 
 //ʼ һʱ
 #define GIMBAL_TASK_INIT_TIME 201
@@ -112,6 +213,14 @@
 #define PITCH_ENCODE_SEN  0.01f
 
 #define GIMBAL_CONTROL_TIME 1
+#define GIMBAL_CONTROL_TIME_S (GIMBAL_CONTROL_TIME * 0.001f)
+
+//1: run at every INS sample and send at once, 0: free running with GIMBAL_CONTROL_TIME
+//1: ÿINSв, 0: GIMBAL_CONTROL_TIME
+#define GIMBAL_IMU_TRIGGER 0
+//longest wait for a sample, then run without it
+//ȴʱ, ʱ򲻵ȴֱ
+#define GIMBAL_IMU_TRIGGER_TIMEOUT 3
 
 //test mode, 0 close, 1 open
 //̨ģʽ 궨 0 Ϊʹòģʽ
@@ -148,6 +257,29 @@
 #define GIMBAL_CALI_START_STEP  GIMBAL_CALI_PITCH_MAX_STEP
 #define GIMBAL_CALI_END_STEP    5
 
+//loops of the pid auto-tune
+//pidĻ·
+#define PID_TUNE_YAW_SPEED      0
+#define PID_TUNE_PITCH_SPEED    1
+#define PID_TUNE_TRIGGER        2
+#define PID_TUNE_LOOP_NUM       3
+
+#define GIMBAL_TUNE_START_STEP  1
+#define GIMBAL_TUNE_RUN_STEP    2
+#define GIMBAL_TUNE_END_STEP    3
+
+//relay amplitude of the current and hysteresis of the speed error, rad/s
+//̵ֵԼٶͻ rad/s
+#define YAW_SPEED_TUNE_RELAY    3000.0f
+#define YAW_SPEED_TUNE_HYST     0.05f
+#define PITCH_SPEED_TUNE_RELAY  3000.0f
+#define PITCH_SPEED_TUNE_HYST   0.05f
+//unit s
+#define GIMBAL_TUNE_TIMEOUT     10.0f
+//the relay stuck on one side, e.g. saturated against gravity, unit s
+//̵ͣһ, ˷ʱ λ s
+#define GIMBAL_TUNE_SWITCH_TIMEOUT 1.0f
+
 //жңʱԼңжϣ̨yawֵԷƯ
 #define GIMBAL_MOTIONLESS_RC_DEADLINE 10
 #define GIMBAL_MOTIONLESS_TIME_MAX    3000
@@ -162,34 +294,21 @@ typedef enum
     GIMBAL_MOTOR_RAW = 0, //ԭʼֵ
     GIMBAL_MOTOR_GYRO,    //ǽǶȿ
     GIMBAL_MOTOR_ENCONDE, //ֵǶȿ
+    GIMBAL_MOTOR_TUNE,    //relay of the pid auto-tune on the speed loop.ٶȻpidļ̵
 } gimbal_motor_mode_e;
 
-typedef struct
-{
-    fp32 kp;
-    fp32 ki;
-    fp32 kd;
-
-    fp32 set;
-    fp32 get;
-    fp32 err;
-
-    fp32 max_out;
-    fp32 max_iout;
-
-    fp32 Pout;
-    fp32 Iout;
-    fp32 Dout;
-
-    fp32 out;
-} gimbal_PID_t;
-
 typedef struct
 {
     const motor_measure_t *gimbal_motor_measure;
-    gimbal_PID_t gimbal_motor_absolute_angle_pid;
-    gimbal_PID_t gimbal_motor_relative_angle_pid;
+    motor_feedback_t gimbal_motor_feedback;     //feedback frame of this cycle.ڵĵ
+    pid_type_def gimbal_motor_absolute_angle_pid;
+    pid_type_def gimbal_motor_relative_angle_pid;
     pid_type_def gimbal_motor_gyro_pid;
+    lqr_type_def gimbal_motor_lqr;
+    adrc_type_def gimbal_motor_adrc;
+    uint8_t control_law;        //GIMBAL_LAW_PID, GIMBAL_LAW_LQR or GIMBAL_LAW_ADRC
+    fp32 gravity_current;       //gravity feedforward of GIMBAL_LAW_LQR.GIMBAL_LAW_LQRǰ
+    fp32 gravity_phase;         //rad
     gimbal_motor_mode_e gimbal_motor_mode;
     gimbal_motor_mode_e last_gimbal_motor_mode;
     uint16_t offset_ecd;
@@ -202,7 +321,7 @@ typedef struct
     fp32 absolute_angle_set; //rad
     fp32 motor_gyro;         //rad/s
     fp32 motor_gyro_set;
-    fp32 motor_speed;
+    fp32 motor_speed;        //rad/s, of the motor against its mount, from the encoder.õĵ԰װת
     fp32 raw_cmd_current;
     fp32 current_set;
     int16_t given_current;
@@ -222,14 +341,25 @@ typedef struct
     uint8_t step;
 } gimbal_step_cali_t;
 
+typedef struct
+{
+    relay_tune_t relay;
+    fp32 kp[PID_TUNE_LOOP_NUM];     //tuned gains, kp 0 means the define is used.Ĳ, kpΪ0ʱʹú궨
+    fp32 ki[PID_TUNE_LOOP_NUM];     //unit 1/s
+    uint8_t loop;
+    uint8_t step;
+} gimbal_tune_t;
+
 typedef struct
 {
     const RC_ctrl_t *gimbal_rc_ctrl;
-    const fp32 *gimbal_INT_angle_point;
-    const fp32 *gimbal_INT_gyro_point;
+    INS_snapshot_t gimbal_INS;
     gimbal_motor_t gimbal_yaw_motor;
     gimbal_motor_t gimbal_pitch_motor;
     gimbal_step_cali_t gimbal_cali;
+    gimbal_tune_t gimbal_tune;
+    fp32 dt;                    //measured control period, unit s.ʵ λ s
+    uint32_t dt_cycle;
 } gimbal_control_t;
 
 /**
@@ -314,4 +444,36 @@ extern bool_t cmd_cali_gimbal_hook(uint16_t *yaw_offset, uint16_t *pitch_offset,
   * @waring         ʹõgimbal_control ̬ºָͨ븴
   */
 extern void set_cali_gimbal_hook(const uint16_t yaw_offset, const uint16_t pitch_offset, const fp32 max_yaw, const fp32 min_yaw, const fp32 max_pitch, const fp32 min_pitch);
+
+/**
+  * @brief          pid auto-tune of a loop, called by calibrate_task until it returns 1
+  * @param[in]      loop: PID_TUNE_YAW_SPEED, PID_TUNE_PITCH_SPEED or PID_TUNE_TRIGGER
+  * @param[out]     kp: Kp found, not changed if it fails
+  * @param[out]     ki: Ki found, unit 1/s, not changed if it fails
+  * @retval         1: ended, 0: running
+  */
+/**
+  * @brief          һ·pid, calibrate_taskֱ1
+  * @param[in]      loop: PID_TUNE_YAW_SPEED, PID_TUNE_PITCH_SPEED  PID_TUNE_TRIGGER
+  * @param[out]     kp: õKp, ʧʱ
+  * @param[out]     ki: õKi λ 1/s, ʧʱ
+  * @retval         1: , 0: 
+  */
+extern bool_t cmd_cali_pid_tune_hook(uint8_t loop, fp32 *kp, fp32 *ki);
+
+/**
+  * @brief          set the tuned gains of a loop, called before gimbal_task starts
+  * @param[in]      loop: PID_TUNE_YAW_SPEED, PID_TUNE_PITCH_SPEED or PID_TUNE_TRIGGER
+  * @param[in]      kp: Kp, 0 keeps the define
+  * @param[in]      ki: Ki, unit 1/s
+  * @retval         none
+  */
+/**
+  * @brief          һ·Ĳ, gimbal_taskʼǰ
+  * @param[in]      loop: PID_TUNE_YAW_SPEED, PID_TUNE_PITCH_SPEED  PID_TUNE_TRIGGER
+  * @param[in]      kp: Kp, Ϊ0ʱʹú궨
+  * @param[in]      ki: Ki λ 1/s
+  * @retval         none
+  */
+extern void set_cali_pid_tune_hook(uint8_t loop, fp32 kp, fp32 ki);
 #endif
@@ -1,8 +1,8 @@
 /**
   ****************************(C) COPYRIGHT 2019 DJI****************************
   * @file       INS_task.c/h
-  * @brief      use bmi088 to calculate the euler angle. no use ist8310, so only
-  *             enable data ready pin to save cpu time.enalbe bmi088 data ready
+  * @brief      use bmi088 to calculate the euler angle. ist8310 is read by I2C
+  *             DMA at its data ready pin to save cpu time.enalbe bmi088 data ready
   *             enable spi DMA to save the time spi transmit
   *             Ҫbmi088ist8310̬㣬óŷǣ
   *             ṩͨbmi088data ready жⲿݵȴӳ
@@ -12,6 +12,18 @@
   *  Version    Date            Author          Modification
   *  V1.0.0     Dec-26-2018     RM              1. done
   *  V2.0.0     Nov-11-2019     RM              1. support bmi088, but don't support mpu6500
+  *  V2.1.0     Oct-16-2026     RM              1. quaternion EKF with gyro bias, selected by INS_FILTER
+  *  V2.2.0     Oct-16-2026     RM              1. integrate with dt measured at gyro data ready, dt histogram
+  *  V2.3.0     Oct-16-2026     RM              1. read gyro FIFO bursts when BMI088_GYRO_FIFO_ENABLE
+  *  V2.4.0     Oct-16-2026     RM              1. triple buffered INS snapshot, wait for next sample
+  *  V2.5.0     Oct-16-2026     RM              1. read ist8310 by I2C DMA at its data ready, latency statistics
+  *  V2.6.0     Oct-16-2026     RM              1. heater warm up by thermal model, learned model saved in flash, time to ready
+  *  V2.7.0     Oct-16-2026     RM              1. raw SPI buffers captured by imu_capture
+  *  V2.8.0     Oct-16-2026     RM              1. feed the vibration analyzer
+  *  V2.9.0     Oct-16-2026     RM              1. gyro zero drift vs temperature table learned while still
+  *  V2.10.0    Oct-16-2026     RM              1. temperature pid with real dt
+  *  V2.11.0    Oct-16-2026     RM              1. drain the gyro FIFO by FIFO_STATUS, clear it at overrun, integrate every frame at its own time
+  *  V2.12.0    Oct-16-2026     RM              1. gyro temperature still window checks the window mean and deviation and no command
   *
   @verbatim
   ==============================================================================
@@ -30,12 +42,18 @@
 #include "bsp_imu_pwm.h"
 #include "bsp_spi.h"
 #include "bmi088driver.h"
+#include "BMI088reg.h"
 #include "ist8310driver.h"
 #include "pid.h"
+#include "bsp_dwt.h"
 #include "ahrs.h"
+#include "quaternion_ekf.h"
+#include "imu_capture.h"
+#include "vibration_task.h"
 
 #include "calibrate_task.h"
 #include "detect_task.h"
+#include "remote_control.h"
 
 
 #define IMU_temp_PWM(pwm)  imu_pwm_set(pwm)                    //pwm
@@ -84,6 +102,61 @@ static void imu_cali_slove(fp32 gyro[3], fp32 accel[3], fp32 mag[3], bmi088_real
   * @retval         none
   */
 static void imu_temp_control(fp32 temp);
+
+/**
+  * @brief          take a heater model learned at this boot, blend it with the one in use
+  * @param[in]      gain: learned heating rate at full power, unit /s
+  * @param[in]      tau: learned heat loss time constant, unit s
+  * @retval         none
+  */
+/**
+  * @brief          ñѧϰļģ, 뵱ǰģں
+  * @param[in]      gain: ѧϰȫ λ /s
+  * @param[in]      tau: ѧϰɢʱ䳣 λ s
+  * @retval         none
+  */
+static void imu_heater_learn(fp32 gain, fp32 tau);
+
+/**
+  * @brief          learn the gyro zero drift of the temperature in a still window
+  * @param[in]      gyro: gyro after imu_cali_slove, unit rad/s
+  * @param[in]      accel: accel after imu_cali_slove, unit m/s2
+  * @param[in]      temp: bmi088 temperature
+  * @retval         none
+  */
+/**
+  * @brief          ھֹѧϰ¶µƯ
+  * @param[in]      gyro: imu_cali_slove֮Ľٶ λ rad/s
+  * @param[in]      accel: imu_cali_slove֮ļٶ λ m/s2
+  * @param[in]      temp: bmi088¶
+  * @retval         none
+  */
+static void gyro_temp_learn(const fp32 gyro[3], const fp32 accel[3], fp32 temp);
+
+/**
+  * @brief          no chassis or gimbal command: the remote control is off, or the rockers are in
+  *                 GYRO_TEMP_STILL_RC and there is no mouse or key
+  * @param[in]      none
+  * @retval         1: no command, 0: command
+  */
+/**
+  * @brief          ûеָ̨̺: ң, ҡGYRO_TEMP_STILL_RCûͰ
+  * @param[in]      none
+  * @retval         1: ûָ, 0: ָ
+  */
+static bool_t gyro_temp_cmd_idle(void);
+
+/**
+  * @brief          set gyro_offset from the table at the temperature, or the calibrated offset out of the table
+  * @param[in]      temp: bmi088 temperature
+  * @retval         none
+  */
+/**
+  * @brief          ¶ȴӱgyro_offset, ûи¶ʱʹУ׼Ư
+  * @param[in]      temp: bmi088¶
+  * @retval         none
+  */
+static void gyro_temp_offset_update(fp32 temp);
 /**
   * @brief          open the SPI DMA accord to the value of imu_update_flag
   * @param[in]      none
@@ -96,15 +169,84 @@ static void imu_temp_control(fp32 temp);
   */
 static void imu_cmd_spi_dma(void);
 
+#if defined(BMI088_GYRO_FIFO_ENABLE)
+/**
+  * @brief          next step of the gyro FIFO read at the end of a SPI DMA, called in DMA interrupt
+  * @param[in]      none
+  * @retval         none
+  */
+/**
+  * @brief          SPI DMAʱFIFOȡһ, DMAже
+  * @param[in]      none
+  * @retval         none
+  */
+static void gyro_fifo_dma_over(void);
+#endif
+
+/**
+  * @brief          measure dt between gyro samples from their data ready time
+  * @param[in]      sample_cycle: DWT cycle at the data ready of the sample
+  * @retval         none
+  */
+/**
+  * @brief          ݾʱ̼
+  * @param[in]      sample_cycle: ôβݾʱDWT
+  * @retval         none
+  */
+static void INS_dt_update(uint32_t sample_cycle);
+
+/**
+  * @brief          publish the current sample to the snapshot buffers and wake waiting tasks
+  * @param[in]      sample_cycle: DWT cycle at the data ready of the sample
+  * @retval         none
+  */
+/**
+  * @brief          ݷջ, ѵȴ
+  * @param[in]      sample_cycle: ôβݾʱDWT
+  * @retval         none
+  */
+static void INS_snapshot_publish(uint32_t sample_cycle);
+
+/**
+  * @brief          start the ist8310 I2C DMA read at its data ready, called in EXTI interrupt
+  * @param[in]      none
+  * @retval         none
+  */
+/**
+  * @brief          ݾʱI2C DMAȡ, ⲿже
+  * @param[in]      none
+  * @retval         none
+  */
+static void imu_cmd_i2c_dma(void);
+
 
 
 extern SPI_HandleTypeDef hspi1;
+extern I2C_HandleTypeDef hi2c3;
 
 
 static TaskHandle_t INS_task_local_handler;
 
 uint8_t gyro_dma_rx_buf[SPI_DMA_GYRO_LENGHT];
+#if defined(BMI088_GYRO_FIFO_ENABLE)
+//burst read of the FIFO data register, 0x3F | 0x80
+//ȡFIFOݼĴ
+uint8_t gyro_dma_tx_buf[SPI_DMA_GYRO_LENGHT] = {0xBF};
+//read of FIFO_STATUS, and the FIFO clear, a write of FIFO_CONFIG_1 with the same mode
+//ȡFIFO_STATUS, ԼFIFO: ͬģʽдFIFO_CONFIG_1
+static uint8_t gyro_fifo_status_tx_buf[2] = {BMI088_GYRO_FIFO_STATUS | 0x80, 0xFF};
+static uint8_t gyro_fifo_clear_tx_buf[2] = {BMI088_GYRO_FIFO_CONFIG_1, BMI088_GYRO_FIFO_MODE_STREAM | BMI088_GYRO_FIFO_DATA_XYZ};
+static uint8_t gyro_fifo_status_rx_buf[2];
+#define GYRO_FIFO_READ_STATUS   0
+#define GYRO_FIFO_READ_DATA     1
+#define GYRO_FIFO_CLEAR         2
+#define GYRO_FIFO_FRAME_CYCLE   (SystemCoreClock / BMI088_GYRO_FIFO_ODR)
+static volatile uint8_t gyro_fifo_step;
+static volatile uint8_t gyro_fifo_frame_num;   //frames in the last burst.ϴζȡ֡
+static fp32 gyro_fifo_frame[BMI088_GYRO_FIFO_DEPTH][3];
+#else
 uint8_t gyro_dma_tx_buf[SPI_DMA_GYRO_LENGHT] = {0x82,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF};
+#endif
 
 uint8_t accel_dma_rx_buf[SPI_DMA_ACCEL_LENGHT];
 uint8_t accel_dma_tx_buf[SPI_DMA_ACCEL_LENGHT] = {0x92,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF};
@@ -113,6 +255,8 @@ uint8_t accel_dma_tx_buf[SPI_DMA_ACCEL_LENGHT] = {0x92,0xFF,0xFF,0xFF,0xFF,0xFF,
 uint8_t accel_temp_dma_rx_buf[SPI_DMA_ACCEL_TEMP_LENGHT];
 uint8_t accel_temp_dma_tx_buf[SPI_DMA_ACCEL_TEMP_LENGHT] = {0xA2,0xFF,0xFF,0xFF};
 
+uint8_t mag_dma_rx_buf[IST8310_DMA_RX_LENGTH];
+
 
 
 volatile uint8_t gyro_update_flag = 0;
@@ -136,11 +280,51 @@ fp32 mag_scale_factor[3][3] = {IST8310_BOARD_INSTALL_SPIN_MATRIX};
 fp32 mag_offset[3];
 fp32 mag_cali_offset[3];
 
-static uint8_t first_temperate;
-static const fp32 imu_temp_PID[3] = {TEMPERATURE_PID_KP, TEMPERATURE_PID_KI, TEMPERATURE_PID_KD};
+static INS_heater_stat_t INS_heater_stat = {0, 0.0f, HEATER_DEFAULT_GAIN, HEATER_DEFAULT_TAU, HEATER_MODE_INIT};
+static bool_t heater_model_saved;           //model in use comes from flash.ǰģflash
+static volatile bool_t heater_model_save;   //a learned model waits to be saved.дѧϰģ
+static INS_gyro_temp_table_t gyro_temp_table;
+static INS_gyro_temp_table_t gyro_temp_saved;  //table in flash.flashеı
+static volatile bool_t gyro_temp_save;        //a learned table waits to be saved.дѧϰ
+static uint32_t gyro_temp_save_tick;
+static volatile uint32_t gyro_cali_tick;        //last INS_cali_gyro, 0: never.ϴңУ׼ʱ, 0ΪδУ׼
+//sums of the still window
+//ֹڵۼֵ
+static fp32 gyro_temp_sum[3];
+static fp32 gyro_temp_rate_sum[3];
+static fp32 gyro_temp_rate_sq_sum[3];
+static fp32 gyro_temp_temp_sum;
+static uint16_t gyro_temp_still_count;
+//the integrator is preloaded at warm up, and is only limited
+//ڼʱԤ, ֻ޷
+#define TEMPERATURE_PID_FLAG PID_I
+static const pid_config_t imu_temp_PID = {TEMPERATURE_PID_KP, TEMPERATURE_PID_KI / TEMPERATURE_PID_DT, TEMPERATURE_PID_KD * TEMPERATURE_PID_DT,
+                                          TEMPERATURE_PID_MAX_OUT, TEMPERATURE_PID_MAX_IOUT, 0.0f, 0.0f};
+static uint32_t imu_temp_cycle;
 static pid_type_def imu_temp_pid;
 
-static const float timing_time = 0.001f;   //tast run time , unit s.еʱ λ s
+static const float timing_time = INS_DT_FRAME_US * 0.000001f;   //tast run time , unit s.еʱ λ s
+
+//DWT cycle at gyro data ready, at the start of its SPI read, at the end of its SPI read
+//ݾ, ʼSPIȡ, SPIȡʱDWT
+static volatile uint32_t gyro_drdy_cycle;
+static volatile uint32_t gyro_spi_cycle;
+static volatile uint32_t gyro_sample_cycle;
+static fp32 INS_dt = 0.001f;            //measured integration dt, unit s.ʵʱ λ s
+static INS_dt_hist_t INS_dt_hist;
+
+//seq of a buffer is 0 while INS_task writes it, INS_snapshot_index is the latest buffer
+//длseqΪ0, INS_snapshot_indexΪµĻ
+static INS_snapshot_t INS_snapshot[INS_SNAPSHOT_NUM];
+static volatile uint8_t INS_snapshot_index;
+static uint32_t INS_snapshot_seq;
+static TaskHandle_t INS_wait_task[INS_WAIT_TASK_NUM];
+
+//DWT cycle at ist8310 data ready
+//ݾʱDWT
+static volatile uint32_t mag_drdy_cycle;
+static INS_mag_stat_t INS_mag_stat;
+static INS_gyro_fifo_stat_t INS_gyro_fifo_stat;
 
 
 //ٶȼƵͨ˲
@@ -156,6 +340,12 @@ static fp32 INS_gyro[3] = {0.0f, 0.0f, 0.0f};
 static fp32 INS_accel[3] = {0.0f, 0.0f, 0.0f};
 static fp32 INS_mag[3] = {0.0f, 0.0f, 0.0f};
 static fp32 INS_quat[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+#if !INS_MAG_FUSION
+static fp32 INS_mag_none[3] = {0.0f, 0.0f, 0.0f};  //zero mag, AHRS skips the mag correction.ų, AHRS
+#endif
+#if INS_FILTER == INS_FILTER_EKF
+static quaternion_ekf_t INS_ekf;
+#endif
 fp32 INS_angle[3] = {0.0f, 0.0f, 0.0f};      //euler angle, unit rad.ŷ λ rad
 
 
@@ -175,6 +365,11 @@ fp32 INS_angle[3] = {0.0f, 0.0f, 0.0f};      //euler angle, unit rad.ŷ
 
 void INS_task(void const *pvParameters)
 {
+    bool_t gyro_sample_update;
+    uint32_t gyro_cycle = 0;
+    uint8_t gyro_frame_num = 1;
+    uint8_t gyro_frame;
+
     //wait a time
     osDelay(INS_TASK_INIT_TIME);
     while(BMI088_init())
@@ -190,8 +385,11 @@ void INS_task(void const *pvParameters)
     //rotate and zero drift 
     imu_cali_slove(INS_gyro, INS_accel, INS_mag, &bmi088_real_data, &ist8310_real_data);
 
-    PID_init(&imu_temp_pid, PID_POSITION, imu_temp_PID, TEMPERATURE_PID_MAX_OUT, TEMPERATURE_PID_MAX_IOUT);
+    PID_init(&imu_temp_pid, &imu_temp_PID);
     AHRS_init(INS_quat, INS_accel, INS_mag);
+#if INS_FILTER == INS_FILTER_EKF
+    quaternion_ekf_init(&INS_ekf, INS_accel);
+#endif
 
     accel_fliter_1[0] = accel_fliter_2[0] = accel_fliter_3[0] = INS_accel[0];
     accel_fliter_1[1] = accel_fliter_2[1] = accel_fliter_3[1] = INS_accel[1];
@@ -222,10 +420,33 @@ void INS_task(void const *pvParameters)
         }
 
 
+        //mag read over, the data is used at the next gyro sample
+        //ƶȡ, һǲʱʹ
+        if(mag_update_flag & (1 << IMU_NOTIFY_SHFITS))
+        {
+            ist8310_read_over(mag_dma_rx_buf, &ist8310_real_data);
+            INS_mag_stat.sample++;
+            INS_mag_stat.latency_us = dwt_cycle_to_us(dwt_get_cycle() - mag_drdy_cycle);
+            if (INS_mag_stat.latency_max_us < INS_mag_stat.latency_us)
+            {
+                INS_mag_stat.latency_max_us = INS_mag_stat.latency_us;
+            }
+            mag_update_flag &= ~(1 << IMU_NOTIFY_SHFITS);
+        }
+
+        gyro_sample_update = 0;
         if(gyro_update_flag & (1 << IMU_NOTIFY_SHFITS))
         {
             gyro_update_flag &= ~(1 << IMU_NOTIFY_SHFITS);
+            gyro_sample_update = 1;
+            gyro_cycle = gyro_sample_cycle;
+#if defined(BMI088_GYRO_FIFO_ENABLE)
+            gyro_frame_num = gyro_fifo_frame_num;
+            BMI088_gyro_fifo_read_over(gyro_dma_rx_buf + BMI088_GYRO_RX_BUF_DATA_OFFSET, gyro_fifo_frame, gyro_frame_num);
+#else
             BMI088_gyro_read_over(gyro_dma_rx_buf + BMI088_GYRO_RX_BUF_DATA_OFFSET, bmi088_real_data.gyro);
+            INS_dt_update(gyro_cycle);
+#endif
         }
 
         if(accel_update_flag & (1 << IMU_UPDATE_SHFITS))
@@ -240,41 +461,72 @@ void INS_task(void const *pvParameters)
             accel_temp_update_flag &= ~(1 << IMU_UPDATE_SHFITS);
             BMI088_temperature_read_over(accel_temp_dma_rx_buf + BMI088_ACCEL_RX_BUF_DATA_OFFSET, &bmi088_real_data.temp);
             imu_temp_control(bmi088_real_data.temp);
+            gyro_temp_offset_update(bmi088_real_data.temp);
         }
 
-        //rotate and zero drift 
-        imu_cali_slove(INS_gyro, INS_accel, INS_mag, &bmi088_real_data, &ist8310_real_data);
-
-
-        //ٶȼƵͨ˲
-        //accel low-pass filter
-        accel_fliter_1[0] = accel_fliter_2[0];
-        accel_fliter_2[0] = accel_fliter_3[0];
-
-        accel_fliter_3[0] = accel_fliter_2[0] * fliter_num[0] + accel_fliter_1[0] * fliter_num[1] + INS_accel[0] * fliter_num[2];
+        //the attitude is solved only at a new gyro sample, not at a mag sample
+        //ֻµʱ̬, ݻʱ
+        if(!gyro_sample_update)
+        {
+            continue;
+        }
 
-        accel_fliter_1[1] = accel_fliter_2[1];
-        accel_fliter_2[1] = accel_fliter_3[1];
+        //one frame without the FIFO, every frame of the burst with it, the accel filter runs once per INS sample
+        //δʹFIFOʱΪһ֡, ʹFIFOʱΪһζȡÿһ֡, ٶȼ˲ÿINSֻһ
+        for (gyro_frame = 0; gyro_frame < gyro_frame_num; gyro_frame++)
+        {
+#if defined(BMI088_GYRO_FIFO_ENABLE)
+            //frame i is integrated over the dt from frame i - 1 to its own sample time
+            //i֡ӵi - 1֡ʱ̵dt
+            bmi088_real_data.gyro[0] = gyro_fifo_frame[gyro_frame][0];
+            bmi088_real_data.gyro[1] = gyro_fifo_frame[gyro_frame][1];
+            bmi088_real_data.gyro[2] = gyro_fifo_frame[gyro_frame][2];
+            INS_dt_update(gyro_cycle - (uint32_t)(gyro_frame_num - 1 - gyro_frame) * GYRO_FIFO_FRAME_CYCLE);
+#endif
+            //rotate and zero drift 
+            imu_cali_slove(INS_gyro, INS_accel, INS_mag, &bmi088_real_data, &ist8310_real_data);
+
+            if (gyro_frame == 0)
+            {
+                //ٶȼƵͨ˲
+                //accel low-pass filter
+                accel_fliter_1[0] = accel_fliter_2[0];
+                accel_fliter_2[0] = accel_fliter_3[0];
 
-        accel_fliter_3[1] = accel_fliter_2[1] * fliter_num[0] + accel_fliter_1[1] * fliter_num[1] + INS_accel[1] * fliter_num[2];
+                accel_fliter_3[0] = accel_fliter_2[0] * fliter_num[0] + accel_fliter_1[0] * fliter_num[1] + INS_accel[0] * fliter_num[2];
 
-        accel_fliter_1[2] = accel_fliter_2[2];
-        accel_fliter_2[2] = accel_fliter_3[2];
+                accel_fliter_1[1] = accel_fliter_2[1];
+                accel_fliter_2[1] = accel_fliter_3[1];
 
-        accel_fliter_3[2] = accel_fliter_2[2] * fliter_num[0] + accel_fliter_1[2] * fliter_num[1] + INS_accel[2] * fliter_num[2];
+                accel_fliter_3[1] = accel_fliter_2[1] * fliter_num[0] + accel_fliter_1[1] * fliter_num[1] + INS_accel[1] * fliter_num[2];
 
+                accel_fliter_1[2] = accel_fliter_2[2];
+                accel_fliter_2[2] = accel_fliter_3[2];
 
-        AHRS_update(INS_quat, timing_time, INS_gyro, accel_fliter_3, INS_mag);
-        get_angle(INS_quat, INS_angle + INS_YAW_ADDRESS_OFFSET, INS_angle + INS_PITCH_ADDRESS_OFFSET, INS_angle + INS_ROLL_ADDRESS_OFFSET);
+                accel_fliter_3[2] = accel_fliter_2[2] * fliter_num[0] + accel_fliter_1[2] * fliter_num[1] + INS_accel[2] * fliter_num[2];
+            }
 
 
-        //because no use ist8310 and save time, no use
-        if(mag_update_flag &= 1 << IMU_DR_SHFITS)
-        {
-            mag_update_flag &= ~(1<< IMU_DR_SHFITS);
-            mag_update_flag |= (1 << IMU_SPI_SHFITS);
-//            ist8310_read_mag(ist8310_real_data.mag);
+#if INS_FILTER == INS_FILTER_EKF
+            //the EKF weights the raw accel by its deviation from gravity, no low-pass filter
+            //EKFݼٶƫĳ̶ȵζ, ʹδ˲ļٶ
+            quaternion_ekf_update(&INS_ekf, INS_dt, INS_gyro, INS_accel);
+            INS_quat[0] = INS_ekf.q[0];
+            INS_quat[1] = INS_ekf.q[1];
+            INS_quat[2] = INS_ekf.q[2];
+            INS_quat[3] = INS_ekf.q[3];
+#else
+#if INS_MAG_FUSION
+            AHRS_update(INS_quat, INS_dt, INS_gyro, accel_fliter_3, INS_mag);
+#else
+            AHRS_update(INS_quat, INS_dt, INS_gyro, accel_fliter_3, INS_mag_none);
+#endif
+#endif
         }
+        gyro_temp_learn(INS_gyro, INS_accel, bmi088_real_data.temp);
+        get_angle(INS_quat, INS_angle + INS_YAW_ADDRESS_OFFSET, INS_angle + INS_PITCH_ADDRESS_OFFSET, INS_angle + INS_ROLL_ADDRESS_OFFSET);
+        INS_snapshot_publish(gyro_cycle);
+        vibration_sample(INS_gyro, INS_accel, gyro_cycle);
 
     }
 }
@@ -323,35 +575,154 @@ static void imu_cali_slove(fp32 gyro[3], fp32 accel[3], fp32 mag[3], bmi088_real
   */
 static void imu_temp_control(fp32 temp)
 {
+    static uint32_t start_tick;
+    static uint32_t ready_tick;
+    static uint32_t learn_tick;
+    static fp32 learn_temp;
+    static fp32 learn_gain;
+    static fp32 learn_out_sum;
+    static uint32_t learn_out_num;
+    static bool_t cold_boot;
+    uint32_t now = xTaskGetTickCount();
+    fp32 target = get_control_temperature();
+    fp32 hold_out;
     uint16_t tempPWM;
-    static uint8_t temp_constant_time = 0;
-    if (first_temperate)
+
+    if (INS_heater_stat.mode == HEATER_MODE_INIT)
     {
-        PID_calc(&imu_temp_pid, temp, get_control_temperature());
-        if (imu_temp_pid.out < 0.0f)
+        start_tick = now;
+        INS_heater_stat.start_temp = temp;
+        //at a cold boot the imu temperature is the ambient temperature
+        //ʱimu¶ȼΪ¶
+        cold_boot = target - temp > HEATER_LEARN_MIN_RISE;
+        INS_heater_stat.mode = HEATER_MODE_WARM_UP;
+    }
+
+    if (INS_heater_stat.mode == HEATER_MODE_WARM_UP)
+    {
+        //ѧϰȫ, ɢб
+        //learn the gain by the slope at full power, corrected by the heat loss
+        if (cold_boot && learn_tick == 0 && now - start_tick >= HEATER_GAIN_LEARN_START)
+        {
+            learn_tick = now;
+            learn_temp = temp;
+        }
+        else if (cold_boot && learn_tick != 0 && learn_gain == 0.0f && now - start_tick >= HEATER_GAIN_LEARN_END)
         {
-            imu_temp_pid.out = 0.0f;
+            learn_gain = (temp - learn_temp) / ((now - learn_tick) * 0.001f)
+                       + ((temp + learn_temp) * 0.5f - INS_heater_stat.start_temp) / INS_heater_stat.tau;
         }
-        tempPWM = (uint16_t)imu_temp_pid.out;
-        IMU_temp_PWM(tempPWM);
+
+        //the temperature keeps rising in the lag time after braking, brake early by that rise
+        //ֹͣȫʺ¶ͺʱڼ, ǰֹͣ
+        if (target - temp > INS_heater_stat.gain * HEATER_LAG_TIME)
+        {
+            IMU_temp_PWM(MPU6500_TEMP_PWM_MAX - 1);
+            return;
+        }
+
+        //ԤΪģάֹ, ֱӽ̬ǴӰ빦
+        //preload the integrator with the hold power of the model, instead of half power
+        hold_out = (target - INS_heater_stat.start_temp) / (INS_heater_stat.gain * INS_heater_stat.tau) * MPU6500_TEMP_PWM_MAX;
+        if (hold_out < 0.0f)
+        {
+            hold_out = 0.0f;
+        }
+        else if (hold_out > TEMPERATURE_PID_MAX_IOUT)
+        {
+            hold_out = TEMPERATURE_PID_MAX_IOUT;
+        }
+        imu_temp_pid.Iout = hold_out;
+        INS_heater_stat.mode = HEATER_MODE_HOLD;
     }
-    else
+
+    PID_calc(&imu_temp_pid, TEMPERATURE_PID_FLAG, temp, target, dwt_get_dt(&imu_temp_cycle, TEMPERATURE_PID_DT));
+    if (imu_temp_pid.out < 0.0f)
+    {
+        imu_temp_pid.out = 0.0f;
+    }
+    tempPWM = (uint16_t)imu_temp_pid.out;
+    IMU_temp_PWM(tempPWM);
+
+    if (INS_heater_stat.ready_time_ms == 0)
+    {
+        if (temp > target - HEATER_READY_BAND && temp < target + HEATER_READY_BAND)
+        {
+            if (ready_tick == 0)
+            {
+                ready_tick = now;
+            }
+            else if (now - ready_tick >= HEATER_READY_TIME)
+            {
+                INS_heater_stat.ready_time_ms = ready_tick;
+                learn_tick = now;
+            }
+        }
+        else
+        {
+            ready_tick = 0;
+        }
+    }
+    else if (cold_boot && learn_gain > 0.0f && learn_out_num != 0xFFFFFFFF)
     {
-        //ûдﵽõ¶ȣһֱʼ
-        //in beginning, max power
-        if (temp > get_control_temperature())
+        //άֹ = (T - T_ambient) / (gain * tau), ɾȶƽѧϰtau
+        //hold power = (T - T_ambient) / (gain * tau), learn tau by the mean out once settled after ready
+        if (now - learn_tick >= HEATER_TAU_LEARN_DELAY)
+        {
+            learn_out_sum += imu_temp_pid.out;
+            learn_out_num++;
+        }
+        if (now - learn_tick >= HEATER_TAU_LEARN_DELAY + HEATER_TAU_LEARN_TIME)
         {
-            temp_constant_time++;
-            if (temp_constant_time > 200)
+            hold_out = learn_out_num ? learn_out_sum / learn_out_num : 0.0f;
+            if (hold_out > 0.0f)
             {
-                //ﵽ¶ȣΪһʣ
-                //
-                first_temperate = 1;
-                imu_temp_pid.Iout = MPU6500_TEMP_PWM_MAX / 2.0f;
+                imu_heater_learn(learn_gain, (target - INS_heater_stat.start_temp) * MPU6500_TEMP_PWM_MAX / (learn_gain * hold_out));
             }
+            learn_out_num = 0xFFFFFFFF;
         }
+    }
+}
+
+/**
+  * @brief          take a heater model learned at this boot, blend it with the one in use
+  * @param[in]      gain: learned heating rate at full power, unit /s
+  * @param[in]      tau: learned heat loss time constant, unit s
+  * @retval         none
+  */
+/**
+  * @brief          ñѧϰļģ, 뵱ǰģں
+  * @param[in]      gain: ѧϰȫ λ /s
+  * @param[in]      tau: ѧϰɢʱ䳣 λ s
+  * @retval         none
+  */
+static void imu_heater_learn(fp32 gain, fp32 tau)
+{
+    fp32 gain_diff, tau_diff;
 
-        IMU_temp_PWM(MPU6500_TEMP_PWM_MAX - 1);
+    if (gain < HEATER_GAIN_MIN || gain > HEATER_GAIN_MAX || tau < HEATER_TAU_MIN || tau > HEATER_TAU_MAX)
+    {
+        return;
+    }
+    //average with the saved model, a single boot is noisy
+    //ѱģȡƽ, Ľϴ
+    if (heater_model_saved)
+    {
+        gain = (gain + INS_heater_stat.gain) * 0.5f;
+        tau = (tau + INS_heater_stat.tau) * 0.5f;
+    }
+
+    gain_diff = (gain - INS_heater_stat.gain) / INS_heater_stat.gain;
+    tau_diff = (tau - INS_heater_stat.tau) / INS_heater_stat.tau;
+    INS_heater_stat.gain = gain;
+    INS_heater_stat.tau = tau;
+    //flash is erased to save, only when the model changes
+    //Ҫflash, ֻģͱ仯ʱ
+    if (!heater_model_saved || gain_diff > HEATER_MODEL_SAVE_DIFF || gain_diff < -HEATER_MODEL_SAVE_DIFF
+        || tau_diff > HEATER_MODEL_SAVE_DIFF || tau_diff < -HEATER_MODEL_SAVE_DIFF)
+    {
+        heater_model_saved = 1;
+        heater_model_save = 1;
     }
 }
 
@@ -404,7 +775,13 @@ void INS_cali_gyro(fp32 cali_scale[3], fp32 cali_offset[3], uint16_t *time_count
             gyro_offset[1] = gyro_cali_offset[1];
             gyro_offset[2] = gyro_cali_offset[2];
         }
+        gyro_cali_tick = xTaskGetTickCount() | 1;
         gyro_offset_calc(gyro_offset, INS_gyro, time_count);
+        //used out of the temperature table
+        //¶ȱΧʹ
+        gyro_cali_offset[0] = gyro_offset[0];
+        gyro_cali_offset[1] = gyro_offset[1];
+        gyro_cali_offset[2] = gyro_offset[2];
 
         cali_offset[0] = gyro_offset[0];
         cali_offset[1] = gyro_offset[1];
@@ -437,6 +814,573 @@ void INS_set_cali_gyro(fp32 cali_scale[3], fp32 cali_offset[3])
     gyro_offset[2] = gyro_cali_offset[2];
 }
 
+/**
+  * @brief          learn the gyro zero drift of the temperature in a still window
+  * @param[in]      gyro: gyro after imu_cali_slove, unit rad/s
+  * @param[in]      accel: accel after imu_cali_slove, unit m/s2
+  * @param[in]      temp: bmi088 temperature
+  * @retval         none
+  */
+/**
+  * @brief          ھֹѧϰ¶µƯ
+  * @param[in]      gyro: imu_cali_slove֮Ľٶ λ rad/s
+  * @param[in]      accel: imu_cali_slove֮ļٶ λ m/s2
+  * @param[in]      temp: bmi088¶
+  * @retval         none
+  */
+static void gyro_temp_learn(const fp32 gyro[3], const fp32 accel[3], fp32 temp)
+{
+    fp32 accel_norm2 = accel[0] * accel[0] + accel[1] * accel[1] + accel[2] * accel[2];
+    fp32 gravity = get_carrier_gravity();
+    fp32 bin_f;
+    fp32 diff;
+    fp32 mean;
+    uint16_t n;
+    uint8_t bin;
+    uint8_t i;
+
+    if (!gyro_temp_cmd_idle() ||
+        accel_norm2 > (gravity + GYRO_TEMP_STILL_ACCEL) * (gravity + GYRO_TEMP_STILL_ACCEL) ||
+        accel_norm2 < (gravity - GYRO_TEMP_STILL_ACCEL) * (gravity - GYRO_TEMP_STILL_ACCEL))
+    {
+        gyro_temp_still_count = 0;
+        return;
+    }
+
+    if (gyro_temp_still_count == 0)
+    {
+        for (i = 0; i < 3; i++)
+        {
+            gyro_temp_sum[i] = 0.0f;
+            gyro_temp_rate_sum[i] = 0.0f;
+            gyro_temp_rate_sq_sum[i] = 0.0f;
+        }
+        gyro_temp_temp_sum = 0.0f;
+    }
+    //the offset in use is taken back, so it does not matter whether it came from the table
+    //ȥǰʹõƯ, Ƿ¶ȱ޹
+    for (i = 0; i < 3; i++)
+    {
+        gyro_temp_sum[i] += gyro[i] - gyro_offset[i];
+        gyro_temp_rate_sum[i] += gyro[i];
+        gyro_temp_rate_sq_sum[i] += gyro[i] * gyro[i];
+    }
+    gyro_temp_temp_sum += temp;
+    gyro_temp_still_count++;
+    if (gyro_temp_still_count < GYRO_TEMP_STILL_TIME)
+    {
+        return;
+    }
+    gyro_temp_still_count = 0;
+
+    //a slow turn or a shake in the window is not zero drift
+    //ڵת򶶶Ư
+    for (i = 0; i < 3; i++)
+    {
+        mean = gyro_temp_rate_sum[i] / GYRO_TEMP_STILL_TIME;
+        if (mean > GYRO_TEMP_STILL_GYRO || mean < -GYRO_TEMP_STILL_GYRO ||
+            gyro_temp_rate_sq_sum[i] / GYRO_TEMP_STILL_TIME - mean * mean > GYRO_TEMP_STILL_GYRO_STD * GYRO_TEMP_STILL_GYRO_STD)
+        {
+            return;
+        }
+    }
+
+    bin_f = (gyro_temp_temp_sum / GYRO_TEMP_STILL_TIME - GYRO_TEMP_MIN) / GYRO_TEMP_STEP + 0.5f;
+    if (bin_f < 0.0f || bin_f >= GYRO_TEMP_BIN_NUM)
+    {
+        return;
+    }
+    bin = (uint8_t)bin_f;
+
+    n = gyro_temp_table.count[bin] < GYRO_TEMP_AVG_MAX ? gyro_temp_table.count[bin] + 1 : GYRO_TEMP_AVG_MAX;
+    for (i = 0; i < 3; i++)
+    {
+        gyro_temp_table.offset[bin][i] += (-gyro_temp_sum[i] / GYRO_TEMP_STILL_TIME - gyro_temp_table.offset[bin][i]) / n;
+    }
+    if (gyro_temp_table.count[bin] < 0xFFFF)
+    {
+        gyro_temp_table.count[bin]++;
+    }
+
+    if (gyro_temp_table.count[bin] < GYRO_TEMP_VALID_COUNT)
+    {
+        return;
+    }
+    if (gyro_temp_saved.count[bin] < GYRO_TEMP_VALID_COUNT)
+    {
+        gyro_temp_save = 1;
+        return;
+    }
+    for (i = 0; i < 3; i++)
+    {
+        diff = gyro_temp_table.offset[bin][i] - gyro_temp_saved.offset[bin][i];
+        if (diff > GYRO_TEMP_SAVE_DIFF || diff < -GYRO_TEMP_SAVE_DIFF)
+        {
+            gyro_temp_save = 1;
+        }
+    }
+}
+
+/**
+  * @brief          no chassis or gimbal command: the remote control is off, or the rockers are in
+  *                 GYRO_TEMP_STILL_RC and there is no mouse or key
+  * @param[in]      none
+  * @retval         1: no command, 0: command
+  */
+/**
+  * @brief          ûеָ̨̺: ң, ҡGYRO_TEMP_STILL_RCûͰ
+  * @param[in]      none
+  * @retval         1: ûָ, 0: ָ
+  */
+static bool_t gyro_temp_cmd_idle(void)
+{
+    const RC_ctrl_t *rc = get_remote_control_point();
+    uint8_t i;
+
+    //chassis and gimbal have no force when the remote control is off
+    //ңʱ̨̺
+    if (toe_is_error(DBUS_TOE))
+    {
+        return 1;
+    }
+    for (i = 0; i < 5; i++)
+    {
+        if (rc->rc.ch[i] > GYRO_TEMP_STILL_RC || rc->rc.ch[i] < -GYRO_TEMP_STILL_RC)
+        {
+            return 0;
+        }
+    }
+    return rc->mouse.x == 0 && rc->mouse.y == 0 && rc->mouse.z == 0 && rc->key.v == 0;
+}
+
+/**
+  * @brief          set gyro_offset from the table at the temperature, or the calibrated offset out of the table
+  * @param[in]      temp: bmi088 temperature
+  * @retval         none
+  */
+/**
+  * @brief          ¶ȴӱgyro_offset, ûи¶ʱʹУ׼Ư
+  * @param[in]      temp: bmi088¶
+  * @retval         none
+  */
+static void gyro_temp_offset_update(fp32 temp)
+{
+    fp32 bin_f = (temp - GYRO_TEMP_MIN) / GYRO_TEMP_STEP;
+    fp32 w;
+    int32_t lo;
+    bool_t lo_valid;
+    bool_t hi_valid;
+    uint8_t i;
+
+    //gyro_offset is being calibrated
+    //gyro_offsetУ׼
+    if (gyro_cali_tick != 0 && xTaskGetTickCount() - gyro_cali_tick < GYRO_TEMP_CALI_HOLD)
+    {
+        return;
+    }
+
+    lo = (bin_f < 0.0f) ? -1 : (int32_t)bin_f;
+    w = bin_f - lo;
+    lo_valid = lo >= 0 && lo < GYRO_TEMP_BIN_NUM && gyro_temp_table.count[lo] >= GYRO_TEMP_VALID_COUNT;
+    hi_valid = lo + 1 >= 0 && lo + 1 < GYRO_TEMP_BIN_NUM && gyro_temp_table.count[lo + 1] >= GYRO_TEMP_VALID_COUNT;
+
+    for (i = 0; i < 3; i++)
+    {
+        if (lo_valid && hi_valid)
+        {
+            gyro_offset[i] = gyro_temp_table.offset[lo][i] + w * (gyro_temp_table.offset[lo + 1][i] - gyro_temp_table.offset[lo][i]);
+        }
+        //half a bin out of the learned range at most
+        //೬ѧϰΧ
+        else if (lo_valid && w < 0.5f)
+        {
+            gyro_offset[i] = gyro_temp_table.offset[lo][i];
+        }
+        else if (hi_valid && w >= 0.5f)
+        {
+            gyro_offset[i] = gyro_temp_table.offset[lo + 1][i];
+        }
+        else
+        {
+            gyro_offset[i] = gyro_cali_offset[i];
+        }
+    }
+}
+
+/**
+  * @brief          measure dt between gyro samples from their data ready time
+  * @param[in]      sample_cycle: DWT cycle at the data ready of the sample
+  * @retval         none
+  */
+/**
+  * @brief          ݾʱ̼
+  * @param[in]      sample_cycle: ôβݾʱDWT
+  * @retval         none
+  */
+static void INS_dt_update(uint32_t sample_cycle)
+{
+    static uint32_t last_sample_cycle;
+    static uint8_t first_sample = 1;
+    uint32_t dt_cycle = sample_cycle - last_sample_cycle;
+    uint32_t dt_us = dwt_cycle_to_us(dt_cycle);
+    int32_t bin;
+
+    last_sample_cycle = sample_cycle;
+    if (first_sample)
+    {
+        first_sample = 0;
+        return;
+    }
+
+    bin = ((int32_t)dt_us - (INS_DT_FRAME_US - INS_DT_HIST_NUM / 2 * INS_DT_HIST_STEP_US)) / INS_DT_HIST_STEP_US;
+    if (bin < 0)
+    {
+        bin = 0;
+    }
+    else if (bin > INS_DT_HIST_NUM - 1)
+    {
+        bin = INS_DT_HIST_NUM - 1;
+    }
+    INS_dt_hist.count[bin]++;
+    if (INS_dt_hist.dt_max_us < dt_us)
+    {
+        INS_dt_hist.dt_max_us = dt_us;
+    }
+    if (INS_dt_hist.dt_min_us == 0 || INS_dt_hist.dt_min_us > dt_us)
+    {
+        INS_dt_hist.dt_min_us = dt_us;
+    }
+
+    if (dt_us == 0 || dt_us > INS_DT_MAX_US)
+    {
+        INS_dt = timing_time;
+    }
+    else
+    {
+        INS_dt = (fp32)dt_cycle / (fp32)SystemCoreClock;
+    }
+}
+
+/**
+  * @brief          publish the current sample to the snapshot buffers and wake waiting tasks
+  * @param[in]      sample_cycle: DWT cycle at the data ready of the sample
+  * @retval         none
+  */
+/**
+  * @brief          ݷջ, ѵȴ
+  * @param[in]      sample_cycle: ôβݾʱDWT
+  * @retval         none
+  */
+static void INS_snapshot_publish(uint32_t sample_cycle)
+{
+    INS_snapshot_t *snapshot;
+    uint8_t index = INS_snapshot_index + 1;
+    uint8_t i;
+
+    if (index >= INS_SNAPSHOT_NUM)
+    {
+        index = 0;
+    }
+    snapshot = &INS_snapshot[index];
+
+    snapshot->seq = 0;
+    __DMB();
+    for (i = 0; i < 4; i++)
+    {
+        snapshot->quat[i] = INS_quat[i];
+    }
+    for (i = 0; i < 3; i++)
+    {
+        snapshot->angle[i] = INS_angle[i];
+        snapshot->gyro[i] = INS_gyro[i];
+        snapshot->accel[i] = INS_accel[i];
+    }
+    snapshot->sample_cycle = sample_cycle;
+    INS_snapshot_seq++;
+    if (INS_snapshot_seq == 0)
+    {
+        INS_snapshot_seq = 1;
+    }
+    __DMB();
+    snapshot->seq = INS_snapshot_seq;
+    __DMB();
+    INS_snapshot_index = index;
+
+    for (i = 0; i < INS_WAIT_TASK_NUM; i++)
+    {
+        if (INS_wait_task[i] != NULL)
+        {
+            xTaskNotifyGive(INS_wait_task[i]);
+        }
+    }
+}
+
+/**
+  * @brief          copy the latest INS sample, wait-free for the reader, never torn by INS_task.
+  *                 the arrays returned by get_xxx_point may change while they are read,
+  *                 control loop should use this function once per cycle.
+  * @param[out]     snapshot: copy of the latest sample
+  * @retval         1: a sample has been published, 0: no sample yet
+  */
+/**
+  * @brief          µINS, ȡȴ, ᱻINS_taskд.
+  *                 get_xxx_pointصڶȡбд,
+  *                 ѭӦÿڵһα
+  * @param[out]     snapshot: ݵĸ
+  * @retval         1:, 0:
+  */
+bool_t get_INS_snapshot(INS_snapshot_t *snapshot)
+{
+    uint8_t index;
+    uint32_t seq;
+
+    if (snapshot == NULL)
+    {
+        return 0;
+    }
+
+    //INS_task writes another buffer, a retry only happens when the reader is
+    //preempted for INS_SNAPSHOT_NUM - 1 samples during the copy
+    //INS_taskд, ֻиƹбϳINS_SNAPSHOT_NUM - 1βŻ
+    do
+    {
+        index = INS_snapshot_index;
+        __DMB();
+        seq = INS_snapshot[index].seq;
+        __DMB();
+        *snapshot = INS_snapshot[index];
+        __DMB();
+    } while (seq != INS_snapshot[index].seq || (seq == 0 && INS_snapshot_seq != 0));
+
+    return snapshot->seq != 0;
+}
+
+/**
+  * @brief          block until a sample newer than last_seq is published, then copy it.
+  *                 at most INS_WAIT_TASK_NUM tasks can call it.
+  * @param[out]     snapshot: copy of the new sample
+  * @param[in]      last_seq: seq of the sample already used, 0 to wait for the first one
+  * @param[in]      timeout: max wait time, unit ms
+  * @retval         1: new sample, 0: timeout or too many waiting tasks, snapshot is the latest one
+  */
+/**
+  * @brief          ֱlast_seqµ, Ƹ.
+  *                 INS_WAIT_TASK_NUMԵ
+  * @param[out]     snapshot: ݵĸ
+  * @param[in]      last_seq: ʹݵ, 0Ϊȴһ
+  * @param[in]      timeout: ȴʱ λ ms
+  * @retval         1:õ, 0:ʱȴ, snapshotΪ
+  */
+bool_t INS_wait_snapshot(INS_snapshot_t *snapshot, uint32_t last_seq, uint32_t timeout)
+{
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+    uint8_t i;
+
+    if (snapshot == NULL)
+    {
+        return 0;
+    }
+
+    //register once, INS_task notifies every registered task at each sample
+    //״εʱע, INS_taskÿβ֪ͨע
+    taskENTER_CRITICAL();
+    for (i = 0; i < INS_WAIT_TASK_NUM; i++)
+    {
+        if (INS_wait_task[i] == task)
+        {
+            break;
+        }
+    }
+    if (i == INS_WAIT_TASK_NUM)
+    {
+        for (i = 0; i < INS_WAIT_TASK_NUM; i++)
+        {
+            if (INS_wait_task[i] == NULL)
+            {
+                INS_wait_task[i] = task;
+                break;
+            }
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    if (i == INS_WAIT_TASK_NUM)
+    {
+        get_INS_snapshot(snapshot);
+        return 0;
+    }
+
+    //a notify given between the check and the take is kept, so no sample is missed
+    //ȴ֮䷢֪ͨᱻ, ©
+    while (1)
+    {
+        get_INS_snapshot(snapshot);
+        if (snapshot->seq != 0 && snapshot->seq != last_seq)
+        {
+            return 1;
+        }
+        if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeout)) == 0)
+        {
+            get_INS_snapshot(snapshot);
+            return 0;
+        }
+    }
+}
+
+/**
+  * @brief          get the histogram of the measured integration dt
+  * @param[in]      none
+  * @retval         the point of the dt histogram
+  */
+/**
+  * @brief          ȡʵʱֱͼ
+  * @param[in]      none
+  * @retval         dtֱͼָ
+  */
+const INS_dt_hist_t *get_INS_dt_hist_point(void)
+{
+    return &INS_dt_hist;
+}
+
+/**
+  * @brief          get the ist8310 read statistics
+  * @param[in]      none
+  * @retval         the point of the statistics
+  */
+/**
+  * @brief          ȡƶȡͳ
+  * @param[in]      none
+  * @retval         ͳݵָ
+  */
+const INS_mag_stat_t *get_INS_mag_stat_point(void)
+{
+    return &INS_mag_stat;
+}
+
+/**
+  * @brief          get the gyro FIFO read statistics
+  * @param[in]      none
+  * @retval         the point of the statistics
+  */
+/**
+  * @brief          ȡFIFOȡͳ
+  * @param[in]      none
+  * @retval         ͳݵָ
+  */
+const INS_gyro_fifo_stat_t *get_INS_gyro_fifo_stat_point(void)
+{
+    return &INS_gyro_fifo_stat;
+}
+
+/**
+  * @brief          set the heater thermal model, called by calibrate with the model in flash
+  * @param[in]      gain: heating rate at full power, unit /s
+  * @param[in]      tau: heat loss time constant, unit s
+  * @retval         none
+  */
+/**
+  * @brief          üģ, У׼flashеģ͵
+  * @param[in]      gain: ȫ λ /s
+  * @param[in]      tau: ɢʱ䳣 λ s
+  * @retval         none
+  */
+void INS_set_heater_model(fp32 gain, fp32 tau)
+{
+    if (gain < HEATER_GAIN_MIN || gain > HEATER_GAIN_MAX || tau < HEATER_TAU_MIN || tau > HEATER_TAU_MAX)
+    {
+        return;
+    }
+    INS_heater_stat.gain = gain;
+    INS_heater_stat.tau = tau;
+    heater_model_saved = 1;
+}
+
+/**
+  * @brief          get the heater thermal model learned at this boot, once
+  * @param[out]     gain: heating rate at full power, unit /s
+  * @param[out]     tau: heat loss time constant, unit s
+  * @retval         1: a new model to save, 0: none
+  */
+/**
+  * @brief          ȡѧϰļģ, ֻһ
+  * @param[out]     gain: ȫ λ /s
+  * @param[out]     tau: ɢʱ䳣 λ s
+  * @retval         1: Ҫģ, 0: 
+  */
+bool_t INS_get_heater_model(fp32 *gain, fp32 *tau)
+{
+    if (gain == NULL || tau == NULL || !heater_model_save)
+    {
+        return 0;
+    }
+    *gain = INS_heater_stat.gain;
+    *tau = INS_heater_stat.tau;
+    heater_model_save = 0;
+    return 1;
+}
+
+/**
+  * @brief          set the gyro zero drift vs temperature table, called by calibrate with the table in flash
+  * @param[in]      table: the table
+  * @retval         none
+  */
+/**
+  * @brief          Ư¶ȱ, У׼flashеı
+  * @param[in]      table: Ư¶ȱ
+  * @retval         none
+  */
+void INS_set_gyro_temp_table(const INS_gyro_temp_table_t *table)
+{
+    if (table == NULL)
+    {
+        return;
+    }
+    gyro_temp_table = *table;
+    gyro_temp_saved = *table;
+}
+
+/**
+  * @brief          get the learned gyro zero drift vs temperature table when it should be saved
+  * @param[out]     table: the table
+  * @retval         1: a table to save, 0: none
+  */
+/**
+  * @brief          ҪʱȡѧϰƯ¶ȱ
+  * @param[out]     table: Ư¶ȱ
+  * @retval         1: Ҫı, 0: 
+  */
+bool_t INS_get_gyro_temp_table(INS_gyro_temp_table_t *table)
+{
+    //flash erase stalls the cpu, not too often
+    //flashʹcpuͣ, Ƶ
+    if (table == NULL || !gyro_temp_save || xTaskGetTickCount() - gyro_temp_save_tick < GYRO_TEMP_SAVE_TIME)
+    {
+        return 0;
+    }
+    taskENTER_CRITICAL();
+    *table = gyro_temp_table;
+    gyro_temp_saved = gyro_temp_table;
+    gyro_temp_save = 0;
+    taskEXIT_CRITICAL();
+    gyro_temp_save_tick = xTaskGetTickCount();
+    return 1;
+}
+
+/**
+  * @brief          get the heater statistics, include time to ready
+  * @param[in]      none
+  * @retval         the point of the statistics
+  */
+/**
+  * @brief          ȡͳ, ʱ
+  * @param[in]      none
+  * @retval         ͳݵָ
+  */
+const INS_heater_stat_t *get_INS_heater_stat_point(void)
+{
+    return &INS_heater_stat;
+}
+
 /**
   * @brief          get the quat
   * @param[in]      none
@@ -525,6 +1469,7 @@ void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
     else if(GPIO_Pin == INT1_GYRO_Pin)
     {
         detect_hook(BOARD_GYRO_TOE);
+        gyro_drdy_cycle = dwt_get_cycle();
         gyro_update_flag |= 1 << IMU_DR_SHFITS;
         if(imu_start_dma_flag)
         {
@@ -534,7 +1479,12 @@ void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
     else if(GPIO_Pin == DRDY_IST8310_Pin)
     {
         detect_hook(BOARD_MAG_TOE);
+        mag_drdy_cycle = dwt_get_cycle();
         mag_update_flag |= 1 << IMU_DR_SHFITS;
+        if(imu_start_dma_flag)
+        {
+            imu_cmd_i2c_dma();
+        }
     }
     else if(GPIO_Pin == GPIO_PIN_0)
     {
@@ -574,9 +1524,17 @@ static void imu_cmd_spi_dma(void)
     {
         gyro_update_flag &= ~(1 << IMU_DR_SHFITS);
         gyro_update_flag |= (1 << IMU_SPI_SHFITS);
+        gyro_spi_cycle = gyro_drdy_cycle;
 
         HAL_GPIO_WritePin(CS1_GYRO_GPIO_Port, CS1_GYRO_Pin, GPIO_PIN_RESET);
+#if defined(BMI088_GYRO_FIFO_ENABLE)
+        //the frame count first, the burst length depends on it
+        //ȶ֡, ȡ
+        gyro_fifo_step = GYRO_FIFO_READ_STATUS;
+        SPI1_DMA_enable((uint32_t)gyro_fifo_status_tx_buf, (uint32_t)gyro_fifo_status_rx_buf, sizeof(gyro_fifo_status_tx_buf));
+#else
         SPI1_DMA_enable((uint32_t)gyro_dma_tx_buf, (uint32_t)gyro_dma_rx_buf, SPI_DMA_GYRO_LENGHT);
+#endif
         taskEXIT_CRITICAL_FROM_ISR(uxSavedInterruptStatus);
         return;
     }
@@ -611,6 +1569,147 @@ static void imu_cmd_spi_dma(void)
 }
 
 
+/**
+  * @brief          start the ist8310 I2C DMA read at its data ready, called in EXTI interrupt
+  * @param[in]      none
+  * @retval         none
+  */
+/**
+  * @brief          ݾʱI2C DMAȡ, ⲿже
+  * @param[in]      none
+  * @retval         none
+  */
+static void imu_cmd_i2c_dma(void)
+{
+    uint32_t isr_cycle;
+
+    mag_update_flag &= ~(1 << IMU_DR_SHFITS);
+    //the last read is not over or not handled by INS_task
+    //ϴζȡδɻINS_taskδ
+    if(mag_update_flag & ((1 << IMU_SPI_SHFITS) | (1 << IMU_NOTIFY_SHFITS)))
+    {
+        INS_mag_stat.drop++;
+        return;
+    }
+
+    if(ist8310_read_mag_DMA(mag_dma_rx_buf))
+    {
+        mag_update_flag |= (1 << IMU_SPI_SHFITS);
+    }
+    else
+    {
+        INS_mag_stat.drop++;
+    }
+
+    isr_cycle = dwt_get_cycle() - mag_drdy_cycle;
+    if(INS_mag_stat.isr_cycle_max < isr_cycle)
+    {
+        INS_mag_stat.isr_cycle_max = isr_cycle;
+    }
+}
+
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    uint32_t isr_cycle;
+
+    if(hi2c == &hi2c3 && (mag_update_flag & (1 << IMU_SPI_SHFITS)))
+    {
+        isr_cycle = dwt_get_cycle();
+        mag_update_flag &= ~(1 << IMU_SPI_SHFITS);
+        mag_update_flag |= (1 << IMU_NOTIFY_SHFITS);
+        __HAL_GPIO_EXTI_GENERATE_SWIT(GPIO_PIN_0);
+
+        isr_cycle = dwt_get_cycle() - isr_cycle;
+        if(INS_mag_stat.isr_cycle_max < isr_cycle)
+        {
+            INS_mag_stat.isr_cycle_max = isr_cycle;
+        }
+    }
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+    if(hi2c == &hi2c3)
+    {
+        mag_update_flag &= ~(1 << IMU_SPI_SHFITS);
+        INS_mag_stat.error++;
+    }
+}
+
+#if defined(BMI088_GYRO_FIFO_ENABLE)
+/**
+  * @brief          next step of the gyro FIFO read at the end of a SPI DMA, called in DMA interrupt
+  * @param[in]      none
+  * @retval         none
+  */
+/**
+  * @brief          SPI DMAʱFIFOȡһ, DMAже
+  * @param[in]      none
+  * @retval         none
+  */
+static void gyro_fifo_dma_over(void)
+{
+    uint8_t status;
+    uint8_t frame_num;
+    uint8_t i;
+
+    if (gyro_fifo_step == GYRO_FIFO_READ_STATUS)
+    {
+        status = gyro_fifo_status_rx_buf[1];
+        if (status & BMI088_GYRO_FIFO_OVERRUN)
+        {
+            //frames were lost, the overrun flag is only cleared by a write of FIFO_CONFIG_1, which also empties the FIFO
+            //֡ʧ, ־ֻͨдFIFO_CONFIG_1, ͬʱFIFO
+            INS_gyro_fifo_stat.overrun++;
+            gyro_fifo_step = GYRO_FIFO_CLEAR;
+            HAL_GPIO_WritePin(CS1_GYRO_GPIO_Port, CS1_GYRO_Pin, GPIO_PIN_RESET);
+            SPI1_DMA_enable((uint32_t)gyro_fifo_clear_tx_buf, (uint32_t)gyro_fifo_status_rx_buf, sizeof(gyro_fifo_clear_tx_buf));
+            return;
+        }
+
+        frame_num = status & BMI088_GYRO_FIFO_FRAME_COUNT;
+        if (frame_num > BMI088_GYRO_FIFO_DEPTH)
+        {
+            frame_num = BMI088_GYRO_FIFO_DEPTH;
+        }
+        if (frame_num != 0)
+        {
+            //every frame is read, a frame left behind would keep the FIFO above the watermark and delay every later sample
+            //ȫ֡, ֡ʹFIFOˮλ֮, ʹ֮ÿݶӳ
+            gyro_fifo_frame_num = frame_num;
+            gyro_fifo_step = GYRO_FIFO_READ_DATA;
+            HAL_GPIO_WritePin(CS1_GYRO_GPIO_Port, CS1_GYRO_Pin, GPIO_PIN_RESET);
+            SPI1_DMA_enable((uint32_t)gyro_dma_tx_buf, (uint32_t)gyro_dma_rx_buf, 1 + frame_num * BMI088_GYRO_FIFO_FRAME_SIZE);
+            return;
+        }
+        INS_gyro_fifo_stat.empty++;
+    }
+
+    gyro_update_flag &= ~(1 << IMU_SPI_SHFITS);
+    if (gyro_fifo_step == GYRO_FIFO_READ_DATA)
+    {
+        //the watermark interrupt is at frame BMI088_GYRO_FIFO_FRAME_NUM - 1, the sample cycle is the one of the last frame
+        //ˮλж϶ӦBMI088_GYRO_FIFO_FRAME_NUM - 1֡, ʱΪһ֡ʱ
+        frame_num = gyro_fifo_frame_num;
+        gyro_sample_cycle = gyro_spi_cycle + (uint32_t)((int32_t)frame_num - BMI088_GYRO_FIFO_FRAME_NUM) * GYRO_FIFO_FRAME_CYCLE;
+        gyro_update_flag |= (1 << IMU_UPDATE_SHFITS);
+        for (i = 0; i < frame_num; i++)
+        {
+            imu_capture_write(IMU_CAPTURE_GYRO, gyro_sample_cycle - (uint32_t)(frame_num - 1 - i) * GYRO_FIFO_FRAME_CYCLE,
+                              gyro_dma_rx_buf + i * BMI088_GYRO_FIFO_FRAME_SIZE, BMI088_GYRO_RX_BUF_DATA_OFFSET + BMI088_GYRO_FIFO_FRAME_SIZE);
+        }
+
+        INS_gyro_fifo_stat.burst++;
+        INS_gyro_fifo_stat.frame += frame_num;
+        if (INS_gyro_fifo_stat.frame_max < frame_num)
+        {
+            INS_gyro_fifo_stat.frame_max = frame_num;
+        }
+    }
+    gyro_fifo_step = GYRO_FIFO_READ_STATUS;
+}
+#endif
+
 void DMA2_Stream2_IRQHandler(void)
 {
 
@@ -622,11 +1721,17 @@ void DMA2_Stream2_IRQHandler(void)
         //Ƕȡ
         if(gyro_update_flag & (1 << IMU_SPI_SHFITS))
         {
+#if defined(BMI088_GYRO_FIFO_ENABLE)
+            HAL_GPIO_WritePin(CS1_GYRO_GPIO_Port, CS1_GYRO_Pin, GPIO_PIN_SET);
+            gyro_fifo_dma_over();
+#else
             gyro_update_flag &= ~(1 << IMU_SPI_SHFITS);
             gyro_update_flag |= (1 << IMU_UPDATE_SHFITS);
+            gyro_sample_cycle = gyro_spi_cycle;
 
             HAL_GPIO_WritePin(CS1_GYRO_GPIO_Port, CS1_GYRO_Pin, GPIO_PIN_SET);
-            
+            imu_capture_write(IMU_CAPTURE_GYRO, gyro_sample_cycle, gyro_dma_rx_buf, SPI_DMA_GYRO_LENGHT);
+#endif
         }
 
         //accel read over
@@ -637,6 +1742,7 @@ void DMA2_Stream2_IRQHandler(void)
             accel_update_flag |= (1 << IMU_UPDATE_SHFITS);
 
             HAL_GPIO_WritePin(CS1_ACCEL_GPIO_Port, CS1_ACCEL_Pin, GPIO_PIN_SET);
+            imu_capture_write(IMU_CAPTURE_ACCEL, dwt_get_cycle(), accel_dma_rx_buf, SPI_DMA_ACCEL_LENGHT);
         }
         //temperature read over
         //¶ȶȡ
@@ -646,6 +1752,7 @@ void DMA2_Stream2_IRQHandler(void)
             accel_temp_update_flag |= (1 << IMU_UPDATE_SHFITS);
 
             HAL_GPIO_WritePin(CS1_ACCEL_GPIO_Port, CS1_ACCEL_Pin, GPIO_PIN_SET);
+            imu_capture_write(IMU_CAPTURE_TEMP, dwt_get_cycle(), accel_temp_dma_rx_buf, SPI_DMA_ACCEL_TEMP_LENGHT);
         }
         
         imu_cmd_spi_dma();
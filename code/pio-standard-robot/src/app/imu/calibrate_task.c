@@ -16,6 +16,11 @@
   *  Version    Date            Author          Modification
   *  V1.0.0     Oct-25-2018     RM              1. done
   *  V1.1.0     Nov-11-2019     RM              1. add chassis clabration
+  *  V1.2.0     Oct-16-2026     RM              1. save the imu heater model learned by INS task
+  *  V1.3.0     Oct-16-2026     RM              1. save the gyro zero drift vs temperature table learned by INS task
+  *  V1.4.0     Oct-16-2026     RM              1. relay feedback pid auto-tune of gimbal speed loops and trigger
+  *  V1.5.0     Oct-16-2026     RM              1. the learned heater model is written only in a safe state or with a calibration
+  *  V1.6.0     Oct-16-2026     RM              1. the learned gyro temperature table is written only in a safe state or with a calibration
   *
   @verbatim
   ==============================================================================
@@ -25,6 +30,9 @@
   *             third:hold for 2 seconds, two rockers set to ./\., begin the gyro calibration
   *                     or set to '\/', begin the gimbal calibration
   *                     or set to /''\, begin the chassis calibration
+  *                     or set to '\'\, begin the pid auto-tune of yaw speed loop
+  *                     or set to /'/', begin the pid auto-tune of pitch speed loop
+  *                     or set to ././, begin the pid auto-tune of trigger speed loop
   *
   *             data in flash, include cali data and name[3] and cali_flag
   *             for example, head_cali has 8 bytes, and it need 12 bytes in flash. if it starts in 0x080A0000
@@ -60,6 +68,9 @@
   *             :ҡ˴./\. ʼУ׼
   *                    ҡ˴'\/' ʼ̨У׼
   *                    ҡ˴/''\ ʼУ׼
+  *                    ҡ˴'\'\ ʼyawٶȻpid
+  *                    ҡ˴/'/' ʼpitchٶȻpid
+  *                    ҡ˴././ ʼٶȻpid
   *
   *             flashУУ׼ݺ name[3]  У׼־λ cali_flag
   *             head_caliа˸ֽ,Ҫ12ֽflash,0x080A0000ʼ
@@ -105,12 +116,13 @@
 
 #include "can_receive.h"
 #include "remote_control.h"
+#include "detect_task.h"
 #include "INS_task.h"
 #include "gimbal_task.h"
 
 
-//include head,gimbal,gyro,accel,mag. gyro,accel and mag have the same data struct. total 5(CALI_LIST_LENGHT) devices, need data lenght + 5 * 4 bytes(name[3]+cali)
-#define FLASH_WRITE_BUF_LENGHT  (sizeof(head_cali_t) + sizeof(gimbal_cali_t) + sizeof(imu_cali_t) * 3  + CALI_LIST_LENGHT * 4)
+//include head,gimbal,gyro,accel,mag,heater,gyro temperature table,pid tune. gyro,accel and mag have the same data struct. total 8(CALI_LIST_LENGHT) devices, need data lenght + 8 * 4 bytes(name[3]+cali)
+#define FLASH_WRITE_BUF_LENGHT  (sizeof(head_cali_t) + sizeof(gimbal_cali_t) + sizeof(imu_cali_t) * 3 + sizeof(heater_cali_t) + sizeof(INS_gyro_temp_table_t) + sizeof(pid_tune_cali_t) + CALI_LIST_LENGHT * 4)
 
 
 
@@ -151,6 +163,33 @@ static void cali_data_read(void);
   */
 static void cali_data_write(void);
 
+/**
+  * @brief          whether the learned data can be written: the remote control is off, or both switches
+  *                 are down, where the gimbal has no force and the chassis and the shoot stop, for
+  *                 CALI_LEARNED_SAFE_TIME. erasing the flash sector stalls the cpu for 1~2 s.
+  * @param[in]      none
+  * @retval         1: safe, 0: not safe
+  */
+/**
+  * @brief          Ƿдѧϰ: ң, ˶·(̨, ֹ̺ͣ)
+  *                 CALI_LEARNED_SAFE_TIME. flashʹcpuͣ1~2s.
+  * @param[in]      none
+  * @retval         1: ȫ, 0: ȫ
+  */
+static bool_t cali_learned_safe(void);
+
+/**
+  * @brief          take the data learned by INS task that wait to be saved into the cali data
+  * @param[in]      none
+  * @retval         1: some data to write, 0: none
+  */
+/**
+  * @brief          INS taskѧϰĴݷУ׼
+  * @param[in]      none
+  * @retval         1: Ҫд, 0: 
+  */
+static bool_t cali_learned_take(void);
+
 
 /**
   * @brief          "head" sensor cali function
@@ -212,6 +251,26 @@ static bool_t cali_gyro_hook(uint32_t *cali, bool_t cmd);   //gyro device cali f
   */
 static bool_t cali_gimbal_hook(uint32_t *cali, bool_t cmd); //gimbal device cali function
 
+/**
+  * @brief          pid auto-tune function, tunes the loop of "pid_tune_loop"
+  * @param[in][out] cali:the point to pid tune data, when cmd == CALI_FUNC_CMD_INIT, param is [in],cmd == CALI_FUNC_CMD_ON, param is [out]
+  * @param[in]      cmd: 
+                    CALI_FUNC_CMD_INIT: means to use cali data to initialize original data
+                    CALI_FUNC_CMD_ON: means need to calibrate
+  * @retval         0:means cali task has not been done
+                    1:means cali task has been done
+  */
+/**
+  * @brief          pid, "pid_tune_loop"Ļ·
+  * @param[in][out] cali:ָָpid,cmdΪCALI_FUNC_CMD_INIT, ,CALI_FUNC_CMD_ON,
+  * @param[in]      cmd: 
+                    CALI_FUNC_CMD_INIT: У׼ݳʼԭʼ
+                    CALI_FUNC_CMD_ON: ҪУ׼
+  * @retval         0:У׼û
+                    1:У׼Ѿ
+  */
+static bool_t cali_pid_tune_hook(uint32_t *cali, bool_t cmd); //pid auto-tune function
+
 
 
 #if INCLUDE_uxTaskGetStackHighWaterMark
@@ -225,27 +284,37 @@ static gimbal_cali_t   gimbal_cali;     //gimbal cali data
 static imu_cali_t      accel_cali;      //accel cali data
 static imu_cali_t      gyro_cali;       //gyro cali data
 static imu_cali_t      mag_cali;        //mag cali data
+static heater_cali_t   heater_cali;     //imu heater model
+static INS_gyro_temp_table_t gyro_temp_cali;    //gyro zero drift vs temperature
+static pid_tune_cali_t pid_tune_cali;   //gains of pid auto-tune
+static uint8_t         pid_tune_loop;   //the loop to tune, PID_TUNE_YAW_SPEED, PID_TUNE_PITCH_SPEED or PID_TUNE_TRIGGER
 
 
 static uint8_t flash_write_buf[FLASH_WRITE_BUF_LENGHT];
 
 cali_sensor_t cali_sensor[CALI_LIST_LENGHT]; 
 
-static const uint8_t cali_name[CALI_LIST_LENGHT][3] = {"HD", "GM", "GYR", "ACC", "MAG"};
+static const uint8_t cali_name[CALI_LIST_LENGHT][3] = {"HD", "GM", "GYR", "ACC", "MAG", "HT", "GT", "PT"};
 
 //cali data address
 static uint32_t *cali_sensor_buf[CALI_LIST_LENGHT] = {
         (uint32_t *)&head_cali, (uint32_t *)&gimbal_cali,
         (uint32_t *)&gyro_cali, (uint32_t *)&accel_cali,
-        (uint32_t *)&mag_cali};
+        (uint32_t *)&mag_cali, (uint32_t *)&heater_cali,
+        (uint32_t *)&gyro_temp_cali, (uint32_t *)&pid_tune_cali};
 
 
 static uint8_t cali_sensor_size[CALI_LIST_LENGHT] =
     {
         sizeof(head_cali_t) / 4, sizeof(gimbal_cali_t) / 4,
-        sizeof(imu_cali_t) / 4, sizeof(imu_cali_t) / 4, sizeof(imu_cali_t) / 4};
+        sizeof(imu_cali_t) / 4, sizeof(imu_cali_t) / 4, sizeof(imu_cali_t) / 4,
+        sizeof(heater_cali_t) / 4, sizeof(INS_gyro_temp_table_t) / 4, sizeof(pid_tune_cali_t) / 4};
 
-void *cali_hook_fun[CALI_LIST_LENGHT] = {cali_head_hook, cali_gimbal_hook, cali_gyro_hook, NULL, NULL};
+//heater and gyro temperature table have no hook, they are learned by INS task, not calibrated by remote control
+//pid tune has no hook here, it must not start by itself when not tuned, calibrate_task calls cali_pid_tune_hook
+//ģͺƯ¶ȱûУ׼, INS taskѧϰ, ңУ׼
+//pidڴûУ׼, ûʱԶʼ, calibrate_taskcali_pid_tune_hook
+void *cali_hook_fun[CALI_LIST_LENGHT] = {cali_head_hook, cali_gimbal_hook, cali_gyro_hook, NULL, NULL, NULL, NULL, NULL};
 
 static uint32_t calibrate_systemTick;
 
@@ -288,12 +357,38 @@ void calibrate_task(void const *pvParameters)
                         cali_sensor[i].cali_done = CALIED_FLAG;
 
                         cali_sensor[i].cali_cmd = 0;
-                        //write
+                        //write, with the learned data waiting to be saved
+                        //д, ͬʱѧϰ
+                        cali_learned_take();
                         cali_data_write();
                     }
                 }
             }
         }
+
+        //pid auto-tune, started by remote control
+        //pid, ңʼ
+        if (cali_sensor[CALI_PID_TUNE].cali_cmd)
+        {
+            if (cali_pid_tune_hook(cali_sensor_buf[CALI_PID_TUNE], CALI_FUNC_CMD_ON))
+            {
+                cali_sensor[CALI_PID_TUNE].name[0] = cali_name[CALI_PID_TUNE][0];
+                cali_sensor[CALI_PID_TUNE].name[1] = cali_name[CALI_PID_TUNE][1];
+                cali_sensor[CALI_PID_TUNE].name[2] = cali_name[CALI_PID_TUNE][2];
+                cali_sensor[CALI_PID_TUNE].cali_done = CALIED_FLAG;
+                cali_sensor[CALI_PID_TUNE].cali_cmd = 0;
+                cali_learned_take();
+                cali_data_write();
+            }
+        }
+
+        //the heater model and the gyro temperature table learned at this boot are only marked by INS task,
+        //they are written in a safe state or with the next calibration, never while the robot runs
+        //ѧϰļģͺƯ¶ȱֻINS task, ڰȫ״̬´У׼ʱд, ڻʱд
+        if (cali_learned_safe() && cali_learned_take())
+        {
+            cali_data_write();
+        }
         osDelay(CALIBRATE_CONTROL_TIME);
 #if INCLUDE_uxTaskGetStackHighWaterMark
         calibrate_task_stack = uxTaskGetStackHighWaterMark(NULL);
@@ -301,6 +396,67 @@ void calibrate_task(void const *pvParameters)
     }
 }
 
+/**
+  * @brief          whether the learned data can be written: the remote control is off, or both switches
+  *                 are down, where the gimbal has no force and the chassis and the shoot stop, for
+  *                 CALI_LEARNED_SAFE_TIME. erasing the flash sector stalls the cpu for 1~2 s.
+  * @param[in]      none
+  * @retval         1: safe, 0: not safe
+  */
+/**
+  * @brief          Ƿдѧϰ: ң, ˶·(̨, ֹ̺ͣ)
+  *                 CALI_LEARNED_SAFE_TIME. flashʹcpuͣ1~2s.
+  * @param[in]      none
+  * @retval         1: ȫ, 0: ȫ
+  */
+static bool_t cali_learned_safe(void)
+{
+    static uint32_t unsafe_tick;
+    uint32_t tick = xTaskGetTickCount();
+
+    if (!toe_is_error(DBUS_TOE) && !(switch_is_down(calibrate_RC->rc.s[0]) && switch_is_down(calibrate_RC->rc.s[1])))
+    {
+        unsafe_tick = tick;
+        return 0;
+    }
+    return tick - unsafe_tick >= CALI_LEARNED_SAFE_TIME;
+}
+
+/**
+  * @brief          take the data learned by INS task that wait to be saved into the cali data
+  * @param[in]      none
+  * @retval         1: some data to write, 0: none
+  */
+/**
+  * @brief          INS taskѧϰĴݷУ׼
+  * @param[in]      none
+  * @retval         1: Ҫд, 0: 
+  */
+static bool_t cali_learned_take(void)
+{
+    bool_t take = 0;
+
+    if (heater_get_learned(&heater_cali.gain, &heater_cali.tau))
+    {
+        cali_sensor[CALI_HEATER].name[0] = cali_name[CALI_HEATER][0];
+        cali_sensor[CALI_HEATER].name[1] = cali_name[CALI_HEATER][1];
+        cali_sensor[CALI_HEATER].name[2] = cali_name[CALI_HEATER][2];
+        cali_sensor[CALI_HEATER].cali_done = CALIED_FLAG;
+        take = 1;
+    }
+    //INS task limits how often the table is given
+    //INS task¶ȱıƵ
+    if (gyro_temp_get_learned(&gyro_temp_cali))
+    {
+        cali_sensor[CALI_GYRO_TEMP].name[0] = cali_name[CALI_GYRO_TEMP][0];
+        cali_sensor[CALI_GYRO_TEMP].name[1] = cali_name[CALI_GYRO_TEMP][1];
+        cali_sensor[CALI_GYRO_TEMP].name[2] = cali_name[CALI_GYRO_TEMP][2];
+        cali_sensor[CALI_GYRO_TEMP].cali_done = CALIED_FLAG;
+        take = 1;
+    }
+    return take;
+}
+
 /**
   * @brief          get imu control temperature, unit 
   * @param[in]      none
@@ -361,6 +517,9 @@ static void RC_cmd_to_calibrate(void)
     static const uint8_t GIMBAL_FLAG  = 2;
     static const uint8_t GYRO_FLAG    = 3;
     static const uint8_t CHASSIS_FLAG = 4;
+    static const uint8_t YAW_TUNE_FLAG      = 5;
+    static const uint8_t PITCH_TUNE_FLAG    = 6;
+    static const uint8_t TRIGGER_TUNE_FLAG  = 7;
 
     static uint8_t  i;
     static uint32_t rc_cmd_systemTick = 0;
@@ -421,6 +580,26 @@ static void RC_cmd_to_calibrate(void)
         CAN_cmd_chassis_reset_ID();
         cali_buzzer_off();
     }
+    else if ((rc_action_flag == YAW_TUNE_FLAG || rc_action_flag == PITCH_TUNE_FLAG || rc_action_flag == TRIGGER_TUNE_FLAG) && rc_cmd_time > RC_CMD_LONG_TIME)
+    {
+        //pid auto-tune
+        if (rc_action_flag == YAW_TUNE_FLAG)
+        {
+            pid_tune_loop = PID_TUNE_YAW_SPEED;
+        }
+        else if (rc_action_flag == PITCH_TUNE_FLAG)
+        {
+            pid_tune_loop = PID_TUNE_PITCH_SPEED;
+        }
+        else
+        {
+            pid_tune_loop = PID_TUNE_TRIGGER;
+        }
+        rc_action_flag = 0;
+        rc_cmd_time = 0;
+        cali_sensor[CALI_PID_TUNE].cali_cmd = 1;
+        cali_buzzer_off();
+    }
 
     if (calibrate_RC->rc.ch[0] < -RC_CALI_VALUE_HOLE && calibrate_RC->rc.ch[1] < -RC_CALI_VALUE_HOLE && calibrate_RC->rc.ch[2] > RC_CALI_VALUE_HOLE && calibrate_RC->rc.ch[3] < -RC_CALI_VALUE_HOLE && switch_is_down(calibrate_RC->rc.s[0]) && switch_is_down(calibrate_RC->rc.s[1]) && rc_action_flag == 0)
     {
@@ -449,6 +628,27 @@ static void RC_cmd_to_calibrate(void)
         rc_cmd_time++;
         rc_action_flag = CHASSIS_FLAG;
     }
+    else if (calibrate_RC->rc.ch[0] < -RC_CALI_VALUE_HOLE && calibrate_RC->rc.ch[1] > RC_CALI_VALUE_HOLE && calibrate_RC->rc.ch[2] < -RC_CALI_VALUE_HOLE && calibrate_RC->rc.ch[3] > RC_CALI_VALUE_HOLE && switch_is_down(calibrate_RC->rc.s[0]) && switch_is_down(calibrate_RC->rc.s[1]) && rc_action_flag != 0)
+    {
+        //two rocker set to '\'\, hold for 2 seconds
+        //ҡ˴'\'\,2s
+        rc_cmd_time++;
+        rc_action_flag = YAW_TUNE_FLAG;
+    }
+    else if (calibrate_RC->rc.ch[0] > RC_CALI_VALUE_HOLE && calibrate_RC->rc.ch[1] > RC_CALI_VALUE_HOLE && calibrate_RC->rc.ch[2] > RC_CALI_VALUE_HOLE && calibrate_RC->rc.ch[3] > RC_CALI_VALUE_HOLE && switch_is_down(calibrate_RC->rc.s[0]) && switch_is_down(calibrate_RC->rc.s[1]) && rc_action_flag != 0)
+    {
+        //two rocker set to /'/', hold for 2 seconds
+        //ҡ˴/'/',2s
+        rc_cmd_time++;
+        rc_action_flag = PITCH_TUNE_FLAG;
+    }
+    else if (calibrate_RC->rc.ch[0] < -RC_CALI_VALUE_HOLE && calibrate_RC->rc.ch[1] < -RC_CALI_VALUE_HOLE && calibrate_RC->rc.ch[2] < -RC_CALI_VALUE_HOLE && calibrate_RC->rc.ch[3] < -RC_CALI_VALUE_HOLE && switch_is_down(calibrate_RC->rc.s[0]) && switch_is_down(calibrate_RC->rc.s[1]) && rc_action_flag != 0)
+    {
+        //two rocker set to ././, hold for 2 seconds
+        //ҡ˴././,2s
+        rc_cmd_time++;
+        rc_action_flag = TRIGGER_TUNE_FLAG;
+    }
     else
     {
         rc_cmd_time = 0;
@@ -521,6 +721,21 @@ void cali_param_init(void)
             }
         }
     }
+
+    if (cali_sensor[CALI_HEATER].cali_done == CALIED_FLAG)
+    {
+        heater_set_cali(heater_cali.gain, heater_cali.tau);
+    }
+
+    if (cali_sensor[CALI_GYRO_TEMP].cali_done == CALIED_FLAG)
+    {
+        gyro_temp_set_cali(&gyro_temp_cali);
+    }
+
+    if (cali_sensor[CALI_PID_TUNE].cali_done == CALIED_FLAG)
+    {
+        cali_pid_tune_hook(cali_sensor_buf[CALI_PID_TUNE], CALI_FUNC_CMD_INIT);
+    }
 }
 
 /**
@@ -742,3 +957,53 @@ static bool_t cali_gimbal_hook(uint32_t *cali, bool_t cmd)
     
     return 0;
 }
+
+/**
+  * @brief          pid auto-tune function, tunes the loop of "pid_tune_loop"
+  * @param[in][out] cali:the point to pid tune data, when cmd == CALI_FUNC_CMD_INIT, param is [in],cmd == CALI_FUNC_CMD_ON, param is [out]
+  * @param[in]      cmd: 
+                    CALI_FUNC_CMD_INIT: means to use cali data to initialize original data
+                    CALI_FUNC_CMD_ON: means need to calibrate
+  * @retval         0:means cali task has not been done
+                    1:means cali task has been done
+  */
+/**
+  * @brief          pid, "pid_tune_loop"Ļ·
+  * @param[in][out] cali:ָָpid,cmdΪCALI_FUNC_CMD_INIT, ,CALI_FUNC_CMD_ON,
+  * @param[in]      cmd: 
+                    CALI_FUNC_CMD_INIT: У׼ݳʼԭʼ
+                    CALI_FUNC_CMD_ON: ҪУ׼
+  * @retval         0:У׼û
+                    1:У׼Ѿ
+  */
+static bool_t cali_pid_tune_hook(uint32_t *cali, bool_t cmd)
+{
+    pid_tune_cali_t *local_cali_t = (pid_tune_cali_t *)cali;
+    uint8_t i;
+
+    if (cmd == CALI_FUNC_CMD_INIT)
+    {
+        for (i = 0; i < PID_TUNE_LOOP_NUM; i++)
+        {
+            set_cali_pid_tune_hook(i, local_cali_t->kp[i], local_cali_t->ki[i]);
+        }
+        return 0;
+    }
+    else if (cmd == CALI_FUNC_CMD_ON)
+    {
+        if (cmd_cali_pid_tune_hook(pid_tune_loop, &local_cali_t->kp[pid_tune_loop], &local_cali_t->ki[pid_tune_loop]))
+        {
+            cali_buzzer_off();
+
+            return 1;
+        }
+        else
+        {
+            gimbal_start_buzzer();
+
+            return 0;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,201 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       imu_capture.c/h
+  * @brief      raw imu capture, a RAM ring of the bmi088 SPI DMA buffers with
+  *             DWT timestamp. it is drained over usb by usb_task, for replay of
+  *             the INS calculation on a host.
+  *             IMUԭʼݲɼ, RAMλм¼bmi088SPI DMAԭʼݼDWT
+  *             ʱ, usb_taskͨusb, λط̬.
+  * @note
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *
+  @verbatim
+  ==============================================================================
+  writers are SPI DMA interrupt and imu_capture_start, a slot is reserved with
+  interrupts masked, then filled and marked by sync last. the reader is usb_task.
+  дΪSPI DMAжϺimu_capture_start, ڹжʱԤ¼λ, дд
+  sync. ȡΪusb_task.
+  ==============================================================================
+  @endverbatim
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+
+#include "imu_capture.h"
+#include "main.h"
+#include "bsp_dwt.h"
+
+//offsets used by imu_cali_slove in INS_task
+//INS_taskimu_cali_sloveʹõƯ
+extern fp32 gyro_offset[3];
+extern fp32 accel_offset[3];
+
+static imu_capture_t imu_capture[IMU_CAPTURE_SIZE];
+//records reserved and records taken, the ring holds imu_capture_head - imu_capture_tail
+//Ԥȡļ¼
+static volatile uint32_t imu_capture_head;
+static volatile uint32_t imu_capture_tail;
+static volatile uint32_t imu_capture_drop_num;
+static volatile uint8_t imu_capture_on;
+
+/**
+  * @brief          start capture, the ring is cleared and the offsets are recorded first
+  * @param[in]      none
+  * @retval         none
+  */
+/**
+  * @brief          ʼɼ, ջȼ¼Ư
+  * @param[in]      none
+  * @retval         none
+  */
+void imu_capture_start(void)
+{
+    uint32_t i;
+
+    imu_capture_on = 0;
+    for (i = 0; i < IMU_CAPTURE_SIZE; i++)
+    {
+        imu_capture[i].sync = 0;
+    }
+    imu_capture_head = 0;
+    imu_capture_tail = 0;
+    imu_capture_drop_num = 0;
+    imu_capture_on = 1;
+
+    imu_capture_write(IMU_CAPTURE_GYRO_OFFSET, dwt_get_cycle(), (const uint8_t *)gyro_offset, sizeof(fp32) * 3);
+    imu_capture_write(IMU_CAPTURE_ACCEL_OFFSET, dwt_get_cycle(), (const uint8_t *)accel_offset, sizeof(fp32) * 3);
+}
+
+/**
+  * @brief          stop capture
+  * @param[in]      none
+  * @retval         none
+  */
+/**
+  * @brief          ֹͣɼ
+  * @param[in]      none
+  * @retval         none
+  */
+void imu_capture_stop(void)
+{
+    imu_capture_on = 0;
+}
+
+/**
+  * @brief          whether capture is on
+  * @param[in]      none
+  * @retval         1: on, 0: off
+  */
+/**
+  * @brief          Ƿڲɼ
+  * @param[in]      none
+  * @retval         1: ڲɼ, 0: δɼ
+  */
+bool_t imu_capture_is_on(void)
+{
+    return imu_capture_on;
+}
+
+/**
+  * @brief          record a raw buffer, called in SPI DMA interrupt
+  * @param[in]      type: IMU_CAPTURE_GYRO, IMU_CAPTURE_ACCEL ...
+  * @param[in]      cycle: DWT cycle of the data
+  * @param[in]      data: raw buffer
+  * @param[in]      len: buffer length, cut to IMU_CAPTURE_DATA_LEN
+  * @retval         none
+  */
+/**
+  * @brief          ¼һԭʼ, SPI DMAже
+  * @param[in]      type: IMU_CAPTURE_GYRO, IMU_CAPTURE_ACCEL ...
+  * @param[in]      cycle: ݵDWT
+  * @param[in]      data: ԭʼ
+  * @param[in]      len: ݳ, IMU_CAPTURE_DATA_LENֽض
+  * @retval         none
+  */
+void imu_capture_write(uint8_t type, uint32_t cycle, const uint8_t *data, uint8_t len)
+{
+    imu_capture_t *record;
+    uint32_t primask;
+    uint32_t index;
+    uint8_t i;
+
+    if (!imu_capture_on || data == NULL)
+    {
+        return;
+    }
+    if (len > IMU_CAPTURE_DATA_LEN)
+    {
+        len = IMU_CAPTURE_DATA_LEN;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if (imu_capture_head - imu_capture_tail >= IMU_CAPTURE_SIZE)
+    {
+        imu_capture_drop_num++;
+        __set_PRIMASK(primask);
+        return;
+    }
+    index = imu_capture_head++;
+    __set_PRIMASK(primask);
+
+    record = &imu_capture[index & (IMU_CAPTURE_SIZE - 1)];
+    record->type = type;
+    record->len = len;
+    record->seq = (uint8_t)index;
+    record->cycle = cycle;
+    for (i = 0; i < len; i++)
+    {
+        record->data[i] = data[i];
+    }
+    __DMB();
+    record->sync = IMU_CAPTURE_SYNC;
+}
+
+/**
+  * @brief          take the oldest record
+  * @param[out]     record: record copy
+  * @retval         1: ok, 0: no complete record
+  */
+/**
+  * @brief          ȡһ¼
+  * @param[out]     record: ¼
+  * @retval         1: ɹ, 0: ûļ¼
+  */
+bool_t imu_capture_read(imu_capture_t *record)
+{
+    imu_capture_t *slot;
+
+    if (record == NULL || imu_capture_tail == imu_capture_head)
+    {
+        return 0;
+    }
+    slot = &imu_capture[imu_capture_tail & (IMU_CAPTURE_SIZE - 1)];
+    //reserved but still being written
+    //Ԥд
+    if (slot->sync != IMU_CAPTURE_SYNC)
+    {
+        return 0;
+    }
+    *record = *slot;
+    slot->sync = 0;
+    __DMB();
+    imu_capture_tail++;
+    return 1;
+}
+
+/**
+  * @brief          records dropped because the ring was full
+  * @param[in]      none
+  * @retval         drop number since start
+  */
+/**
+  * @brief          ļ¼
+  * @param[in]      none
+  * @retval         ʼɼĶ
+  */
+uint32_t imu_capture_drop(void)
+{
+    return imu_capture_drop_num;
+}
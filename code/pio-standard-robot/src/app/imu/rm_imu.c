@@ -0,0 +1,325 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       rm_imu.c/h
+  * @brief      RM IMU module on the gimbal CAN bus, frames are decoded in CAN rx
+  *             interrupt. the gimbal attitude is taken from the module and aligned
+  *             in time with the board INS, the board INS takes over when the module
+  *             is lost. the chassis keeps using the board INS.
+  *             ̨CANϵRM IMUģ, CANжн. ̨̬ȡģ鲢
+  *             INSʱ, ģʱɰINS. ʹðINS.
+  * @note
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *
+  @verbatim
+  ==============================================================================
+  rm_imu_decode runs in CAN rx interrupt, the sample is protected by a seqlock
+  like the motor feedback. the fusion state belongs to gimbal_task.
+  rm_imu_decodeCANж, һ˳. ں״ֻ̬
+  gimbal_task.
+  ==============================================================================
+  @endverbatim
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+
+#include "rm_imu.h"
+#include "main.h"
+#include "bsp_dwt.h"
+#include "AHRS.h"
+#include "user_lib.h"
+#include "detect_task.h"
+
+//latest module sample, angle is filled by the reader
+//ģ, ŷɶȡ߼
+static INS_snapshot_t rm_imu_data;
+//seqlock of rm_imu_data, odd while the CAN interrupt is writing
+//rm_imu_data˳, CANждʱΪ
+static volatile uint32_t rm_imu_lock;
+
+static rm_imu_stat_t rm_imu_stat;
+static uint32_t rm_imu_fusion_cycle;
+static uint8_t rm_imu_offset_init;
+//1 -> 0 while sliding back to the module
+//صģݵĹϵ, 1 -> 0
+static fp32 rm_imu_blend;
+
+static void rm_imu_predict(const INS_snapshot_t *sample, uint32_t now, fp32 angle[3]);
+
+/**
+  * @brief          decode a frame of the module, called in CAN rx interrupt
+  * @param[in]      std_id: frame ID
+  * @param[in]      data: 8 bytes of data
+  * @param[in]      rx_cycle: DWT cycle at receive
+  * @retval         1: a module frame, 0: other ID
+  */
+/**
+  * @brief          һ֡ģ, CANже
+  * @param[in]      std_id: ֡ID
+  * @param[in]      data: 8ֽ
+  * @param[in]      rx_cycle: ʱDWT
+  * @retval         1: ģ֡, 0: ID
+  */
+bool_t rm_imu_decode(uint32_t std_id, const uint8_t data[8], uint32_t rx_cycle)
+{
+    int16_t raw[4];
+    uint8_t i;
+
+    if (data == NULL || std_id < RM_IMU_QUAT_ID || std_id > RM_IMU_ACCEL_ID)
+    {
+        return 0;
+    }
+
+    for (i = 0; i < 4; i++)
+    {
+        raw[i] = (int16_t)(data[2 * i] | data[2 * i + 1] << 8);
+    }
+
+    rm_imu_lock++;
+    __DMB();
+    if (std_id == RM_IMU_QUAT_ID)
+    {
+        for (i = 0; i < 4; i++)
+        {
+            rm_imu_data.quat[i] = raw[i] * RM_IMU_QUAT_SEN;
+        }
+        rm_imu_data.sample_cycle = rx_cycle - RM_IMU_DELAY_US * (SystemCoreClock / 1000000);
+        rm_imu_data.seq++;
+    }
+    else if (std_id == RM_IMU_GYRO_ID)
+    {
+        for (i = 0; i < 3; i++)
+        {
+            rm_imu_data.gyro[i] = raw[i] * RM_IMU_GYRO_SEN;
+        }
+    }
+    else
+    {
+        for (i = 0; i < 3; i++)
+        {
+            rm_imu_data.accel[i] = raw[i] * RM_IMU_ACCEL_SEN;
+        }
+    }
+    __DMB();
+    rm_imu_lock++;
+
+    if (std_id == RM_IMU_QUAT_ID)
+    {
+        detect_hook(RM_IMU_TOE);
+    }
+    return 1;
+}
+
+/**
+  * @brief          copy the latest module sample, sample_cycle is the estimated sample time
+  * @param[out]     snapshot: sample copy
+  * @retval         1: at least one sample received, 0: no sample
+  */
+/**
+  * @brief          ģ, sample_cycleΪƵĲʱ
+  * @param[out]     snapshot: ݸ
+  * @retval         1: յ, 0: 
+  */
+bool_t get_rm_imu_snapshot(INS_snapshot_t *snapshot)
+{
+    uint32_t lock;
+
+    if (snapshot == NULL)
+    {
+        return 0;
+    }
+
+    do
+    {
+        lock = rm_imu_lock;
+        __DMB();
+        *snapshot = rm_imu_data;
+        __DMB();
+    } while ((lock & 0x01) || lock != rm_imu_lock);
+
+    if (snapshot->seq == 0)
+    {
+        return 0;
+    }
+    get_angle(snapshot->quat, snapshot->angle + INS_YAW_ADDRESS_OFFSET, snapshot->angle + INS_PITCH_ADDRESS_OFFSET, snapshot->angle + INS_ROLL_ADDRESS_OFFSET);
+    return 1;
+}
+
+/**
+  * @brief          push a sample to now by its gyro and return the euler angle
+  * @param[in]      sample: INS or module sample
+  * @param[in]      now: DWT cycle to push to
+  * @param[out]     angle: euler angle at now, 0:yaw, 1:pitch, 2:roll
+  * @retval         none
+  */
+/**
+  * @brief          ýٶȽƵǰʱ, ŷ
+  * @param[in]      sample: INSģ
+  * @param[in]      now: ƵDWT
+  * @param[out]     angle: ǰʱ̵ŷ, 0:yaw, 1:pitch, 2:roll
+  * @retval         none
+  */
+static void rm_imu_predict(const INS_snapshot_t *sample, uint32_t now, fp32 angle[3])
+{
+    fp32 quat[4];
+    fp32 half_dt;
+    fp32 norm;
+    uint32_t age_us = dwt_cycle_to_us(now - sample->sample_cycle);
+    uint8_t i;
+
+    if (age_us > RM_IMU_TIMEOUT_US)
+    {
+        age_us = RM_IMU_TIMEOUT_US;
+    }
+    half_dt = 0.5f * age_us * 0.000001f;
+
+    //q' = q + 0.5 * dt * q x (0, w), body frame gyro
+    //q' = q + 0.5 * dt * q x (0, w), ٶΪϵ
+    quat[0] = sample->quat[0] + half_dt * (-sample->quat[1] * sample->gyro[0] - sample->quat[2] * sample->gyro[1] - sample->quat[3] * sample->gyro[2]);
+    quat[1] = sample->quat[1] + half_dt * (sample->quat[0] * sample->gyro[0] + sample->quat[2] * sample->gyro[2] - sample->quat[3] * sample->gyro[1]);
+    quat[2] = sample->quat[2] + half_dt * (sample->quat[0] * sample->gyro[1] - sample->quat[1] * sample->gyro[2] + sample->quat[3] * sample->gyro[0]);
+    quat[3] = sample->quat[3] + half_dt * (sample->quat[0] * sample->gyro[2] + sample->quat[1] * sample->gyro[1] - sample->quat[2] * sample->gyro[0]);
+
+    norm = invSqrt(quat[0] * quat[0] + quat[1] * quat[1] + quat[2] * quat[2] + quat[3] * quat[3]);
+    for (i = 0; i < 4; i++)
+    {
+        quat[i] *= norm;
+    }
+    get_angle(quat, angle + INS_YAW_ADDRESS_OFFSET, angle + INS_PITCH_ADDRESS_OFFSET, angle + INS_ROLL_ADDRESS_OFFSET);
+}
+
+/**
+  * @brief          replace the board sample with the fused gimbal attitude at now,
+  *                 seq stays the board one, so INS_wait_snapshot still clocks the loop.
+  *                 one caller only, it is gimbal_task.
+  * @param[in,out]  gimbal_INS: in the board sample, out the gimbal attitude
+  * @retval         none
+  */
+/**
+  * @brief          õǰʱںϺ̨̬滻, seqΪ,
+  *                 INS_wait_snapshotԿͬ. ֻgimbal_task.
+  * @param[in,out]  gimbal_INS: , ̨̬
+  * @retval         none
+  */
+void rm_imu_fusion_update(INS_snapshot_t *gimbal_INS)
+{
+    INS_snapshot_t rm;
+    fp32 board_angle[3];
+    fp32 rm_angle[3];
+    fp32 dt;
+    fp32 k;
+    uint32_t now;
+    uint32_t board_seq;
+    bool_t rm_online;
+    bool_t board_online;
+
+    if (gimbal_INS == NULL)
+    {
+        return;
+    }
+
+    now = dwt_get_cycle();
+    dt = rm_imu_fusion_cycle ? dwt_cycle_to_us(now - rm_imu_fusion_cycle) * 0.000001f : 0.0f;
+    rm_imu_fusion_cycle = now;
+
+    rm_online = get_rm_imu_snapshot(&rm) && !toe_is_error(RM_IMU_TOE);
+    if (rm.seq != 0)
+    {
+        rm_imu_stat.rm_age_us = dwt_cycle_to_us(now - rm.sample_cycle);
+        rm_online = rm_online && rm_imu_stat.rm_age_us < RM_IMU_TIMEOUT_US;
+    }
+    board_online = gimbal_INS->seq != 0 && !toe_is_error(BOARD_GYRO_TOE);
+
+    if (board_online)
+    {
+        rm_imu_predict(gimbal_INS, now, board_angle);
+    }
+    if (rm_online)
+    {
+        rm_imu_predict(&rm, now, rm_angle);
+    }
+
+    //offset from board to module, both at now
+    //صģƫ, ߶ڵǰʱ
+    if (rm_online && board_online)
+    {
+        if (!rm_imu_offset_init)
+        {
+            rm_imu_stat.yaw_offset = rad_format(rm_angle[INS_YAW_ADDRESS_OFFSET] - board_angle[INS_YAW_ADDRESS_OFFSET]);
+            rm_imu_stat.pitch_offset = rm_angle[INS_PITCH_ADDRESS_OFFSET] - board_angle[INS_PITCH_ADDRESS_OFFSET];
+            rm_imu_offset_init = 1;
+        }
+        else
+        {
+            k = dt / (RM_IMU_OFFSET_TAU + dt);
+            rm_imu_stat.yaw_offset = rad_format(rm_imu_stat.yaw_offset +
+                                                k * rad_format(rm_angle[INS_YAW_ADDRESS_OFFSET] - board_angle[INS_YAW_ADDRESS_OFFSET] - rm_imu_stat.yaw_offset));
+            rm_imu_stat.pitch_offset += k * (rm_angle[INS_PITCH_ADDRESS_OFFSET] - board_angle[INS_PITCH_ADDRESS_OFFSET] - rm_imu_stat.pitch_offset);
+        }
+    }
+    if (board_online)
+    {
+        board_angle[INS_YAW_ADDRESS_OFFSET] = rad_format(board_angle[INS_YAW_ADDRESS_OFFSET] + rm_imu_stat.yaw_offset);
+        board_angle[INS_PITCH_ADDRESS_OFFSET] += rm_imu_stat.pitch_offset;
+    }
+
+    board_seq = gimbal_INS->seq;
+    if (rm_online)
+    {
+        if (rm_imu_stat.source == RM_IMU_SOURCE_BOARD)
+        {
+            rm_imu_blend = 1.0f;
+        }
+        rm_imu_stat.source = RM_IMU_SOURCE_RM;
+
+        if (rm_imu_blend > 0.0f && board_online)
+        {
+            rm_angle[INS_YAW_ADDRESS_OFFSET] = rad_format(rm_angle[INS_YAW_ADDRESS_OFFSET] +
+                                                          rm_imu_blend * rad_format(board_angle[INS_YAW_ADDRESS_OFFSET] - rm_angle[INS_YAW_ADDRESS_OFFSET]));
+            rm_angle[INS_PITCH_ADDRESS_OFFSET] += rm_imu_blend * (board_angle[INS_PITCH_ADDRESS_OFFSET] - rm_angle[INS_PITCH_ADDRESS_OFFSET]);
+            rm_imu_blend -= dt / RM_IMU_BLEND_TIME;
+        }
+        else
+        {
+            rm_imu_blend = 0.0f;
+        }
+
+        *gimbal_INS = rm;
+        gimbal_INS->angle[INS_YAW_ADDRESS_OFFSET] = rm_angle[INS_YAW_ADDRESS_OFFSET];
+        gimbal_INS->angle[INS_PITCH_ADDRESS_OFFSET] = rm_angle[INS_PITCH_ADDRESS_OFFSET];
+        gimbal_INS->angle[INS_ROLL_ADDRESS_OFFSET] = rm_angle[INS_ROLL_ADDRESS_OFFSET];
+        gimbal_INS->seq = board_seq;
+    }
+    else if (board_online)
+    {
+        if (rm_imu_stat.source == RM_IMU_SOURCE_RM)
+        {
+            rm_imu_stat.failover++;
+        }
+        rm_imu_stat.source = RM_IMU_SOURCE_BOARD;
+        gimbal_INS->angle[INS_YAW_ADDRESS_OFFSET] = board_angle[INS_YAW_ADDRESS_OFFSET];
+        gimbal_INS->angle[INS_PITCH_ADDRESS_OFFSET] = board_angle[INS_PITCH_ADDRESS_OFFSET];
+        gimbal_INS->angle[INS_ROLL_ADDRESS_OFFSET] = board_angle[INS_ROLL_ADDRESS_OFFSET];
+    }
+    else
+    {
+        //keep the board sample as it is
+        //ְݲ
+        rm_imu_stat.source = RM_IMU_SOURCE_NONE;
+    }
+}
+
+/**
+  * @brief          get fusion statistics point
+  * @param[in]      none
+  * @retval         the point of rm_imu_stat
+  */
+/**
+  * @brief          ȡںͳƵָ
+  * @param[in]      none
+  * @retval         rm_imu_statָ
+  */
+const rm_imu_stat_t *get_rm_imu_stat_point(void)
+{
+    return &rm_imu_stat;
+}
@@ -0,0 +1,147 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       rm_imu.c/h
+  * @brief      RM IMU module on the gimbal CAN bus, frames are decoded in CAN rx
+  *             interrupt. the gimbal attitude is taken from the module and aligned
+  *             in time with the board INS, the board INS takes over when the module
+  *             is lost. the chassis keeps using the board INS.
+  *             ̨CANϵRM IMUģ, CANжн. ̨̬ȡģ鲢
+  *             INSʱ, ģʱɰINS. ʹðINS.
+  * @note
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *
+  @verbatim
+  ==============================================================================
+  the module sends little endian int16 frames:
+  RM_IMU_QUAT_ID: q0 q1 q2 q3, unit RM_IMU_QUAT_SEN
+  RM_IMU_GYRO_ID: x y z, unit RM_IMU_GYRO_SEN
+  RM_IMU_ACCEL_ID: x y z, unit RM_IMU_ACCEL_SEN
+  its axes must be mounted the same as the board, x forward and z up, the board
+  is on the gimbal as gimbal_task assumes.
+  ģ鷢Сint16֡. ģ뿪尲װһ, 尲װ̨.
+
+  fusion, run by gimbal_task once per cycle:
+  1. both samples are pushed to the same time, now, by their own gyro.
+  2. while both are online, the difference of yaw and pitch is low pass filtered
+     into the offset from board to module frame.
+  3. module online: output is the module. lost: output is the board plus offset,
+     and when the module is back the output slides to it in RM_IMU_BLEND_TIME.
+  ں, gimbal_taskÿڵ:
+  1. ·ݶøԵĽٶƵǰʱ.
+  2. ·ʱ, yawpitch֮ͨ˲õصģƫ.
+  3. ģʱģ. ʱݼƫ, ģָRM_IMU_BLEND_TIME
+     ƽɻģ.
+  ==============================================================================
+  @endverbatim
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+
+#ifndef RM_IMU_H
+#define RM_IMU_H
+
+#include "struct_typedef.h"
+#include "INS_task.h"
+
+//1: gimbal attitude from the RM IMU module, 0: from the board INS only
+//1: ̨̬RM IMUģ, 0: ֻʹðINS
+#define RM_IMU_ENABLE 0
+
+#define RM_IMU_CAN_BUS  CAN_BUS_2
+#define RM_IMU_CAN_FIFO CAN_RX_FIFO0
+
+#define RM_IMU_QUAT_ID  0x401
+#define RM_IMU_GYRO_ID  0x402
+#define RM_IMU_ACCEL_ID 0x403
+
+//default ranges of the module, 2000dps and 3g
+//ģĬ, 2000dps3g
+#define RM_IMU_QUAT_SEN     0.0001f
+#define RM_IMU_GYRO_SEN     0.00106526443603169529841533860381f
+#define RM_IMU_ACCEL_SEN    0.0008974358974f
+
+//sample to CAN rx delay of the module, unit us
+//ģӲCANյӳ λ us
+#define RM_IMU_DELAY_US 500
+//a sample older than it is not used, unit us
+//ʱݲʹ λ us
+#define RM_IMU_TIMEOUT_US 20000
+//time constant of the board to module offset, unit s
+//صģƫ˲ʱ䳣 λ s
+#define RM_IMU_OFFSET_TAU 2.0f
+//output slides back to the module in it after a failover, unit s
+//лصģݵĹʱ λ s
+#define RM_IMU_BLEND_TIME 0.2f
+
+//source of the gimbal attitude
+//̨̬Դ
+#define RM_IMU_SOURCE_NONE  0
+#define RM_IMU_SOURCE_RM    1
+#define RM_IMU_SOURCE_BOARD 2
+
+typedef struct
+{
+    uint8_t source;
+    uint32_t failover;          //times switched to the board.лصĴ
+    uint32_t rm_age_us;         //module sample age at the last update.ϴθʱģݵʱ
+    fp32 yaw_offset;            //module minus board, unit rad.ģ λ rad
+    fp32 pitch_offset;
+} rm_imu_stat_t;
+
+/**
+  * @brief          decode a frame of the module, called in CAN rx interrupt
+  * @param[in]      std_id: frame ID
+  * @param[in]      data: 8 bytes of data
+  * @param[in]      rx_cycle: DWT cycle at receive
+  * @retval         1: a module frame, 0: other ID
+  */
+/**
+  * @brief          һ֡ģ, CANже
+  * @param[in]      std_id: ֡ID
+  * @param[in]      data: 8ֽ
+  * @param[in]      rx_cycle: ʱDWT
+  * @retval         1: ģ֡, 0: ID
+  */
+extern bool_t rm_imu_decode(uint32_t std_id, const uint8_t data[8], uint32_t rx_cycle);
+
+/**
+  * @brief          copy the latest module sample, sample_cycle is the estimated sample time
+  * @param[out]     snapshot: sample copy
+  * @retval         1: at least one sample received, 0: no sample
+  */
+/**
+  * @brief          ģ, sample_cycleΪƵĲʱ
+  * @param[out]     snapshot: ݸ
+  * @retval         1: յ, 0: 
+  */
+extern bool_t get_rm_imu_snapshot(INS_snapshot_t *snapshot);
+
+/**
+  * @brief          replace the board sample with the fused gimbal attitude at now,
+  *                 seq stays the board one, so INS_wait_snapshot still clocks the loop.
+  *                 one caller only, it is gimbal_task.
+  * @param[in,out]  gimbal_INS: in the board sample, out the gimbal attitude
+  * @retval         none
+  */
+/**
+  * @brief          õǰʱںϺ̨̬滻, seqΪ,
+  *                 INS_wait_snapshotԿͬ. ֻgimbal_task.
+  * @param[in,out]  gimbal_INS: , ̨̬
+  * @retval         none
+  */
+extern void rm_imu_fusion_update(INS_snapshot_t *gimbal_INS);
+
+/**
+  * @brief          get fusion statistics point
+  * @param[in]      none
+  * @retval         the point of rm_imu_stat
+  */
+/**
+  * @brief          ȡںͳƵָ
+  * @param[in]      none
+  * @retval         rm_imu_statָ
+  */
+extern const rm_imu_stat_t *get_rm_imu_stat_point(void);
+
+#endif
@@ -0,0 +1,337 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       vibration_task.c/h
+  * @brief      vibration spectrum of gyro or accel, INS_task fills a window of
+  *             samples and a low priority task runs the FFT, usb_task outputs
+  *             the spectrum and the largest peaks.
+  *             ǻٶȼƵƵ, INS_taskɼһڵ, ȼ
+  *             FFT, usb_taskƵ׺ļֵ.
+  * @note
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *
+  @verbatim
+  ==============================================================================
+  the window buffer belongs to INS_task while vibration_full is 0, and to
+  vibration_task while it is 1. the result belongs to vibration_task while
+  vibration_result_ready is 0, and to usb_task while it is 1.
+  vibration_fullΪ0ʱڻINS_task, Ϊ1ʱvibration_task.
+  vibration_result_readyΪ0ʱvibration_task, Ϊ1ʱusb_task.
+  ==============================================================================
+  @endverbatim
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+
+#include "vibration_task.h"
+#include "main.h"
+#include "cmsis_os.h"
+#include "arm_math.h"
+
+static fp32 vibration_buf[3][VIBRATION_FFT_LEN];
+static volatile uint16_t vibration_index;
+static volatile uint8_t vibration_full;
+static volatile uint8_t vibration_restart;
+static volatile uint8_t vibration_mode;
+static uint8_t vibration_window_mode;
+static uint32_t vibration_start_cycle;
+static uint32_t vibration_end_cycle;
+static TaskHandle_t vibration_task_local_handler;
+
+static vibration_result_t vibration_result;
+static volatile uint8_t vibration_result_ready;
+static uint32_t vibration_window_num;
+static uint32_t vibration_drop_num;
+
+static arm_rfft_fast_instance_f32 vibration_fft;
+static fp32 vibration_fft_in[VIBRATION_FFT_LEN];
+static fp32 vibration_fft_out[VIBRATION_FFT_LEN];
+
+static void vibration_analyze(void);
+static void vibration_peak_find(const fp32 amp[VIBRATION_BIN_NUM], fp32 bin_hz, vibration_peak_t peak[VIBRATION_PEAK_NUM]);
+
+#if INCLUDE_uxTaskGetStackHighWaterMark
+uint32_t vibration_high_water;
+#endif
+
+/**
+  * @brief          vibration task, waits for a full window and runs the FFT
+  * @param[in]      pvParameters: NULL
+  * @retval         none
+  */
+/**
+  * @brief          񶯷, ȴڲɼɺFFT
+  * @param[in]      pvParameters: NULL
+  * @retval         none
+  */
+void vibration_task(void const *pvParameters)
+{
+    arm_rfft_fast_init_f32(&vibration_fft, VIBRATION_FFT_LEN);
+    vibration_task_local_handler = xTaskGetCurrentTaskHandle();
+
+    while (1)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (!vibration_full)
+        {
+            continue;
+        }
+
+        vibration_window_num++;
+        if (vibration_result_ready)
+        {
+            vibration_drop_num++;
+        }
+        else
+        {
+            vibration_analyze();
+            __DMB();
+            vibration_result_ready = 1;
+        }
+
+        vibration_index = 0;
+        __DMB();
+        vibration_full = 0;
+
+#if INCLUDE_uxTaskGetStackHighWaterMark
+        vibration_high_water = uxTaskGetStackHighWaterMark(NULL);
+#endif
+    }
+}
+
+/**
+  * @brief          add a sample to the window, called by INS_task at every sample
+  * @param[in]      gyro: unit rad/s
+  * @param[in]      accel: unit m/s2
+  * @param[in]      cycle: DWT cycle of the sample
+  * @retval         none
+  */
+/**
+  * @brief          򴰿ڼһβ, INS_taskÿβ
+  * @param[in]      gyro: λ rad/s
+  * @param[in]      accel: λ m/s2
+  * @param[in]      cycle: ʱDWT
+  * @retval         none
+  */
+void vibration_sample(const fp32 gyro[3], const fp32 accel[3], uint32_t cycle)
+{
+    const fp32 *data;
+    uint16_t index;
+    uint8_t i;
+
+    if (vibration_mode == VIBRATION_OFF || vibration_full || gyro == NULL || accel == NULL)
+    {
+        return;
+    }
+    if (vibration_restart)
+    {
+        vibration_restart = 0;
+        vibration_index = 0;
+    }
+
+    index = vibration_index;
+    if (index == 0)
+    {
+        vibration_window_mode = vibration_mode;
+        vibration_start_cycle = cycle;
+    }
+    data = (vibration_window_mode == VIBRATION_ACCEL) ? accel : gyro;
+    for (i = 0; i < 3; i++)
+    {
+        vibration_buf[i][index] = data[i];
+    }
+
+    index++;
+    vibration_index = index;
+    if (index == VIBRATION_FFT_LEN)
+    {
+        vibration_end_cycle = cycle;
+        __DMB();
+        vibration_full = 1;
+        if (vibration_task_local_handler != NULL)
+        {
+            xTaskNotifyGive(vibration_task_local_handler);
+        }
+    }
+}
+
+/**
+  * @brief          set the analyzed sensor, the current window restarts
+  * @param[in]      mode: VIBRATION_OFF, VIBRATION_GYRO or VIBRATION_ACCEL
+  * @retval         none
+  */
+/**
+  * @brief          ÷Ĵ, ¿ʼɼ
+  * @param[in]      mode: VIBRATION_OFF, VIBRATION_GYRO  VIBRATION_ACCEL
+  * @retval         none
+  */
+void vibration_set_mode(uint8_t mode)
+{
+    if (mode > VIBRATION_ACCEL)
+    {
+        return;
+    }
+    vibration_window_num = 0;
+    vibration_drop_num = 0;
+    vibration_restart = 1;
+    vibration_mode = mode;
+}
+
+/**
+  * @brief          get the analyzed sensor
+  * @param[in]      none
+  * @retval         VIBRATION_OFF, VIBRATION_GYRO or VIBRATION_ACCEL
+  */
+/**
+  * @brief          ȡĴ
+  * @param[in]      none
+  * @retval         VIBRATION_OFF, VIBRATION_GYRO  VIBRATION_ACCEL
+  */
+uint8_t vibration_get_mode(void)
+{
+    return vibration_mode;
+}
+
+/**
+  * @brief          get the latest result, it is kept until vibration_result_free
+  * @param[in]      none
+  * @retval         the point of result, NULL if no new result
+  */
+/**
+  * @brief          ȡ½, ڵvibration_result_free֮ǰֲ
+  * @param[in]      none
+  * @retval         ָ, û½ʱΪNULL
+  */
+const vibration_result_t *vibration_result_get(void)
+{
+    if (!vibration_result_ready)
+    {
+        return NULL;
+    }
+    __DMB();
+    return &vibration_result;
+}
+
+/**
+  * @brief          the result is taken, the next window can be written
+  * @param[in]      none
+  * @retval         none
+  */
+/**
+  * @brief          ȡ, дһڵĽ
+  * @param[in]      none
+  * @retval         none
+  */
+void vibration_result_free(void)
+{
+    __DMB();
+    vibration_result_ready = 0;
+}
+
+/**
+  * @brief          spectrum and peaks of the full window into vibration_result
+  * @param[in]      none
+  * @retval         none
+  */
+/**
+  * @brief          ڵƵ׺ͷֵ, vibration_result
+  * @param[in]      none
+  * @retval         none
+  */
+static void vibration_analyze(void)
+{
+    fp32 *amp;
+    fp32 mean;
+    fp32 bin_hz;
+    uint32_t window_cycle = vibration_end_cycle - vibration_start_cycle;
+    uint16_t k;
+    uint8_t i;
+
+    vibration_result.mode = vibration_window_mode;
+    vibration_result.sample_rate = window_cycle ? (fp32)SystemCoreClock * (VIBRATION_FFT_LEN - 1) / (fp32)window_cycle : 0.0f;
+    vibration_result.window = vibration_window_num;
+    vibration_result.drop = vibration_drop_num;
+    bin_hz = vibration_result.sample_rate / VIBRATION_FFT_LEN;
+
+    for (i = 0; i < 3; i++)
+    {
+        amp = vibration_result.amp[i];
+
+        mean = 0.0f;
+        for (k = 0; k < VIBRATION_FFT_LEN; k++)
+        {
+            mean += vibration_buf[i][k];
+        }
+        mean /= VIBRATION_FFT_LEN;
+
+        //hann window
+        //
+        for (k = 0; k < VIBRATION_FFT_LEN; k++)
+        {
+            vibration_fft_in[k] = (vibration_buf[i][k] - mean) * (0.5f - 0.5f * arm_cos_f32(2.0f * PI * k / VIBRATION_FFT_LEN));
+        }
+        arm_rfft_fast_f32(&vibration_fft, vibration_fft_in, vibration_fft_out, 0);
+
+        //out[0] is DC and out[1] is nyquist, then re, im of bin 1 ~ N/2-1
+        //out[0]Ϊֱ, out[1]Ϊο˹Ƶ, ֮ΪƵ1 ~ N/2-1ʵ鲿
+        arm_cmplx_mag_f32(vibration_fft_out, amp, VIBRATION_BIN_NUM);
+        amp[0] = fabsf(vibration_fft_out[0]);
+
+        //the hann window sums to N/2, a sine of amplitude A gives A * N/4
+        //֮ΪN/2, ֵΪAźŶӦA * N/4
+        for (k = 0; k < VIBRATION_BIN_NUM; k++)
+        {
+            amp[k] *= 4.0f / VIBRATION_FFT_LEN;
+        }
+
+        vibration_peak_find(amp, bin_hz, vibration_result.peak[i]);
+    }
+}
+
+/**
+  * @brief          the largest local maxima, the frequency is refined by parabola
+  * @param[in]      amp: amplitude of every bin
+  * @param[in]      bin_hz: bin width, unit Hz
+  * @param[out]     peak: largest first, freq 0 if not found
+  * @retval         none
+  */
+/**
+  * @brief          ļֲֵ, Ƶֵ߲
+  * @param[in]      amp: Ƶֵ
+  * @param[in]      bin_hz: Ƶ λ Hz
+  * @param[out]     peak: ӴС, δҵʱƵΪ0
+  * @retval         none
+  */
+static void vibration_peak_find(const fp32 amp[VIBRATION_BIN_NUM], fp32 bin_hz, vibration_peak_t peak[VIBRATION_PEAK_NUM])
+{
+    fp32 denom;
+    fp32 delta;
+    uint16_t k;
+    uint8_t p;
+
+    for (p = 0; p < VIBRATION_PEAK_NUM; p++)
+    {
+        peak[p].freq = 0.0f;
+        peak[p].amp = 0.0f;
+    }
+
+    for (k = VIBRATION_PEAK_MIN_BIN; k < VIBRATION_BIN_NUM - 1; k++)
+    {
+        if (amp[k] <= amp[k - 1] || amp[k] < amp[k + 1] || amp[k] <= peak[VIBRATION_PEAK_NUM - 1].amp)
+        {
+            continue;
+        }
+
+        p = VIBRATION_PEAK_NUM - 1;
+        while (p > 0 && peak[p - 1].amp < amp[k])
+        {
+            peak[p] = peak[p - 1];
+            p--;
+        }
+
+        denom = amp[k - 1] - 2.0f * amp[k] + amp[k + 1];
+        delta = (denom != 0.0f) ? 0.5f * (amp[k - 1] - amp[k + 1]) / denom : 0.0f;
+        peak[p].freq = (k + delta) * bin_hz;
+        peak[p].amp = amp[k];
+    }
+}
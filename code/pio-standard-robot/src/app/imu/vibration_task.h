@@ -0,0 +1,140 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       vibration_task.c/h
+  * @brief      vibration spectrum of gyro or accel, INS_task fills a window of
+  *             samples and a low priority task runs the FFT, usb_task outputs
+  *             the spectrum and the largest peaks.
+  *             ǻٶȼƵƵ, INS_taskɼһڵ, ȼ
+  *             FFT, usb_taskƵ׺ļֵ.
+  * @note
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *
+  @verbatim
+  ==============================================================================
+  every window: mean removed, hann window, arm_rfft_fast_f32, amplitude per bin.
+  the amplitude is that of a sine at the bin frequency, unit rad/s or m/s2.
+  the sample rate is measured by DWT over the window, it is the INS rate.
+  a window is dropped if the last result is not taken by usb_task yet.
+  ÿ: ȥֵ, , arm_rfft_fast_f32, Ƶֵ. ֵΪƵ
+  źŵķֵ, λ rad/s  m/s2. DWTڴڲ, INS.
+  һνδusb_taskȡʱ.
+  ==============================================================================
+  @endverbatim
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+
+#ifndef VIBRATION_TASK_H
+#define VIBRATION_TASK_H
+
+#include "struct_typedef.h"
+
+//FFT length, 32~4096 and power of 2, about 0.5s at 1kHz
+//FFT, 32~4096Ϊ2, 1kHzʱԼ0.5s
+#define VIBRATION_FFT_LEN 512
+#define VIBRATION_BIN_NUM (VIBRATION_FFT_LEN / 2)
+//largest peaks of each axis
+//ÿֵ
+#define VIBRATION_PEAK_NUM 4
+//bins below it are not taken as peaks, they hold the mean and window leakage
+//ڸƵĲΪֵ, Ϊֵʹй©
+#define VIBRATION_PEAK_MIN_BIN 2
+
+#define VIBRATION_OFF   0
+#define VIBRATION_GYRO  1
+#define VIBRATION_ACCEL 2
+
+typedef struct
+{
+    fp32 freq;      //unit Hz.λ Hz
+    fp32 amp;
+} vibration_peak_t;
+
+typedef struct
+{
+    uint8_t mode;           //VIBRATION_GYRO or VIBRATION_ACCEL
+    fp32 sample_rate;       //unit Hz.λ Hz
+    uint32_t window;        //window count since mode set.ģʽĴ
+    uint32_t drop;          //windows dropped.Ĵ
+    fp32 amp[3][VIBRATION_BIN_NUM];
+    vibration_peak_t peak[3][VIBRATION_PEAK_NUM];
+} vibration_result_t;
+
+/**
+  * @brief          vibration task, waits for a full window and runs the FFT
+  * @param[in]      pvParameters: NULL
+  * @retval         none
+  */
+/**
+  * @brief          񶯷, ȴڲɼɺFFT
+  * @param[in]      pvParameters: NULL
+  * @retval         none
+  */
+extern void vibration_task(void const *pvParameters);
+
+/**
+  * @brief          add a sample to the window, called by INS_task at every sample
+  * @param[in]      gyro: unit rad/s
+  * @param[in]      accel: unit m/s2
+  * @param[in]      cycle: DWT cycle of the sample
+  * @retval         none
+  */
+/**
+  * @brief          򴰿ڼһβ, INS_taskÿβ
+  * @param[in]      gyro: λ rad/s
+  * @param[in]      accel: λ m/s2
+  * @param[in]      cycle: ʱDWT
+  * @retval         none
+  */
+extern void vibration_sample(const fp32 gyro[3], const fp32 accel[3], uint32_t cycle);
+
+/**
+  * @brief          set the analyzed sensor, the current window restarts
+  * @param[in]      mode: VIBRATION_OFF, VIBRATION_GYRO or VIBRATION_ACCEL
+  * @retval         none
+  */
+/**
+  * @brief          ÷Ĵ, ¿ʼɼ
+  * @param[in]      mode: VIBRATION_OFF, VIBRATION_GYRO  VIBRATION_ACCEL
+  * @retval         none
+  */
+extern void vibration_set_mode(uint8_t mode);
+
+/**
+  * @brief          get the analyzed sensor
+  * @param[in]      none
+  * @retval         VIBRATION_OFF, VIBRATION_GYRO or VIBRATION_ACCEL
+  */
+/**
+  * @brief          ȡĴ
+  * @param[in]      none
+  * @retval         VIBRATION_OFF, VIBRATION_GYRO  VIBRATION_ACCEL
+  */
+extern uint8_t vibration_get_mode(void);
+
+/**
+  * @brief          get the latest result, it is kept until vibration_result_free
+  * @param[in]      none
+  * @retval         the point of result, NULL if no new result
+  */
+/**
+  * @brief          ȡ½, ڵvibration_result_free֮ǰֲ
+  * @param[in]      none
+  * @retval         ָ, û½ʱΪNULL
+  */
+extern const vibration_result_t *vibration_result_get(void);
+
+/**
+  * @brief          the result is taken, the next window can be written
+  * @param[in]      none
+  * @retval         none
+  */
+/**
+  * @brief          ȡ, дһڵĽ
+  * @param[in]      none
+  * @retval         none
+  */
+extern void vibration_result_free(void);
+
+#endif
@@ -6,6 +6,9 @@
   * @history
   *  Version    Date            Author          Modification
   *  V1.0.0     Dec-26-2018     RM              1. 
+  *  V1.1.0     Oct-16-2026     RM              1. ʹõ״̬ƵٶȺȦ
+  *  V1.2.0     Oct-16-2026     RM              1. PIDʹʵ
+  *  V1.3.0     Oct-16-2026     RM              1. ٶȻpid
   *
   @verbatim
   ==============================================================================
@@ -28,6 +31,7 @@
 
 #include "CAN_receive.h"
 #include "gimbal_behaviour.h"
+#include "bsp_dwt.h"
 #include "detect_task.h"
 #include "pid.h"
 
@@ -40,6 +44,9 @@
 //΢IO
 #define BUTTEN_TRIG_PIN HAL_GPIO_ReadPin(BUTTON_TRIG_GPIO_Port, BUTTON_TRIG_Pin)
 
+//PID, KDʱPID_D. ǰPID_ANTI_WINDUP, ԭPID_calcֻͬ޷
+#define TRIGGER_PID_FLAG    (PID_I)
+
 
 
 
@@ -83,21 +90,22 @@ shoot_control_t shoot_control;          //
 void shoot_init(void)
 {
 
-    static const fp32 Trigger_speed_pid[3] = {TRIGGER_ANGLE_PID_KP, TRIGGER_ANGLE_PID_KI, TRIGGER_ANGLE_PID_KD};
+    //Kaw = Ki / Kp, used once PID_ANTI_WINDUP is added
+    static const pid_config_t Trigger_speed_pid = {TRIGGER_ANGLE_PID_KP, TRIGGER_ANGLE_PID_KI / SHOOT_CONTROL_TIME_S, TRIGGER_ANGLE_PID_KD * SHOOT_CONTROL_TIME_S,
+                                                   TRIGGER_READY_PID_MAX_OUT, TRIGGER_READY_PID_MAX_IOUT, TRIGGER_ANGLE_PID_KI / TRIGGER_ANGLE_PID_KP / SHOOT_CONTROL_TIME_S, 0.0f};
     shoot_control.shoot_mode = SHOOT_STOP;
     //ңָ
     shoot_control.shoot_rc = get_remote_control_point();
     //ָ
-    shoot_control.shoot_motor_measure = get_trigger_motor_measure_point();
+    shoot_control.shoot_motor_measure = &shoot_control.shoot_motor_feedback.measure;
     //ʼPID
-    PID_init(&shoot_control.trigger_motor_pid, PID_POSITION, Trigger_speed_pid, TRIGGER_READY_PID_MAX_OUT, TRIGGER_READY_PID_MAX_IOUT);
+    PID_init(&shoot_control.trigger_motor_pid, &Trigger_speed_pid);
     //
     shoot_feedback_update();
     ramp_init(&shoot_control.fric1_ramp, SHOOT_CONTROL_TIME * 0.001f, FRIC_DOWN, FRIC_OFF);
     ramp_init(&shoot_control.fric2_ramp, SHOOT_CONTROL_TIME * 0.001f, FRIC_DOWN, FRIC_OFF);
     shoot_control.fric_pwm1 = FRIC_OFF;
     shoot_control.fric_pwm2 = FRIC_OFF;
-    shoot_control.ecd_count = 0;
     shoot_control.angle = shoot_control.shoot_motor_measure->ecd * MOTOR_ECD_TO_ANGLE;
     shoot_control.given_current = 0;
     shoot_control.move_flag = 0;
@@ -179,7 +187,7 @@ int16_t shoot_control_loop(void)
     {
         shoot_laser_on(); //⿪
         //㲦ֵPID
-        PID_calc(&shoot_control.trigger_motor_pid, shoot_control.speed, shoot_control.speed_set);
+        PID_calc(&shoot_control.trigger_motor_pid, TRIGGER_PID_FLAG, shoot_control.speed, shoot_control.speed_set, shoot_control.dt);
         shoot_control.given_current = (int16_t)(shoot_control.trigger_motor_pid.out);
         if(shoot_control.shoot_mode < SHOOT_READY_BULLET)
         {
@@ -191,6 +199,12 @@ int16_t shoot_control_loop(void)
 
     }
 
+    //pidʱ̵ٶȻ, 趨ֵΪ0
+    if (shoot_control.trigger_tune != NULL)
+    {
+        shoot_control.given_current = (int16_t)relay_tune_calc(shoot_control.trigger_tune, -shoot_control.speed, shoot_control.dt);
+    }
+
     shoot_control.fric_pwm1 = (uint16_t)(shoot_control.fric1_ramp.out);
     shoot_control.fric_pwm2 = (uint16_t)(shoot_control.fric2_ramp.out);
     shoot_fric1_on(shoot_control.fric_pwm1);
@@ -198,6 +212,34 @@ int16_t shoot_control_loop(void)
     return shoot_control.given_current;
 }
 
+/**
+  * @brief          pid, ̵沦ٶȻ
+  * @param[in]      tune: ̵ṹָ, NULLʱָٶȻ
+  * @retval         none
+  */
+void shoot_tune_trigger(relay_tune_t *tune)
+{
+    shoot_control.trigger_tune = tune;
+    PID_clear(&shoot_control.trigger_motor_pid);
+}
+
+/**
+  * @brief          òٶȻ, Kaw = Ki / Kp
+  * @param[in]      kp: Kp
+  * @param[in]      ki: Ki λ 1/s
+  * @retval         none
+  */
+void shoot_set_trigger_pid(fp32 kp, fp32 ki)
+{
+    if (!(kp > 0.0f))
+    {
+        return;
+    }
+    shoot_control.trigger_motor_pid.Kp = kp;
+    shoot_control.trigger_motor_pid.Ki = ki;
+    shoot_control.trigger_motor_pid.Kaw = ki / kp;
+}
+
 /**
   * @brief          ״̬ãңϲһοϲرգ²1η1ţһֱ£䣬3min׼ʱӵ
   * @param[in]      void
@@ -304,41 +346,15 @@ static void shoot_set_mode(void)
   */
 static void shoot_feedback_update(void)
 {
+    //ݿ
+    get_motor_feedback(CAN_TRIGGER_MOTOR_INDEX, &shoot_control.shoot_motor_feedback);
+    shoot_control.dt = dwt_get_dt(&shoot_control.dt_cycle, SHOOT_CONTROL_TIME_S);
 
-    static fp32 speed_fliter_1 = 0.0f;
-    static fp32 speed_fliter_2 = 0.0f;
-    static fp32 speed_fliter_3 = 0.0f;
-
-    //ֵٶ˲һ
-    static const fp32 fliter_num[3] = {1.725709860247969f, -0.75594777109163436f, 0.030237910843665373f};
-
-    //׵ͨ˲
-    speed_fliter_1 = speed_fliter_2;
-    speed_fliter_2 = speed_fliter_3;
-    speed_fliter_3 = speed_fliter_2 * fliter_num[0] + speed_fliter_1 * fliter_num[1] + (shoot_control.shoot_motor_measure->speed_rpm * MOTOR_RPM_TO_SPEED) * fliter_num[2];
-    shoot_control.speed = speed_fliter_3;
-
-    //Ȧã ΪתһȦ ת 36ȦݴݣڿǶ
-    if (shoot_control.shoot_motor_measure->ecd - shoot_control.shoot_motor_measure->last_ecd > HALF_ECD_RANGE)
-    {
-        shoot_control.ecd_count--;
-    }
-    else if (shoot_control.shoot_motor_measure->ecd - shoot_control.shoot_motor_measure->last_ecd < -HALF_ECD_RANGE)
-    {
-        shoot_control.ecd_count++;
-    }
-
-    if (shoot_control.ecd_count == FULL_COUNT)
-    {
-        shoot_control.ecd_count = -(FULL_COUNT - 1);
-    }
-    else if (shoot_control.ecd_count == -FULL_COUNT)
-    {
-        shoot_control.ecd_count = FULL_COUNT - 1;
-    }
+    //ֵٶ, CANжеĵ״̬˲
+    shoot_control.speed = shoot_control.shoot_motor_feedback.state.velocity * MOTOR_STATE_RADS_TO_RPM * MOTOR_RPM_TO_SPEED;
 
-    //Ƕ
-    shoot_control.angle = (shoot_control.ecd_count * ECD_RANGE + shoot_control.shoot_motor_measure->ecd) * MOTOR_ECD_TO_ANGLE;
+    //Ƕ, ΪתһȦ, ת 36Ȧ, תȦ36ȡ
+    shoot_control.angle = rad_format((shoot_control.shoot_motor_feedback.state.round % (2 * FULL_COUNT) * ECD_RANGE + shoot_control.shoot_motor_measure->ecd) * MOTOR_ECD_TO_ANGLE);
     //΢
     shoot_control.key = BUTTEN_TRIG_PIN;
     //갴
@@ -6,6 +6,9 @@
   * @history
   *  Version    Date            Author          Modification
   *  V1.0.0     Dec-26-2018     RM              1. 
+  *  V1.1.0     Oct-16-2026     RM              1. ʹõ״̬ƵٶȺȦ
+  *  V1.2.0     Oct-16-2026     RM              1. PIDʹʵ
+  *  V1.3.0     Oct-16-2026     RM              1. ٶȻpid
   *
   @verbatim
   ==============================================================================
@@ -31,6 +34,7 @@
 //̨ģʽʹõĿͨ
 
 #define SHOOT_CONTROL_TIME          GIMBAL_CONTROL_TIME
+#define SHOOT_CONTROL_TIME_S        GIMBAL_CONTROL_TIME_S
 
 #define SHOOT_FRIC_PWM_ADD_VALUE    100.0f
 
@@ -71,7 +75,7 @@
 #define PI_FOUR                     0.78539816339744830961566084581988f
 #define PI_TEN                      0.314f
 
-//ֵPID
+//ֵPID, KIKDSHOOT_CONTROL_TIME, pidлΪ
 #define TRIGGER_ANGLE_PID_KP        800.0f
 #define TRIGGER_ANGLE_PID_KI        0.5f
 #define TRIGGER_ANGLE_PID_KD        0.0f
@@ -82,6 +86,10 @@
 #define TRIGGER_READY_PID_MAX_OUT   10000.0f
 #define TRIGGER_READY_PID_MAX_IOUT  7000.0f
 
+//pidļ̵ֵͻز, زλspeedͬ
+#define TRIGGER_TUNE_RELAY          3000.0f
+#define TRIGGER_TUNE_HYST           0.2f
+
 
 #define SHOOT_HEAT_REMAIN_VALUE     80
 
@@ -102,18 +110,21 @@ typedef struct
     shoot_mode_e shoot_mode;
     const RC_ctrl_t *shoot_rc;
     const motor_measure_t *shoot_motor_measure;
+    motor_feedback_t shoot_motor_feedback;
     ramp_function_source_t fric1_ramp;
     uint16_t fric_pwm1;
     ramp_function_source_t fric2_ramp;
     uint16_t fric_pwm2;
     pid_type_def trigger_motor_pid;
+    fp32 dt;                //ʵ λ s
+    uint32_t dt_cycle;
     fp32 trigger_speed_set;
     fp32 speed;
     fp32 speed_set;
     fp32 angle;
     fp32 set_angle;
     int16_t given_current;
-    int8_t ecd_count;
+    relay_tune_t *trigger_tune;    //ΪNULLʱ̵沦ٶȻ
 
     bool_t press_l;
     bool_t press_r;
@@ -137,5 +148,18 @@ typedef struct
 //̨ʹͬһcanidҲִ̨
 extern void shoot_init(void);
 extern int16_t shoot_control_loop(void);
+/**
+  * @brief          pid, ̵沦ٶȻ
+  * @param[in]      tune: ̵ṹָ, NULLʱָٶȻ
+  * @retval         none
+  */
+extern void shoot_tune_trigger(relay_tune_t *tune);
+/**
+  * @brief          òٶȻ, Kaw = Ki / Kp
+  * @param[in]      kp: Kp
+  * @param[in]      ki: Ki λ 1/s
+  * @retval         none
+  */
+extern void shoot_set_trigger_pid(fp32 kp, fp32 ki);
 
 #endif
@@ -6,9 +6,36 @@
   * @history
   *  Version    Date            Author          Modification
   *  V1.0.0     Nov-11-2019     RM              1. done
+  *  V1.1.0     Oct-16-2026     RM              1. output CAN bus statistics
+  *  V1.2.0     Oct-16-2026     RM              1. dump CAN recorder when 'd' is received
+  *  V1.3.0     Oct-16-2026     RM              1. output imu dt histogram
+  *  V1.4.0     Oct-16-2026     RM              1. output mag read latency
+  *  V1.5.0     Oct-16-2026     RM              1. output imu heater time to ready
+  *  V1.6.0     Oct-16-2026     RM              1. stream raw imu capture when 'c' is received
+  *  V1.7.0     Oct-16-2026     RM              1. output imu sample to CAN tx latency
+  *  V1.8.0     Oct-16-2026     RM              1. output RM IMU fusion state
+  *  V1.9.0     Oct-16-2026     RM              1. output vibration spectrum when 'v' is received
+  *  V1.10.0    Oct-16-2026     RM              1. output gyro FIFO statistics
   *
   @verbatim
   ==============================================================================
+  send 'd' to the board, it freezes the CAN recorder and dumps every record as
+  "time_us bus R/T id dlc data", one frame per line.
+  򿪷巢'd', CAN¼ǲÿһ¼, ÿһ֡
+  "ʱus  R/T ID  ".
+  send 'c' to the board, it starts raw imu capture, prints
+  "IMU capture clock:<SystemCoreClock>" and then streams binary imu_capture_t
+  records instead of the status, see imu_capture.h. send 'c' again to stop.
+  򿪷巢'c', ʼIMUԭʼݲɼ, һʱƵʺԶimu_capture_t
+  ״̬Ϣ, ʽimu_capture.h. ٴη'c'ֹͣ.
+  send 'v' to the board, it switches the vibration analyzer gyro -> accel -> off.
+  while it is on, every window replaces the status with
+  "vibration <sensor> rate:<Hz> bin:<mHz> window:<n> drop:<n>",
+  "peak x/y/z: <Hz> <amp>" of the largest peaks and "amp x/y/z: <amp> ..." of
+  every bin from 0, amp unit 1e-6 rad/s or 1e-6 m/s2.
+  򿪷巢'v', 񶯷  -> ٶȼ -> ر л. ʱÿڵ
+  ״̬Ϣ: , Ƶ, ֵƵֵ,
+  ֵλ 1e-6 rad/s  1e-6 m/s2.
 
   ==============================================================================
   @endverbatim
@@ -24,13 +51,40 @@
 #include <stdarg.h>
 #include "string.h"
 
+#include "CAN_receive.h"
+#include "can_recorder.h"
+#include "imu_capture.h"
+#include "rm_imu.h"
+#include "vibration_task.h"
+#include "INS_task.h"
 #include "detect_task.h"
 #include "voltage_task.h"
 
 
+//usb task period, status is sent every USB_STATUS_TIME ms
+//usb, ÿUSB_STATUS_TIMEһ״̬
+#define USB_TASK_TIME 10
+#define USB_STATUS_TIME 1000
+//wait for the previous transfer at most USB_TX_TIMEOUT ms
+//ȴһη͵ʱ
+#define USB_TX_TIMEOUT 50
+
 static void usb_printf(const char *fmt,...);
+static void usb_flush(void);
+static void usb_can_stat_printf(void);
+static void usb_can_record_dump(void);
+static void usb_imu_dt_printf(void);
+static void usb_imu_capture_send(void);
+static void usb_vibration_printf(void);
 
-static uint8_t usb_buf[256];
+//two buffers, one is being sent while the other is written
+//˫, һʱдһ
+static uint8_t usb_buf[2][1024];
+static uint8_t usb_buf_index;
+static uint16_t usb_buf_len;
+static volatile uint8_t usb_dump_request;
+static volatile uint8_t usb_capture_request;
+static volatile uint8_t usb_vibration_request;
 static const char status[2][7] = {"OK", "ERROR!"};
 const error_t *error_list_usb_local;
 
@@ -38,13 +92,63 @@ const error_t *error_list_usb_local;
 
 void usb_task(void const * argument)
 {
+    uint16_t status_time = 0;
+
     MX_USB_DEVICE_Init();
     error_list_usb_local = get_error_list_point();
 
 
     while(1)
     {
-        osDelay(1000);
+        osDelay(USB_TASK_TIME);
+        if (usb_dump_request)
+        {
+            usb_dump_request = 0;
+            usb_can_record_dump();
+        }
+        if (usb_capture_request)
+        {
+            usb_capture_request = 0;
+            if (imu_capture_is_on())
+            {
+                imu_capture_stop();
+                usb_printf("\r\nIMU capture off, drop:%lu\r\n", (unsigned long)imu_capture_drop());
+                usb_flush();
+            }
+            else
+            {
+                usb_printf("IMU capture clock:%lu\r\n", (unsigned long)SystemCoreClock);
+                usb_flush();
+                imu_capture_start();
+            }
+        }
+        if (usb_vibration_request)
+        {
+            usb_vibration_request = 0;
+            vibration_set_mode((vibration_get_mode() + 1) % (VIBRATION_ACCEL + 1));
+            usb_printf("vibration mode:%d\r\n", vibration_get_mode());
+            usb_flush();
+        }
+        //the binary stream takes the place of the status
+        //״̬
+        if (imu_capture_is_on())
+        {
+            usb_imu_capture_send();
+            continue;
+        }
+        if (vibration_get_mode() != VIBRATION_OFF)
+        {
+            usb_vibration_printf();
+            continue;
+        }
+
+        status_time += USB_TASK_TIME;
+        if (status_time < USB_STATUS_TIME)
+        {
+            continue;
+        }
+        status_time = 0;
+
         usb_printf(
 "******************************\r\n\
 voltage percentage:%d%% \r\n\
@@ -74,22 +178,266 @@ referee usart:%s\r\n\
             status[error_list_usb_local[BOARD_ACCEL_TOE].error_exist],
             status[error_list_usb_local[BOARD_MAG_TOE].error_exist],
             status[error_list_usb_local[REFEREE_TOE].error_exist]);
+        usb_can_stat_printf();
+        usb_flush();
+        usb_imu_dt_printf();
+        usb_flush();
+    }
+
+}
+
+static void usb_can_stat_printf(void)
+{
+    static const char bus_name[CAN_BUS_NUM][5] = {"CAN1", "CAN2"};
+    can_bus_stat_t bus_stat;
+    can_id_stat_t id_stat;
+    can_tx_stat_t tx_stat;
+    uint8_t i;
+
+    for (i = 0; i < CAN_BUS_NUM; i++)
+    {
+        get_can_bus_stat(i, &bus_stat);
+        usb_printf("%s load:%d.%d%% rx:%d/s tx:%d/s TEC:%d REC:%d passive:%d bus off:%d(%d) mailbox:%d/3 overrun:%d/%d\r\n",
+                   bus_name[i], bus_stat.load / 10, bus_stat.load % 10, bus_stat.rx_rate, bus_stat.tx_rate,
+                   bus_stat.tec, bus_stat.rec, bus_stat.error_passive, bus_stat.bus_off, bus_stat.bus_off_count,
+                   bus_stat.mailbox_high_water, bus_stat.fifo_overrun[0], bus_stat.fifo_overrun[1]);
+    }
+    for (i = 0; i < CAN_MOTOR_NUM; i++)
+    {
+        get_can_rx_id_stat(i, &id_stat);
+        usb_printf("rx %s 0x%03X:%d/s\r\n", bus_name[id_stat.bus], id_stat.std_id, id_stat.rate);
+    }
+    for (i = 0; i < CAN_TX_GROUP_NUM; i++)
+    {
+        get_can_tx_id_stat(i, &id_stat);
+        usb_printf("tx %s 0x%03X:%d/s\r\n", bus_name[id_stat.bus], id_stat.std_id, id_stat.rate);
+    }
+    //groups marked with CAN_tx_mark only
+    //ֻCAN_tx_markǵķ
+    for (i = 0; i < CAN_TX_GROUP_NUM; i++)
+    {
+        get_can_tx_stat(i, &tx_stat);
+        if (tx_stat.latency_num == 0)
+        {
+            continue;
+        }
+        usb_printf("tx group %d imu latency:%lu us mean:%lu us max:%lu us\r\n", i, (unsigned long)tx_stat.latency_us,
+                   (unsigned long)(tx_stat.latency_sum_us / tx_stat.latency_num), (unsigned long)tx_stat.latency_max_us);
+    }
+    usb_printf("******************************\r\n");
+}
+
+static void usb_imu_dt_printf(void)
+{
+    const INS_dt_hist_t *dt_hist = get_INS_dt_hist_point();
+    const INS_mag_stat_t *mag_stat = get_INS_mag_stat_point();
+    const INS_heater_stat_t *heater_stat = get_INS_heater_stat_point();
+    uint8_t i;
+
+    usb_printf("imu dt:%d~%dus hist(%dus+%dus*n):", dt_hist->dt_min_us, dt_hist->dt_max_us,
+               INS_DT_FRAME_US - INS_DT_HIST_NUM / 2 * INS_DT_HIST_STEP_US, INS_DT_HIST_STEP_US);
+    for (i = 0; i < INS_DT_HIST_NUM; i++)
+    {
+        usb_printf(" %d", dt_hist->count[i]);
+    }
+    usb_printf("\r\n");
+    usb_printf("mag:%d drop:%d error:%d latency:%dus(max %dus) isr max:%d cycle\r\n", mag_stat->sample, mag_stat->drop,
+               mag_stat->error, mag_stat->latency_us, mag_stat->latency_max_us, mag_stat->isr_cycle_max);
+#if defined(BMI088_GYRO_FIFO_ENABLE)
+    {
+        const INS_gyro_fifo_stat_t *fifo_stat = get_INS_gyro_fifo_stat_point();
+
+        usb_printf("gyro fifo: burst:%lu frame:%lu max:%lu empty:%lu overrun:%lu\r\n", (unsigned long)fifo_stat->burst,
+                   (unsigned long)fifo_stat->frame, (unsigned long)fifo_stat->frame_max, (unsigned long)fifo_stat->empty,
+                   (unsigned long)fifo_stat->overrun);
+    }
+#endif
+    //time to ready counts from the scheduler start
+    //ʱӵʼʱ
+    usb_printf("heater: start:%dC ready:%lums gain:%dmC/s tau:%ds\r\n", (int)heater_stat->start_temp,
+               (unsigned long)heater_stat->ready_time_ms, (int)(heater_stat->gain * 1000.0f), (int)heater_stat->tau);
+#if RM_IMU_ENABLE
+    {
+        static const char source_name[3][6] = {"none", "rm", "board"};
+        const rm_imu_stat_t *rm_imu_stat = get_rm_imu_stat_point();
+
+        usb_printf("rm imu: source:%s age:%luus failover:%lu offset yaw:%dmrad pitch:%dmrad\r\n", source_name[rm_imu_stat->source],
+                   (unsigned long)rm_imu_stat->rm_age_us, (unsigned long)rm_imu_stat->failover,
+                   (int)(rm_imu_stat->yaw_offset * 1000.0f), (int)(rm_imu_stat->pitch_offset * 1000.0f));
+    }
+#endif
+}
+
+static void usb_imu_capture_send(void)
+{
+    imu_capture_t record;
+
+    //gyro, accel and temperature are about 26 records in USB_TASK_TIME, flush as the buffer fills
+    //USB_TASK_TIMEԼ26¼, ʱ
+    while (imu_capture_read(&record))
+    {
+        if (usb_buf_len + sizeof(record) > sizeof(usb_buf[0]))
+        {
+            usb_flush();
+        }
+        memcpy(usb_buf[usb_buf_index] + usb_buf_len, &record, sizeof(record));
+        usb_buf_len += sizeof(record);
+    }
+    if (usb_buf_len)
+    {
+        usb_flush();
+    }
+}
+
+static void usb_vibration_printf(void)
+{
+    static const char sensor_name[3][6] = {"off", "gyro", "accel"};
+    const vibration_result_t *result = vibration_result_get();
+    uint16_t k;
+    uint8_t i, p;
+
+    if (result == NULL)
+    {
+        return;
+    }
+    //a window of the sensor before the switch
+    //л֮ǰĴ
+    if (result->mode != vibration_get_mode())
+    {
+        vibration_result_free();
+        return;
+    }
+
+    usb_printf("vibration %s rate:%dHz bin:%dmHz window:%lu drop:%lu\r\n", sensor_name[result->mode], (int)result->sample_rate,
+               (int)(result->sample_rate * 1000.0f / VIBRATION_FFT_LEN), (unsigned long)result->window, (unsigned long)result->drop);
+    for (i = 0; i < 3; i++)
+    {
+        usb_printf("peak %c:", 'x' + i);
+        for (p = 0; p < VIBRATION_PEAK_NUM; p++)
+        {
+            usb_printf(" %d.%dHz %ld", (int)result->peak[i][p].freq, (int)(result->peak[i][p].freq * 10.0f) % 10,
+                       (long)(result->peak[i][p].amp * 1000000.0f));
+        }
+        usb_printf("\r\n");
+    }
+    usb_flush();
+    for (i = 0; i < 3; i++)
+    {
+        usb_printf("amp %c:", 'x' + i);
+        for (k = 0; k < VIBRATION_BIN_NUM; k++)
+        {
+            usb_printf(" %ld", (long)(result->amp[i][k] * 1000000.0f));
+            if (usb_buf_len > sizeof(usb_buf[0]) - 16)
+            {
+                usb_flush();
+            }
+        }
+        usb_printf("\r\n");
+    }
+    usb_flush();
+    vibration_result_free();
+}
+
+static void usb_can_record_dump(void)
+{
+    can_record_t record;
+    uint16_t count;
+    uint16_t n;
+    uint8_t dlc, i;
 
+    can_recorder_freeze(1);
+    //let a writer already in progress finish
+    //ȴдļ¼
+    osDelay(1);
+
+    count = can_recorder_count();
+    usb_printf("CAN record:%d\r\n", count);
+    for (n = 0; n < count; n++)
+    {
+        can_recorder_read(n, &record);
+        dlc = record.dir_dlc & 0x0F;
+        usb_printf("%lu %d %c %03X %d ", (unsigned long)record.time_us, record.bus + 1, (record.dir_dlc >> 7) ? 'T' : 'R', record.std_id, dlc);
+        for (i = 0; i < dlc; i++)
+        {
+            usb_printf("%02X", record.data[i]);
+        }
+        usb_printf("\r\n");
+        if (usb_buf_len > sizeof(usb_buf[0]) - 64)
+        {
+            usb_flush();
+        }
     }
+    usb_printf("CAN record end\r\n");
+    usb_flush();
 
+    can_recorder_freeze(0);
+}
+
+/**
+  * @brief          usb receive call back, called in usb interrupt
+  * @param[in]      buf: received data
+  * @param[in]      len: data length
+  * @retval         none
+  */
+/**
+  * @brief          usbջص, usbже
+  * @param[in]      buf: 
+  * @param[in]      len: ݳ
+  * @retval         none
+  */
+void usb_receive(uint8_t *buf, uint32_t len)
+{
+    uint32_t i;
+    for (i = 0; i < len; i++)
+    {
+        if (buf[i] == 'd')
+        {
+            usb_dump_request = 1;
+        }
+        else if (buf[i] == 'c')
+        {
+            usb_capture_request = 1;
+        }
+        else if (buf[i] == 'v')
+        {
+            usb_vibration_request = 1;
+        }
+    }
 }
 
+//append to usb_buf, usb_flush sends it
 static void usb_printf(const char *fmt,...)
 {
     static va_list ap;
-    uint16_t len = 0;
+    int len = 0;
 
     va_start(ap, fmt);
 
-    len = vsprintf((char *)usb_buf, fmt, ap);
+    len = vsnprintf((char *)usb_buf[usb_buf_index] + usb_buf_len, sizeof(usb_buf[0]) - usb_buf_len, fmt, ap);
 
     va_end(ap);
 
+    if (len > 0)
+    {
+        usb_buf_len += len;
+        if (usb_buf_len > sizeof(usb_buf[0]) - 1)
+        {
+            usb_buf_len = sizeof(usb_buf[0]) - 1;
+        }
+    }
+}
 
-    CDC_Transmit_FS(usb_buf, len);
+//send usb_buf after the previous transfer, then switch to the other buffer
+//ȴһηɺ, Ȼлһ
+static void usb_flush(void)
+{
+    uint16_t wait_time = 0;
+
+    while (CDC_Transmit_FS(usb_buf[usb_buf_index], usb_buf_len) == USBD_BUSY && wait_time < USB_TX_TIMEOUT)
+    {
+        osDelay(1);
+        wait_time++;
+    }
+    usb_buf_index ^= 1;
+    usb_buf_len = 0;
 }
@@ -1,34 +1,116 @@
 #include "bsp_can.h"
 #include "main.h"
+#include "CAN_receive.h"
+#include "rm_imu.h"
 
 
 extern CAN_HandleTypeDef hcan1;
 extern CAN_HandleTypeDef hcan2;
 
-void can_filter_init(void)
+//first filter bank of each bus, CAN2 banks start from SlaveStartFilterBank
+#define CAN_SLAVE_START_FILTER_BANK 14
+
+typedef struct
 {
+    uint8_t bus;
+    uint16_t id;
+    uint32_t fifo;
+} can_filter_id_t;
 
+#define CAN_FILTER_ID_ENTRY(index, bus, id, fifo, toe) {bus, id, fifo},
+#define CAN_DM_FILTER_ID_ENTRY(index, bus, can_id, master_id, fifo, toe, p_max, v_max, t_max) {bus, master_id, fifo},
+static const can_filter_id_t can_filter_id[] =
+{
+    CAN_MOTOR_TABLE(CAN_FILTER_ID_ENTRY)
+    CAN_DM_MOTOR_TABLE(CAN_DM_FILTER_ID_ENTRY)
+#if RM_IMU_ENABLE
+    {RM_IMU_CAN_BUS, RM_IMU_QUAT_ID, RM_IMU_CAN_FIFO},
+    {RM_IMU_CAN_BUS, RM_IMU_GYRO_ID, RM_IMU_CAN_FIFO},
+    {RM_IMU_CAN_BUS, RM_IMU_ACCEL_ID, RM_IMU_CAN_FIFO},
+#endif
+};
+#undef CAN_FILTER_ID_ENTRY
+#undef CAN_DM_FILTER_ID_ENTRY
+#define CAN_FILTER_ID_NUM (sizeof(can_filter_id) / sizeof(can_filter_id[0]))
+
+//16 bit id list filter, one bank holds 4 standard ids, unused slots repeat the first id
+static void can_filter_list_config(CAN_HandleTypeDef *hcan, uint32_t bank, uint32_t fifo, const uint16_t *id, uint8_t num)
+{
     CAN_FilterTypeDef can_filter_st;
+    uint16_t list[4];
+    uint8_t i;
+
+    for (i = 0; i < 4; i++)
+    {
+        list[i] = (uint16_t)(id[i < num ? i : 0] << 5);
+    }
+
     can_filter_st.FilterActivation = ENABLE;
-    can_filter_st.FilterMode = CAN_FILTERMODE_IDMASK;
-    can_filter_st.FilterScale = CAN_FILTERSCALE_32BIT;
-    can_filter_st.FilterIdHigh = 0x0000;
-    can_filter_st.FilterIdLow = 0x0000;
-    can_filter_st.FilterMaskIdHigh = 0x0000;
-    can_filter_st.FilterMaskIdLow = 0x0000;
-    can_filter_st.FilterBank = 0;
-    can_filter_st.FilterFIFOAssignment = CAN_RX_FIFO0;
-    HAL_CAN_ConfigFilter(&hcan1, &can_filter_st);
+    can_filter_st.FilterMode = CAN_FILTERMODE_IDLIST;
+    can_filter_st.FilterScale = CAN_FILTERSCALE_16BIT;
+    can_filter_st.FilterIdHigh = list[0];
+    can_filter_st.FilterIdLow = list[1];
+    can_filter_st.FilterMaskIdHigh = list[2];
+    can_filter_st.FilterMaskIdLow = list[3];
+    can_filter_st.FilterBank = bank;
+    can_filter_st.FilterFIFOAssignment = fifo;
+    can_filter_st.SlaveStartFilterBank = CAN_SLAVE_START_FILTER_BANK;
+    HAL_CAN_ConfigFilter(hcan, &can_filter_st);
+}
+
+//configure the id list banks of one bus from CAN_MOTOR_TABLE and the RM IMU, grouped by rx fifo
+static void can_filter_bus_config(CAN_HandleTypeDef *hcan, uint8_t bus, uint32_t bank)
+{
+    static const uint32_t fifo_list[2] = {CAN_RX_FIFO0, CAN_RX_FIFO1};
+    uint16_t id[4];
+    uint8_t num;
+    uint8_t f, i;
+
+    for (f = 0; f < 2; f++)
+    {
+        num = 0;
+        for (i = 0; i < CAN_FILTER_ID_NUM; i++)
+        {
+            if (can_filter_id[i].bus != bus || can_filter_id[i].fifo != fifo_list[f])
+            {
+                continue;
+            }
+            id[num++] = can_filter_id[i].id;
+            if (num == 4)
+            {
+                can_filter_list_config(hcan, bank++, fifo_list[f], id, num);
+                num = 0;
+            }
+        }
+        if (num != 0)
+        {
+            can_filter_list_config(hcan, bank++, fifo_list[f], id, num);
+        }
+    }
+}
+
+void can_filter_init(void)
+{
+    can_filter_bus_config(&hcan1, CAN_BUS_1, 0);
     HAL_CAN_Start(&hcan1);
-    HAL_CAN_ActivateNotification(&hcan1, CAN_IT_RX_FIFO0_MSG_PENDING);
+    HAL_CAN_ActivateNotification(&hcan1, CAN_IT_RX_FIFO0_MSG_PENDING | CAN_IT_RX_FIFO1_MSG_PENDING);
 
 
-    can_filter_st.SlaveStartFilterBank = 14;
-    can_filter_st.FilterBank = 14;
-    HAL_CAN_ConfigFilter(&hcan2, &can_filter_st);
+    can_filter_bus_config(&hcan2, CAN_BUS_2, CAN_SLAVE_START_FILTER_BANK);
     HAL_CAN_Start(&hcan2);
-    HAL_CAN_ActivateNotification(&hcan2, CAN_IT_RX_FIFO0_MSG_PENDING);
-
+    HAL_CAN_ActivateNotification(&hcan2, CAN_IT_RX_FIFO0_MSG_PENDING | CAN_IT_RX_FIFO1_MSG_PENDING);
+}
 
+//read error state and tx mailbox use of a bus, bus: CAN_BUS_1 or CAN_BUS_2
+void can_bus_reg_read(uint8_t bus, can_bus_reg_t *reg)
+{
+    CAN_TypeDef *can = (bus == CAN_BUS_2) ? CAN2 : CAN1;
+    uint32_t esr = can->ESR;
+    uint32_t tsr = can->TSR;
 
+    reg->tec = (uint8_t)((esr & CAN_ESR_TEC) >> CAN_ESR_TEC_Pos);
+    reg->rec = (uint8_t)((esr & CAN_ESR_REC) >> CAN_ESR_REC_Pos);
+    reg->error_passive = (esr & CAN_ESR_EPVF) != 0;
+    reg->bus_off = (esr & CAN_ESR_BOFF) != 0;
+    reg->mailbox_used = ((tsr & CAN_TSR_TME0) == 0) + ((tsr & CAN_TSR_TME1) == 0) + ((tsr & CAN_TSR_TME2) == 0);
 }
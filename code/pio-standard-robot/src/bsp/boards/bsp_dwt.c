@@ -0,0 +1,83 @@
+#include "bsp_dwt.h"
+#include "main.h"
+
+static uint32_t cycle_per_us = 1;
+static uint32_t dwt_last_cycle;
+static uint64_t dwt_total_cycle;
+
+void dwt_init(void)
+{
+    cycle_per_us = SystemCoreClock / 1000000;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    dwt_last_cycle = 0;
+    dwt_total_cycle = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+uint32_t dwt_get_cycle(void)
+{
+    return DWT->CYCCNT;
+}
+
+uint32_t dwt_cycle_to_us(uint32_t cycle)
+{
+    return cycle / cycle_per_us;
+}
+
+uint32_t dwt_elapsed_us(uint32_t since_cycle)
+{
+    //unsigned subtraction handles one CYCCNT wrap (~25s at 168MHz)
+    return (DWT->CYCCNT - since_cycle) / cycle_per_us;
+}
+
+//extends CYCCNT to 64 bits in software, right only if called at least once per CYCCNT wrap (~25s at 168MHz)
+static uint64_t dwt_total_update(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    uint32_t cycle;
+    uint64_t total;
+
+    __disable_irq();
+    cycle = DWT->CYCCNT;
+    dwt_total_cycle += cycle - dwt_last_cycle;
+    dwt_last_cycle = cycle;
+    total = dwt_total_cycle;
+    __set_PRIMASK(primask);
+
+    return total;
+}
+
+//keeps the 64 bit extension of dwt_get_us right without calls of it,
+//TIM7 calls it every second through the CAN statistics
+void dwt_update(void)
+{
+    dwt_total_update();
+}
+
+//us since dwt_init, wraps after ~71 minutes
+uint32_t dwt_get_us(void)
+{
+    return (uint32_t)(dwt_total_update() / cycle_per_us);
+}
+
+//seconds since *last_cycle, and *last_cycle is set to now.
+//nominal at the first call (*last_cycle == 0), or after a gap of more than 4 nominal, e.g. the task was held
+fp32 dwt_get_dt(uint32_t *last_cycle, fp32 nominal)
+{
+    uint32_t cycle = DWT->CYCCNT;
+    fp32 dt;
+
+    if (last_cycle == NULL)
+    {
+        return nominal;
+    }
+    dt = (fp32)(cycle - *last_cycle) / (fp32)SystemCoreClock;
+    if (*last_cycle == 0 || dt <= 0.0f || dt > 4.0f * nominal)
+    {
+        dt = nominal;
+    }
+    *last_cycle = cycle;
+    return dt;
+}
@@ -0,0 +1,12 @@
+#ifndef BSP_DWT_H
+#define BSP_DWT_H
+#include "struct_typedef.h"
+
+extern void dwt_init(void);
+extern uint32_t dwt_get_cycle(void);
+extern uint32_t dwt_cycle_to_us(uint32_t cycle);
+extern uint32_t dwt_elapsed_us(uint32_t since_cycle);
+extern void dwt_update(void);
+extern uint32_t dwt_get_us(void);
+extern fp32 dwt_get_dt(uint32_t *last_cycle, fp32 nominal);
+#endif
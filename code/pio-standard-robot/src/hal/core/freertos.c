@@ -38,6 +38,7 @@
 #include "usb_task.h"
 #include "voltage_task.h"
 #include "servo_task.h"
+#include "vibration_task.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -54,6 +55,7 @@ osThreadId referee_usart_task_handle;
 osThreadId usb_task_handle;
 osThreadId battery_voltage_handle;
 osThreadId servo_task_handle;
+osThreadId vibration_task_handle;
 
 
 /* USER CODE END PTD */
@@ -185,6 +187,9 @@ void MX_FREERTOS_Init(void) {
     osThreadDef(SERVO, servo_task, osPriorityNormal, 0, 128);
     servo_task_handle = osThreadCreate(osThread(SERVO), NULL);
 
+    osThreadDef(VIBRATION, vibration_task, osPriorityLow, 0, 256);
+    vibration_task_handle = osThreadCreate(osThread(VIBRATION), NULL);
+
 
 
   /* USER CODE END RTOS_THREADS */
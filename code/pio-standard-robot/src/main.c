@@ -38,7 +38,9 @@
 /* USER CODE BEGIN Includes */
 #include "bsp_can.h"
 #include "bsp_delay.h"
+#include "bsp_dwt.h"
 #include "bsp_usart.h"
+#include "CAN_receive.h"
 #include "remote_control.h"
 
 #include "calibrate_task.h"
@@ -139,11 +141,14 @@ int main(void)
   MX_TIM1_Init();
   MX_TIM3_Init();
   MX_TIM10_Init();
+  MX_TIM7_Init();
   MX_USART1_UART_Init();
   MX_USART6_UART_Init();
   /* USER CODE BEGIN 2 */
     can_filter_init();
+    can_tx_init();
     delay_init();
+    dwt_init();
     cali_param_init();
     remote_control_init();
     usart1_tx_dma_init();
@@ -0,0 +1,475 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       bench_ahrs.c
+  * @brief      benchmark of the attitude filters of INS_task, AHRS_update and
+  *             the quaternion EKF: ns per update, angle error and yaw drift per
+  *             minute, on simulated motion with a known attitude or on a
+  *             recorded IMU log.
+  *             INS_task̬˲, AHRS_updateԪEKF: ÿθµĺʱ,
+  *             ǶÿyawƯ, ʹ֪̬ķ˶¼IMU.
+  * @note       usage: bench_ahrs [-r rate_hz] [log.txt ...]
+  *             without a log the simulated runs are used, at rate_hz, 1000 by
+  *             default. a log has one sample per line:
+  *             "time_us gx gy gz ax ay az [roll pitch yaw]", rad/s, m/s2 and rad,
+  *             after calibration, lines starting with '#' are skipped. with the
+  *             reference angles the error is against them, without them roll and
+  *             pitch are checked against the accel tilt while the IMU is still.
+  *             the time is the best of BENCH_REPEAT runs over the whole data.
+  *             ÷: bench_ahrs [-r Ƶhz] [log.txt ...]
+  *             ûм¼ļʱʹ÷, ƵĬ1000. ¼ļÿһ:
+  *             "time_us gx gy gz ax ay az [roll pitch yaw]", λ rad/s, m/s2, rad,
+  *             ΪУ׼, '#'ͷб. вοǶʱȽ, ûʱ
+  *             ֹʱrollpitchٶȼǱȽ. ʱȡBENCH_REPEATȫ
+  *             ̵һ.
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *  V1.1.0     Oct-16-2026     RM              1. quaternion EKF
+  *
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "AHRS.h"
+#include "quaternion_ekf.h"
+
+#define BENCH_REPEAT        20
+#define BENCH_SIM_TIME      60.0
+#define BENCH_SETTLE_TIME   2.0     //errors are counted after it, unit s.ʱ֮ͳ λ s
+#define BENCH_GRAVITY       9.780327
+#define BENCH_LINE_LEN      256
+
+//still: gyro norm below it, unit rad/s, and accel norm this close to gravity, unit m/s2
+//ֹ: ģСڸֵ λ rad/s, Ҽٶģ֮Сڸֵ λ m/s2
+#define BENCH_STILL_GYRO    0.05f
+#define BENCH_STILL_ACCEL   0.2f
+
+#define BENCH_RAD_TO_DEG    57.295779513082320876798154814105
+
+typedef struct
+{
+    fp32 dt;
+    fp32 gyro[3];
+    fp32 accel[3];
+    fp32 ref[3];        //roll, pitch, yaw, unit rad
+} bench_sample_t;
+
+typedef struct
+{
+    const char *name;
+    bench_sample_t *sample;
+    uint32_t num;
+    uint8_t has_ref;
+} bench_data_t;
+
+//one attitude filter as INS_task runs it
+//INS_taskķʽеһ̬˲
+typedef struct
+{
+    const char *name;
+    void (*init)(const fp32 accel[3]);
+    void (*update)(fp32 dt, const fp32 gyro[3], const fp32 accel[3]);
+    void (*angle)(fp32 *roll, fp32 *pitch, fp32 *yaw);
+} bench_filter_t;
+
+typedef struct
+{
+    fp64 tilt_sq;
+    fp32 tilt_max;
+    uint32_t tilt_num;
+    fp32 yaw_end;
+    fp64 time;
+} bench_error_t;
+
+static uint64_t bench_rng = 0x9E3779B97F4A7C15ULL;
+
+static fp64 bench_uniform(void)
+{
+    bench_rng ^= bench_rng << 13;
+    bench_rng ^= bench_rng >> 7;
+    bench_rng ^= bench_rng << 17;
+    return ((bench_rng >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+static fp64 bench_gauss(void)
+{
+    return sqrt(-2.0 * log(bench_uniform())) * cos(2.0 * M_PI * bench_uniform());
+}
+
+static uint64_t bench_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static fp32 bench_wrap(fp32 angle)
+{
+    while (angle > (fp32)M_PI)
+    {
+        angle -= 2.0f * (fp32)M_PI;
+    }
+    while (angle < -(fp32)M_PI)
+    {
+        angle += 2.0f * (fp32)M_PI;
+    }
+    return angle;
+}
+
+/*
+ahrs: the 3 tap accel IIR then AHRS_update, as INS_task with INS_FILTER_AHRS.
+fliter_num is the same as in INS_task.c, designed for 1kHz.
+ahrs: ٶIIRAHRS_update, INS_taskINS_FILTER_AHRSͬ.
+fliter_numINS_task.cͬ, 1kHz.
+*/
+static const fp32 fliter_num[3] = {1.929454039488895f, -0.93178349823448126f, 0.002329458745586203f};
+static fp32 ahrs_quat[4];
+static fp32 ahrs_fliter[3][3];
+
+static void ahrs_init(const fp32 accel[3])
+{
+    uint8_t i;
+
+    AHRS_init(ahrs_quat, accel, NULL);
+    for (i = 0; i < 3; i++)
+    {
+        ahrs_fliter[0][i] = ahrs_fliter[1][i] = ahrs_fliter[2][i] = accel[i];
+    }
+}
+
+static void ahrs_update(fp32 dt, const fp32 gyro[3], const fp32 accel[3])
+{
+    static const fp32 mag_none[3] = {0.0f, 0.0f, 0.0f};
+    uint8_t i;
+
+    for (i = 0; i < 3; i++)
+    {
+        ahrs_fliter[0][i] = ahrs_fliter[1][i];
+        ahrs_fliter[1][i] = ahrs_fliter[2][i];
+        ahrs_fliter[2][i] = ahrs_fliter[1][i] * fliter_num[0] + ahrs_fliter[0][i] * fliter_num[1] + accel[i] * fliter_num[2];
+    }
+    AHRS_update(ahrs_quat, dt, gyro, (const fp32 *)ahrs_fliter[2], mag_none);
+}
+
+static void ahrs_angle(fp32 *roll, fp32 *pitch, fp32 *yaw)
+{
+    get_angle(ahrs_quat, yaw, pitch, roll);
+}
+
+/*
+qekf: quaternion_ekf_update on the raw accel, as INS_task with INS_FILTER_EKF.
+qekf: ʹδ˲ļٶȵquaternion_ekf_update, INS_taskINS_FILTER_EKFͬ.
+*/
+static quaternion_ekf_t qekf;
+
+static void qekf_init(const fp32 accel[3])
+{
+    quaternion_ekf_init(&qekf, accel);
+}
+
+static void qekf_update(fp32 dt, const fp32 gyro[3], const fp32 accel[3])
+{
+    quaternion_ekf_update(&qekf, dt, gyro, accel);
+}
+
+static void qekf_angle(fp32 *roll, fp32 *pitch, fp32 *yaw)
+{
+    get_angle(qekf.q, yaw, pitch, roll);
+}
+
+static const bench_filter_t bench_filter[] =
+{
+    {"ahrs", ahrs_init, ahrs_update, ahrs_angle},
+    {"qekf", qekf_init, qekf_update, qekf_angle},
+};
+
+#define BENCH_FILTER_NUM (sizeof(bench_filter) / sizeof(bench_filter[0]))
+
+/*
+simulated motion, the attitude is analytic so the body rate and the specific
+force are exact. Z-Y-X euler angles, z up, gravity (0, 0, -g).
+gimbal: yaw +-1.2 rad at 0.4Hz with 1.5 rad/s spin, pitch +-0.35 rad at 1.3Hz,
+roll +-0.05 rad at 2.1Hz, chassis acceleration 3 m/s2 at 0.7Hz and 1 m/s2 of
+150Hz vibration. still: fixed tilt. both have a gyro bias and white noise.
+˶, ̬Ϊʽ, ˽ٶȺͱǾȷ. Z-Y-Xŷ, z,
+ (0, 0, -g). gimbal: yaw 0.4Hz +-1.2 rad  1.5 rad/s ת, pitch 1.3Hz
++-0.35 rad, roll 2.1Hz +-0.05 rad, ̼ٶ 0.7Hz 3 m/s2  150Hz 1 m/s2 .
+still: ̶. ߶ƯͰ.
+*/
+typedef struct
+{
+    fp64 yaw_amp, yaw_freq, yaw_spin;
+    fp64 pitch_amp, pitch_freq, pitch_bias;
+    fp64 roll_amp, roll_freq, roll_bias;
+    fp64 lin_amp, lin_freq;
+    fp64 vib_amp, vib_freq;
+} bench_motion_t;
+
+static const fp64 bench_gyro_bias[3] = {0.002, -0.0015, 0.003};
+#define BENCH_GYRO_NOISE    0.004   //rad/s
+#define BENCH_ACCEL_NOISE   0.03    //m/s2
+
+static void bench_motion(const bench_motion_t *m, fp64 t, fp64 angle[3], fp64 rate[3])
+{
+    fp64 w;
+
+    //roll, pitch, yaw and their derivatives
+    //roll, pitch, yaw䵼
+    w = 2.0 * M_PI * m->roll_freq;
+    angle[0] = m->roll_bias + m->roll_amp * sin(w * t);
+    rate[0] = m->roll_amp * w * cos(w * t);
+    w = 2.0 * M_PI * m->pitch_freq;
+    angle[1] = m->pitch_bias + m->pitch_amp * sin(w * t);
+    rate[1] = m->pitch_amp * w * cos(w * t);
+    w = 2.0 * M_PI * m->yaw_freq;
+    angle[2] = m->yaw_spin * t + m->yaw_amp * sin(w * t);
+    rate[2] = m->yaw_spin + m->yaw_amp * w * cos(w * t);
+}
+
+static void bench_simulate(bench_data_t *data, const char *name, const bench_motion_t *m, fp64 rate_hz, fp64 time)
+{
+    fp64 angle[3], d_angle[3];
+    fp64 sr, cr, sp, cp, sy, cy;
+    fp64 acc_w[3], f_b[3], w_b[3];
+    fp64 t;
+    uint32_t n;
+    uint8_t i;
+
+    data->name = name;
+    data->num = (uint32_t)(time * rate_hz);
+    data->sample = (bench_sample_t *)calloc(data->num, sizeof(bench_sample_t));
+    data->has_ref = 1;
+
+    for (n = 0; n < data->num; n++)
+    {
+        t = n / rate_hz;
+        bench_motion(m, t, angle, d_angle);
+        sr = sin(angle[0]);
+        cr = cos(angle[0]);
+        sp = sin(angle[1]);
+        cp = cos(angle[1]);
+        sy = sin(angle[2]);
+        cy = cos(angle[2]);
+
+        //body rate from euler rates
+        //ŷٶȵõٶ
+        w_b[0] = d_angle[0] - d_angle[2] * sp;
+        w_b[1] = d_angle[1] * cr + d_angle[2] * cp * sr;
+        w_b[2] = -d_angle[1] * sr + d_angle[2] * cp * cr;
+
+        //specific force in world, rotated to body by R^T, R = Rz * Ry * Rx
+        //ϵ, R^Tתϵ, R = Rz * Ry * Rx
+        acc_w[0] = m->lin_amp * sin(2.0 * M_PI * m->lin_freq * t);
+        acc_w[1] = m->lin_amp * cos(2.0 * M_PI * m->lin_freq * 1.3 * t);
+        acc_w[2] = BENCH_GRAVITY + m->vib_amp * sin(2.0 * M_PI * m->vib_freq * t);
+        f_b[0] = (cy * cp) * acc_w[0] + (sy * cp) * acc_w[1] - sp * acc_w[2];
+        f_b[1] = (cy * sp * sr - sy * cr) * acc_w[0] + (sy * sp * sr + cy * cr) * acc_w[1] + cp * sr * acc_w[2];
+        f_b[2] = (cy * sp * cr + sy * sr) * acc_w[0] + (sy * sp * cr - cy * sr) * acc_w[1] + cp * cr * acc_w[2];
+
+        data->sample[n].dt = (fp32)(1.0 / rate_hz);
+        for (i = 0; i < 3; i++)
+        {
+            data->sample[n].gyro[i] = (fp32)(w_b[i] + bench_gyro_bias[i] + BENCH_GYRO_NOISE * bench_gauss());
+            data->sample[n].accel[i] = (fp32)(f_b[i] + BENCH_ACCEL_NOISE * bench_gauss());
+            data->sample[n].ref[i] = (fp32)angle[i];
+        }
+        data->sample[n].ref[2] = bench_wrap((fp32)fmod(angle[2], 2.0 * M_PI));
+    }
+}
+
+static int bench_load(bench_data_t *data, const char *path)
+{
+    FILE *file = fopen(path, "r");
+    char line[BENCH_LINE_LEN];
+    bench_sample_t sample;
+    unsigned long long time_us, last_us = 0;
+    uint32_t size = 0;
+    int field;
+
+    memset(data, 0, sizeof(bench_data_t));
+    if (file == NULL)
+    {
+        perror(path);
+        return -1;
+    }
+    data->name = path;
+    data->has_ref = 1;
+
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r')
+        {
+            continue;
+        }
+        memset(&sample, 0, sizeof(sample));
+        field = sscanf(line, "%llu %f %f %f %f %f %f %f %f %f", &time_us, &sample.gyro[0], &sample.gyro[1], &sample.gyro[2],
+                       &sample.accel[0], &sample.accel[1], &sample.accel[2], &sample.ref[0], &sample.ref[1], &sample.ref[2]);
+        if (field != 7 && field != 10)
+        {
+            fprintf(stderr, "%s: bad line: %s", path, line);
+            fclose(file);
+            return -1;
+        }
+        if (field == 7)
+        {
+            data->has_ref = 0;
+        }
+        sample.dt = data->num ? (time_us - last_us) * 0.000001f : 0.0f;
+        last_us = time_us;
+
+        if (data->num == size)
+        {
+            size = size ? size * 2 : 4096;
+            data->sample = (bench_sample_t *)realloc(data->sample, size * sizeof(bench_sample_t));
+        }
+        data->sample[data->num++] = sample;
+    }
+    fclose(file);
+    if (data->num < 2)
+    {
+        fprintf(stderr, "%s: no samples\n", path);
+        return -1;
+    }
+    data->sample[0].dt = data->sample[1].dt;
+    return 0;
+}
+
+static void bench_run(const bench_filter_t *filter, const bench_data_t *data, bench_error_t *error)
+{
+    const bench_sample_t *s;
+    fp32 roll, pitch, yaw, roll_ref, pitch_ref, norm, err;
+    uint32_t n;
+
+    memset(error, 0, sizeof(bench_error_t));
+    filter->init(data->sample[0].accel);
+    for (n = 0; n < data->num; n++)
+    {
+        s = &data->sample[n];
+        filter->update(s->dt, s->gyro, s->accel);
+        error->time += s->dt;
+        if (error->time < BENCH_SETTLE_TIME)
+        {
+            continue;
+        }
+
+        filter->angle(&roll, &pitch, &yaw);
+        if (data->has_ref)
+        {
+            roll_ref = s->ref[0];
+            pitch_ref = s->ref[1];
+            error->yaw_end = bench_wrap(yaw - s->ref[2]);
+        }
+        else
+        {
+            //tilt of the accel while still
+            //ֹʱٶȼƵ
+            norm = sqrtf(s->accel[0] * s->accel[0] + s->accel[1] * s->accel[1] + s->accel[2] * s->accel[2]);
+            if (sqrtf(s->gyro[0] * s->gyro[0] + s->gyro[1] * s->gyro[1] + s->gyro[2] * s->gyro[2]) > BENCH_STILL_GYRO ||
+                fabsf(norm - get_carrier_gravity()) > BENCH_STILL_ACCEL)
+            {
+                continue;
+            }
+            roll_ref = atan2f(s->accel[1], s->accel[2]);
+            pitch_ref = atan2f(-s->accel[0], sqrtf(s->accel[1] * s->accel[1] + s->accel[2] * s->accel[2]));
+        }
+        err = sqrtf(bench_wrap(roll - roll_ref) * bench_wrap(roll - roll_ref) + (pitch - pitch_ref) * (pitch - pitch_ref));
+        error->tilt_sq += err * err;
+        error->tilt_num++;
+        if (error->tilt_max < err)
+        {
+            error->tilt_max = err;
+        }
+    }
+}
+
+static fp64 bench_time(const bench_filter_t *filter, const bench_data_t *data)
+{
+    uint64_t start, best = UINT64_MAX;
+    uint32_t n;
+    int r;
+
+    for (r = 0; r < BENCH_REPEAT; r++)
+    {
+        filter->init(data->sample[0].accel);
+        start = bench_ns();
+        for (n = 0; n < data->num; n++)
+        {
+            filter->update(data->sample[n].dt, data->sample[n].gyro, data->sample[n].accel);
+        }
+        start = bench_ns() - start;
+        if (best > start)
+        {
+            best = start;
+        }
+    }
+    return (fp64)best / data->num;
+}
+
+static void bench_report(const bench_data_t *data)
+{
+    bench_error_t error;
+    fp64 ns;
+    uint32_t f;
+
+    for (f = 0; f < BENCH_FILTER_NUM; f++)
+    {
+        bench_run(&bench_filter[f], data, &error);
+        ns = bench_time(&bench_filter[f], data);
+        printf("%-14s %-6s %8.1f %10.3f %10.3f", data->name, bench_filter[f].name, ns,
+               error.tilt_num ? sqrt(error.tilt_sq / error.tilt_num) * BENCH_RAD_TO_DEG : 0.0,
+               error.tilt_max * BENCH_RAD_TO_DEG);
+        if (data->has_ref)
+        {
+            printf(" %10.3f %10.3f\n", error.yaw_end * BENCH_RAD_TO_DEG, error.yaw_end * BENCH_RAD_TO_DEG * 60.0 / error.time);
+        }
+        else
+        {
+            printf(" %10s %10s  (%u still samples)\n", "-", "-", error.tilt_num);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    static const bench_motion_t still = {0.0, 0.0, 0.0, 0.0, 0.0, -0.035, 0.0, 0.0, 0.052, 0.0, 0.0, 0.0, 0.0};
+    static const bench_motion_t gimbal = {1.2, 0.4, 1.5, 0.35, 1.3, 0.0, 0.05, 2.1, 0.0, 3.0, 0.7, 1.0, 150.0};
+    bench_data_t data;
+    fp64 rate_hz = 1000.0;
+    int log_num = 0;
+    int i;
+
+    printf("%-14s %-6s %8s %10s %10s %10s %10s\n", "data", "filter", "ns/upd", "tilt rms", "tilt max", "yaw end",
+           "yaw /min");
+    printf("%-14s %-6s %8s %10s %10s %10s %10s\n", "", "", "", "deg", "deg", "deg", "deg");
+
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+        {
+            rate_hz = atof(argv[++i]);
+            continue;
+        }
+        log_num++;
+        if (bench_load(&data, argv[i]) == 0)
+        {
+            bench_report(&data);
+        }
+        free(data.sample);
+    }
+
+    if (log_num == 0)
+    {
+        bench_simulate(&data, "sim still", &still, rate_hz, BENCH_SIM_TIME);
+        bench_report(&data);
+        free(data.sample);
+        bench_simulate(&data, "sim gimbal", &gimbal, rate_hz, BENCH_SIM_TIME);
+        bench_report(&data);
+        free(data.sample);
+    }
+    return 0;
+}
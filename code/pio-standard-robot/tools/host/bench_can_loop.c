@@ -0,0 +1,383 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       bench_can_loop.c
+  * @brief      command to feedback loop of CAN_receive.c against simulated
+  *             motors on SocketCAN: a 1kHz task posts the chassis and gimbal
+  *             currents, the tx stage of TIM7 at 4kHz or CAN_tx_now sends them,
+  *             host_motor_sim answers 0x201~0x207 and the rx interrupt takes the
+  *             feedback. prints the rates, the lost feedback and the latency
+  *             from the post to the mailbox and to the feedback.
+  *             CAN_receive.cSocketCANģ·: 1kHz
+  *             ύ̨̺, 4kHzTIM7͵ȻCAN_tx_now,
+  *             host_motor_simظ0x201~0x207, ж϶ȡ. ,
+  *             ʧķ, Լύ͵յӳ.
+  * @note       usage: bench_can_loop [-i ifname] [-x] [-m ms]
+  *             both buses are on ifname, vcan0 by default, the motors run in a
+  *             thread, or with -x in another process (motor_sim). without
+  *             SocketCAN a socketpair takes the place of the interface, the path
+  *             is the same but the kernel CAN stack. a feedback carries the
+  *             command current, the command of period k is k % 1024 + 1, so the
+  *             latency is from the post of that command. the host is not the M4,
+  *             the interrupts are threads, the numbers are of the host.
+  *             ÷: bench_can_loop [-i ifname] [-x] [-m ms]
+  *             ߶ifname, Ĭvcan0, һ߳, ʹ-xʱ
+  *             һ(motor_sim). ûSocketCANʱ׽ֶԴӿ,
+  *             ·ͬ, ֻûںCANЭջ. , kڵ
+  *             Ϊ k % 1024 + 1, ӳٴӸύʱ. M4, жΪ
+  *             ߳, Ϊϵֵ.
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include "host_hal.h"
+#include "host_motor_sim.h"
+#include "main.h"
+#include "bsp_dwt.h"
+#include "CAN_receive.h"
+#include "can_recorder.h"
+
+#define BENCH_IFNAME        "vcan0"
+#define BENCH_MS            3000        //each row, unit ms.ÿеʱ λ ms
+#define BENCH_PERIOD_NS     1000000     //the task, 1kHz.
+#define BENCH_TIM7_NS       250000      //TIM7, 4kHz
+#define BENCH_DRAIN_MS      20          //wait for the last feedback, unit ms.ȴķ λ ms
+#define BENCH_CMD_RING      1024        //power of 2.2
+#define BENCH_HIST_US       10          //latency bin, unit us.ӳֱͼ λ us
+#define BENCH_HIST_NUM      2000
+//lost feedback allowed, of the expected.ʧķ
+#define BENCH_LOST_MAX      0.01f
+
+//the DJI motors of CAN_MOTOR_TABLE, the ones host_motor_sim answers
+//CAN_MOTOR_TABLEеĴ󽮵, host_motor_simظĵ
+static const uint8_t bench_motor[] =
+{
+#define BENCH_MOTOR_ENTRY(index, ...) index,
+    CAN_MOTOR_TABLE(BENCH_MOTOR_ENTRY)
+#undef BENCH_MOTOR_ENTRY
+};
+#define BENCH_MOTOR_NUM (sizeof(bench_motor) / sizeof(bench_motor[0]))
+
+typedef struct
+{
+    uint32_t period;            //periods run.е
+    uint32_t late;              //periods started a period late.һϿʼ
+    uint32_t tx_frame;
+    uint32_t expected;          //feedback frames the tx frames ask for.֡Ӧõķ֡
+    uint32_t rx_frame;
+    uint32_t sample;            //feedback matched to its command.Ӧϵķ
+    uint64_t latency_sum_us;
+    uint32_t latency_max_us;
+    uint32_t mailbox_sum_us;    //post to mailbox of can_tx_stat_t.can_tx_stat_tύӳ
+    uint32_t mailbox_num;
+    uint32_t hist[BENCH_HIST_NUM];
+} bench_result_t;
+
+static volatile uint8_t bench_stop;
+static volatile uint8_t bench_sim_stop;
+static uint32_t bench_post_cycle[BENCH_CMD_RING];
+static uint32_t bench_last_seq[BENCH_MOTOR_NUM];
+static bench_result_t bench_result;
+
+static void bench_add_ns(struct timespec *ts, long ns)
+{
+    ts->tv_nsec += ns;
+    while (ts->tv_nsec >= 1000000000L)
+    {
+        ts->tv_nsec -= 1000000000L;
+        ts->tv_sec++;
+    }
+}
+
+static void *bench_rx_thread(void *arg)
+{
+    (void)arg;
+    while (!bench_stop)
+    {
+        host_can_poll(10000);
+    }
+    return NULL;
+}
+
+static void *bench_tim7_thread(void *arg)
+{
+    struct timespec next;
+    (void)arg;
+
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    while (!bench_stop)
+    {
+        bench_add_ns(&next, BENCH_TIM7_NS);
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+        host_irq_tim7();
+    }
+    return NULL;
+}
+
+static void *bench_sim_thread(void *arg)
+{
+    host_motor_sim_run(*(int *)arg, &bench_sim_stop);
+    return NULL;
+}
+
+//tx frames sent and post to mailbox latency of the chassis and gimbal groups
+//̨̺ķ֡ύӳ
+static void bench_tx_count(uint32_t *chassis, uint32_t *gimbal, uint32_t *latency_sum_us, uint32_t *latency_num)
+{
+    can_tx_stat_t stat;
+
+    get_can_tx_stat(CAN_TX_CHASSIS_GROUP, &stat);
+    *chassis = stat.sent;
+    *latency_sum_us = stat.latency_sum_us;
+    *latency_num = stat.latency_num;
+    get_can_tx_stat(CAN_TX_GIMBAL_GROUP, &stat);
+    *gimbal = stat.sent;
+    *latency_sum_us += stat.latency_sum_us;
+    *latency_num += stat.latency_num;
+}
+
+//new feedback of every motor, the latency of the command it answers
+//ÿ·, Լظӳ
+static void bench_read_feedback(bench_result_t *result)
+{
+    motor_feedback_t feedback;
+    uint32_t latency_us;
+    uint32_t cmd;
+    uint8_t i;
+
+    for (i = 0; i < BENCH_MOTOR_NUM; i++)
+    {
+        if (!get_motor_feedback(bench_motor[i], &feedback) || feedback.seq == bench_last_seq[i])
+        {
+            continue;
+        }
+        result->rx_frame += feedback.seq - bench_last_seq[i];
+        bench_last_seq[i] = feedback.seq;
+        cmd = (uint32_t)(uint16_t)feedback.measure.given_current - 1U;
+        if (cmd >= BENCH_CMD_RING || bench_post_cycle[cmd] == 0)
+        {
+            continue;
+        }
+        latency_us = dwt_cycle_to_us(feedback.rx_cycle - bench_post_cycle[cmd]);
+        result->sample++;
+        result->latency_sum_us += latency_us;
+        if (latency_us > result->latency_max_us)
+        {
+            result->latency_max_us = latency_us;
+        }
+        result->hist[latency_us / BENCH_HIST_US < BENCH_HIST_NUM ? latency_us / BENCH_HIST_US : BENCH_HIST_NUM - 1]++;
+    }
+}
+
+/**
+  * @brief          run the 1kHz task for ms, the tx by the TIM7 phases or by CAN_tx_now
+  * @param[in]      tx_now: 1: CAN_tx_now after the post
+  * @param[in]      ms: time, unit ms
+  * @param[out]     result: counts of the run
+  * @retval         none
+  */
+/**
+  * @brief          1kHzms, TIM7λCAN_tx_now
+  * @param[in]      tx_now: 1: ύCAN_tx_now
+  * @param[in]      ms: ʱ λ ms
+  * @param[out]     result: еļ
+  * @retval         none
+  */
+static void bench_run(bool_t tx_now, uint32_t ms, bench_result_t *result)
+{
+    struct timespec next, now;
+    uint32_t chassis0, gimbal0, chassis1, gimbal1;
+    uint32_t mailbox_sum0, mailbox_num0, mailbox_sum1, mailbox_num1;
+    motor_feedback_t feedback;
+    uint32_t cycle;
+    int16_t cmd;
+    uint32_t k;
+    uint8_t i;
+
+    memset(result, 0, sizeof(bench_result_t));
+    memset(bench_post_cycle, 0, sizeof(bench_post_cycle));
+    for (i = 0; i < BENCH_MOTOR_NUM; i++)
+    {
+        bench_last_seq[i] = get_motor_feedback(bench_motor[i], &feedback) ? feedback.seq : 0;
+    }
+    bench_tx_count(&chassis0, &gimbal0, &mailbox_sum0, &mailbox_num0);
+
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    for (k = 0; k < ms; k++)
+    {
+        bench_add_ns(&next, BENCH_PERIOD_NS);
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if ((now.tv_sec - next.tv_sec) * 1000000000L + (now.tv_nsec - next.tv_nsec) > BENCH_PERIOD_NS)
+        {
+            result->late++;
+        }
+
+        bench_read_feedback(result);
+
+        //as chassis_task and gimbal_task: mark, post, and send now with GIMBAL_IMU_TRIGGER
+        //chassis_taskgimbal_taskͬ: , ύ, GIMBAL_IMU_TRIGGERʱ
+        cmd = (int16_t)((k & (BENCH_CMD_RING - 1)) + 1);
+        cycle = dwt_get_cycle();
+        bench_post_cycle[k & (BENCH_CMD_RING - 1)] = cycle ? cycle : 1;
+        CAN_tx_mark(CAN_TX_CHASSIS_GROUP, cycle);
+        CAN_cmd_chassis(cmd, cmd, cmd, cmd);
+        CAN_tx_mark(CAN_TX_GIMBAL_GROUP, cycle);
+        CAN_cmd_gimbal(cmd, cmd, cmd, 0);
+        if (tx_now)
+        {
+            CAN_tx_now(CAN_TX_CHASSIS_GROUP);
+            CAN_tx_now(CAN_TX_GIMBAL_GROUP);
+        }
+        result->period++;
+    }
+
+    usleep(BENCH_DRAIN_MS * 1000);
+    bench_read_feedback(result);
+    bench_tx_count(&chassis1, &gimbal1, &mailbox_sum1, &mailbox_num1);
+    result->tx_frame = (chassis1 - chassis0) + (gimbal1 - gimbal0);
+    result->expected = 4 * (chassis1 - chassis0) + 3 * (gimbal1 - gimbal0);
+    result->mailbox_sum_us = mailbox_sum1 - mailbox_sum0;
+    result->mailbox_num = mailbox_num1 - mailbox_num0;
+}
+
+static uint32_t bench_percentile_us(const bench_result_t *result, fp32 p)
+{
+    uint32_t target = (uint32_t)(result->sample * p);
+    uint32_t sum = 0;
+    uint32_t i;
+
+    for (i = 0; i < BENCH_HIST_NUM; i++)
+    {
+        sum += result->hist[i];
+        if (sum > target)
+        {
+            break;
+        }
+    }
+    return i * BENCH_HIST_US;
+}
+
+static bool_t bench_print(const char *name, const bench_result_t *result, uint32_t ms)
+{
+    fp32 second = ms * 0.001f;
+    uint32_t lost = result->expected > result->rx_frame ? result->expected - result->rx_frame : 0;
+
+    printf("%-14s %7.0f %7.0f %7.0f %6u %6u %9.1f %7.1f %6u %6u %6u\n", name, result->period / second,
+           result->tx_frame / second, result->rx_frame / second, lost, result->late,
+           result->mailbox_num ? (fp32)result->mailbox_sum_us / result->mailbox_num : 0.0f,
+           result->sample ? (fp32)result->latency_sum_us / result->sample : 0.0f,
+           bench_percentile_us(result, 0.5f), bench_percentile_us(result, 0.99f), result->latency_max_us);
+    return result->sample != 0 && lost <= result->expected * BENCH_LOST_MAX;
+}
+
+int main(int argc, char **argv)
+{
+    const char *ifname = BENCH_IFNAME;
+    const char *bus_name;
+    bool_t external = 0;
+    uint32_t ms = BENCH_MS;
+    int pair[2];
+    int hal_fd;
+    int sim_fd = -1;
+    pthread_t rx, tim7, sim;
+    bool_t ok;
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-i") == 0 && i + 1 < argc)
+        {
+            ifname = argv[++i];
+        }
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+        {
+            ms = (uint32_t)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-x") == 0)
+        {
+            external = 1;
+        }
+        else
+        {
+            fprintf(stderr, "usage: bench_can_loop [-i ifname] [-x] [-m ms]\n");
+            return 2;
+        }
+    }
+
+    bus_name = ifname;
+    hal_fd = host_can_socket(ifname);
+    if (hal_fd < 0)
+    {
+        if (external)
+        {
+            fprintf(stderr, "bench_can_loop: -x needs the SocketCAN interface %s\n", ifname);
+            return 2;
+        }
+        if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, pair) != 0)
+        {
+            perror("socketpair");
+            return 2;
+        }
+        printf("%s: no SocketCAN here, a socketpair in its place\n", ifname);
+        bus_name = "socketpair";
+        hal_fd = pair[0];
+        sim_fd = pair[1];
+    }
+    else if (!external)
+    {
+        sim_fd = host_can_socket(ifname);
+    }
+    host_can_attach(CAN_BUS_1, hal_fd);
+    host_can_attach(CAN_BUS_2, hal_fd);
+
+    //the recorder is not under test
+    //¼ڲԷΧ
+    can_recorder_freeze(1);
+    host_dwt_real_time(1);
+    can_tx_init();
+
+    if (sim_fd >= 0)
+    {
+        pthread_create(&sim, NULL, bench_sim_thread, &sim_fd);
+    }
+    pthread_create(&rx, NULL, bench_rx_thread, NULL);
+    pthread_create(&tim7, NULL, bench_tim7_thread, NULL);
+
+    printf("1kHz x %u motors, both buses on %s, %u ms a row\n", (uint32_t)BENCH_MOTOR_NUM, bus_name, ms);
+    printf("%-14s %7s %7s %7s %6s %6s %9s %7s %6s %6s %6s\n", "tx", "cmd/s", "tx/s", "rx/s", "lost", "late",
+           "mailbox", "mean", "p50", "p99", "max");
+    printf("%-14s %7s %7s %7s %6s %6s %9s %7s %6s %6s %6s\n", "", "", "", "", "", "", "us", "us", "us", "us", "us");
+    bench_run(0, ms, &bench_result);
+    ok = bench_print("TIM7 phase", &bench_result, ms);
+    bench_run(1, ms, &bench_result);
+    ok = bench_print("CAN_tx_now", &bench_result, ms) && ok;
+
+    bench_stop = 1;
+    bench_sim_stop = 1;
+    pthread_join(rx, NULL);
+    pthread_join(tim7, NULL);
+    if (sim_fd >= 0)
+    {
+        pthread_join(sim, NULL);
+        close(sim_fd);
+    }
+    close(hal_fd);
+
+    if (!ok)
+    {
+        printf("FAIL\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,408 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       bench_pid.c
+  * @brief      benchmark of the pid of pid.c against the PID_calc it replaced:
+  *             ns and cycles per call of the old position pid and of PID_calc
+  *             with the flags the tasks use, and a check that both give the
+  *             same out with the same terms. then the chassis wheel speed loops,
+  *             PID_BANK_NUM PID_calc against one PID_bank_calc per update.
+  *             pid.cpid滻PID_calc: ԭλʽpidиflag
+  *             PID_calcÿεõĺʱ, ͬʱͬ. ȻΪ
+  *             ٻ, ÿθPID_BANK_NUMPID_calcһPID_bank_calcıȽ.
+  * @note       usage: bench_pid
+  *             the inputs are BENCH_INPUT_NUM set and feedback pairs read in a
+  *             ring, every call is a real call, the inline PID_calc is wrapped
+  *             in a function as the old PID_calc is one. the time is the best
+  *             of BENCH_REPEAT runs. cycles are TSC ticks, only on x86, it is
+  *             the host and not the M4, the ratio between the rows is the point.
+  *             ÷: bench_pid
+  *             ΪBENCH_INPUT_NUM趨ֵͷ, ѭȡ, ÿξΪʵĺ,
+  *             PID_calcһ, ԭPID_calcͬ. ʱȡBENCH_REPEAT
+  *             ̵һ. ΪTSC, x86, ΪλM4, ڸ֮ıȽ.
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *  V1.1.0     Oct-16-2026     RM              1. chassis wheels by PID_calc and by PID_bank_calc
+  *  V1.2.0     Oct-16-2026     RM              1. speed loops without anti-windup, as the tasks, more runs
+  *
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "pid.h"
+
+#define BENCH_REPEAT        25
+#define BENCH_CALLS         4000000
+#define BENCH_INPUT_NUM     1024        //power of 2.2
+#define BENCH_CHECK_CALLS   100000
+#define BENCH_UPDATES       (BENCH_CALLS / PID_BANK_NUM)
+
+//the chassis wheel speed loop, gains per cycle as pid.c V1.0.0 took them
+//ٻ, pid.c V1.0.0ԿΪλĲ
+#define BENCH_T             0.002f
+#define BENCH_KP            15000.0f
+#define BENCH_KI            10.0f
+#define BENCH_KD            2.0f
+#define BENCH_MAX_OUT       16000.0f
+#define BENCH_MAX_IOUT      2000.0f
+
+#define BENCH_ALL_FLAG      (PID_I | PID_D | PID_D_ON_MEASURE | PID_D_FILTER | PID_ANTI_WINDUP | PID_FEEDFORWARD)
+#define BENCH_ANGLE_FLAG    (PID_D | PID_EXT_RATE | PID_ANGLE)
+#define BENCH_SPEED_FLAG    (PID_I)
+#define BENCH_AW_FLAG       (PID_I | PID_ANTI_WINDUP)
+#define BENCH_PID_FLAG      (PID_I | PID_D)
+
+//PID_calc of pid.c V1.0.0 in PID_POSITION mode, as it was, for the comparison
+//pid.c V1.0.0PID_POSITIONģʽPID_calc, ԭڱȽ
+typedef struct
+{
+    fp32 Kp;
+    fp32 Ki;
+    fp32 Kd;
+
+    fp32 max_out;
+    fp32 max_iout;
+
+    fp32 set;
+    fp32 fdb;
+
+    fp32 out;
+    fp32 Pout;
+    fp32 Iout;
+    fp32 Dout;
+    fp32 Dbuf[3];
+    fp32 error[3];
+} bench_old_pid_t;
+
+#define LimitMax(input, max)   \
+    {                          \
+        if (input > max)       \
+        {                      \
+            input = max;       \
+        }                      \
+        else if (input < -max) \
+        {                      \
+            input = -max;      \
+        }                      \
+    }
+
+static __attribute__((noinline)) fp32 bench_old_pid_calc(bench_old_pid_t *pid, fp32 ref, fp32 set)
+{
+    if (pid == NULL)
+    {
+        return 0.0f;
+    }
+
+    pid->error[2] = pid->error[1];
+    pid->error[1] = pid->error[0];
+    pid->set = set;
+    pid->fdb = ref;
+    pid->error[0] = set - ref;
+    pid->Pout = pid->Kp * pid->error[0];
+    pid->Iout += pid->Ki * pid->error[0];
+    pid->Dbuf[2] = pid->Dbuf[1];
+    pid->Dbuf[1] = pid->Dbuf[0];
+    pid->Dbuf[0] = (pid->error[0] - pid->error[1]);
+    pid->Dout = pid->Kd * pid->Dbuf[0];
+    LimitMax(pid->Iout, pid->max_iout);
+    pid->out = pid->Pout + pid->Iout + pid->Dout;
+    LimitMax(pid->out, pid->max_out);
+    return pid->out;
+}
+
+static void bench_old_pid_init(bench_old_pid_t *pid)
+{
+    static const bench_old_pid_t zero;
+
+    *pid = zero;
+    pid->Kp = BENCH_KP;
+    pid->Ki = BENCH_KI;
+    pid->Kd = BENCH_KD;
+    pid->max_out = BENCH_MAX_OUT;
+    pid->max_iout = BENCH_MAX_IOUT;
+}
+
+//the gains of the old pid in the units of pid_config_t
+//pid_config_tλʾԭpid
+static const pid_config_t bench_config = {BENCH_KP, BENCH_KI / BENCH_T, BENCH_KD * BENCH_T, BENCH_MAX_OUT, BENCH_MAX_IOUT,
+                                          BENCH_KI / BENCH_KP / BENCH_T, 0.004f};
+
+static __attribute__((noinline)) fp32 bench_pid_calc(pid_type_def *pid, fp32 ref, fp32 set)
+{
+    return PID_calc(pid, BENCH_PID_FLAG, ref, set, BENCH_T);
+}
+
+static __attribute__((noinline)) fp32 bench_speed_calc(pid_type_def *pid, fp32 ref, fp32 set)
+{
+    return PID_calc(pid, BENCH_SPEED_FLAG, ref, set, BENCH_T);
+}
+
+static __attribute__((noinline)) fp32 bench_aw_calc(pid_type_def *pid, fp32 ref, fp32 set)
+{
+    return PID_calc(pid, BENCH_AW_FLAG, ref, set, BENCH_T);
+}
+
+static __attribute__((noinline)) fp32 bench_angle_calc(pid_type_def *pid, fp32 ref, fp32 set)
+{
+    return PID_calc_full(pid, BENCH_ANGLE_FLAG, ref, set - ref, set, 0.0f, BENCH_T);
+}
+
+static __attribute__((noinline)) fp32 bench_all_calc(pid_type_def *pid, fp32 ref, fp32 set)
+{
+    return PID_calc_full(pid, BENCH_ALL_FLAG, ref, 0.0f, set, set * 0.1f, BENCH_T);
+}
+
+//one update of the chassis wheels as chassis_control_loop ran them before the bank, and with the bank
+//ʹpid֮ǰchassis_control_loop, Լʹpidʱ, һθµȫ
+static __attribute__((noinline)) void bench_wheel_calc(pid_type_def pid[PID_BANK_NUM], const fp32 *fdb, const fp32 *set,
+                                                       int16_t current[PID_BANK_NUM])
+{
+    uint8_t i;
+
+    for (i = 0; i < PID_BANK_NUM; i++)
+    {
+        PID_calc(&pid[i], BENCH_SPEED_FLAG, fdb[i], set[i], BENCH_T);
+    }
+    for (i = 0; i < PID_BANK_NUM; i++)
+    {
+        current[i] = (int16_t)(pid[i].out);
+    }
+}
+
+static __attribute__((noinline)) void bench_bank_calc(pid_bank_t *bank, const fp32 *fdb, const fp32 *set,
+                                                      int16_t current[PID_BANK_NUM])
+{
+    uint8_t i;
+
+    for (i = 0; i < PID_BANK_NUM; i++)
+    {
+        bank->fdb[i] = fdb[i];
+        bank->set[i] = set[i];
+    }
+    PID_bank_calc(bank, BENCH_SPEED_FLAG, BENCH_T);
+    for (i = 0; i < PID_BANK_NUM; i++)
+    {
+        current[i] = (int16_t)(bank->out[i]);
+    }
+}
+
+typedef struct
+{
+    const char *name;
+    fp32 (*calc)(pid_type_def *pid, fp32 ref, fp32 set);
+} bench_case_t;
+
+static const bench_case_t bench_case[] =
+{
+    {"PID_calc  I D", bench_pid_calc},
+    {"PID_calc  I speed loop", bench_speed_calc},
+    {"PID_calc  I anti-windup", bench_aw_calc},
+    {"PID_calc_full  angle", bench_angle_calc},
+    {"PID_calc_full  all terms", bench_all_calc},
+};
+
+static fp32 bench_set[BENCH_INPUT_NUM];
+static fp32 bench_fdb[BENCH_INPUT_NUM];
+static volatile fp32 bench_sink;
+
+static double bench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint64_t bench_ticks(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static void bench_print(const char *name, double time, uint64_t ticks, uint32_t num)
+{
+    printf("%-28s %8.2f", name, time / num * 1e9);
+    if (ticks != 0)
+    {
+        printf(" %10.1f\n", (double)ticks / num);
+    }
+    else
+    {
+        printf(" %10s\n", "-");
+    }
+}
+
+int main(void)
+{
+    bench_old_pid_t old_pid;
+    pid_type_def pid;
+    pid_type_def wheel_pid[PID_BANK_NUM];
+    pid_bank_t bank;
+    int16_t current[PID_BANK_NUM];
+    int32_t current_sum;
+    fp32 bank_diff_max = 0.0f;
+    double t0, time, best_time;
+    uint64_t c0, ticks, best_ticks;
+    fp32 sum;
+    fp32 diff, diff_max = 0.0f;
+    uint32_t i, r, c, k;
+
+    //a rate that moves along its set, and steps that saturate the out
+    //趨ֵٶ, Լʹ͵ĽԾ
+    for (i = 0; i < BENCH_INPUT_NUM; i++)
+    {
+        bench_set[i] = ((int32_t)(i / 64 % 5) - 2) * 0.5f;
+        bench_fdb[i] = bench_set[i] * (1.0f - expf(-(fp32)(i % 64) / 8.0f)) + ((int32_t)(i * 7 % 13) - 6) * 0.001f;
+    }
+
+    printf("%-28s %8s %10s\n", "pid", "ns/call", "cycle/call");
+    best_time = 1e9;
+    best_ticks = 0;
+    for (r = 0; r < BENCH_REPEAT; r++)
+    {
+        bench_old_pid_init(&old_pid);
+        sum = 0.0f;
+        t0 = bench_now();
+        c0 = bench_ticks();
+        for (i = 0; i < BENCH_CALLS; i++)
+        {
+            sum += bench_old_pid_calc(&old_pid, bench_fdb[i & (BENCH_INPUT_NUM - 1)], bench_set[i & (BENCH_INPUT_NUM - 1)]);
+        }
+        ticks = bench_ticks() - c0;
+        time = bench_now() - t0;
+        bench_sink = sum;
+        if (time < best_time)
+        {
+            best_time = time;
+            best_ticks = ticks;
+        }
+    }
+    bench_print("old PID_calc  position", best_time, best_ticks, BENCH_CALLS);
+
+    for (c = 0; c < sizeof(bench_case) / sizeof(bench_case[0]); c++)
+    {
+        best_time = 1e9;
+        best_ticks = 0;
+        for (r = 0; r < BENCH_REPEAT; r++)
+        {
+            PID_init(&pid, &bench_config);
+            sum = 0.0f;
+            t0 = bench_now();
+            c0 = bench_ticks();
+            for (i = 0; i < BENCH_CALLS; i++)
+            {
+                sum += bench_case[c].calc(&pid, bench_fdb[i & (BENCH_INPUT_NUM - 1)], bench_set[i & (BENCH_INPUT_NUM - 1)]);
+            }
+            ticks = bench_ticks() - c0;
+            time = bench_now() - t0;
+            bench_sink = sum;
+            if (time < best_time)
+            {
+                best_time = time;
+                best_ticks = ticks;
+            }
+        }
+        bench_print(bench_case[c].name, best_time, best_ticks, BENCH_CALLS);
+    }
+
+    //same terms, same out: the old D kicks at the first call, where the new one waits for a last error
+    //ͬʱͬ: ԭpidһεʱDг, pidȴϴЧ
+    bench_old_pid_init(&old_pid);
+    PID_init(&pid, &bench_config);
+    for (i = 0; i < BENCH_CHECK_CALLS; i++)
+    {
+        diff = bench_old_pid_calc(&old_pid, bench_fdb[i & (BENCH_INPUT_NUM - 1)], bench_set[i & (BENCH_INPUT_NUM - 1)]) -
+               bench_pid_calc(&pid, bench_fdb[i & (BENCH_INPUT_NUM - 1)], bench_set[i & (BENCH_INPUT_NUM - 1)]);
+        if (i != 0 && fabsf(diff) > diff_max)
+        {
+            diff_max = fabsf(diff);
+        }
+    }
+    printf("old and new I D out, max diff %g\n", diff_max);
+
+    printf("\n%-28s %8s %10s\n", "chassis wheels", "ns/upd", "cycle/upd");
+    for (c = 0; c < 2; c++)
+    {
+        best_time = 1e9;
+        best_ticks = 0;
+        for (r = 0; r < BENCH_REPEAT; r++)
+        {
+            for (k = 0; k < PID_BANK_NUM; k++)
+            {
+                PID_init(&wheel_pid[k], &bench_config);
+            }
+            PID_bank_init(&bank, &bench_config);
+            current_sum = 0;
+            t0 = bench_now();
+            c0 = bench_ticks();
+            for (i = 0; i < BENCH_UPDATES; i++)
+            {
+                k = (i * PID_BANK_NUM) & (BENCH_INPUT_NUM - 1);
+                if (c == 0)
+                {
+                    bench_wheel_calc(wheel_pid, &bench_fdb[k], &bench_set[k], current);
+                }
+                else
+                {
+                    bench_bank_calc(&bank, &bench_fdb[k], &bench_set[k], current);
+                }
+                current_sum += current[0];
+            }
+            ticks = bench_ticks() - c0;
+            time = bench_now() - t0;
+            bench_sink = (fp32)current_sum;
+            if (time < best_time)
+            {
+                best_time = time;
+                best_ticks = ticks;
+            }
+        }
+        bench_print(c == 0 ? "PID_calc  x PID_BANK_NUM" : "PID_bank_calc", best_time, best_ticks, BENCH_UPDATES);
+    }
+
+    //the bank is the same pid in arrays
+    //pidΪʽͬpid
+    for (k = 0; k < PID_BANK_NUM; k++)
+    {
+        PID_init(&wheel_pid[k], &bench_config);
+    }
+    PID_bank_init(&bank, &bench_config);
+    for (i = 0; i < BENCH_CHECK_CALLS; i++)
+    {
+        //the wheels at other points of the ring
+        //ʹûвͬλõ
+        for (k = 0; k < PID_BANK_NUM; k++)
+        {
+            c = (i + k * (BENCH_INPUT_NUM / PID_BANK_NUM)) & (BENCH_INPUT_NUM - 1);
+            PID_calc(&wheel_pid[k], BENCH_SPEED_FLAG, bench_fdb[c], bench_set[c], BENCH_T);
+            bank.fdb[k] = bench_fdb[c];
+            bank.set[k] = bench_set[c];
+        }
+        PID_bank_calc(&bank, BENCH_SPEED_FLAG, BENCH_T);
+        for (k = 0; k < PID_BANK_NUM; k++)
+        {
+            diff = fabsf(wheel_pid[k].out - bank.out[k]);
+            if (diff > bank_diff_max)
+            {
+                bank_diff_max = diff;
+            }
+        }
+    }
+    printf("PID_calc and PID_bank_calc out, max diff %g\n", bank_diff_max);
+
+    if (diff_max > BENCH_MAX_OUT * 1e-5f || bank_diff_max > BENCH_MAX_OUT * 1e-5f)
+    {
+        printf("FAIL\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,371 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       can_log.c/h
+  * @brief      parse the CAN recorder dump of usb_task and replay it into the
+  *             CAN receive path of the app sources on a PC.
+  *             usb_taskCAN¼, PCϻطŵӦòCAN·.
+  * @note
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *  V1.1.0     Oct-16-2026     RM              1. trace gives the rotor turns instead of an fp32 position
+  *
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "can_log.h"
+#include "host_hal.h"
+#include "main.h"
+
+#define CAN_LOG_LINE_LEN 128
+
+typedef struct
+{
+    uint8_t bus;
+    uint16_t std_id;
+    uint32_t fifo;
+    uint8_t index;
+} can_log_motor_t;
+
+//rx id of every motor, from the same tables as CAN_receive.c
+//ÿķID, CAN_receive.cʹͬһű
+#define CAN_LOG_MOTOR_ENTRY(index, bus, id, fifo, toe) {bus, id, fifo, index},
+#define CAN_LOG_DM_MOTOR_ENTRY(index, bus, can_id, master_id, fifo, toe, p_max, v_max, t_max) {bus, master_id, fifo, index},
+static const can_log_motor_t can_log_motor[] =
+{
+    CAN_MOTOR_TABLE(CAN_LOG_MOTOR_ENTRY)
+    CAN_DM_MOTOR_TABLE(CAN_LOG_DM_MOTOR_ENTRY)
+};
+#undef CAN_LOG_MOTOR_ENTRY
+#undef CAN_LOG_DM_MOTOR_ENTRY
+
+static struct
+{
+    uint8_t bus;
+    uint32_t std_id;
+    uint8_t dlc;
+    uint8_t data[8];
+    uint8_t num;
+} can_log_tx_out;
+
+static uint64_t can_log_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void can_log_tx_hook(uint8_t bus, uint32_t std_id, uint8_t dlc, const uint8_t *data)
+{
+    can_log_tx_out.bus = bus;
+    can_log_tx_out.std_id = std_id;
+    can_log_tx_out.dlc = dlc;
+    memcpy(can_log_tx_out.data, data, dlc);
+    can_log_tx_out.num++;
+}
+
+static int16_t can_log_i16(const uint8_t *data)
+{
+    return (int16_t)(uint16_t)((data[0] << 8) | data[1]);
+}
+
+static const can_log_motor_t *can_log_find_motor(uint8_t bus, uint16_t std_id)
+{
+    uint32_t i;
+
+    for (i = 0; i < sizeof(can_log_motor) / sizeof(can_log_motor[0]); i++)
+    {
+        if (can_log_motor[i].bus == bus && can_log_motor[i].std_id == std_id)
+        {
+            return &can_log_motor[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+  * @brief          parse a dump
+  * @param[in]      file: dump text
+  * @param[out]     records: malloc'ed records, free by the caller
+  * @param[out]     num: records parsed
+  * @retval         0: ok, -1: no header, bad line or count not the same as the header
+  */
+/**
+  * @brief          ¼
+  * @param[in]      file: ¼ı
+  * @param[out]     records: mallocļ¼, ɵͷ
+  * @param[out]     num: ļ¼
+  * @retval         0: ɹ, -1: ûм¼ͷ, ʽ¼ͷ
+  */
+int can_log_parse(FILE *file, can_record_t **records, uint32_t *num)
+{
+    char line[CAN_LOG_LINE_LEN];
+    can_record_t *record;
+    unsigned long time_us;
+    unsigned int bus, std_id, dlc, byte;
+    char dir;
+    char data[17];
+    int count = -1;
+    uint32_t line_num = 0;
+    uint32_t n = 0;
+    uint8_t i;
+
+    if (file == NULL || records == NULL || num == NULL)
+    {
+        return -1;
+    }
+    *records = NULL;
+    *num = 0;
+
+    //skip the status lines before the header
+    //¼ͷ֮ǰ״̬Ϣ
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        line_num++;
+        if (sscanf(line, "CAN record:%d", &count) == 1)
+        {
+            break;
+        }
+    }
+    if (count < 0 || count > CAN_RECORDER_SIZE)
+    {
+        fprintf(stderr, "can_log: no \"CAN record:<count>\" header\n");
+        return -1;
+    }
+
+    *records = (can_record_t *)calloc(count ? count : 1, sizeof(can_record_t));
+    if (*records == NULL)
+    {
+        return -1;
+    }
+
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        line_num++;
+        if (strncmp(line, "CAN record end", 14) == 0)
+        {
+            if (n != (uint32_t)count)
+            {
+                fprintf(stderr, "can_log: %u records, header says %d\n", n, count);
+                return -1;
+            }
+            *num = n;
+            return 0;
+        }
+
+        data[0] = '\0';
+        if (n >= (uint32_t)count ||
+            sscanf(line, "%lu %u %c %x %u %16s", &time_us, &bus, &dir, &std_id, &dlc, data) < 5 ||
+            bus < 1 || bus > CAN_BUS_NUM || (dir != 'R' && dir != 'T') || std_id > 0x7FF || dlc > 8 ||
+            strlen(data) != dlc * 2)
+        {
+            fprintf(stderr, "can_log: bad record at line %u: %s", line_num, line);
+            return -1;
+        }
+
+        record = &(*records)[n];
+        record->time_us = (uint32_t)time_us;
+        record->bus = (uint8_t)(bus - 1);
+        record->std_id = (uint16_t)std_id;
+        record->dir_dlc = (uint8_t)(((dir == 'T') ? (CAN_RECORD_TX << 7) : 0) | dlc);
+        for (i = 0; i < dlc; i++)
+        {
+            if (sscanf(&data[i * 2], "%2x", &byte) != 1)
+            {
+                fprintf(stderr, "can_log: bad data at line %u: %s", line_num, line);
+                return -1;
+            }
+            record->data[i] = (uint8_t)byte;
+        }
+        n++;
+    }
+
+    fprintf(stderr, "can_log: no \"CAN record end\"\n");
+    return -1;
+}
+
+static void can_log_replay_rx(const can_record_t *record, uint64_t time_us, can_log_hook_t hook, FILE *trace, can_log_result_t *result)
+{
+    const can_log_motor_t *motor;
+    motor_feedback_t feedback;
+    uint8_t dlc = record->dir_dlc & 0x0F;
+    uint32_t fifo;
+    uint64_t start;
+    uint8_t i;
+
+    //the filters only pass table ids, the fifo of any other id does not matter
+    //ֻͨеID, IDʹĸFIFO޹ؽҪ
+    motor = can_log_find_motor(record->bus, record->std_id);
+    fifo = (motor != NULL) ? motor->fifo : CAN_RX_FIFO0;
+
+    host_can_rx_push(record->bus, fifo, record->std_id, dlc, record->data);
+    start = can_log_ns();
+    host_irq_can_rx(record->bus, fifo);
+    result->rx_ns += can_log_ns() - start;
+    result->rx_frame++;
+
+    if (motor == NULL || !get_motor_feedback(motor->index, &feedback))
+    {
+        result->other_frame++;
+        if (trace != NULL)
+        {
+            fprintf(trace, "%llu,R,%d,%03X,-1,", (unsigned long long)time_us, record->bus + 1, record->std_id);
+            for (i = 0; i < dlc; i++)
+            {
+                fprintf(trace, "%02X", record->data[i]);
+            }
+            fprintf(trace, "\n");
+        }
+        return;
+    }
+
+    result->motor_frame[motor->index]++;
+    if (trace != NULL)
+    {
+        if (motor->index >= CAN_DM_MOTOR_INDEX_BASE)
+        {
+            fprintf(trace, "%llu,R,%d,%03X,%d,%d,%.5f,%.4f,%.4f,%d\n", (unsigned long long)time_us, record->bus + 1,
+                    record->std_id, motor->index, feedback.dm.state, feedback.dm.position, feedback.dm.velocity,
+                    feedback.dm.torque, feedback.dm.t_rotor);
+        }
+        else
+        {
+            fprintf(trace, "%llu,R,%d,%03X,%d,%u,%d,%d,%u,%ld,%.4f,%.2f\n", (unsigned long long)time_us, record->bus + 1,
+                    record->std_id, motor->index, feedback.measure.ecd, feedback.measure.speed_rpm,
+                    feedback.measure.given_current, feedback.measure.temperate, (long)feedback.state.round,
+                    feedback.state.velocity, feedback.state.accel);
+        }
+    }
+    if (hook != NULL)
+    {
+        hook(time_us, motor->index, &feedback);
+    }
+}
+
+static void can_log_replay_tx(const can_record_t *record, uint64_t time_us, FILE *trace, can_log_result_t *result)
+{
+    const uint8_t *data = record->data;
+    uint8_t dlc = record->dir_dlc & 0x0F;
+    uint8_t group;
+    uint8_t match;
+    uint64_t start;
+
+    if (dlc != 8)
+    {
+        result->tx_skip++;
+        return;
+    }
+
+    can_log_tx_out.num = 0;
+    start = can_log_ns();
+    if (record->bus == CAN_BUS_2 && record->std_id == CAN_GIMBAL_ALL_ID)
+    {
+        group = CAN_TX_GIMBAL_GROUP;
+        CAN_cmd_gimbal(can_log_i16(&data[0]), can_log_i16(&data[2]), can_log_i16(&data[4]), can_log_i16(&data[6]));
+    }
+    else if (record->bus == CAN_BUS_1 && record->std_id == CAN_CHASSIS_ALL_ID)
+    {
+        group = CAN_TX_CHASSIS_GROUP;
+        CAN_cmd_chassis(can_log_i16(&data[0]), can_log_i16(&data[2]), can_log_i16(&data[4]), can_log_i16(&data[6]));
+    }
+    else if (record->bus == CAN_BUS_1 && record->std_id == CAN_CHASSIS_RESET_ID)
+    {
+        group = CAN_TX_CHASSIS_RESET_ID_GROUP;
+        CAN_cmd_chassis_reset_ID();
+    }
+    else
+    {
+        //Damiao commands are floats packed by the task, they are not posted again
+        //õ, ύ
+        result->tx_skip++;
+        return;
+    }
+    CAN_tx_now(group);
+    result->tx_ns += can_log_ns() - start;
+    result->tx_frame++;
+
+    match = can_log_tx_out.num == 1 && can_log_tx_out.bus == record->bus && can_log_tx_out.std_id == record->std_id &&
+            can_log_tx_out.dlc == dlc && memcmp(can_log_tx_out.data, data, dlc) == 0;
+    if (match)
+    {
+        result->tx_match++;
+    }
+    else
+    {
+        result->tx_mismatch++;
+    }
+
+    if (trace != NULL)
+    {
+        fprintf(trace, "%llu,T,%d,%03X,%d,%d,%d,%d,%d\n", (unsigned long long)time_us, record->bus + 1, record->std_id,
+                match, can_log_i16(&data[0]), can_log_i16(&data[2]), can_log_i16(&data[4]), can_log_i16(&data[6]));
+    }
+}
+
+/**
+  * @brief          replay records in order, time_us wraps are unwrapped. rx records
+  *                 go through the rx interrupt at their time, tx records are posted
+  *                 with CAN_cmd_chassis, CAN_cmd_gimbal or CAN_cmd_chassis_reset_ID
+  *                 and sent by CAN_tx_now
+  * @param[in]      records: records
+  * @param[in]      num: record number
+  * @param[in]      hook: called after every motor frame, NULL for none
+  * @param[in]      trace: one csv line per record, NULL for none
+  * @param[out]     result: counters
+  * @retval         none
+  */
+/**
+  * @brief          ˳طż¼, time_us. ռ¼ʱ̽ж,
+  *                 ͼ¼CAN_cmd_chassis, CAN_cmd_gimbalCAN_cmd_chassis_reset_ID
+  *                 ύCAN_tx_now
+  * @param[in]      records: ¼
+  * @param[in]      num: ¼
+  * @param[in]      hook: ÿһ֡, NULLΪ
+  * @param[in]      trace: ÿ¼һcsv, NULLΪ
+  * @param[out]     result: 
+  * @retval         none
+  */
+void can_log_replay(const can_record_t *records, uint32_t num, can_log_hook_t hook, FILE *trace, can_log_result_t *result)
+{
+    uint64_t time_us = 0;
+    uint32_t n;
+
+    if (records == NULL || result == NULL)
+    {
+        return;
+    }
+    memset(result, 0, sizeof(can_log_result_t));
+    host_can_set_tx_hook(can_log_tx_hook);
+
+    if (trace != NULL)
+    {
+        fprintf(trace, "#time_us,R,bus,id,motor,ecd,speed_rpm,given_current,temperate,round,velocity,accel\n");
+        fprintf(trace, "#time_us,R,bus,id,motor,state,position,velocity,torque,t_rotor (Damiao)\n");
+        fprintf(trace, "#time_us,R,bus,id,-1,data (no motor)\n");
+        fprintf(trace, "#time_us,T,bus,id,match,data0,data1,data2,data3\n");
+    }
+
+    for (n = 0; n < num; n++)
+    {
+        if (n > 0)
+        {
+            time_us += (uint32_t)(records[n].time_us - records[n - 1].time_us);
+        }
+        host_dwt_set_cycle((records[0].time_us + time_us) * (HOST_CORE_CLOCK / 1000000U));
+
+        if (records[n].dir_dlc >> 7)
+        {
+            can_log_replay_tx(&records[n], time_us, trace, result);
+        }
+        else
+        {
+            can_log_replay_rx(&records[n], time_us, hook, trace, result);
+        }
+    }
+    result->duration_us = time_us;
+    host_can_set_tx_hook(NULL);
+}
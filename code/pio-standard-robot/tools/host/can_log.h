@@ -0,0 +1,105 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       can_log.c/h
+  * @brief      parse the CAN recorder dump of usb_task and replay it into the
+  *             CAN receive path of the app sources on a PC.
+  *             usb_taskCAN¼, PCϻطŵӦòCAN·.
+  * @note       the log carries only CAN frames. the RC, INS and referee inputs
+  *             of chassis_task and gimbal_task are not in it, so the tasks are
+  *             not run. what is replayed is the code that runs on CAN data
+  *             alone: the rx dispatch, seqlock and motor_state of every motor
+  *             frame, and the tx post and mailbox stage of every recorded
+  *             command, whose output is checked against the recorded frame.
+  *             control code that only needs motor feedback hooks in through
+  *             can_log_hook_t.
+  *             ¼ֻCAN֡, ûchassis_taskgimbal_taskң, INS
+  *             ϵͳ, ˲. طŵֻCANݵĴ: ÿһ֡
+  *             Ľշַ, ˳motor_state, Լÿһ¼Ŀ
+  *             ύͷ׶, ¼֡Ƚ. ֻҪĿƴ
+  *             ͨcan_log_hook_t.
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *
+  @verbatim
+  ==============================================================================
+  dump format, see usb_can_record_dump of usb_task.c. lines before the header
+  are skipped, every line ends with "\r\n" or "\n":
+  CAN record:<count>
+  <time_us> <bus 1/2> <R/T> <id hex> <dlc> <data hex, 2 digits a byte>
+  ...
+  CAN record end
+  ¼ʽusb_task.cusb_can_record_dump. ¼ͷ֮ǰб.
+  ==============================================================================
+  @endverbatim
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+#ifndef CAN_LOG_H
+#define CAN_LOG_H
+
+#include <stdio.h>
+
+#include "struct_typedef.h"
+#include "can_recorder.h"
+#include "CAN_receive.h"
+
+//called after every replayed motor frame, feedback is read by get_motor_feedback
+//ÿһ֡طź, feedbackget_motor_feedbackȡ
+typedef void (*can_log_hook_t)(uint64_t time_us, uint8_t motor_index, const motor_feedback_t *feedback);
+
+typedef struct
+{
+    uint32_t rx_frame;              //rx records replayed.طŵĽռ¼
+    uint32_t motor_frame[CAN_MOTOR_NUM];
+    uint32_t other_frame;           //rx records of no motor.ǵĽռ¼
+    uint32_t tx_frame;              //tx records replayed.طŵķͼ¼
+    uint32_t tx_match;              //tx output same as the record.¼ͬ
+    uint32_t tx_mismatch;
+    uint32_t tx_skip;               //tx records of no tx group.ڷķͼ¼
+    uint64_t duration_us;           //first to last record.һһ¼ʱ
+    uint64_t rx_ns;                 //host time in the rx interrupt.жϵʱ
+    uint64_t tx_ns;                 //host time to post and send.ύͷ͵ʱ
+} can_log_result_t;
+
+/**
+  * @brief          parse a dump
+  * @param[in]      file: dump text
+  * @param[out]     records: malloc'ed records, free by the caller
+  * @param[out]     num: records parsed
+  * @retval         0: ok, -1: no header, bad line or count not the same as the header
+  */
+/**
+  * @brief          ¼
+  * @param[in]      file: ¼ı
+  * @param[out]     records: mallocļ¼, ɵͷ
+  * @param[out]     num: ļ¼
+  * @retval         0: ɹ, -1: ûм¼ͷ, ʽ¼ͷ
+  */
+extern int can_log_parse(FILE *file, can_record_t **records, uint32_t *num);
+
+/**
+  * @brief          replay records in order, time_us wraps are unwrapped. rx records
+  *                 go through the rx interrupt at their time, tx records are posted
+  *                 with CAN_cmd_chassis, CAN_cmd_gimbal or CAN_cmd_chassis_reset_ID
+  *                 and sent by CAN_tx_now
+  * @param[in]      records: records
+  * @param[in]      num: record number
+  * @param[in]      hook: called after every motor frame, NULL for none
+  * @param[in]      trace: one csv line per record, NULL for none
+  * @param[out]     result: counters
+  * @retval         none
+  */
+/**
+  * @brief          ˳طż¼, time_us. ռ¼ʱ̽ж,
+  *                 ͼ¼CAN_cmd_chassis, CAN_cmd_gimbalCAN_cmd_chassis_reset_ID
+  *                 ύCAN_tx_now
+  * @param[in]      records: ¼
+  * @param[in]      num: ¼
+  * @param[in]      hook: ÿһ֡, NULLΪ
+  * @param[in]      trace: ÿ¼һcsv, NULLΪ
+  * @param[out]     result: 
+  * @retval         none
+  */
+extern void can_log_replay(const can_record_t *records, uint32_t num, can_log_hook_t hook, FILE *trace, can_log_result_t *result);
+
+#endif
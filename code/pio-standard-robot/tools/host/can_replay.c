@@ -0,0 +1,114 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       can_replay.c
+  * @brief      replay a CAN recorder dump through the CAN receive path, print
+  *             the frame counts, the host time per frame and whether every
+  *             recorded command comes out of the tx stage unchanged.
+  *             CAN¼طŵCAN·, ֡, ÿ֡ʱ, Լÿ
+  *             ¼ͽ׶κǷ񲻱.
+  * @note       usage: can_replay [-t trace.csv] dump.txt
+  *             dump.txt is the serial output after sending 'd' to the board,
+  *             trace.csv gets one line per record, see can_log.h for the scope.
+  *             ÷: can_replay [-t trace.csv] dump.txt
+  *             dump.txtΪ򿪷巢'd'Ĵ, trace.csvÿ¼һ,
+  *             طŷΧcan_log.h.
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "can_log.h"
+
+static const char *const can_replay_motor_name[CAN_MOTOR_NUM] =
+{
+#define CAN_REPLAY_MOTOR_NAME(index, ...) [index] = #index,
+    CAN_MOTOR_TABLE(CAN_REPLAY_MOTOR_NAME)
+    CAN_DM_MOTOR_TABLE(CAN_REPLAY_MOTOR_NAME)
+#undef CAN_REPLAY_MOTOR_NAME
+};
+
+int main(int argc, char **argv)
+{
+    const char *dump_path = NULL;
+    const char *trace_path = NULL;
+    FILE *dump;
+    FILE *trace = NULL;
+    can_record_t *records;
+    uint32_t num;
+    can_log_result_t result;
+    fp32 second;
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+        {
+            trace_path = argv[++i];
+        }
+        else
+        {
+            dump_path = argv[i];
+        }
+    }
+    if (dump_path == NULL)
+    {
+        fprintf(stderr, "usage: can_replay [-t trace.csv] dump.txt\n");
+        return 2;
+    }
+
+    dump = fopen(dump_path, "r");
+    if (dump == NULL)
+    {
+        perror(dump_path);
+        return 2;
+    }
+    if (can_log_parse(dump, &records, &num) != 0)
+    {
+        fclose(dump);
+        free(records);
+        return 2;
+    }
+    fclose(dump);
+
+    if (trace_path != NULL)
+    {
+        trace = fopen(trace_path, "w");
+        if (trace == NULL)
+        {
+            perror(trace_path);
+            free(records);
+            return 2;
+        }
+    }
+
+    can_log_replay(records, num, NULL, trace, &result);
+    if (trace != NULL)
+    {
+        fclose(trace);
+    }
+    free(records);
+
+    second = result.duration_us * 0.000001f;
+    printf("records %u, %.3f s\n", num, second);
+    for (i = 0; i < CAN_MOTOR_NUM; i++)
+    {
+        if (result.motor_frame[i] != 0)
+        {
+            printf("  %-24s %6u frames %7.1f Hz\n", can_replay_motor_name[i], result.motor_frame[i],
+                   second > 0.0f ? result.motor_frame[i] / second : 0.0f);
+        }
+    }
+    printf("  other rx                 %6u frames\n", result.other_frame);
+    printf("rx %u frames, %.0f ns per frame\n", result.rx_frame,
+           result.rx_frame ? (double)result.rx_ns / result.rx_frame : 0.0);
+    printf("tx %u frames, %.0f ns per frame, %u same as record, %u different, %u not replayed\n", result.tx_frame,
+           result.tx_frame ? (double)result.tx_ns / result.tx_frame : 0.0, result.tx_match, result.tx_mismatch,
+           result.tx_skip);
+
+    return result.tx_mismatch != 0;
+}
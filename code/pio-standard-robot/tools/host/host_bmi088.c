@@ -0,0 +1,56 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       host_bmi088.c
+  * @brief      BMI088Middleware of the host, no sensor is attached. it only
+  *             lets BMI088driver.c link, the replay uses its *_read_over
+  *             functions on captured SPI buffers.
+  *             λBMI088Middleware, ûӴ. ֻBMI088driver.c,
+  *             طʱʹ*_read_overɼSPI.
+  * @note
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+
+#include "BMI088Middleware.h"
+
+void BMI088_GPIO_init(void)
+{
+}
+
+void BMI088_com_init(void)
+{
+}
+
+void BMI088_delay_ms(uint16_t ms)
+{
+}
+
+void BMI088_delay_us(uint16_t us)
+{
+}
+
+void BMI088_ACCEL_NS_L(void)
+{
+}
+
+void BMI088_ACCEL_NS_H(void)
+{
+}
+
+void BMI088_GYRO_NS_L(void)
+{
+}
+
+void BMI088_GYRO_NS_H(void)
+{
+}
+
+//an idle SPI bus reads 0xFF
+//еSPI߶0xFF
+uint8_t BMI088_read_write_byte(uint8_t reg)
+{
+    return 0xFF;
+}
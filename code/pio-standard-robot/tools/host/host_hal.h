@@ -0,0 +1,185 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       host_hal.c/h
+  * @brief      fake CAN bus, DWT counter and interrupt lock, so that the app
+  *             sources build and run on a PC. an interrupt is a call made
+  *             with the interrupt lock held, a task critical section takes the
+  *             same lock, as on the board where it masks the interrupt.
+  *             ģCAN, DWTж, ʹӦòԴļPCϱ.
+  *             жΪжһε, ٽȡͬһ, 
+  *             жϵЧͬ.
+  * @note       a bus may be put on SocketCAN, e.g. vcan0, or on any file of
+  *             struct can_frame: the mailbox frames are written there and
+  *             host_can_poll reads it, keeps the ids of the bsp_can filters
+  *             and runs the rx interrupt per frame. the DWT counter can follow
+  *             the monotonic clock for timing against another process.
+  *             ߿ԽӵSocketCAN, vcan0, ⴫struct can_frameļ:
+  *             ֡дļ, host_can_pollȡ, bsp_canĹID,
+  *             ÿ֡һνж. DWTԸ浥ʱ, ̼ʱ.
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *  V1.1.0     Oct-16-2026     RM              1. SocketCAN backend, DWT counter of the monotonic clock
+  *
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+#ifndef HOST_HAL_H
+#define HOST_HAL_H
+
+#include "struct_typedef.h"
+
+//core clock of the board, the DWT counter runs at it
+//ںʱ, DWTƵ
+#define HOST_CORE_CLOCK 168000000U
+
+//frames each fake rx fifo holds, the real fifo holds 3
+//ÿģFIFOɵ֡, ʵFIFOΪ3֡
+#define HOST_CAN_RX_FIFO_SIZE 16
+
+//called for every frame put into a mailbox, bus is CAN_BUS_1 or CAN_BUS_2
+//ÿһ֡ʱ
+typedef void (*host_can_tx_hook_t)(uint8_t bus, uint32_t std_id, uint8_t dlc, const uint8_t *data);
+
+/**
+  * @brief          set the DWT counter, unit cycle of HOST_CORE_CLOCK
+  * @param[in]      cycle: 64 bit cycle count, dwt_get_cycle returns the low 32 bits
+  * @retval         none
+  */
+/**
+  * @brief          DWT, λΪHOST_CORE_CLOCK
+  * @param[in]      cycle: 64λڼ, dwt_get_cycleص32λ
+  * @retval         none
+  */
+extern void host_dwt_set_cycle(uint64_t cycle);
+
+/**
+  * @brief          advance the DWT counter
+  * @param[in]      us: time, unit us
+  * @retval         none
+  */
+/**
+  * @brief          ƽDWT
+  * @param[in]      us: ʱ λ us
+  * @retval         none
+  */
+extern void host_dwt_advance_us(uint32_t us);
+
+/**
+  * @brief          put a frame into a fake rx fifo, it is read by the next rx interrupt
+  * @param[in]      bus: CAN_BUS_1 or CAN_BUS_2
+  * @param[in]      fifo: CAN_RX_FIFO0 or CAN_RX_FIFO1
+  * @param[in]      std_id: standard ID
+  * @param[in]      dlc: data length, [0,8]
+  * @param[in]      data: frame data
+  * @retval         1: ok, 0: fifo full, the overrun flag is set
+  */
+/**
+  * @brief          һ֡ģFIFO, һνж϶ȡ
+  * @param[in]      bus: CAN_BUS_1  CAN_BUS_2
+  * @param[in]      fifo: CAN_RX_FIFO0  CAN_RX_FIFO1
+  * @param[in]      std_id: ׼ID
+  * @param[in]      dlc: ݳ, [0,8]
+  * @param[in]      data: ֡
+  * @retval         1: ɹ, 0: FIFO, ־
+  */
+extern bool_t host_can_rx_push(uint8_t bus, uint32_t fifo, uint32_t std_id, uint8_t dlc, const uint8_t *data);
+
+/**
+  * @brief          run the rx interrupt of a fifo with the interrupt lock held
+  * @param[in]      bus: CAN_BUS_1 or CAN_BUS_2
+  * @param[in]      fifo: CAN_RX_FIFO0 or CAN_RX_FIFO1
+  * @retval         none
+  */
+/**
+  * @brief          жһFIFOĽж
+  * @param[in]      bus: CAN_BUS_1  CAN_BUS_2
+  * @param[in]      fifo: CAN_RX_FIFO0  CAN_RX_FIFO1
+  * @retval         none
+  */
+extern void host_irq_can_rx(uint8_t bus, uint32_t fifo);
+
+/**
+  * @brief          run the TIM7 interrupt with the interrupt lock held
+  * @param[in]      none
+  * @retval         none
+  */
+/**
+  * @brief          жTIM7ж
+  * @param[in]      none
+  * @retval         none
+  */
+extern void host_irq_tim7(void);
+
+/**
+  * @brief          set the hook called for every frame put into a mailbox, the
+  *                 mailboxes are empty again when the hook returns
+  * @param[in]      hook: NULL for none
+  * @retval         none
+  */
+/**
+  * @brief          ÿһ֡ʱõĺ, غ伴Ϊ
+  * @param[in]      hook: NULLΪ
+  * @retval         none
+  */
+extern void host_can_set_tx_hook(host_can_tx_hook_t hook);
+
+/**
+  * @brief          open a raw SocketCAN socket bound to an interface
+  * @param[in]      ifname: interface name, e.g. vcan0
+  * @retval         socket, -1 when the host has no SocketCAN or no such interface
+  */
+/**
+  * @brief          򿪰󶨵һӿڵSocketCANԭʼ׽
+  * @param[in]      ifname: ӿ, vcan0
+  * @retval         ׽, ֧SocketCANûиýӿʱΪ-1
+  */
+extern int host_can_socket(const char *ifname);
+
+/**
+  * @brief          put a bus on a file of struct can_frame, a SocketCAN socket or an
+  *                 end of a SOCK_SEQPACKET socketpair. the frames put into its
+  *                 mailboxes are written to it and host_can_poll reads it, buses may
+  *                 share a file
+  * @param[in]      bus: CAN_BUS_1 or CAN_BUS_2
+  * @param[in]      fd: the file, -1 takes the bus off it
+  * @retval         none
+  */
+/**
+  * @brief          ߽ӵstruct can_frameļ, SocketCAN׽ֻ
+  *                 SOCK_SEQPACKET׽ֶԵһ. ֡дļ, 
+  *                 host_can_pollȡ, ߿ɹһļ
+  * @param[in]      bus: CAN_BUS_1  CAN_BUS_2
+  * @param[in]      fd: ļ, -1ΪϿ
+  * @retval         none
+  */
+extern void host_can_attach(uint8_t bus, int fd);
+
+/**
+  * @brief          read the frames of the attached files, a frame is kept by a bus
+  *                 when its id is in the bsp_can filters of the bus, put into that
+  *                 fifo and read by the rx interrupt at once
+  * @param[in]      timeout_us: longest wait for the first frame, unit us
+  * @retval         frames kept
+  */
+/**
+  * @brief          ȡѽļ֡, IDߵbsp_canʱɸ߱,
+  *                 ӦFIFOɽж϶ȡ
+  * @param[in]      timeout_us: ȴһ֡ʱ λ us
+  * @retval         ֡
+  */
+extern uint32_t host_can_poll(uint32_t timeout_us);
+
+/**
+  * @brief          DWT counter of the monotonic clock, from 0 at this call, instead of
+  *                 host_dwt_set_cycle
+  * @param[in]      on: 1: monotonic clock, 0: host_dwt_set_cycle
+  * @retval         none
+  */
+/**
+  * @brief          DWTʹõʱ, ӱεʱΪ0, host_dwt_set_cycle
+  * @param[in]      on: 1: ʱ, 0: host_dwt_set_cycle
+  * @retval         none
+  */
+extern void host_dwt_real_time(bool_t on);
+
+#endif
@@ -0,0 +1,161 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       host_motor_sim.c/h
+  * @brief      simulated DJI motors on a file of struct can_frame, a SocketCAN
+  *             socket or an end of a socketpair. a current command of 0x200 or
+  *             0x1FF is answered at once with the feedback of its motors on
+  *             0x201~0x207, as the ids of CAN_receive.h.
+  *             ڴstruct can_frameļģ󽮵, SocketCAN׽ֻ
+  *             ׽ֶԵһ. յ0x2000x1FFĵ0x201~0x207
+  *             ظķ, IDCAN_receive.hͬ.
+  * @note       the rotor speed follows the command by a first order lag, the
+  *             encoder turns with it, the current of the feedback is the command,
+  *             so a reader finds the command a feedback answers. a real motor
+  *             sends its feedback at its own 1kHz, not at the command.
+  *             תתһ׹Ը, ֮ת, ĵΪ,
+  *             ˿ɷҵظ. ʵʵ1kHzͷ,
+  *             յʱ.
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+
+#include <poll.h>
+#include <string.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <linux/can.h>
+
+#include "host_motor_sim.h"
+
+//dt of the first answer and the most taken at once, unit s
+//һλظdtԼһʱ λ s
+#define HOST_MOTOR_SIM_DT_MAX 0.01f
+//encoder counts per turn
+//ÿȦ
+#define HOST_MOTOR_SIM_ECD_RANGE 8192.0f
+
+typedef struct
+{
+    fp32 speed_rpm;
+    fp32 ecd;               //unit count, [0, 8192).λ 
+    int16_t current;
+    struct timespec last;   //time of the last answer, tv_sec 0 before it.ϴλظʱ, ֮ǰtv_secΪ0
+} host_motor_sim_motor_t;
+
+/**
+  * @brief          take a command, move the motor to now and send its feedback
+  * @param[in]      fd: file of struct can_frame
+  * @param[out]     motor: the motor
+  * @param[in]      std_id: feedback id
+  * @param[in]      current: command current
+  * @retval         1: sent, 0: not
+  */
+/**
+  * @brief          , ƽǰʱ̲ͷ
+  * @param[in]      fd: struct can_frameļ
+  * @param[out]     motor: 
+  * @param[in]      std_id: ID
+  * @param[in]      current: 
+  * @retval         1: ѷ, 0: δ
+  */
+static bool_t host_motor_sim_answer(int fd, host_motor_sim_motor_t *motor, uint32_t std_id, int16_t current)
+{
+    struct can_frame frame;
+    struct timespec now;
+    fp32 dt;
+    uint16_t ecd;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    dt = HOST_MOTOR_SIM_DT_MAX;
+    if (motor->last.tv_sec != 0)
+    {
+        dt = (fp32)(now.tv_sec - motor->last.tv_sec) + (fp32)(now.tv_nsec - motor->last.tv_nsec) * 1e-9f;
+        if (dt > HOST_MOTOR_SIM_DT_MAX)
+        {
+            dt = HOST_MOTOR_SIM_DT_MAX;
+        }
+    }
+    motor->last = now;
+
+    //speed of the current before it, the command takes effect from now
+    //ʹ֮ǰµת, Ӵ˿Ч
+    motor->ecd += motor->speed_rpm * (HOST_MOTOR_SIM_ECD_RANGE / 60.0f) * dt;
+    motor->ecd -= HOST_MOTOR_SIM_ECD_RANGE * (fp32)(int32_t)(motor->ecd / HOST_MOTOR_SIM_ECD_RANGE);
+    if (motor->ecd < 0.0f)
+    {
+        motor->ecd += HOST_MOTOR_SIM_ECD_RANGE;
+    }
+    motor->speed_rpm += (motor->current * HOST_MOTOR_SIM_RPM_PER_CURRENT - motor->speed_rpm) * dt / (HOST_MOTOR_SIM_TAU + dt);
+    motor->current = current;
+
+    ecd = (uint16_t)motor->ecd;
+    if (ecd >= (uint16_t)HOST_MOTOR_SIM_ECD_RANGE)
+    {
+        ecd = 0;
+    }
+    memset(&frame, 0, sizeof(frame));
+    frame.can_id = std_id;
+    frame.can_dlc = 8;
+    frame.data[0] = (uint8_t)(ecd >> 8);
+    frame.data[1] = (uint8_t)ecd;
+    frame.data[2] = (uint8_t)((uint16_t)(int16_t)motor->speed_rpm >> 8);
+    frame.data[3] = (uint8_t)(int16_t)motor->speed_rpm;
+    frame.data[4] = (uint8_t)((uint16_t)current >> 8);
+    frame.data[5] = (uint8_t)current;
+    frame.data[6] = HOST_MOTOR_SIM_TEMPERATE;
+    return send(fd, &frame, sizeof(frame), 0) == (ssize_t)sizeof(frame);
+}
+
+uint32_t host_motor_sim_run(int fd, volatile const uint8_t *stop)
+{
+    host_motor_sim_motor_t motor[HOST_MOTOR_SIM_NUM];
+    struct pollfd pfd;
+    struct can_frame frame;
+    uint32_t sent = 0;
+    uint32_t first_id;
+    uint8_t i;
+
+    memset(motor, 0, sizeof(motor));
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    while (!*stop)
+    {
+        if (poll(&pfd, 1, 10) <= 0)
+        {
+            continue;
+        }
+        while (recv(fd, &frame, sizeof(frame), MSG_DONTWAIT) == (ssize_t)sizeof(frame))
+        {
+            if (frame.can_id == 0x200)
+            {
+                first_id = 0x201;
+            }
+            else if (frame.can_id == 0x1FF)
+            {
+                first_id = 0x205;
+            }
+            else
+            {
+                continue;
+            }
+            //4 currents of 16 bits, high byte first
+            //416λ, ֽǰ
+            for (i = 0; i < 4 && 2 * i + 1 < frame.can_dlc; i++)
+            {
+                if (first_id + i > HOST_MOTOR_SIM_ID_LAST)
+                {
+                    break;
+                }
+                if (host_motor_sim_answer(fd, &motor[first_id + i - HOST_MOTOR_SIM_ID_FIRST], first_id + i,
+                                          (int16_t)((frame.data[2 * i] << 8) | frame.data[2 * i + 1])))
+                {
+                    sent++;
+                }
+            }
+        }
+    }
+    return sent;
+}
@@ -0,0 +1,56 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       host_motor_sim.c/h
+  * @brief      simulated DJI motors on a file of struct can_frame, a SocketCAN
+  *             socket or an end of a socketpair. a current command of 0x200 or
+  *             0x1FF is answered at once with the feedback of its motors on
+  *             0x201~0x207, as the ids of CAN_receive.h.
+  *             ڴstruct can_frameļģ󽮵, SocketCAN׽ֻ
+  *             ׽ֶԵһ. յ0x2000x1FFĵ0x201~0x207
+  *             ظķ, IDCAN_receive.hͬ.
+  * @note       the rotor speed follows the command by a first order lag, the
+  *             encoder turns with it, the current of the feedback is the command,
+  *             so a reader finds the command a feedback answers. a real motor
+  *             sends its feedback at its own 1kHz, not at the command.
+  *             תתһ׹Ը, ֮ת, ĵΪ,
+  *             ˿ɷҵظ. ʵʵ1kHzͷ,
+  *             յʱ.
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+#ifndef HOST_MOTOR_SIM_H
+#define HOST_MOTOR_SIM_H
+
+#include "struct_typedef.h"
+
+//feedback ids answered, 0x201~0x204 of the command 0x200, 0x205~0x207 of 0x1FF
+//ظķID, 0x200Ӧ0x201~0x204, 0x1FFӦ0x205~0x207
+#define HOST_MOTOR_SIM_ID_FIRST 0x201
+#define HOST_MOTOR_SIM_ID_LAST  0x207
+#define HOST_MOTOR_SIM_NUM      (HOST_MOTOR_SIM_ID_LAST - HOST_MOTOR_SIM_ID_FIRST + 1)
+
+//rotor rpm per unit of command current, and the time constant to it, unit s
+//ÿλӦתת, Լʱ䳣 λ s
+#define HOST_MOTOR_SIM_RPM_PER_CURRENT 0.5f
+#define HOST_MOTOR_SIM_TAU             0.02f
+#define HOST_MOTOR_SIM_TEMPERATE       30
+
+/**
+  * @brief          answer the commands on a file until stop is set, checked at least
+  *                 every 10ms
+  * @param[in]      fd: file of struct can_frame
+  * @param[in]      stop: set to 1 to return
+  * @retval         feedback frames sent
+  */
+/**
+  * @brief          ļϻظ, ֱstopλ, ÿ10msһ
+  * @param[in]      fd: struct can_frameļ
+  * @param[in]      stop: 1ʱ
+  * @retval         ͵ķ֡
+  */
+extern uint32_t host_motor_sim_run(int fd, volatile const uint8_t *stop);
+
+#endif
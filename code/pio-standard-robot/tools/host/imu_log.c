@@ -0,0 +1,422 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       imu_log.c/h
+  * @brief      parse the raw imu capture streamed by usb_task and replay it
+  *             through the INS_task calculation on a PC.
+  *             usb_taskIMUԭʼ, PCϰINS_taskļط.
+  * @note
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "imu_log.h"
+#include "INS_task.h"
+#include "BMI088driver.h"
+#include "AHRS.h"
+#include "quaternion_ekf.h"
+
+#define IMU_LOG_LINE_LEN    128
+#define IMU_LOG_REPEAT      5
+#define IMU_LOG_HEADER      "IMU capture clock:"
+#define IMU_LOG_STOP        "drop:"
+
+/*
+imu_cali_slove and the accel filter are static in INS_task.c, they are copied
+here with the install matrix and fliter_num of INS_task.c, keep them the same.
+the mag is not captured, so it is left out.
+imu_cali_sloveͼٶȼ˲INS_task.cΪstatic, ˴ͬINS_task.cİװ
+fliter_numһ, 豣һ. δɼ, ʡ.
+*/
+static const fp32 gyro_scale_factor[3][3] = {{0.0f, 1.0f, 0.0f}, {-1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}};
+static const fp32 accel_scale_factor[3][3] = {{0.0f, 1.0f, 0.0f}, {-1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}};
+static const fp32 fliter_num[3] = {1.929454039488895f, -0.93178349823448126f, 0.002329458745586203f};
+
+static fp32 gyro_offset[3];
+static fp32 accel_offset[3];
+
+static void imu_cali_slove(fp32 gyro[3], fp32 accel[3], const fp32 raw_gyro[3], const fp32 raw_accel[3])
+{
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        gyro[i] = raw_gyro[0] * gyro_scale_factor[i][0] + raw_gyro[1] * gyro_scale_factor[i][1] + raw_gyro[2] * gyro_scale_factor[i][2] + gyro_offset[i];
+        accel[i] = raw_accel[0] * accel_scale_factor[i][0] + raw_accel[1] * accel_scale_factor[i][1] + raw_accel[2] * accel_scale_factor[i][2] + accel_offset[i];
+    }
+}
+
+//one gyro sample and the accel and temperature records before it
+//һ֮ǰļٶȼƺ¶ȼ¼
+typedef struct
+{
+    const imu_capture_t *gyro_record;
+    uint32_t accel_index;
+    fp32 dt;
+    fp64 time;
+} imu_log_sample_t;
+
+static uint64_t imu_log_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void imu_log_stage_time(imu_log_result_t *result, imu_log_stage_e stage, uint64_t ns, uint32_t num)
+{
+    fp64 per_call = num ? (fp64)ns / num : 0.0;
+
+    if (result->stage_ns[stage] == 0.0 || result->stage_ns[stage] > per_call)
+    {
+        result->stage_ns[stage] = per_call;
+    }
+}
+
+/**
+  * @brief          parse a capture stream
+  * @param[in]      file: stream, opened in binary mode
+  * @param[out]     log: records and counters, free by imu_log_free
+  * @retval         0: ok, -1: no header or a record of unknown type or length
+  */
+/**
+  * @brief          ɼ
+  * @param[in]      file: , ԶƷʽ
+  * @param[out]     log: ¼ͼ, imu_log_freeͷ
+  * @retval         0: ɹ, -1: ûм¼ͷ¼ͻ򳤶ȴ
+  */
+int imu_log_parse(FILE *file, imu_log_t *log)
+{
+    char line[IMU_LOG_LINE_LEN];
+    const char *text;
+    unsigned long value;
+    imu_capture_t record;
+    imu_capture_t *grow;
+    uint32_t size = 0;
+    int c;
+
+    memset(log, 0, sizeof(imu_log_t));
+    log->drop = -1;
+
+    while (log->clock == 0)
+    {
+        if (fgets(line, sizeof(line), file) == NULL)
+        {
+            fprintf(stderr, "imu log: no \"" IMU_LOG_HEADER "\" header\n");
+            return -1;
+        }
+        text = strstr(line, IMU_LOG_HEADER);
+        if (text != NULL && sscanf(text + strlen(IMU_LOG_HEADER), "%lu", &value) == 1)
+        {
+            log->clock = (uint32_t)value;
+        }
+    }
+
+    while ((c = fgetc(file)) == IMU_CAPTURE_SYNC)
+    {
+        record.sync = (uint8_t)c;
+        if (fread((uint8_t *)&record + 1, sizeof(record) - 1, 1, file) != 1)
+        {
+            break;
+        }
+        if (record.type > IMU_CAPTURE_ACCEL_OFFSET || record.len > IMU_CAPTURE_DATA_LEN)
+        {
+            fprintf(stderr, "imu log: record %u has type %u and len %u\n", log->num, record.type, record.len);
+            imu_log_free(log);
+            return -1;
+        }
+        if (log->num != 0)
+        {
+            log->gap += (uint8_t)(record.seq - log->records[log->num - 1].seq - 1);
+        }
+        if (log->num == size)
+        {
+            size = size ? size * 2 : 4096;
+            grow = (imu_capture_t *)realloc(log->records, size * sizeof(imu_capture_t));
+            if (grow == NULL)
+            {
+                imu_log_free(log);
+                return -1;
+            }
+            log->records = grow;
+        }
+        log->records[log->num++] = record;
+    }
+
+    if (c != EOF)
+    {
+        ungetc(c, file);
+        while (fgets(line, sizeof(line), file) != NULL)
+        {
+            text = strstr(line, IMU_LOG_STOP);
+            if (text != NULL && sscanf(text + strlen(IMU_LOG_STOP), "%lu", &value) == 1)
+            {
+                log->drop = (int32_t)value;
+                break;
+            }
+        }
+    }
+    return 0;
+}
+
+/**
+  * @brief          free the records of a log
+  * @param[in]      log: log
+  * @retval         none
+  */
+/**
+  * @brief          ͷż¼
+  * @param[in]      log: ¼
+  * @retval         none
+  */
+void imu_log_free(imu_log_t *log)
+{
+    free(log->records);
+    log->records = NULL;
+    log->num = 0;
+}
+
+/**
+  * @brief          replay the records through the INS_task calculation, the gyro dt
+  *                 is measured from the record cycles as INS_dt_update does
+  * @param[in]      log: parsed log
+  * @param[in]      filter: IMU_LOG_FILTER_AHRS or IMU_LOG_FILTER_EKF
+  * @param[in]      trajectory: csv "time_s,yaw,pitch,roll" in rad per gyro sample, NULL for none
+  * @param[in]      samples: calibrated samples "time_us gx gy gz ax ay az" for bench_ahrs, NULL for none
+  * @param[out]     result: counters, stage time and the end attitude
+  * @retval         0: ok, -1: no gyro sample after an accel record
+  */
+/**
+  * @brief          INS_taskļطż¼, dtINS_dt_updateͬɼ¼ļõ
+  * @param[in]      log: ļ¼
+  * @param[in]      filter: IMU_LOG_FILTER_AHRSIMU_LOG_FILTER_EKF
+  * @param[in]      trajectory: ÿһcsv "time_s,yaw,pitch,roll" λ rad, NULLΪ
+  * @param[in]      samples: bench_ahrsʹõУ׼ "time_us gx gy gz ax ay az", NULLΪ
+  * @param[out]     result: , ׶κʱͽʱ̬
+  * @retval         0: ɹ, -1: ٶȼƼ¼֮û
+  */
+int imu_log_replay(const imu_log_t *log, uint8_t filter, FILE *trajectory, FILE *samples, imu_log_result_t *result)
+{
+    static const fp32 mag_none[3] = {0.0f, 0.0f, 0.0f};
+    const imu_capture_t **accel_record;
+    const imu_capture_t **temp_record;
+    imu_log_sample_t *sample;
+    fp32 (*raw_gyro)[3], (*raw_accel)[3], (*gyro)[3], (*accel)[3], (*accel_fliter)[3], (*quat)[4], (*angle)[3];
+    fp32 *temp;
+    fp32 fliter[3][3];
+    fp32 sensor_time;
+    quaternion_ekf_t ekf;
+    uint32_t last_cycle = 0;
+    uint32_t dt_us;
+    uint32_t accel_num = 0, temp_num = 0, num = 0;
+    uint32_t i, n;
+    uint8_t run, j;
+    uint64_t ns;
+    int ret = 0;
+
+    memset(result, 0, sizeof(imu_log_result_t));
+    memset(gyro_offset, 0, sizeof(gyro_offset));
+    memset(accel_offset, 0, sizeof(accel_offset));
+
+    accel_record = (const imu_capture_t **)calloc(log->num + 1, sizeof(imu_capture_t *));
+    temp_record = (const imu_capture_t **)calloc(log->num + 1, sizeof(imu_capture_t *));
+    sample = (imu_log_sample_t *)calloc(log->num + 1, sizeof(imu_log_sample_t));
+    raw_gyro = calloc(log->num + 1, sizeof(*raw_gyro));
+    raw_accel = calloc(log->num + 1, sizeof(*raw_accel));
+    gyro = calloc(log->num + 1, sizeof(*gyro));
+    accel = calloc(log->num + 1, sizeof(*accel));
+    accel_fliter = calloc(log->num + 1, sizeof(*accel_fliter));
+    quat = calloc(log->num + 1, sizeof(*quat));
+    angle = calloc(log->num + 1, sizeof(*angle));
+    temp = calloc(log->num + 1, sizeof(*temp));
+
+    //records in the order they were written, a gyro sample takes the latest accel record
+    //¼д˳, ʹļٶȼƼ¼
+    for (i = 0; i < log->num; i++)
+    {
+        const imu_capture_t *record = &log->records[i];
+
+        switch (record->type)
+        {
+        case IMU_CAPTURE_GYRO:
+            if (accel_num == 0)
+            {
+                result->gyro_skip++;
+                break;
+            }
+            sample[num].gyro_record = record;
+            sample[num].accel_index = accel_num - 1;
+            //as INS_dt_update
+            //INS_dt_updateͬ
+            dt_us = (uint32_t)((uint64_t)(record->cycle - last_cycle) * 1000000U / log->clock);
+            if (num == 0 || dt_us == 0 || dt_us > INS_DT_MAX_US)
+            {
+                sample[num].dt = INS_DT_FRAME_US * 0.000001f;
+                result->dt_fallback += num != 0;
+            }
+            else
+            {
+                sample[num].dt = (fp32)(record->cycle - last_cycle) / (fp32)log->clock;
+            }
+            sample[num].time = num ? sample[num - 1].time + (fp64)(uint32_t)(record->cycle - last_cycle) / log->clock : 0.0;
+            last_cycle = record->cycle;
+            num++;
+            break;
+        case IMU_CAPTURE_ACCEL:
+            accel_record[accel_num++] = record;
+            break;
+        case IMU_CAPTURE_TEMP:
+            temp_record[temp_num++] = record;
+            break;
+        case IMU_CAPTURE_GYRO_OFFSET:
+            memcpy(gyro_offset, record->data, sizeof(gyro_offset));
+            break;
+        case IMU_CAPTURE_ACCEL_OFFSET:
+            memcpy(accel_offset, record->data, sizeof(accel_offset));
+            break;
+        default:
+            break;
+        }
+    }
+    result->gyro_sample = num;
+    result->accel_sample = accel_num;
+    result->temp_sample = temp_num;
+    if (num == 0)
+    {
+        ret = -1;
+        goto end;
+    }
+    result->duration = sample[num - 1].time;
+
+    for (run = 0; run < IMU_LOG_REPEAT; run++)
+    {
+        ns = imu_log_ns();
+        for (n = 0; n < num; n++)
+        {
+            BMI088_gyro_read_over((uint8_t *)sample[n].gyro_record->data + BMI088_GYRO_RX_BUF_DATA_OFFSET, raw_gyro[n]);
+        }
+        for (i = 0; i < accel_num; i++)
+        {
+            BMI088_accel_read_over((uint8_t *)accel_record[i]->data + BMI088_ACCEL_RX_BUF_DATA_OFFSET, raw_accel[i], &sensor_time);
+        }
+        for (i = 0; i < temp_num; i++)
+        {
+            BMI088_temperature_read_over((uint8_t *)temp_record[i]->data + BMI088_ACCEL_RX_BUF_DATA_OFFSET, &temp[i]);
+        }
+        imu_log_stage_time(result, IMU_LOG_STAGE_READ, imu_log_ns() - ns, num + accel_num + temp_num);
+
+        ns = imu_log_ns();
+        for (n = 0; n < num; n++)
+        {
+            imu_cali_slove(gyro[n], accel[n], raw_gyro[n], raw_accel[sample[n].accel_index]);
+        }
+        imu_log_stage_time(result, IMU_LOG_STAGE_CALI, imu_log_ns() - ns, num);
+
+        //filter state starts at the first accel, as in INS_task
+        //˲״̬Եһٶȳʼ, INS_taskͬ
+        for (j = 0; j < 3; j++)
+        {
+            fliter[0][j] = fliter[1][j] = fliter[2][j] = accel[0][j];
+        }
+        ns = imu_log_ns();
+        if (filter == IMU_LOG_FILTER_AHRS)
+        {
+            for (n = 0; n < num; n++)
+            {
+                for (j = 0; j < 3; j++)
+                {
+                    fliter[0][j] = fliter[1][j];
+                    fliter[1][j] = fliter[2][j];
+                    fliter[2][j] = fliter[1][j] * fliter_num[0] + fliter[0][j] * fliter_num[1] + accel[n][j] * fliter_num[2];
+                    accel_fliter[n][j] = fliter[2][j];
+                }
+            }
+        }
+        imu_log_stage_time(result, IMU_LOG_STAGE_FILTER, imu_log_ns() - ns, num);
+
+        if (filter == IMU_LOG_FILTER_EKF)
+        {
+            quaternion_ekf_init(&ekf, accel[0]);
+            ns = imu_log_ns();
+            for (n = 0; n < num; n++)
+            {
+                quaternion_ekf_update(&ekf, sample[n].dt, gyro[n], accel[n]);
+                memcpy(quat[n], ekf.q, sizeof(quat[n]));
+            }
+        }
+        else
+        {
+            AHRS_init(quat[0], accel[0], mag_none);
+            ns = imu_log_ns();
+            for (n = 0; n < num; n++)
+            {
+                if (n != 0)
+                {
+                    memcpy(quat[n], quat[n - 1], sizeof(quat[n]));
+                }
+                AHRS_update(quat[n], sample[n].dt, gyro[n], accel_fliter[n], mag_none);
+            }
+        }
+        imu_log_stage_time(result, IMU_LOG_STAGE_ATTITUDE, imu_log_ns() - ns, num);
+
+        ns = imu_log_ns();
+        for (n = 0; n < num; n++)
+        {
+            get_angle(quat[n], &angle[n][0], &angle[n][1], &angle[n][2]);
+        }
+        imu_log_stage_time(result, IMU_LOG_STAGE_ANGLE, imu_log_ns() - ns, num);
+    }
+
+    result->angle_end[0] = angle[num - 1][0];
+    result->angle_end[1] = angle[num - 1][1];
+    result->angle_end[2] = angle[num - 1][2];
+    result->temp_min = temp_num ? temp[0] : 0.0f;
+    result->temp_max = result->temp_min;
+    for (i = 1; i < temp_num; i++)
+    {
+        if (result->temp_min > temp[i])
+        {
+            result->temp_min = temp[i];
+        }
+        if (result->temp_max < temp[i])
+        {
+            result->temp_max = temp[i];
+        }
+    }
+
+    if (trajectory != NULL)
+    {
+        fprintf(trajectory, "time_s,yaw,pitch,roll\n");
+        for (n = 0; n < num; n++)
+        {
+            fprintf(trajectory, "%.6f,%.6f,%.6f,%.6f\n", sample[n].time, angle[n][0], angle[n][1], angle[n][2]);
+        }
+    }
+    if (samples != NULL)
+    {
+        fprintf(samples, "# calibrated samples of an imu capture, time_us gx gy gz ax ay az\n");
+        for (n = 0; n < num; n++)
+        {
+            fprintf(samples, "%.0f %.6f %.6f %.6f %.5f %.5f %.5f\n", sample[n].time * 1000000.0, gyro[n][0], gyro[n][1],
+                    gyro[n][2], accel[n][0], accel[n][1], accel[n][2]);
+        }
+    }
+
+end:
+    free(accel_record);
+    free(temp_record);
+    free(sample);
+    free(raw_gyro);
+    free(raw_accel);
+    free(gyro);
+    free(accel);
+    free(accel_fliter);
+    free(quat);
+    free(angle);
+    free(temp);
+    return ret;
+}
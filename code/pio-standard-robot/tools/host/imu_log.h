@@ -0,0 +1,138 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       imu_log.c/h
+  * @brief      parse the raw imu capture streamed by usb_task and replay it
+  *             through the INS_task calculation on a PC: BMI088_*_read_over,
+  *             imu_cali_slove, the accel filter and AHRS_update or the
+  *             quaternion EKF, then get_angle.
+  *             usb_taskIMUԭʼ, PCϰINS_taskļط:
+  *             BMI088_*_read_over, imu_cali_slove, ٶȼ˲, AHRS_update
+  *             ԪEKF, Լget_angle.
+  * @note       the stages run one after the other over the whole capture, every
+  *             stage is fed by the output of the one before, so each one is
+  *             timed alone with no timer call per sample. the result is the
+  *             same as running them sample by sample as INS_task does.
+  *             INS_task parts that are not replayed: the mag (not captured),
+  *             the temperature control and the gyro zero drift learning, the
+  *             gyro offset is the one recorded at the capture start. with
+  *             BMI088_GYRO_FIFO_ENABLE every frame is a gyro sample and the
+  *             accel filter runs at every frame, INS_task runs it once a burst.
+  *             ׶ζȫ, ÿһ׶εΪһ׶ε, ˿
+  *             ʱÿüʱ, INS_taskͬ.
+  *             δطŵĲ: (δɼ), ¶ȿƺƯѧϰ, Ưʹòɼ
+  *             ʼʱ¼ֵ. BMI088_GYRO_FIFO_ENABLEʱÿһ֡Ϊһ,
+  *             ٶȼ˲ÿ֡, INS_taskÿζȡһ.
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *
+  @verbatim
+  ==============================================================================
+  stream format, see usb_task.c and imu_capture.h. text before the header is
+  skipped, the binary imu_capture_t records follow the header line and end at
+  the first byte that is not IMU_CAPTURE_SYNC, the stop line may follow:
+  IMU capture clock:<SystemCoreClock>\r\n
+  <imu_capture_t, 24 bytes> ...
+  \r\nIMU capture off, drop:<count>\r\n
+  ݸʽusb_task.cimu_capture.h. ¼ͷ֮ǰı, ͷ֮ΪƵ
+  imu_capture_t¼, ڵһIMU_CAPTURE_SYNCֽڴ, ֹͣ.
+  ==============================================================================
+  @endverbatim
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+#ifndef IMU_LOG_H
+#define IMU_LOG_H
+
+#include <stdio.h>
+
+#include "struct_typedef.h"
+#include "imu_capture.h"
+
+//attitude filter of the replay, as INS_FILTER of INS_task
+//طʹõ̬˲, INS_taskINS_FILTERͬ
+#define IMU_LOG_FILTER_AHRS 0
+#define IMU_LOG_FILTER_EKF  1
+
+//stages of the replay, in the order of INS_task
+//طŵĸ׶, INS_taskе˳
+typedef enum
+{
+    IMU_LOG_STAGE_READ = 0,     //BMI088_*_read_over of every record.ÿ¼BMI088_*_read_over
+    IMU_LOG_STAGE_CALI,         //imu_cali_slove.
+    IMU_LOG_STAGE_FILTER,       //accel low-pass filter, AHRS only.ٶȼƵͨ˲, AHRS
+    IMU_LOG_STAGE_ATTITUDE,     //AHRS_update or quaternion_ekf_update.
+    IMU_LOG_STAGE_ANGLE,        //get_angle.
+    IMU_LOG_STAGE_NUM,
+} imu_log_stage_e;
+
+typedef struct
+{
+    uint32_t clock;             //SystemCoreClock of the board, unit Hz.ںʱ λ Hz
+    imu_capture_t *records;     //malloc'ed, free by imu_log_free.malloc, imu_log_freeͷ
+    uint32_t num;
+    uint32_t gap;               //records lost by the seq.seqõĶʧ¼
+    int32_t drop;               //drop of the stop line, -1: no stop line.ֹͣеĶ, -1Ϊûֹͣ
+} imu_log_t;
+
+typedef struct
+{
+    uint32_t gyro_sample;       //gyro records replayed.طŵǼ¼
+    uint32_t gyro_skip;         //gyro records before the first accel record.һٶȼƼ¼֮ǰǼ¼
+    uint32_t accel_sample;
+    uint32_t temp_sample;
+    uint32_t dt_fallback;       //dt 0 or above INS_DT_MAX_US, the nominal dt is used.dtΪ0򳬹INS_DT_MAX_US, ʹñֵ
+    fp64 duration;              //first to last gyro sample, unit s.һһʱ λ s
+    fp32 temp_min;              //unit 
+    fp32 temp_max;
+    fp32 angle_end[3];          //yaw, pitch, roll at the end, unit rad.ʱyaw, pitch, roll λ rad
+    fp64 stage_ns[IMU_LOG_STAGE_NUM];   //host time per call, best of IMU_LOG_REPEAT runs.ÿεõʱ, ȡ
+} imu_log_result_t;
+
+/**
+  * @brief          parse a capture stream
+  * @param[in]      file: stream, opened in binary mode
+  * @param[out]     log: records and counters, free by imu_log_free
+  * @retval         0: ok, -1: no header or a record of unknown type or length
+  */
+/**
+  * @brief          ɼ
+  * @param[in]      file: , ԶƷʽ
+  * @param[out]     log: ¼ͼ, imu_log_freeͷ
+  * @retval         0: ɹ, -1: ûм¼ͷ¼ͻ򳤶ȴ
+  */
+extern int imu_log_parse(FILE *file, imu_log_t *log);
+
+/**
+  * @brief          free the records of a log
+  * @param[in]      log: log
+  * @retval         none
+  */
+/**
+  * @brief          ͷż¼
+  * @param[in]      log: ¼
+  * @retval         none
+  */
+extern void imu_log_free(imu_log_t *log);
+
+/**
+  * @brief          replay the records through the INS_task calculation, the gyro dt
+  *                 is measured from the record cycles as INS_dt_update does
+  * @param[in]      log: parsed log
+  * @param[in]      filter: IMU_LOG_FILTER_AHRS or IMU_LOG_FILTER_EKF
+  * @param[in]      trajectory: csv "time_s,yaw,pitch,roll" in rad per gyro sample, NULL for none
+  * @param[in]      samples: calibrated samples "time_us gx gy gz ax ay az" for bench_ahrs, NULL for none
+  * @param[out]     result: counters, stage time and the end attitude
+  * @retval         0: ok, -1: no gyro sample after an accel record
+  */
+/**
+  * @brief          INS_taskļطż¼, dtINS_dt_updateͬɼ¼ļõ
+  * @param[in]      log: ļ¼
+  * @param[in]      filter: IMU_LOG_FILTER_AHRSIMU_LOG_FILTER_EKF
+  * @param[in]      trajectory: ÿһcsv "time_s,yaw,pitch,roll" λ rad, NULLΪ
+  * @param[in]      samples: bench_ahrsʹõУ׼ "time_us gx gy gz ax ay az", NULLΪ
+  * @param[out]     result: , ׶κʱͽʱ̬
+  * @retval         0: ɹ, -1: ٶȼƼ¼֮û
+  */
+extern int imu_log_replay(const imu_log_t *log, uint8_t filter, FILE *trajectory, FILE *samples, imu_log_result_t *result);
+
+#endif
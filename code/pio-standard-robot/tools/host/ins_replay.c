@@ -0,0 +1,148 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       ins_replay.c
+  * @brief      replay a raw imu capture through the INS_task calculation, print
+  *             the record counts, the host time per call of every stage and
+  *             the attitude at the end, and write the attitude trajectory.
+  *             IMUԭʼݰINS_taskļط, ¼, ׶ÿεõ
+  *             ʱͽʱ̬, ̬켣.
+  * @note       usage: ins_replay [-e] [-t trajectory.csv] [-l samples.txt] capture.bin
+  *             capture.bin is the usb output after sending 'c' to the board
+  *             until 'c' is sent again, -e replays the quaternion EKF instead
+  *             of AHRS_update, samples.txt is the calibrated data in the log
+  *             format of bench_ahrs, see imu_log.h for the scope.
+  *             ÷: ins_replay [-e] [-t trajectory.csv] [-l samples.txt] capture.bin
+  *             capture.binΪ򿪷巢'c'ٴη'c'֮usb, -eʹԪ
+  *             EKFAHRS_update, samples.txtΪbench_ahrsʽУ׼, طŷΧ
+  *             imu_log.h.
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "imu_log.h"
+
+#define INS_REPLAY_RAD_TO_DEG 57.295779513082320876798154814105f
+
+static const char *const ins_replay_stage_name[IMU_LOG_STAGE_NUM] =
+{
+    [IMU_LOG_STAGE_READ] = "read_over",
+    [IMU_LOG_STAGE_CALI] = "imu_cali_slove",
+    [IMU_LOG_STAGE_FILTER] = "accel filter",
+    [IMU_LOG_STAGE_ATTITUDE] = "attitude",
+    [IMU_LOG_STAGE_ANGLE] = "get_angle",
+};
+
+static FILE *ins_replay_open(const char *path)
+{
+    FILE *file;
+
+    if (path == NULL)
+    {
+        return NULL;
+    }
+    file = fopen(path, "w");
+    if (file == NULL)
+    {
+        perror(path);
+        exit(2);
+    }
+    return file;
+}
+
+int main(int argc, char **argv)
+{
+    const char *capture_path = NULL;
+    const char *trajectory_path = NULL;
+    const char *samples_path = NULL;
+    uint8_t filter = IMU_LOG_FILTER_AHRS;
+    FILE *capture;
+    FILE *trajectory;
+    FILE *samples;
+    imu_log_t log;
+    imu_log_result_t result;
+    int ret;
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-e") == 0)
+        {
+            filter = IMU_LOG_FILTER_EKF;
+        }
+        else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+        {
+            trajectory_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc)
+        {
+            samples_path = argv[++i];
+        }
+        else
+        {
+            capture_path = argv[i];
+        }
+    }
+    if (capture_path == NULL)
+    {
+        fprintf(stderr, "usage: ins_replay [-e] [-t trajectory.csv] [-l samples.txt] capture.bin\n");
+        return 2;
+    }
+
+    capture = fopen(capture_path, "rb");
+    if (capture == NULL)
+    {
+        perror(capture_path);
+        return 2;
+    }
+    ret = imu_log_parse(capture, &log);
+    fclose(capture);
+    if (ret != 0)
+    {
+        return 2;
+    }
+
+    trajectory = ins_replay_open(trajectory_path);
+    samples = ins_replay_open(samples_path);
+    ret = imu_log_replay(&log, filter, trajectory, samples, &result);
+    if (trajectory != NULL)
+    {
+        fclose(trajectory);
+    }
+    if (samples != NULL)
+    {
+        fclose(samples);
+    }
+
+    printf("records %u, clock %u Hz, seq gap %u, board drop %d\n", log.num, log.clock, log.gap, log.drop);
+    imu_log_free(&log);
+    if (ret != 0)
+    {
+        fprintf(stderr, "no gyro record after an accel record\n");
+        return 2;
+    }
+    printf("gyro %u (%u before the first accel), accel %u, temperature %u, %.3f s, %.1f Hz, dt fallback %u\n",
+           result.gyro_sample, result.gyro_skip, result.accel_sample, result.temp_sample, result.duration,
+           result.duration > 0.0 ? (result.gyro_sample - 1) / result.duration : 0.0, result.dt_fallback);
+    if (result.temp_sample != 0)
+    {
+        printf("temperature %.1f ~ %.1f C\n", result.temp_min, result.temp_max);
+    }
+    printf("%s, ns per call:\n", filter == IMU_LOG_FILTER_EKF ? "quaternion EKF" : "AHRS_update");
+    for (i = 0; i < IMU_LOG_STAGE_NUM; i++)
+    {
+        if (filter == IMU_LOG_FILTER_EKF && i == IMU_LOG_STAGE_FILTER)
+        {
+            continue;
+        }
+        printf("  %-16s %8.1f\n", ins_replay_stage_name[i], result.stage_ns[i]);
+    }
+    printf("end yaw %.2f pitch %.2f roll %.2f deg\n", result.angle_end[0] * INS_REPLAY_RAD_TO_DEG,
+           result.angle_end[1] * INS_REPLAY_RAD_TO_DEG, result.angle_end[2] * INS_REPLAY_RAD_TO_DEG);
+    return 0;
+}
@@ -0,0 +1,52 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       motor_sim.c
+  * @brief      simulated motors 0x201~0x207 on a SocketCAN interface, a process
+  *             for bench_can_loop -x or for the firmware on a USB-CAN adapter.
+  *             SocketCANӿģ0x201~0x207, Ϊ
+  *             bench_can_loop -x, USB-CANڹ̼.
+  * @note       usage: motor_sim [ifname], vcan0 by default, stop with ctrl-c.
+  *             vcan0: ip link add dev vcan0 type vcan && ip link set up vcan0
+  *             ÷: motor_sim [ifname], Ĭvcan0, ctrl-cֹͣ.
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+
+#include <signal.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "host_hal.h"
+#include "host_motor_sim.h"
+
+static volatile uint8_t motor_sim_stop;
+
+static void motor_sim_signal(int sig)
+{
+    (void)sig;
+    motor_sim_stop = 1;
+}
+
+int main(int argc, char **argv)
+{
+    const char *ifname = argc > 1 ? argv[1] : "vcan0";
+    uint32_t sent;
+    int fd;
+
+    fd = host_can_socket(ifname);
+    if (fd < 0)
+    {
+        fprintf(stderr, "motor_sim: no SocketCAN interface %s\n", ifname);
+        return 2;
+    }
+    signal(SIGINT, motor_sim_signal);
+    signal(SIGTERM, motor_sim_signal);
+    printf("motors 0x%X~0x%X on %s\n", HOST_MOTOR_SIM_ID_FIRST, HOST_MOTOR_SIM_ID_LAST, ifname);
+    sent = host_motor_sim_run(fd, &motor_sim_stop);
+    close(fd);
+    printf("%u feedback frames\n", sent);
+    return 0;
+}
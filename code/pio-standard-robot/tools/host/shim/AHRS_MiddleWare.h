@@ -0,0 +1,47 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       AHRS_MiddleWare.h
+  * @brief      host stand-in of lib/components/algorithm/AHRS_middleware.h,
+  *             the same declarations on the host struct_typedef.h, the
+  *             firmware header defines int64_t as long long.
+  *             AHRS_middleware.h, ͬ, ȡstruct_typedef.h,
+  *             ̼ͷļint64_tΪlong long.
+  * @note       the firmware includes it as AHRS_MiddleWare.h, which only finds
+  *             AHRS_middleware.h on a case-insensitive file system.
+  *             ̼AHRS_MiddleWare.h, ֻڲִСдļϵͳҵ
+  *             AHRS_middleware.h.
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+#ifndef AHRS_MIDDLEWARE_H
+#define AHRS_MIDDLEWARE_H
+
+#include <stddef.h>
+#include "struct_typedef.h"
+
+#ifndef PI
+#define PI 3.14159265358979f
+#endif
+
+#ifndef ANGLE_TO_RAD
+#define ANGLE_TO_RAD 0.01745329251994329576923690768489f
+#endif
+
+#ifndef RAD_TO_ANGLE
+#define RAD_TO_ANGLE 57.295779513082320876798154814105f
+#endif
+
+extern void AHRS_get_height(fp32 *high);
+extern void AHRS_get_latitude(fp32 *latitude);
+extern fp32 AHRS_invSqrt(fp32 num);
+extern fp32 AHRS_sinf(fp32 angle);
+extern fp32 AHRS_cosf(fp32 angle);
+extern fp32 AHRS_tanf(fp32 angle);
+extern fp32 AHRS_asinf(fp32 sin);
+extern fp32 AHRS_acosf(fp32 cos);
+extern fp32 AHRS_atan2f(fp32 y, fp32 x);
+
+#endif
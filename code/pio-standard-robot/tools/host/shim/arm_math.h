@@ -0,0 +1,59 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       arm_math.h
+  * @brief      host stand-in of the CMSIS-DSP arm_math.h, only the calls the
+  *             app sources under tools/host use, on libm. arm_sin_f32 and
+  *             arm_cos_f32 of CMSIS interpolate a table, the error against
+  *             sinf is below 1e-6.
+  *             CMSIS-DSP arm_math.h, tools/hostõӦòԴļ
+  *             ĺ, libmʵ. CMSISarm_sin_f32arm_cos_f32Ϊֵ,
+  *             sinfС1e-6.
+  * @note
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+#ifndef _ARM_MATH_H
+#define _ARM_MATH_H
+
+#include <math.h>
+#include <stdint.h>
+
+#ifndef PI
+#define PI 3.14159265358979f
+#endif
+
+typedef float float32_t;
+
+typedef enum
+{
+    ARM_MATH_SUCCESS = 0,
+    ARM_MATH_ARGUMENT_ERROR = -1,
+} arm_status;
+
+//same as CMSIS: a negative input gives 0 and ARM_MATH_ARGUMENT_ERROR
+//CMSISͬ: Ϊʱ0ARM_MATH_ARGUMENT_ERROR
+static inline arm_status arm_sqrt_f32(float32_t in, float32_t *pOut)
+{
+    if (in >= 0.0f)
+    {
+        *pOut = sqrtf(in);
+        return ARM_MATH_SUCCESS;
+    }
+    *pOut = 0.0f;
+    return ARM_MATH_ARGUMENT_ERROR;
+}
+
+static inline float32_t arm_sin_f32(float32_t x)
+{
+    return sinf(x);
+}
+
+static inline float32_t arm_cos_f32(float32_t x)
+{
+    return cosf(x);
+}
+
+#endif
@@ -0,0 +1,39 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       cmsis_os.h
+  * @brief      host stand-in of cmsis_os.h, the FreeRTOS calls the app sources
+  *             under tools/host use. no scheduler runs on the host, a critical
+  *             section takes one host mutex.
+  *             cmsis_os.h, tools/hostõFreeRTOS. ûе,
+  *             ٽΪһ.
+  * @note
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+#ifndef CMSIS_OS_H
+#define CMSIS_OS_H
+
+#include "struct_typedef.h"
+
+typedef uint32_t TickType_t;
+typedef long BaseType_t;
+typedef void *TaskHandle_t;
+
+#define pdTRUE  1
+#define pdFALSE 0
+#define pdPASS  1
+#define portMAX_DELAY 0xFFFFFFFFU
+
+extern void host_critical_enter(void);
+extern void host_critical_exit(void);
+extern TickType_t xTaskGetTickCount(void);
+
+#define taskENTER_CRITICAL() host_critical_enter()
+#define taskEXIT_CRITICAL() host_critical_exit()
+#define taskENTER_CRITICAL_FROM_ISR() (host_critical_enter(), 0U)
+#define taskEXIT_CRITICAL_FROM_ISR(state) ((void)(state), host_critical_exit())
+
+#endif
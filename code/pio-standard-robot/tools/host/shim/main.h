@@ -0,0 +1,106 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       main.h
+  * @brief      host stand-in of the CubeMX main.h, only the HAL types, flags
+  *             and calls the app sources under tools/host use. the calls are
+  *             done by host_hal.c on a fake CAN bus and a fake DWT counter.
+  *             CubeMX main.h, tools/hostõӦòԴļHAL
+  *             , ־ͺ. host_hal.cģCANߺDWTʵ.
+  * @note
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+#ifndef __MAIN_H
+#define __MAIN_H
+
+#include <stddef.h>
+#include <string.h>
+#include "struct_typedef.h"
+
+typedef enum
+{
+    HAL_OK = 0x00U,
+    HAL_ERROR = 0x01U,
+    HAL_BUSY = 0x02U,
+    HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+#define DISABLE 0U
+#define ENABLE  1U
+
+//barriers: the firmware orders the CAN interrupt and the tasks with __DMB, on the host
+//the interrupt is a thread, so a full fence that also stops the compiler
+//: ̼__DMB֤CANжϺ֮˳, жΪһ߳, ʹڴ
+#define __DMB() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define __DSB() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define __ISB() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define __disable_irq() ((void)0)
+#define __enable_irq() ((void)0)
+#define __get_PRIMASK() 0U
+#define __set_PRIMASK(primask) ((void)(primask))
+
+typedef struct
+{
+    uint8_t bus;    //CAN_BUS_1 or CAN_BUS_2
+} CAN_HandleTypeDef;
+
+typedef struct
+{
+    uint32_t StdId;
+    uint32_t ExtId;
+    uint32_t IDE;
+    uint32_t RTR;
+    uint32_t DLC;
+    uint32_t Timestamp;
+    uint32_t FilterMatchIndex;
+} CAN_RxHeaderTypeDef;
+
+typedef struct
+{
+    uint32_t StdId;
+    uint32_t ExtId;
+    uint32_t IDE;
+    uint32_t RTR;
+    uint32_t DLC;
+    uint32_t TransmitGlobalTime;
+} CAN_TxHeaderTypeDef;
+
+typedef struct
+{
+    uint8_t id;
+} TIM_HandleTypeDef;
+
+#define CAN_ID_STD      0x00000000U
+#define CAN_ID_EXT      0x00000004U
+#define CAN_RTR_DATA    0x00000000U
+#define CAN_RX_FIFO0    0x00000000U
+#define CAN_RX_FIFO1    0x00000001U
+#define CAN_FLAG_FOV0   0x00000204U
+#define CAN_FLAG_FOV1   0x00000404U
+
+#define __HAL_CAN_GET_FLAG(hcan, flag) host_can_get_flag((hcan), (flag))
+#define __HAL_CAN_CLEAR_FLAG(hcan, flag) host_can_clear_flag((hcan), (flag))
+
+extern CAN_HandleTypeDef hcan1;
+extern CAN_HandleTypeDef hcan2;
+extern TIM_HandleTypeDef htim7;
+
+extern uint32_t host_can_get_flag(CAN_HandleTypeDef *hcan, uint32_t flag);
+extern void host_can_clear_flag(CAN_HandleTypeDef *hcan, uint32_t flag);
+
+extern uint32_t HAL_CAN_GetRxFifoFillLevel(CAN_HandleTypeDef *hcan, uint32_t RxFifo);
+extern HAL_StatusTypeDef HAL_CAN_GetRxMessage(CAN_HandleTypeDef *hcan, uint32_t RxFifo, CAN_RxHeaderTypeDef *pHeader, uint8_t aData[]);
+extern uint32_t HAL_CAN_GetTxMailboxesFreeLevel(CAN_HandleTypeDef *hcan);
+extern HAL_StatusTypeDef HAL_CAN_AddTxMessage(CAN_HandleTypeDef *hcan, CAN_TxHeaderTypeDef *pHeader, uint8_t aData[], uint32_t *pTxMailbox);
+extern uint32_t HAL_CAN_IsTxMessagePending(CAN_HandleTypeDef *hcan, uint32_t TxMailboxes);
+extern HAL_StatusTypeDef HAL_CAN_AbortTxRequest(CAN_HandleTypeDef *hcan, uint32_t TxMailboxes);
+extern HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim);
+
+extern void HAL_CAN_RxFifo0MsgPendingCallback(CAN_HandleTypeDef *hcan);
+extern void HAL_CAN_RxFifo1MsgPendingCallback(CAN_HandleTypeDef *hcan);
+extern void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim);
+
+#endif
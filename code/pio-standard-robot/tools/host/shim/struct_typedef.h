@@ -0,0 +1,25 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       struct_typedef.h
+  * @brief      host stand-in of src/application/struct_typedef.h, the fixed
+  *             width types come from the host <stdint.h>, int64_t of the
+  *             firmware header is long long and clashes with 64 bit libc.
+  *             struct_typedef.h, ȡ<stdint.h>, ̼ͷļ
+  *             int64_tΪlong long, 64λlibcͻ.
+  * @note
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+#ifndef STRUCT_TYPEDEF_H
+#define STRUCT_TYPEDEF_H
+
+#include <stdint.h>
+
+typedef unsigned char bool_t;
+typedef float fp32;
+typedef double fp64;
+
+#endif
@@ -0,0 +1,602 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       sim_gimbal.c
+  * @brief      simulation of the gimbal control laws of gimbal_task.c on a
+  *             model of the axis: pitch angle steps by the pid cascade and by
+  *             the lqr with the gravity feedforward, settle time and overshoot.
+  *             then yaw held still in the world by the pid cascade and by the
+  *             adrc while the chassis spins under it, rejection time and peak
+  *             error, on built in chassis motions or on a recorded chassis rate.
+  *             ̨ɷ: ģ, pitchǶȽԾֱɴpidʹ
+  *             ǰlqr, ͳƵʱͳ. ȻΪyawתʱ, pid
+  *             adrcyawϵǶȲ, ͳʱ, ʹõ
+  *             ˶¼ĵ̽ٶ.
+  * @note       usage: sim_gimbal [-t trace.csv] [samples.txt]
+  *             the model is the one the lqr is designed on, see gimbal_task.h,
+  *             rate' = a * (current - gravity * cos(pitch)) - c * rate, stepped
+  *             at GIMBAL_CONTROL_TIME, the current reaches the motor
+  *             SIM_DELAY_CYCLE cycles late. yaw has no gravity, c acts on the
+  *             rate against the chassis with a coulomb friction, the gyro has
+  *             noise and the encoder goes through motor_state_update as the CAN
+  *             feedback does. the laws are set up from the constants of
+  *             gimbal_task.h as gimbal_init does. the point is the ratio between
+  *             the laws, not the time of a real gimbal.
+  *             samples.txt is the calibrated imu data of ins_replay -l or a log
+  *             of bench_ahrs, of a capture taken with the board on the chassis
+  *             or the gimbal locked to it, gz is replayed as the chassis rate.
+  *             trace.csv gets one line per cycle of the replay.
+  *             returns 1 if the lqr does not settle in the window, or the adrc
+  *             does not take out a chassis motion or does it worse than the
+  *             cascade.
+  *             ÷: sim_gimbal [-t trace.csv] [samples.txt]
+  *             ģlqrͬ, gimbal_task.h, rate' = a * ( -  *
+  *             cos(pitch)) - c * rate, GIMBAL_CONTROL_TIME, ӳ
+  *             SIM_DELAY_CYCLEõ. yaw, cԵ̵Ľٶ,
+  *             пĦ, , CANͬmotor_state_update.
+  *             ɰgimbal_initgimbal_task.hĳ. ڸ֮
+  *             Ƚ, ʵ̨ʱ.
+  *             samples.txtΪins_replay -lУ׼IMUݻbench_ahrsļ¼,
+  *             ɼʱڵϻ̨ڵ, gzΪ̽ٶȻط.
+  *             trace.csvΪطŵÿһ.
+  *             lqrڴδȶ, adrcδ˶ȴʱ1.
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. pitch steps by pid cascade and lqr
+  *  V1.1.0     Oct-16-2026     RM              1. yaw chassis rotation by pid cascade and adrc, replay of a chassis rate
+  *
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gimbal_task.h"
+#include "motor_state.h"
+
+//model of the pitch axis, a and c of the lqr design, gravity as the feedforward
+//pitchģ, aclqrͬ, ǰͬ
+#define SIM_PITCH_A         0.04f
+#define SIM_PITCH_C         10.0f
+#define SIM_PITCH_GRAVITY   PITCH_GRAVITY_CURRENT
+//cycles from the current set to the motor, CAN frame and the current loop of the motor
+//趨ӳ, CAN֡͵
+#define SIM_DELAY_CYCLE     2
+//the axis settles at the start angle before the step
+//ԾǰʼǶȶʱ
+#define SIM_PRE_NUM         (2000 / GIMBAL_CONTROL_TIME)
+#define SIM_STEP_NUM        (1500 / GIMBAL_CONTROL_TIME)
+#define SIM_STEP_TIME       (SIM_STEP_NUM * GIMBAL_CONTROL_TIME_S)
+//settled once the angle stays within this band of the set
+//Ƕȱ趨ֵĸ÷ΧΪȶ
+#define SIM_SETTLE_BAND     0.005f
+//lqr overshoot over this is a failure
+//lqrֵΪʧ
+#define SIM_LQR_MAX_OVER    0.05f
+
+//model of the yaw axis, a as the adrc b0, c as the adrc c, on the rate against the chassis,
+//the coulomb friction in current, full past SIM_YAW_FRICTION_RATE
+//yawģ, aadrcb0ͬ, cadrccͬ, Ե̵Ľٶ,
+//ĦԵʾ, SIM_YAW_FRICTION_RATEʱΪȫֵ
+#define SIM_YAW_A               0.03f
+#define SIM_YAW_C               10.0f
+#define SIM_YAW_FRICTION        1500.0f
+#define SIM_YAW_FRICTION_RATE   0.05f
+//peak of the uniform gyro noise, unit rad/s
+//Ǿֵ, λ rad/s
+#define SIM_GYRO_NOISE          0.01f
+#define SIM_YAW_NUM             (3000 / GIMBAL_CONTROL_TIME)
+//taken out once the error stays within this band
+//ڸ÷ΧΪ
+#define SIM_REJECT_BAND         0.002f
+#define SIM_ECD_RANGE           8192
+#define SIM_RAD_TO_ECD          (SIM_ECD_RANGE / 6.28318530717958647692f)
+#define SIM_RADS_TO_RPM         9.5492965855137201461330258023509f
+#define SIM_LINE_LEN            256
+
+typedef enum
+{
+    SIM_LAW_PID = 0,
+    SIM_LAW_LQR,
+    SIM_LAW_ADRC,
+} sim_law_e;
+
+typedef struct
+{
+    fp32 settle;    //unit s, SIM_STEP_TIME if not settled
+    fp32 over;      //of the step
+} sim_result_t;
+
+//what the yaw sees per cycle, the first cycle is held before the start
+//yawÿڵ, ʼǰֵһڵֵ
+typedef struct
+{
+    const fp32 *chassis_rate;   //rad/s
+    const fp32 *hit;            //current of a hit on the gimbal, NULL for none
+    fp32 angle_set;             //rad, from the start
+    int num;
+} sim_yaw_input_t;
+
+typedef struct
+{
+    fp32 reject;    //unit s, last time out of SIM_REJECT_BAND, num cycles if still out
+    fp32 peak;      //unit rad
+    fp32 rms;       //unit rad
+} sim_yaw_result_t;
+
+static fp32 sim_angle[SIM_STEP_NUM];
+
+static sim_result_t sim_settle(const fp32 *angle, int num, fp32 start, fp32 set)
+{
+    sim_result_t result = {0.0f, 0.0f};
+    int i;
+    for (i = num - 1; i >= 0; i--)
+    {
+        if (fabsf(angle[i] - set) > SIM_SETTLE_BAND)
+        {
+            break;
+        }
+    }
+    result.settle = (i + 1) * GIMBAL_CONTROL_TIME_S;
+    for (i = 0; i < num; i++)
+    {
+        fp32 over = (angle[i] - set) / (set - start);
+        if (over > result.over)
+        {
+            result.over = over;
+        }
+    }
+    return result;
+}
+
+/**
+  * @brief          step of the pitch angle from start to set
+  * @param[in]      law: SIM_LAW_PID or SIM_LAW_LQR
+  * @param[in]      gravity_scale: gravity feedforward over the gravity of the model, lqr only
+  * @param[in]      start: angle before the step, unit rad
+  * @param[in]      set: angle set of the step, unit rad
+  * @retval         settle time and overshoot
+  */
+static sim_result_t sim_pitch_step(sim_law_e law, fp32 gravity_scale, fp32 start, fp32 set)
+{
+    //as gimbal_init
+    static const pid_config_t angle_config = {PITCH_GYRO_ABSOLUTE_PID_KP, PITCH_GYRO_ABSOLUTE_PID_KI / GIMBAL_CONTROL_TIME_S, GIMBAL_ANGLE_PID_KD_SIGN * PITCH_GYRO_ABSOLUTE_PID_KD,
+                                              PITCH_GYRO_ABSOLUTE_PID_MAX_OUT, PITCH_GYRO_ABSOLUTE_PID_MAX_IOUT, 0.0f, 0.0f};
+    static const pid_config_t speed_config = {PITCH_SPEED_PID_KP, PITCH_SPEED_PID_KI / GIMBAL_CONTROL_TIME_S, PITCH_SPEED_PID_KD * GIMBAL_CONTROL_TIME_S,
+                                              PITCH_SPEED_PID_MAX_OUT, PITCH_SPEED_PID_MAX_IOUT, PITCH_SPEED_PID_KI / PITCH_SPEED_PID_KP / GIMBAL_CONTROL_TIME_S, 0.0f};
+    static const lqr_config_t lqr_config = {PITCH_LQR_K_ANGLE, PITCH_LQR_K_RATE, PITCH_LQR_K_I, PITCH_LQR_MAX_OUT, PITCH_LQR_MAX_IOUT, PITCH_LQR_I_BAND};
+    const fp32 dt = GIMBAL_CONTROL_TIME_S;
+    pid_type_def angle_pid, speed_pid;
+    lqr_type_def lqr;
+    fp32 current_delay[SIM_DELAY_CYCLE + 1] = {0.0f};
+    fp32 angle = start;
+    fp32 rate = 0.0f;
+    int i, j;
+
+    PID_init(&angle_pid, &angle_config);
+    PID_init(&speed_pid, &speed_config);
+    LQR_init(&lqr, &lqr_config);
+
+    for (i = -SIM_PRE_NUM; i < SIM_STEP_NUM; i++)
+    {
+        fp32 angle_set = i < 0 ? start : set;
+        fp32 current;
+        if (law == SIM_LAW_LQR)
+        {
+            current = LQR_calc(&lqr, angle, rate, angle_set, 0.0f, gravity_scale * PITCH_GRAVITY_CURRENT * cosf(angle + PITCH_GRAVITY_PHASE), dt);
+        }
+        else
+        {
+            fp32 rate_set = PID_calc_full(&angle_pid, GIMBAL_ANGLE_PID_FLAG, angle, rate, angle_set, 0.0f, dt);
+            current = PID_calc(&speed_pid, GIMBAL_SPEED_PID_FLAG, rate, rate_set, dt);
+        }
+        //the given current is an int16_t
+        //͵ĵΪint16_t
+        current = (fp32)(int16_t)current;
+        for (j = SIM_DELAY_CYCLE; j > 0; j--)
+        {
+            current_delay[j] = current_delay[j - 1];
+        }
+        current_delay[0] = current;
+
+        rate += dt * (SIM_PITCH_A * (current_delay[SIM_DELAY_CYCLE] - SIM_PITCH_GRAVITY * cosf(angle + PITCH_GRAVITY_PHASE)) - SIM_PITCH_C * rate);
+        angle += dt * rate;
+        if (i >= 0)
+        {
+            sim_angle[i] = angle;
+        }
+    }
+    return sim_settle(sim_angle, SIM_STEP_NUM, start, set);
+}
+
+static fp32 sim_noise(void)
+{
+    return ((fp32)rand() / (fp32)RAND_MAX * 2.0f - 1.0f) * SIM_GYRO_NOISE;
+}
+
+static sim_yaw_result_t sim_reject(const fp32 *err, int num)
+{
+    sim_yaw_result_t result = {0.0f, 0.0f, 0.0f};
+    double sum = 0.0;
+    int i;
+    for (i = num - 1; i >= 0; i--)
+    {
+        if (fabsf(err[i]) > SIM_REJECT_BAND)
+        {
+            break;
+        }
+    }
+    result.reject = (i + 1) * GIMBAL_CONTROL_TIME_S;
+    for (i = 0; i < num; i++)
+    {
+        if (fabsf(err[i]) > result.peak)
+        {
+            result.peak = fabsf(err[i]);
+        }
+        sum += (double)err[i] * err[i];
+    }
+    result.rms = num > 0 ? (fp32)sqrt(sum / num) : 0.0f;
+    return result;
+}
+
+/**
+  * @brief          yaw held at the world angle set while the chassis turns under it
+  * @param[in]      law: SIM_LAW_PID or SIM_LAW_ADRC
+  * @param[in]      adrc_config: adrc config, adrc only
+  * @param[in]      input: chassis rate, hit and angle set
+  * @param[out]     err: angle set - angle per cycle, input->num
+  * @retval         rejection time and error
+  */
+static sim_yaw_result_t sim_yaw_run(sim_law_e law, const adrc_config_t *adrc_config, const sim_yaw_input_t *input, fp32 *err)
+{
+    //as gimbal_init
+    static const pid_config_t angle_config = {YAW_GYRO_ABSOLUTE_PID_KP, YAW_GYRO_ABSOLUTE_PID_KI / GIMBAL_CONTROL_TIME_S, GIMBAL_ANGLE_PID_KD_SIGN * YAW_GYRO_ABSOLUTE_PID_KD,
+                                              YAW_GYRO_ABSOLUTE_PID_MAX_OUT, YAW_GYRO_ABSOLUTE_PID_MAX_IOUT, 0.0f, 0.0f};
+    static const pid_config_t speed_config = {YAW_SPEED_PID_KP, YAW_SPEED_PID_KI / GIMBAL_CONTROL_TIME_S, YAW_SPEED_PID_KD * GIMBAL_CONTROL_TIME_S,
+                                              YAW_SPEED_PID_MAX_OUT, YAW_SPEED_PID_MAX_IOUT, YAW_SPEED_PID_KI / YAW_SPEED_PID_KP / GIMBAL_CONTROL_TIME_S, 0.0f};
+    const fp32 dt = GIMBAL_CONTROL_TIME_S;
+    pid_type_def angle_pid, speed_pid;
+    adrc_type_def adrc;
+    motor_state_t motor_state;
+    fp32 current_delay[SIM_DELAY_CYCLE + 1] = {0.0f};
+    fp32 angle = 0.0f;
+    fp32 rate = input->chassis_rate[0];
+    fp32 relative_angle = 0.0f;
+    int i, j;
+
+    PID_init(&angle_pid, &angle_config);
+    PID_init(&speed_pid, &speed_config);
+    ADRC_init(&adrc, adrc_config);
+    memset(&motor_state, 0, sizeof(motor_state));
+    srand(1);
+
+    for (i = -SIM_PRE_NUM; i < input->num; i++)
+    {
+        int k = i < 0 ? 0 : i;
+        fp32 chassis_rate = input->chassis_rate[k];
+        fp32 hit = (input->hit != NULL && i >= 0) ? input->hit[k] : 0.0f;
+        fp32 angle_set = i < 0 ? 0.0f : input->angle_set;
+        fp32 relative_rate = rate - chassis_rate;
+        fp32 gyro = rate + sim_noise();
+        fp32 friction, current;
+        int32_t ecd;
+
+        //the encoder frame of the cycle, as CAN_receive does
+        //ڵı֡, CAN_receiveͬ
+        ecd = (int32_t)floorf(relative_angle * SIM_RAD_TO_ECD) % SIM_ECD_RANGE;
+        if (ecd < 0)
+        {
+            ecd += SIM_ECD_RANGE;
+        }
+        motor_state_update(&motor_state, (uint16_t)ecd, (int16_t)lroundf(relative_rate * SIM_RADS_TO_RPM),
+                           i == -SIM_PRE_NUM ? 0.0f : dt);
+
+        if (law == SIM_LAW_ADRC)
+        {
+            current = ADRC_calc(&adrc, angle, gyro, motor_state.velocity, angle_set, 0.0f, dt);
+        }
+        else
+        {
+            fp32 rate_set = PID_calc_full(&angle_pid, GIMBAL_ANGLE_PID_FLAG, angle, gyro, angle_set, 0.0f, dt);
+            current = PID_calc(&speed_pid, GIMBAL_SPEED_PID_FLAG, gyro, rate_set, dt);
+        }
+        current = (fp32)(int16_t)current;
+        for (j = SIM_DELAY_CYCLE; j > 0; j--)
+        {
+            current_delay[j] = current_delay[j - 1];
+        }
+        current_delay[0] = current;
+
+        friction = relative_rate / SIM_YAW_FRICTION_RATE;
+        if (friction > 1.0f)
+        {
+            friction = 1.0f;
+        }
+        else if (friction < -1.0f)
+        {
+            friction = -1.0f;
+        }
+        rate += dt * (SIM_YAW_A * (current_delay[SIM_DELAY_CYCLE] - SIM_YAW_FRICTION * friction - hit) - SIM_YAW_C * relative_rate);
+        angle += dt * rate;
+        relative_angle += dt * (rate - chassis_rate);
+        if (i >= 0)
+        {
+            err[i] = angle_set - angle;
+        }
+    }
+    return sim_reject(err, input->num);
+}
+
+//the laws of the yaw table, cascade, adrc, adrc without the encoder, adrc with b0 off
+//yawеĿ, , adrc, ʹñadrc, b0ƫadrc
+#define SIM_YAW_LAW_NUM 5
+
+static const char *const sim_yaw_law_name[SIM_YAW_LAW_NUM] = {"pid cascade", "adrc", "adrc c = 0", "adrc b0 -30%", "adrc b0 +50%"};
+
+static void sim_yaw_laws(const sim_yaw_input_t *input, fp32 *err[SIM_YAW_LAW_NUM], sim_yaw_result_t result[SIM_YAW_LAW_NUM])
+{
+    const adrc_config_t adrc_config[SIM_YAW_LAW_NUM] =
+    {
+        {YAW_ADRC_B0, YAW_ADRC_WC, YAW_ADRC_WO, YAW_ADRC_C, YAW_ADRC_MAX_OUT},
+        {YAW_ADRC_B0, YAW_ADRC_WC, YAW_ADRC_WO, YAW_ADRC_C, YAW_ADRC_MAX_OUT},
+        {YAW_ADRC_B0, YAW_ADRC_WC, YAW_ADRC_WO, 0.0f, YAW_ADRC_MAX_OUT},
+        {YAW_ADRC_B0 * 0.7f, YAW_ADRC_WC, YAW_ADRC_WO, YAW_ADRC_C, YAW_ADRC_MAX_OUT},
+        {YAW_ADRC_B0 * 1.5f, YAW_ADRC_WC, YAW_ADRC_WO, YAW_ADRC_C, YAW_ADRC_MAX_OUT},
+    };
+    int i;
+    for (i = 0; i < SIM_YAW_LAW_NUM; i++)
+    {
+        result[i] = sim_yaw_run(i == 0 ? SIM_LAW_PID : SIM_LAW_ADRC, &adrc_config[i], input, err[i]);
+    }
+}
+
+static void sim_yaw_print(const char *name, const sim_yaw_result_t result[SIM_YAW_LAW_NUM])
+{
+    int i;
+    printf("%-20s", name);
+    for (i = 0; i < SIM_YAW_LAW_NUM; i++)
+    {
+        printf("  %5.0f %6.1f", result[i].reject * 1000.0f, result[i].peak * 1000.0f);
+    }
+    printf("\n");
+}
+
+/**
+  * @brief          load the chassis rate, gz of a calibrated imu log, at GIMBAL_CONTROL_TIME
+  * @param[in]      path: "time_us gx gy gz ax ay az [roll pitch yaw]" per line, '#' lines skipped
+  * @param[out]     num: cycles
+  * @retval         chassis rate per cycle, free it, NULL on error
+  */
+static fp32 *sim_load_rate(const char *path, int *num)
+{
+    FILE *file = fopen(path, "r");
+    char line[SIM_LINE_LEN];
+    double *time_us = NULL;
+    fp32 *gz = NULL;
+    fp32 *rate = NULL;
+    int size = 0;
+    int sample_num = 0;
+    int cycle_num, n, k;
+
+    if (file == NULL)
+    {
+        perror(path);
+        return NULL;
+    }
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        fp32 gyro[3];
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r')
+        {
+            continue;
+        }
+        if (sample_num == size)
+        {
+            double *time_grow;
+            fp32 *gz_grow;
+            size = size ? size * 2 : 4096;
+            time_grow = realloc(time_us, size * sizeof(double));
+            if (time_grow != NULL)
+            {
+                time_us = time_grow;
+            }
+            gz_grow = realloc(gz, size * sizeof(fp32));
+            if (gz_grow != NULL)
+            {
+                gz = gz_grow;
+            }
+            if (time_grow == NULL || gz_grow == NULL)
+            {
+                sample_num = 0;
+                break;
+            }
+        }
+        if (sscanf(line, "%lf %f %f %f", &time_us[sample_num], &gyro[0], &gyro[1], &gyro[2]) != 4)
+        {
+            fprintf(stderr, "%s: bad line: %s", path, line);
+            sample_num = 0;
+            break;
+        }
+        gz[sample_num++] = gyro[2];
+    }
+    fclose(file);
+
+    if (sample_num > 0)
+    {
+        //the last sample at or before each cycle
+        //ÿȡʱ̼֮ǰһ
+        cycle_num = (int)((time_us[sample_num - 1] - time_us[0]) / (GIMBAL_CONTROL_TIME * 1000.0)) + 1;
+        rate = malloc(cycle_num * sizeof(fp32));
+        for (n = 0, k = 0; rate != NULL && n < cycle_num; n++)
+        {
+            while (k + 1 < sample_num && time_us[k + 1] - time_us[0] <= n * GIMBAL_CONTROL_TIME * 1000.0)
+            {
+                k++;
+            }
+            rate[n] = gz[k];
+        }
+        *num = cycle_num;
+    }
+    else
+    {
+        fprintf(stderr, "%s: no sample\n", path);
+    }
+    free(time_us);
+    free(gz);
+    return rate;
+}
+
+int main(int argc, char **argv)
+{
+    static const fp32 step[][2] = {{0.0f, 0.3f}, {-0.3f, 0.3f}, {0.3f, -0.3f}, {0.0f, 0.05f}};
+    static fp32 yaw_rate[SIM_YAW_NUM], yaw_hit[SIM_YAW_NUM], yaw_zero[SIM_YAW_NUM];
+    static fp32 yaw_err[SIM_YAW_LAW_NUM][SIM_YAW_NUM];
+    fp32 *err[SIM_YAW_LAW_NUM];
+    sim_yaw_result_t yaw[SIM_YAW_LAW_NUM];
+    sim_yaw_input_t input;
+    const char *samples_path = NULL;
+    const char *trace_path = NULL;
+    int fail = 0;
+    int n;
+    unsigned int i;
+
+    for (n = 1; n < argc; n++)
+    {
+        if (strcmp(argv[n], "-t") == 0 && n + 1 < argc)
+        {
+            trace_path = argv[++n];
+        }
+        else
+        {
+            samples_path = argv[n];
+        }
+    }
+    if (trace_path != NULL && samples_path == NULL)
+    {
+        fprintf(stderr, "usage: sim_gimbal [-t trace.csv] [samples.txt]\n");
+        return 1;
+    }
+
+    printf("pitch step, settle to %.0f mrad, ms and overshoot\n", SIM_SETTLE_BAND * 1000.0f);
+    printf("%-16s %16s %16s %16s\n", "step rad", "pid cascade", "lqr + ff", "lqr + ff -20%");
+    for (i = 0; i < sizeof(step) / sizeof(step[0]); i++)
+    {
+        sim_result_t pid = sim_pitch_step(SIM_LAW_PID, 0.0f, step[i][0], step[i][1]);
+        sim_result_t lqr = sim_pitch_step(SIM_LAW_LQR, 1.0f, step[i][0], step[i][1]);
+        sim_result_t lqr_low = sim_pitch_step(SIM_LAW_LQR, 0.8f, step[i][0], step[i][1]);
+        printf("%+5.2f -> %+5.2f    %8.0f %5.1f%%  %8.0f %5.1f%%  %8.0f %5.1f%%\n", step[i][0], step[i][1],
+               pid.settle * 1000.0f, pid.over * 100.0f, lqr.settle * 1000.0f, lqr.over * 100.0f,
+               lqr_low.settle * 1000.0f, lqr_low.over * 100.0f);
+        if (lqr.settle >= SIM_STEP_TIME || lqr.over > SIM_LQR_MAX_OVER ||
+            lqr_low.settle >= SIM_STEP_TIME)
+        {
+            fail = 1;
+        }
+    }
+    if (fail)
+    {
+        printf("FAIL: lqr does not settle\n");
+        return fail;
+    }
+
+    //chassis spin up 0 -> 8 rad/s in 0.2 s, spin flip 8 -> -8 rad/s in 0.3 s, a hit of 4000 for 50 ms, a set step
+    //0.2 sڴ0ٵ8 rad/s, 0.3 sڴ8-8 rad/s, 50 ms4000, 趨ֵԾ
+    printf("\nyaw held in the world, ms to within %.0f mrad and peak mrad\n", SIM_REJECT_BAND * 1000.0f);
+    printf("%-20s", "chassis");
+    for (n = 0; n < SIM_YAW_LAW_NUM; n++)
+    {
+        err[n] = yaw_err[n];
+        printf("  %12s", sim_yaw_law_name[n]);
+    }
+    printf("\n");
+    for (i = 0; i < 4; i++)
+    {
+        for (n = 0; n < SIM_YAW_NUM; n++)
+        {
+            fp32 t = n * GIMBAL_CONTROL_TIME_S;
+            yaw_zero[n] = 0.0f;
+            yaw_hit[n] = (i == 2 && t < 0.05f) ? 4000.0f : 0.0f;
+            if (i == 0)
+            {
+                yaw_rate[n] = t < 0.2f ? 40.0f * t : 8.0f;
+            }
+            else if (i == 1)
+            {
+                yaw_rate[n] = t < 0.3f ? 8.0f - 16.0f / 0.3f * t : -8.0f;
+            }
+            else
+            {
+                yaw_rate[n] = 0.0f;
+            }
+        }
+        input.chassis_rate = i < 2 ? yaw_rate : yaw_zero;
+        input.hit = yaw_hit;
+        input.angle_set = i == 3 ? 0.3f : 0.0f;
+        input.num = SIM_YAW_NUM;
+        sim_yaw_laws(&input, err, yaw);
+        sim_yaw_print(i == 0 ? "spin up 0 -> 8" : i == 1 ? "spin flip 8 -> -8" : i == 2 ? "hit 4000 50 ms" : "set step 0.3", yaw);
+        //the chassis and the hit, a set step is not for the adrc to win
+        //̺ͳ, 趨ֵԾҪadrc
+        if (i < 3 && (yaw[1].reject >= SIM_YAW_NUM * GIMBAL_CONTROL_TIME_S || yaw[1].peak > yaw[0].peak ||
+                      yaw[1].reject > yaw[0].reject))
+        {
+            fail = 1;
+        }
+    }
+    if (fail)
+    {
+        printf("FAIL: adrc does not take out the chassis motion\n");
+        return fail;
+    }
+
+    if (samples_path != NULL)
+    {
+        fp32 *rate = sim_load_rate(samples_path, &input.num);
+        FILE *trace = NULL;
+        if (rate == NULL)
+        {
+            return 1;
+        }
+        for (n = 0; n < SIM_YAW_LAW_NUM; n++)
+        {
+            err[n] = malloc(input.num * sizeof(fp32));
+            if (err[n] == NULL)
+            {
+                return 1;
+            }
+        }
+        input.chassis_rate = rate;
+        input.hit = NULL;
+        input.angle_set = 0.0f;
+        sim_yaw_laws(&input, err, yaw);
+        printf("\nreplay %s, %d cycles, chassis rate from gz, rms and peak mrad\n", samples_path, input.num);
+        for (n = 0; n < SIM_YAW_LAW_NUM; n++)
+        {
+            printf("%-16s rms %6.2f peak %6.1f\n", sim_yaw_law_name[n], yaw[n].rms * 1000.0f, yaw[n].peak * 1000.0f);
+        }
+        if (trace_path != NULL)
+        {
+            trace = fopen(trace_path, "w");
+            if (trace == NULL)
+            {
+                perror(trace_path);
+            }
+        }
+        if (trace != NULL)
+        {
+            fprintf(trace, "time_s,chassis_rate,pid_err,adrc_err,adrc_c0_err\n");
+            for (n = 0; n < input.num; n++)
+            {
+                fprintf(trace, "%.3f,%.4f,%.6f,%.6f,%.6f\n", n * GIMBAL_CONTROL_TIME_S, rate[n], err[0][n], err[1][n], err[2][n]);
+            }
+            fclose(trace);
+        }
+        for (n = 0; n < SIM_YAW_LAW_NUM; n++)
+        {
+            free(err[n]);
+        }
+        free(rate);
+    }
+    return 0;
+}
@@ -0,0 +1,182 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       test_can_replay.c
+  * @brief      test of can_log.c: a dump in the format of usb_can_record_dump
+  *             is written, parsed and replayed, the motor state, the tx output
+  *             and the counters are checked. broken dumps must be refused.
+  *             can_log.cĲ: usb_can_record_dumpĸʽд¼, ط,
+  *             ״̬, ͼ. ʽļ¼뱻ܾ.
+  * @note       250ms of a chassis motor at 1000 rpm and a yaw motor at rest
+  *             at 1kHz, chassis and gimbal commands every ms and a frame of an
+  *             unknown id, time_us wraps in the middle.
+  *             1kHz250ms: 1000 rpmĵ̵;ֹyaw, ÿ
+  *             ̨̺, Լһ֡δ֪ID, time_us;.
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *  V1.1.0     Oct-16-2026     RM              1. motor position as integer turns and encoder
+  *
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "can_log.h"
+
+#define TEST_MS             250U
+#define TEST_RECORD_NUM     (TEST_MS * 4U + 1U)
+#define TEST_TIME_START     (0xFFFFFFFFU - 100000U)
+#define TEST_RPM            1000
+#define TEST_ECD_PER_MS     (TEST_RPM * 8192.0 / 60000.0)
+#define TEST_YAW_ECD        4321
+
+static int test_fail;
+
+static void test_check(int ok, const char *what)
+{
+    printf("%-48s %s\n", what, ok ? "ok" : "FAIL");
+    if (!ok)
+    {
+        test_fail = 1;
+    }
+}
+
+static void test_line(FILE *file, uint32_t time_us, int bus, char dir, int std_id, const uint8_t *data, int dlc)
+{
+    int i;
+
+    fprintf(file, "%lu %d %c %03X %d ", (unsigned long)time_us, bus, dir, std_id, dlc);
+    for (i = 0; i < dlc; i++)
+    {
+        fprintf(file, "%02X", data[i]);
+    }
+    fprintf(file, "\r\n");
+}
+
+static void test_put16(uint8_t *data, int16_t value)
+{
+    data[0] = (uint8_t)((uint16_t)value >> 8);
+    data[1] = (uint8_t)value;
+}
+
+static FILE *test_dump(void)
+{
+    FILE *file = tmpfile();
+    uint8_t data[8];
+    uint32_t time_us = TEST_TIME_START;
+    uint32_t ms;
+    uint16_t ecd;
+
+    fprintf(file, "status line before the dump\r\n");
+    fprintf(file, "CAN record:%u\r\n", TEST_RECORD_NUM);
+    for (ms = 0; ms < TEST_MS; ms++, time_us += 1000U)
+    {
+        ecd = (uint16_t)((uint32_t)lround(ms * TEST_ECD_PER_MS) % 8192U);
+        test_put16(&data[0], (int16_t)ecd);
+        test_put16(&data[2], TEST_RPM);
+        test_put16(&data[4], 1200);
+        data[6] = 40;
+        data[7] = 0;
+        test_line(file, time_us, 1, 'R', 0x201, data, 8);
+
+        test_put16(&data[0], TEST_YAW_ECD);
+        test_put16(&data[2], 0);
+        test_put16(&data[4], -300);
+        data[6] = 35;
+        test_line(file, time_us + 50U, 2, 'R', 0x205, data, 8);
+
+        test_put16(&data[0], (int16_t)ms);
+        test_put16(&data[2], -(int16_t)ms);
+        test_put16(&data[4], 16384);
+        test_put16(&data[6], -16384);
+        test_line(file, time_us + 250U, 1, 'T', 0x200, data, 8);
+        test_line(file, time_us + 500U, 2, 'T', 0x1FF, data, 8);
+    }
+    data[0] = 0xAB;
+    test_line(file, time_us, 2, 'R', 0x300, data, 1);
+    fprintf(file, "CAN record end\r\n");
+    rewind(file);
+    return file;
+}
+
+static int test_parse_text(const char *text)
+{
+    FILE *file = tmpfile();
+    can_record_t *records;
+    uint32_t num;
+    int ret;
+
+    fputs(text, file);
+    rewind(file);
+    ret = can_log_parse(file, &records, &num);
+    fclose(file);
+    free(records);
+    return ret;
+}
+
+int main(void)
+{
+    FILE *file = test_dump();
+    can_record_t *records;
+    uint32_t num;
+    can_log_result_t result;
+    motor_feedback_t feedback;
+    motor_state_t state;
+    long ecd_total;
+
+    test_check(can_log_parse(file, &records, &num) == 0 && num == TEST_RECORD_NUM, "parse");
+    fclose(file);
+    if (test_fail)
+    {
+        free(records);
+        printf("FAIL\n");
+        return 1;
+    }
+    test_check(records[0].time_us == TEST_TIME_START && records[0].bus == CAN_BUS_1 && records[0].std_id == 0x201 &&
+               records[0].dir_dlc == 8 && records[3].dir_dlc == ((CAN_RECORD_TX << 7) | 8) && records[3].bus == CAN_BUS_2,
+               "record fields");
+
+    can_log_replay(records, num, NULL, NULL, &result);
+    free(records);
+
+    printf("duration %llu us, rx %.0f ns per frame, tx %.0f ns per frame\n", (unsigned long long)result.duration_us,
+           (double)result.rx_ns / result.rx_frame, (double)result.tx_ns / result.tx_frame);
+    test_check(result.duration_us == TEST_MS * 1000U, "duration across the time_us wrap");
+    test_check(result.rx_frame == TEST_MS * 2U + 1U && result.other_frame == 1 &&
+               result.motor_frame[CAN_CHASSIS_M1_INDEX] == TEST_MS && result.motor_frame[CAN_YAW_MOTOR_INDEX] == TEST_MS,
+               "rx counts");
+    test_check(result.tx_frame == TEST_MS * 2U && result.tx_match == TEST_MS * 2U && result.tx_mismatch == 0 &&
+               result.tx_skip == 0, "tx output same as the record");
+
+    get_motor_feedback(CAN_CHASSIS_M1_INDEX, &feedback);
+    ecd_total = lround((TEST_MS - 1U) * TEST_ECD_PER_MS);
+    test_check(feedback.seq == TEST_MS && feedback.state.round == ecd_total / 8192 && feedback.state.last_ecd == ecd_total % 8192,
+               "chassis motor position");
+    test_check(fabsf(feedback.state.velocity - TEST_RPM * 2.0f * (fp32)M_PI / 60.0f) < 1.0f, "chassis motor velocity");
+    //a trigger or a wheel far past MOTOR_STATE_ANGLE_TURNS_MAX turns keeps one encoder count
+    //ԶMOTOR_STATE_ANGLE_TURNS_MAXȦʱԾȷһֵ
+    memset(&state, 0, sizeof(state));
+    state.round = 1000001;
+    state.last_ecd = 1;
+    test_check(motor_state_angle(&state, 2) == (8192 + 1) * MOTOR_STATE_ECD_TO_RAD, "motor angle past 2048 turns");
+    state.round = -1000001;
+    test_check(motor_state_angle(&state, 2) == (8192 + 1) * MOTOR_STATE_ECD_TO_RAD, "motor angle of negative turns");
+    get_motor_feedback(CAN_YAW_MOTOR_INDEX, &feedback);
+    test_check(feedback.measure.ecd == TEST_YAW_ECD && feedback.measure.given_current == -300 &&
+               fabsf(feedback.state.velocity) < 1e-6f, "yaw motor at rest");
+
+    test_check(test_parse_text("CAN record:1\r\n1 1 R 201 8 0102030405060708\r\n") != 0, "refuse a dump without end");
+    test_check(test_parse_text("CAN record:2\r\n1 1 R 201 8 0102030405060708\r\nCAN record end\r\n") != 0,
+               "refuse a count not the same as the header");
+    test_check(test_parse_text("CAN record:1\r\n1 3 R 201 8 0102030405060708\r\nCAN record end\r\n") != 0,
+               "refuse a bad bus");
+    test_check(test_parse_text("CAN record:1\r\n1 1 R 201 8 01020304\r\nCAN record end\r\n") != 0,
+               "refuse data shorter than dlc");
+    test_check(test_parse_text("1 1 R 201 8 0102030405060708\r\n") != 0, "refuse a dump without header");
+    test_check(test_parse_text("CAN record:0\r\nCAN record end\r\n") == 0, "accept an empty dump");
+
+    printf("%s\n", test_fail ? "FAIL" : "PASS");
+    return test_fail;
+}
@@ -0,0 +1,180 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       test_can_seqlock.c
+  * @brief      stress test of the motor feedback seqlock of CAN_receive.c. a
+  *             writer thread runs the CAN rx interrupt as fast as it can, reader
+  *             threads copy the same motor with get_motor_feedback and check that
+  *             every field of a copy comes from one frame.
+  *             CAN_receive.c˳ѹ. д߳̾ܿCAN
+  *             ж, ߳get_motor_feedbackͬһ, ÿ
+  *             ֶζͬһ֡.
+  * @note       frame n carries ecd = n % 8192, speed = n * 7, current = -n * 13,
+  *             temperate = n % 251 and is received at DWT cycle n * 1000, so seq,
+  *             last_ecd and rx_cycle are checked too. the same check of a plain
+  *             copy through get_chassis_motor_measure_point is counted as well,
+  *             to show the test does catch torn reads.
+  *             n֡Ϊ ecd = n % 8192, speed = n * 7, current = -n * 13,
+  *             temperate = n % 251, DWT n * 1000 ʱ, Ҳseq,
+  *             last_ecdrx_cycle. ͬʱͳֱӸget_chassis_motor_measure_point
+  *             ˺Ѵ, ˵ܷ˺.
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "host_hal.h"
+#include "main.h"
+#include "CAN_receive.h"
+#include "can_recorder.h"
+
+#define TEST_READER_NUM     2
+#define TEST_FRAME_NUM      4000000U
+#define TEST_CYCLE_PER_FRAME 1000U
+
+typedef struct
+{
+    uint32_t copy;
+    uint32_t torn;
+    uint32_t raw_copy;
+    uint32_t raw_torn;
+    uint32_t last_seq;
+    uint32_t backward;
+} test_reader_t;
+
+static volatile uint8_t test_done;
+
+static uint16_t frame_ecd(uint32_t n)
+{
+    return (uint16_t)(n % 8192U);
+}
+
+static int16_t frame_speed(uint32_t n)
+{
+    return (int16_t)(uint16_t)(n * 7U);
+}
+
+static int16_t frame_current(uint32_t n)
+{
+    return (int16_t)(uint16_t)(0U - n * 13U);
+}
+
+static uint8_t frame_temperate(uint32_t n)
+{
+    return (uint8_t)(n % 251U);
+}
+
+static void *test_writer(void *arg)
+{
+    uint8_t data[8];
+    uint32_t n;
+    (void)arg;
+
+    for (n = 1; n <= TEST_FRAME_NUM; n++)
+    {
+        data[0] = (uint8_t)(frame_ecd(n) >> 8);
+        data[1] = (uint8_t)frame_ecd(n);
+        data[2] = (uint8_t)((uint16_t)frame_speed(n) >> 8);
+        data[3] = (uint8_t)frame_speed(n);
+        data[4] = (uint8_t)((uint16_t)frame_current(n) >> 8);
+        data[5] = (uint8_t)frame_current(n);
+        data[6] = frame_temperate(n);
+        data[7] = 0;
+        host_dwt_set_cycle((uint64_t)n * TEST_CYCLE_PER_FRAME);
+        host_can_rx_push(CAN_BUS_1, CAN_RX_FIFO0, CAN_3508_M1_ID, 8, data);
+        host_irq_can_rx(CAN_BUS_1, CAN_RX_FIFO0);
+    }
+    test_done = 1;
+    return NULL;
+}
+
+static void *test_reader(void *arg)
+{
+    test_reader_t *reader = (test_reader_t *)arg;
+    const volatile motor_measure_t *raw = get_chassis_motor_measure_point(0);
+    motor_feedback_t feedback;
+    motor_measure_t measure;
+    uint32_t n;
+
+    while (!test_done)
+    {
+        if (get_motor_feedback(CAN_CHASSIS_M1_INDEX, &feedback))
+        {
+            n = feedback.seq;
+            reader->copy++;
+            if (feedback.measure.ecd != frame_ecd(n) || feedback.measure.speed_rpm != frame_speed(n) ||
+                feedback.measure.given_current != frame_current(n) || feedback.measure.temperate != frame_temperate(n) ||
+                (n > 1 && feedback.measure.last_ecd != (int16_t)frame_ecd(n - 1)) ||
+                feedback.rx_cycle != n * TEST_CYCLE_PER_FRAME)
+            {
+                reader->torn++;
+            }
+            if (n < reader->last_seq)
+            {
+                reader->backward++;
+            }
+            reader->last_seq = n;
+        }
+
+        //the same check on a plain copy, speed tells the frame
+        //ֱӸͬļ, speedȷ֡
+        measure.ecd = raw->ecd;
+        measure.speed_rpm = raw->speed_rpm;
+        measure.given_current = raw->given_current;
+        n = ((uint32_t)(uint16_t)measure.speed_rpm * 28087U) & 0xFFFFU;  //28087 = 7^-1 mod 2^16
+        if (n != 0)
+        {
+            reader->raw_copy++;
+            if (measure.ecd != frame_ecd(n) || (uint16_t)measure.given_current != (uint16_t)frame_current(n))
+            {
+                reader->raw_torn++;
+            }
+        }
+    }
+    return NULL;
+}
+
+int main(void)
+{
+    pthread_t writer;
+    pthread_t reader_thread[TEST_READER_NUM];
+    test_reader_t reader[TEST_READER_NUM] = {{0}};
+    uint32_t copy = 0, torn = 0, raw_copy = 0, raw_torn = 0, backward = 0;
+    int i;
+
+    //the recorder is not under test
+    //¼ڲԷΧ
+    can_recorder_freeze(1);
+
+    for (i = 0; i < TEST_READER_NUM; i++)
+    {
+        pthread_create(&reader_thread[i], NULL, test_reader, &reader[i]);
+    }
+    pthread_create(&writer, NULL, test_writer, NULL);
+    pthread_join(writer, NULL);
+    for (i = 0; i < TEST_READER_NUM; i++)
+    {
+        pthread_join(reader_thread[i], NULL);
+        copy += reader[i].copy;
+        torn += reader[i].torn;
+        raw_copy += reader[i].raw_copy;
+        raw_torn += reader[i].raw_torn;
+        backward += reader[i].backward;
+    }
+
+    printf("frames %u, readers %d\n", TEST_FRAME_NUM, TEST_READER_NUM);
+    printf("get_motor_feedback: %u copies, %u torn, %u out of order\n", copy, torn, backward);
+    printf("plain copy:         %u copies, %u torn\n", raw_copy, raw_torn);
+    if (torn != 0 || backward != 0 || copy == 0)
+    {
+        printf("FAIL\n");
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
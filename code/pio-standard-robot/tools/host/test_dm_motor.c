@@ -0,0 +1,201 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       test_dm_motor.c
+  * @brief      unit test of the Damiao MIT packing and feedback decode of
+  *             dm_motor.c against reference frames.
+  *             dm_motor.cдMITͷԲο֡ĵԪ.
+  * @note       the reference frames follow the MIT mapping of the Damiao manual
+  *             and demo code, x_int = (int)((x - x_min) * (2^bits - 1) / span),
+  *             evaluated in exact rational arithmetic offline. mid-range values
+  *             are chosen at least 0.1 LSB away from an integer, so float32
+  *             rounding cannot flip a bit. 7F FF 7F F0 00 00 07 FF is the zero
+  *             command of the manual.
+  *             ο̵ֲ֡MITӳ x_int = (int)((x - x_min) * (2^bits - 1) / span)
+  *             Ծȷ. мֵ0.1 LSB, float32벻ı.
+  *             7F FF 7F F0 00 00 07 FFΪֲе.
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+
+#include <math.h>
+#include <stdio.h>
+
+#include "dm_motor.h"
+
+typedef struct
+{
+    const char *name;
+    dm_motor_range_t range;
+    fp32 position;
+    fp32 velocity;
+    fp32 kp;
+    fp32 kd;
+    fp32 torque;
+    uint8_t frame[8];
+} test_pack_t;
+
+typedef struct
+{
+    const char *name;
+    dm_motor_range_t range;
+    uint8_t frame[8];
+    dm_motor_measure_t measure;
+} test_decode_t;
+
+//DM4310 default ranges and a DM8006 setting
+//DM4310ĬϷΧDM8006һ
+#define TEST_DM4310 {12.5f, 30.0f, 10.0f}
+#define TEST_DM8006 {12.5f, 45.0f, 40.0f}
+
+static const test_pack_t test_pack[] =
+{
+    {"zero",         TEST_DM4310,   0.0f,   0.0f,   0.0f,  0.0f,   0.0f, {0x7F, 0xFF, 0x7F, 0xF0, 0x00, 0x00, 0x07, 0xFF}},
+    {"max",          TEST_DM4310,  12.5f,  30.0f, 500.0f,  5.0f,  10.0f, {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}},
+    {"min",          TEST_DM4310, -12.5f, -30.0f,   0.0f,  0.0f, -10.0f, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+    {"clamped",      TEST_DM4310,  20.0f, -45.0f, 600.0f, -1.0f,  15.0f, {0xFF, 0xFF, 0x00, 0x0F, 0xFF, 0x00, 0x0F, 0xFF}},
+    {"negative",     TEST_DM4310,  -1.3f,  -4.7f,  35.5f, 0.83f,  -2.9f, {0x72, 0xAF, 0x6B, 0xE1, 0x22, 0x2A, 0x75, 0xAD}},
+    {"positive",     TEST_DM4310,   3.1f,  12.2f, 120.3f,  1.7f,   6.1f, {0x9F, 0xBD, 0xB4, 0x03, 0xD9, 0x57, 0x0C, 0xE0}},
+    {"dm8006 mixed", TEST_DM8006,  -7.7f,  21.4f,  10.2f, 0.22f, -27.1f, {0x31, 0x26, 0xBC, 0xD0, 0x53, 0x0B, 0x42, 0x94}},
+};
+
+static const test_decode_t test_decode[] =
+{
+    {"mid",          TEST_DM4310, {0x11, 0x80, 0x00, 0x80, 0x07, 0xFF, 0x28, 0x2D}, {1, 1,   0.000191f,   0.007326f, -0.002442f,  40,  45}},
+    {"error state",  TEST_DM4310, {0xD2, 0x12, 0x34, 0x56, 0x78, 0x9A, 0x3C, 0x50}, {2, 13, -10.722324f,  -9.736264f,  0.754579f,  60,  80}},
+    {"min",          TEST_DM8006, {0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, {1, 0,  -12.5f,      -45.0f,     -40.0f,        0,   0}},
+    {"max",          TEST_DM8006, {0x13, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0x80}, {3, 1,   12.5f,       45.0f,      40.0f,      127, 128}},
+};
+
+static const uint8_t test_cmd[] = {DM_MOTOR_CMD_CLEAR_ERROR, DM_MOTOR_CMD_ENABLE, DM_MOTOR_CMD_DISABLE, DM_MOTOR_CMD_SAVE_ZERO};
+
+static int test_fail;
+
+static void test_print_frame(const char *tag, const uint8_t frame[8])
+{
+    int i;
+    printf("    %s", tag);
+    for (i = 0; i < 8; i++)
+    {
+        printf(" %02X", frame[i]);
+    }
+    printf("\n");
+}
+
+static void test_check_pack(void)
+{
+    uint8_t frame[8];
+    size_t n;
+    int i;
+
+    for (n = 0; n < sizeof(test_pack) / sizeof(test_pack[0]); n++)
+    {
+        const test_pack_t *t = &test_pack[n];
+        dm_motor_pack_mit(frame, &t->range, t->position, t->velocity, t->kp, t->kd, t->torque);
+        for (i = 0; i < 8 && frame[i] == t->frame[i]; i++)
+        {
+        }
+        if (i < 8)
+        {
+            printf("FAIL pack %s\n", t->name);
+            test_print_frame("expect", t->frame);
+            test_print_frame("got   ", frame);
+            test_fail++;
+        }
+    }
+}
+
+static int test_near(fp32 a, fp32 b, fp32 tol)
+{
+    return fabsf(a - b) <= tol;
+}
+
+static void test_check_decode(void)
+{
+    dm_motor_measure_t measure;
+    size_t n;
+
+    for (n = 0; n < sizeof(test_decode) / sizeof(test_decode[0]); n++)
+    {
+        const test_decode_t *t = &test_decode[n];
+        dm_motor_decode(&measure, &t->range, t->frame);
+        //1e-5 of the range, the reference floats are printed to 6 places
+        //ݲΪΧ1e-5, οֵ6λС
+        if (measure.id != t->measure.id || measure.state != t->measure.state ||
+            !test_near(measure.position, t->measure.position, 2e-5f * t->range.p_max) ||
+            !test_near(measure.velocity, t->measure.velocity, 2e-5f * t->range.v_max) ||
+            !test_near(measure.torque, t->measure.torque, 2e-5f * t->range.t_max) ||
+            measure.t_mos != t->measure.t_mos || measure.t_rotor != t->measure.t_rotor)
+        {
+            printf("FAIL decode %s: id %u state %u p %f v %f t %f mos %u rotor %u\n", t->name, measure.id, measure.state,
+                   measure.position, measure.velocity, measure.torque, measure.t_mos, measure.t_rotor);
+            test_fail++;
+        }
+    }
+}
+
+static void test_check_cmd(void)
+{
+    uint8_t frame[8];
+    size_t n;
+    int i;
+
+    for (n = 0; n < sizeof(test_cmd); n++)
+    {
+        dm_motor_pack_cmd(frame, test_cmd[n]);
+        for (i = 0; i < 7 && frame[i] == 0xFF; i++)
+        {
+        }
+        if (i < 7 || frame[7] != test_cmd[n])
+        {
+            printf("FAIL cmd %02X\n", test_cmd[n]);
+            test_print_frame("got", frame);
+            test_fail++;
+        }
+    }
+}
+
+//float to uint and back is within one LSB over the whole range, for every width used
+//λ, ȫΧڸתתص1LSB
+static void test_check_round_trip(void)
+{
+    static const uint8_t bits[] = {12, 16};
+    fp32 x, y, lsb;
+    size_t n;
+    int i;
+
+    for (n = 0; n < sizeof(bits); n++)
+    {
+        lsb = 25.0f / (fp32)((1 << bits[n]) - 1);
+        for (i = -10000; i <= 10000; i++)
+        {
+            x = 12.5f * (fp32)i / 10000.0f;
+            y = dm_uint_to_float(dm_float_to_uint(x, -12.5f, 12.5f, bits[n]), -12.5f, 12.5f, bits[n]);
+            if (y > x + 1e-4f || y < x - lsb - 1e-4f)
+            {
+                printf("FAIL round trip %u bits: %f -> %f\n", bits[n], x, y);
+                test_fail++;
+                break;
+            }
+        }
+    }
+}
+
+int main(void)
+{
+    test_check_pack();
+    test_check_decode();
+    test_check_cmd();
+    test_check_round_trip();
+    if (test_fail)
+    {
+        printf("FAIL %d\n", test_fail);
+        return 1;
+    }
+    printf("PASS %u pack, %u decode, %u command frames, round trip of 12 and 16 bits\n",
+           (unsigned)(sizeof(test_pack) / sizeof(test_pack[0])), (unsigned)(sizeof(test_decode) / sizeof(test_decode[0])),
+           (unsigned)sizeof(test_cmd));
+    return 0;
+}
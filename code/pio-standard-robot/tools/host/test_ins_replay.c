@@ -0,0 +1,202 @@
+/**
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  * @file       test_ins_replay.c
+  * @brief      test of imu_log.c: a capture in the format of usb_task is written,
+  *             parsed and replayed with both filters, the counters, dt and the
+  *             attitude are checked. broken captures must be refused.
+  *             imu_log.cĲ: usb_taskĸʽдɼ, ˲
+  *             ط, , dt̬. ʽݱ뱻ܾ.
+  * @note       2s of the board level and turning at 0.5 rad/s about z, gyro at
+  *             1kHz, accel at 800Hz, temperature at 100Hz, the DWT cycle wraps
+  *             after 50ms and one record is lost by seq.
+  *             2s: ˮƽ, z0.5 rad/sת, 1kHz, ٶȼ
+  *             800Hz, ¶100Hz, DWT50ms, seqʧһ¼.
+  * @history
+  *  Version    Date            Author          Modification
+  *  V1.0.0     Oct-16-2026     RM              1. done
+  *
+  ****************************(C) COPYRIGHT 2019 DJI****************************
+  */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "imu_log.h"
+#include "BMI088driver.h"
+
+#define TEST_CLOCK          168000000U
+#define TEST_GYRO_NUM       2000U
+#define TEST_GYRO_US        1000U
+#define TEST_ACCEL_US       1250U
+#define TEST_TEMP_US        10000U
+#define TEST_CYCLE_START    (0xFFFFFFFFU - 50U * (TEST_CLOCK / 1000U))
+#define TEST_RATE           0.5f        //rad/s about z
+#define TEST_GYRO_OFFSET_Z  (-0.01f)
+#define TEST_GRAVITY        9.80665f
+#define TEST_TEMP_RAW       136         //40
+#define TEST_LOST_SEQ       100U        //seq skipped at this record.ڸ¼һseq
+#define TEST_DROP           3
+
+static int test_fail;
+static uint32_t test_record_num;
+static uint8_t test_seq;
+
+static void test_check(int ok, const char *what)
+{
+    printf("%-48s %s\n", what, ok ? "ok" : "FAIL");
+    if (!ok)
+    {
+        test_fail = 1;
+    }
+}
+
+static void test_record(FILE *file, uint8_t type, uint32_t cycle, const uint8_t *data, uint8_t len)
+{
+    imu_capture_t record;
+
+    memset(&record, 0, sizeof(record));
+    record.sync = IMU_CAPTURE_SYNC;
+    record.type = type;
+    record.len = len;
+    if (test_record_num == TEST_LOST_SEQ)
+    {
+        test_seq++;
+    }
+    record.seq = test_seq++;
+    record.cycle = cycle;
+    memcpy(record.data, data, len);
+    fwrite(&record, sizeof(record), 1, file);
+    test_record_num++;
+}
+
+static void test_put16(uint8_t *data, int16_t value)
+{
+    data[0] = (uint8_t)value;
+    data[1] = (uint8_t)((uint16_t)value >> 8);
+}
+
+static uint32_t test_cycle(uint32_t time_us)
+{
+    return TEST_CYCLE_START + time_us * (TEST_CLOCK / 1000000U);
+}
+
+static FILE *test_capture(void)
+{
+    FILE *file = tmpfile();
+    const fp32 gyro_offset[3] = {0.0f, 0.0f, TEST_GYRO_OFFSET_Z};
+    const fp32 accel_offset[3] = {0.0f, 0.0f, 0.0f};
+    uint8_t gyro[8] = {0};
+    uint8_t accel[9] = {0};
+    uint8_t temp[4] = {0};
+    uint32_t accel_us = 0, temp_us = 0, gyro_us;
+    uint32_t n;
+
+    //raw z is board z with the install matrix of INS_task.c
+    //INS_task.cİװ, ԭʼzἴz
+    test_put16(&gyro[1 + 4], (int16_t)lroundf((TEST_RATE - TEST_GYRO_OFFSET_Z) / BMI088_GYRO_2000_SEN));
+    test_put16(&accel[2 + 4], (int16_t)lroundf(TEST_GRAVITY / BMI088_ACCEL_3G_SEN));
+    temp[2] = TEST_TEMP_RAW >> 3;
+    temp[3] = (TEST_TEMP_RAW & 0x07) << 5;
+
+    fprintf(file, "status line before the capture\r\n");
+    fprintf(file, "IMU capture clock:%u\r\n", TEST_CLOCK);
+    test_record(file, IMU_CAPTURE_GYRO_OFFSET, test_cycle(0), (const uint8_t *)gyro_offset, sizeof(gyro_offset));
+    test_record(file, IMU_CAPTURE_ACCEL_OFFSET, test_cycle(0), (const uint8_t *)accel_offset, sizeof(accel_offset));
+    for (n = 0; n < TEST_GYRO_NUM; n++)
+    {
+        gyro_us = n * TEST_GYRO_US;
+        for (; accel_us <= gyro_us; accel_us += TEST_ACCEL_US)
+        {
+            test_record(file, IMU_CAPTURE_ACCEL, test_cycle(accel_us), accel, sizeof(accel));
+        }
+        for (; temp_us <= gyro_us; temp_us += TEST_TEMP_US)
+        {
+            test_record(file, IMU_CAPTURE_TEMP, test_cycle(temp_us), temp, sizeof(temp));
+        }
+        test_record(file, IMU_CAPTURE_GYRO, test_cycle(gyro_us), gyro, sizeof(gyro));
+    }
+    fprintf(file, "\r\nIMU capture off, drop:%d\r\n", TEST_DROP);
+    rewind(file);
+    return file;
+}
+
+static int test_parse_bytes(const void *bytes, size_t len)
+{
+    FILE *file = tmpfile();
+    imu_log_t log;
+    int ret;
+
+    fwrite(bytes, 1, len, file);
+    rewind(file);
+    ret = imu_log_parse(file, &log);
+    fclose(file);
+    imu_log_free(&log);
+    return ret;
+}
+
+int main(void)
+{
+    FILE *file = test_capture();
+    FILE *samples = tmpfile();
+    imu_log_t log;
+    imu_log_result_t result;
+    fp64 time_us;
+    fp32 gyro[3], accel[3];
+    char line[128];
+    char bad[64];
+    imu_capture_t record;
+    int i;
+
+    test_check(imu_log_parse(file, &log) == 0 && log.num == test_record_num, "parse");
+    fclose(file);
+    if (test_fail)
+    {
+        imu_log_free(&log);
+        printf("FAIL\n");
+        return 1;
+    }
+    test_check(log.clock == TEST_CLOCK && log.gap == 1 && log.drop == TEST_DROP, "clock, seq gap and drop");
+
+    test_check(imu_log_replay(&log, IMU_LOG_FILTER_AHRS, NULL, samples, &result) == 0, "replay AHRS_update");
+    printf("read_over %.1f cali %.1f filter %.1f AHRS_update %.1f get_angle %.1f ns per call\n",
+           result.stage_ns[IMU_LOG_STAGE_READ], result.stage_ns[IMU_LOG_STAGE_CALI], result.stage_ns[IMU_LOG_STAGE_FILTER],
+           result.stage_ns[IMU_LOG_STAGE_ATTITUDE], result.stage_ns[IMU_LOG_STAGE_ANGLE]);
+    test_check(result.gyro_sample == TEST_GYRO_NUM && result.gyro_skip == 0 && result.temp_sample == TEST_GYRO_NUM / 10U &&
+               result.accel_sample == (TEST_GYRO_NUM - 1U) * TEST_GYRO_US / TEST_ACCEL_US + 1U, "sample counts");
+    test_check(fabs(result.duration - (TEST_GYRO_NUM - 1U) * TEST_GYRO_US * 0.000001) < 1e-9 && result.dt_fallback == 0,
+               "dt across the DWT wrap");
+    test_check(result.temp_min == 40.0f && result.temp_max == 40.0f, "temperature");
+    printf("end yaw %.5f pitch %.5f roll %.5f rad\n", result.angle_end[0], result.angle_end[1], result.angle_end[2]);
+    test_check(fabsf(result.angle_end[0] - TEST_RATE * TEST_GYRO_NUM * TEST_GYRO_US * 0.000001f) < 0.005f,
+               "yaw of the turn with the gyro offset applied");
+    test_check(fabsf(result.angle_end[1]) < 0.002f && fabsf(result.angle_end[2]) < 0.002f, "level");
+
+    rewind(samples);
+    test_check(fgets(line, sizeof(line), samples) != NULL && line[0] == '#' && fgets(line, sizeof(line), samples) != NULL &&
+               sscanf(line, "%lf %f %f %f %f %f %f", &time_us, &gyro[0], &gyro[1], &gyro[2], &accel[0], &accel[1], &accel[2]) == 7 &&
+               fabsf(gyro[2] - TEST_RATE) < 0.001f && fabsf(accel[2] - TEST_GRAVITY) < 0.001f && fabsf(gyro[0]) < 1e-6f,
+               "calibrated samples for bench_ahrs");
+    fclose(samples);
+
+    test_check(imu_log_replay(&log, IMU_LOG_FILTER_EKF, NULL, NULL, &result) == 0, "replay quaternion EKF");
+    printf("end yaw %.5f pitch %.5f roll %.5f rad\n", result.angle_end[0], result.angle_end[1], result.angle_end[2]);
+    test_check(fabsf(result.angle_end[0] - TEST_RATE * TEST_GYRO_NUM * TEST_GYRO_US * 0.000001f) < 0.01f &&
+               fabsf(result.angle_end[1]) < 0.002f && fabsf(result.angle_end[2]) < 0.002f, "EKF attitude");
+    imu_log_free(&log);
+
+    test_check(test_parse_bytes("no header\r\n", 11) != 0, "refuse a capture without header");
+    memset(&record, 0, sizeof(record));
+    record.sync = IMU_CAPTURE_SYNC;
+    record.type = IMU_CAPTURE_ACCEL_OFFSET + 1;
+    i = sprintf(bad, "IMU capture clock:%u\r\n", TEST_CLOCK);
+    memcpy(bad + i, &record, sizeof(record));
+    test_check(test_parse_bytes(bad, i + sizeof(record)) != 0, "refuse a record of unknown type");
+    record.type = IMU_CAPTURE_GYRO;
+    record.len = IMU_CAPTURE_DATA_LEN + 1;
+    memcpy(bad + i, &record, sizeof(record));
+    test_check(test_parse_bytes(bad, i + sizeof(record)) != 0, "refuse a record too long");
+
+    printf("%s\n", test_fail ? "FAIL" : "PASS");
+    return test_fail;
+}